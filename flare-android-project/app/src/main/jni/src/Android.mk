@@ -19,7 +19,6 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
 	../../../../../../src/AnimationMedia.cpp \
 	../../../../../../src/AnimationSet.cpp \
 	../../../../../../src/AStarContainer.cpp \
-	../../../../../../src/AStarNode.cpp \
 	../../../../../../src/Avatar.cpp \
 	../../../../../../src/Camera.cpp \
 	../../../../../../src/CampaignManager.cpp \
@@ -34,6 +33,8 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
 	../../../../../../src/EngineSettings.cpp \
 	../../../../../../src/EventManager.cpp \
 	../../../../../../src/FileParser.cpp \
+	../../../../../../src/FileParserCache.cpp \
+	../../../../../../src/FlowField.cpp \
 	../../../../../../src/FogOfWar.cpp \
 	../../../../../../src/FontEngine.cpp \
 	../../../../../../src/GameSlotPreview.cpp \
@@ -57,8 +58,11 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
 	../../../../../../src/Map.cpp \
 	../../../../../../src/MapParallax.cpp \
 	../../../../../../src/MapCollision.cpp \
+	../../../../../../src/MapLayer.cpp \
+	../../../../../../src/MapLayerCache.cpp \
 	../../../../../../src/MapRenderer.cpp \
 	../../../../../../src/MapSaver.cpp \
+	../../../../../../src/MapVisibility.cpp \
 	../../../../../../src/Menu.cpp \
 	../../../../../../src/MenuActionBar.cpp \
 	../../../../../../src/MenuActiveEffects.cpp \
@@ -88,12 +92,20 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
 	../../../../../../src/ModManager.cpp \
 	../../../../../../src/NPC.cpp \
 	../../../../../../src/NPCManager.cpp \
+	../../../../../../src/NullRenderDevice.cpp \
+	../../../../../../src/NullSoundManager.cpp \
+	../../../../../../src/PackArchive.cpp \
+	../../../../../../src/PathHierarchy.cpp \
+	../../../../../../src/PathScheduler.cpp \
 	../../../../../../src/PowerManager.cpp \
 	../../../../../../src/QuestLog.cpp \
 	../../../../../../src/RenderDevice.cpp \
+	../../../../../../src/RenderInterpolation.cpp \
+	../../../../../../src/RenderOrder.cpp \
 	../../../../../../src/SaveLoad.cpp \
 	../../../../../../src/SDLInputState.cpp \
 	../../../../../../src/SDLHardwareRenderDevice.cpp \
+	../../../../../../src/SDLSoftwareBlitter.cpp \
 	../../../../../../src/SDLSoftwareRenderDevice.cpp \
 	../../../../../../src/SDLSoundManager.cpp \
 	../../../../../../src/SDLFontEngine.cpp \
@@ -101,9 +113,12 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
 	../../../../../../src/SharedGameResources.cpp \
 	../../../../../../src/SharedResources.cpp \
 	../../../../../../src/SoundManager.cpp \
+	../../../../../../src/SpatialGrid.cpp \
 	../../../../../../src/StatBlock.cpp \
 	../../../../../../src/Stats.cpp \
+	../../../../../../src/StatsRenderDevice.cpp \
 	../../../../../../src/Subtitles.cpp \
+	../../../../../../src/TextCache.cpp \
 	../../../../../../src/TileSet.cpp \
 	../../../../../../src/TooltipData.cpp \
 	../../../../../../src/TooltipManager.cpp \
@@ -126,6 +141,7 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
 	../../../../../../src/WidgetSlot.cpp \
  	../../../../../../src/WidgetTabControl.cpp \
 	../../../../../../src/WidgetTooltip.cpp \
+	../../../../../../src/WorkerPool.cpp \
 	../../../../../../src/XPScaling.cpp
 
 LOCAL_SHARED_LIBRARIES := SDL2 SDL2_image SDL2_mixer SDL2_ttf
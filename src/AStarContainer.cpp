@@ -17,138 +17,138 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 */
 
 #include "AStarContainer.h"
-#include <cstring>
 #include <cfloat>
 
-AStarContainer::AStarContainer(unsigned int _map_width, unsigned int _map_height, unsigned int _node_limit)
-	: size(0)
-	, node_limit(_node_limit)
-	, map_width(_map_width)
-	, map_height(_map_height)
+AStarContainer::AStarContainer()
+	: node_limit(0)
+	, map_width(0)
+	, map_height(0)
+	, generation(0)
+	, heuristic_weight(2)
 {
-	nodes.resize(node_limit, NULL);
-
-	//initialise the map array. A -1 value will mean there is no node at that position
-	map_pos.resize(map_width);
-	for (unsigned i=0; i<map_width; ++i) {
-		map_pos[i].resize(map_height, -1);
-	}
 }
 
 AStarContainer::~AStarContainer() {
-	for(unsigned int i=0; i<size; i++)
-		delete nodes[i];
-	nodes.clear();
 }
 
-int AStarContainer::getSize() {
-	return size;
+void AStarContainer::reset(int _map_width, int _map_height, unsigned int _node_limit, float _heuristic_weight) {
+	node_limit = _node_limit;
+	heuristic_weight = _heuristic_weight;
+
+	if (_map_width != map_width || _map_height != map_height) {
+		map_width = _map_width;
+		map_height = _map_height;
+
+		size_t tile_count = static_cast<size_t>(map_width * map_height);
+		g.resize(tile_count);
+		h.resize(tile_count);
+		parent.resize(tile_count);
+		heap_pos.resize(tile_count);
+		open_gen.assign(tile_count, 0);
+		closed_gen.assign(tile_count, 0);
+		generation = 0;
+	}
+
+	generation++;
+
+	// on wrap-around, old stamps could collide with the new generation
+	if (generation == 0) {
+		open_gen.assign(open_gen.size(), 0);
+		closed_gen.assign(closed_gen.size(), 0);
+		generation = 1;
+	}
+
+	heap.clear();
+	closed.clear();
+	if (heap.capacity() < node_limit)
+		heap.reserve(node_limit);
+	if (closed.capacity() < node_limit)
+		closed.reserve(node_limit);
+}
+
+void AStarContainer::setHeapPos(unsigned pos, int index) {
+	heap[pos] = index;
+	heap_pos[index] = pos;
 }
 
-void AStarContainer::add(AStarNode* node) {
-	if (size >= node_limit) return;
+void AStarContainer::addOpen(int index, int parent_index, float g_cost, float h_cost) {
+	if (heap.size() >= node_limit) return;
+
+	g[index] = g_cost;
+	h[index] = h_cost;
+	parent[index] = parent_index;
+	open_gen[index] = generation;
 
 	//add the new node at the end and update its index
-	nodes[size] = node;
-	map_pos[node->getX()][node->getY()] = static_cast<short>(size);
+	heap.push_back(index);
+	heap_pos[index] = static_cast<unsigned>(heap.size() - 1);
 
 	//reorder the heap based on f ordering, staring with thenewly added node and working up the tree from there
-	int m = size;
-
-	AStarNode* temp = NULL;
+	unsigned m = static_cast<unsigned>(heap.size() - 1);
 	while(m != 0) {
 		//if the current nodes f value is shorter than its parent, they need to be swapped
-		if(nodes[m]->getFinalCost() <= nodes[m/2]->getFinalCost()) {
-			temp = nodes[m/2];
-			nodes[m/2] = nodes[m];
-			map_pos[nodes[m/2]->getX()][nodes[m/2]->getY()] = static_cast<short>(m/2);
-			nodes[m] = temp;
-			map_pos[nodes[m]->getX()][nodes[m]->getY()] = static_cast<short>(m);
+		if(getFinalCost(heap[m]) <= getFinalCost(heap[m/2])) {
+			int temp = heap[m/2];
+			setHeapPos(m/2, heap[m]);
+			setHeapPos(m, temp);
 			m=m/2;
 		}
 		else
 			break;
 	}
-	size++;
-}
-
-AStarNode* AStarContainer::get_shortest_f() {
-	return nodes[0];
 }
 
-void AStarContainer::remove(AStarNode* node) {
-
-	unsigned int heap_indexv = map_pos[node->getX()][node->getY()] + 1;
+void AStarContainer::removeOpen(int index) {
+	unsigned heap_indexv = heap_pos[index] + 1;
+	unsigned size = static_cast<unsigned>(heap.size());
 
 	//swap the last node in the list with the node being deleted
-	nodes[heap_indexv-1] = nodes[size-1];
-	map_pos[nodes[heap_indexv-1]->getX()][nodes[heap_indexv-1]->getY()] = static_cast<short>(heap_indexv-1);
-
+	setHeapPos(heap_indexv-1, heap[size-1]);
+	heap.pop_back();
 	size--;
 
-	if(size == 0) {
-		map_pos[node->getX()][node->getY()] = -1;
+	open_gen[index] = 0;
+
+	if(size == 0)
 		return;
-	}
 
 	// reorder the heap to maintain the f ordering, starting at the node which replaced the deleted node, and working down the tree
-
 	while(true) {
 		//start at the node which dropped down the tree on the previous iteration
-		unsigned int heap_indexu = heap_indexv;
+		unsigned heap_indexu = heap_indexv;
 		if(2*heap_indexu+1 <= size) { //if both children exist
 			//Select the lowest of the two children.
-			if(nodes[heap_indexu-1]->getFinalCost() >= nodes[2*heap_indexu-1]->getFinalCost()) heap_indexv = 2*heap_indexu;
-			if(nodes[heap_indexv-1]->getFinalCost() >= nodes[2*heap_indexu]->getFinalCost()) heap_indexv = 2*heap_indexu+1;
+			if(getFinalCost(heap[heap_indexu-1]) >= getFinalCost(heap[2*heap_indexu-1])) heap_indexv = 2*heap_indexu;
+			if(getFinalCost(heap[heap_indexv-1]) >= getFinalCost(heap[2*heap_indexu])) heap_indexv = 2*heap_indexu+1;
 		}
 		else if (2*heap_indexu <= size) { //if only child #1 exists
 			//Check if the F cost is greater than the child
-			if(nodes[heap_indexu-1]->getFinalCost() >= nodes[2*heap_indexu-1]->getFinalCost()) heap_indexv = 2*heap_indexu;
+			if(getFinalCost(heap[heap_indexu-1]) >= getFinalCost(heap[2*heap_indexu-1])) heap_indexv = 2*heap_indexu;
 		}
 
 		if(heap_indexu != heap_indexv) { //If parent's F > one or both of its children, swap them
-			AStarNode* temp = nodes[heap_indexu-1];
-			nodes[heap_indexu-1] = nodes[heap_indexv-1];
-			map_pos[nodes[heap_indexu-1]->getX()][nodes[heap_indexu-1]->getY()] = static_cast<short>(heap_indexu-1);
-			nodes[heap_indexv-1] = temp;
-			map_pos[nodes[heap_indexv-1]->getX()][nodes[heap_indexv-1]->getY()] = static_cast<short>(heap_indexv-1);
+			int temp = heap[heap_indexu-1];
+			setHeapPos(heap_indexu-1, heap[heap_indexv-1]);
+			setHeapPos(heap_indexv-1, temp);
 		}
 		else {
 			break;//if item <= both children, exit loop
 		}
 	}//Repeat forever
-
-	//remove the node from the map pos index
-	map_pos[node->getX()][node->getY()] = -1;
-}
-
-bool AStarContainer::exists(const Point& pos) {
-	return map_pos[pos.x][pos.y] != -1;
-}
-
-AStarNode* AStarContainer::get(int x, int y) {
-	return nodes[map_pos[x][y]];
 }
 
-bool AStarContainer::isEmpty() {
-	return size == 0;
-}
-
-void AStarContainer::updateParent(const Point& pos, const Point& parent_pos, float score) {
-	get(pos.x, pos.y)->setParent(parent_pos);
-	get(pos.x, pos.y)->setActualCost(score);
+void AStarContainer::updateParent(int index, int parent_index, float g_cost) {
+	parent[index] = parent_index;
+	g[index] = g_cost;
 
 	//reorder the heap based on the new f value of this node. starting at the updated node and working up the tree
-	int m = map_pos[pos.x][pos.y];
-	AStarNode* temp = NULL;
+	unsigned m = heap_pos[index];
 	while(m != 0) {
 		//if the current node has a lower f value than its parent in the heap, swap them
-		if(nodes[m]->getFinalCost() <= nodes[m/2]->getFinalCost()) {
-			temp = nodes[m/2];
-			nodes[m/2] = nodes[m];
-			map_pos[nodes[m/2]->getX()][nodes[m/2]->getY()] = static_cast<short>(m/2);
-			nodes[m] = temp;
-			map_pos[nodes[m]->getX()][nodes[m]->getY()] = static_cast<short>(m);
+		if(getFinalCost(heap[m]) <= getFinalCost(heap[m/2])) {
+			int temp = heap[m/2];
+			setHeapPos(m/2, heap[m]);
+			setHeapPos(m, temp);
 			m=m/2;
 		}
 		else
@@ -156,54 +156,20 @@ void AStarContainer::updateParent(const Point& pos, const Point& parent_pos, flo
 	}
 }
 
-AStarCloseContainer::AStarCloseContainer(unsigned int _map_width, unsigned int _map_height, unsigned int _node_limit)
-	: size(0)
-	, node_limit(_node_limit)
-	, map_width(_map_width)
-	, map_height(_map_height)
-{
-	nodes.resize(node_limit, NULL);
-
-	//initialise the map array. A -1 value will mean there is no node at that position
-	map_pos.resize(map_width);
-	for (unsigned i=0; i<map_width; ++i) {
-		map_pos[i].resize(map_height, -1);
-	}
-}
-
-AStarCloseContainer::~AStarCloseContainer() {
-	for(unsigned int i=0; i<size; i++)
-		delete nodes[i];
-	nodes.clear();
-}
-
-int AStarCloseContainer::getSize() {
-	return size;
-}
-
-void AStarCloseContainer::add(AStarNode* node) {
-	if (size >= node_limit) return;
-
-	nodes[size] = node;
-	map_pos[node->getX()][node->getY()] = static_cast<short>(size);
-	size++;
-}
-
-bool AStarCloseContainer::exists(const Point& pos) {
-	return map_pos[pos.x][pos.y] != -1;
-}
+void AStarContainer::addClosed(int index) {
+	if (closed.size() >= node_limit) return;
 
-AStarNode* AStarCloseContainer::get(int x, int y) {
-	return nodes[map_pos[x][y]];
+	closed.push_back(index);
+	closed_gen[index] = generation;
 }
 
-AStarNode* AStarCloseContainer::get_shortest_h() {
-	AStarNode *current = NULL;
+int AStarContainer::getShortestH() const {
+	int current = -1;
 	float lowest_score = FLT_MAX;
-	for(unsigned int i = 0; i < size; i++) {
-		if(nodes[i]->getH() < lowest_score) {
-			lowest_score = nodes[i]->getH();
-			current = nodes[i];
+	for (size_t i = 0; i < closed.size(); i++) {
+		if (h[closed[i]] < lowest_score) {
+			lowest_score = h[closed[i]];
+			current = closed[i];
 		}
 	}
 	return current;
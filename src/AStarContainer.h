@@ -20,93 +20,84 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include <vector>
 
-#include "AStarNode.h"
+#include "Utils.h"
 
-typedef std::vector< std::vector<short> > AStar_Grid;
-
-/* Designed to be used for the Open nodes.
-*  Unsuitable for Closed nodes but a close node conatiner is declared below
+/* Scratch space for a single A* search.
+*
+*  Nodes are not allocated individually. Instead, every tile of the map has a slot in a set of flat arrays
+*  (index = y * map_width + x) that hold its cost, parent and list membership.
+*  A container is meant to be kept alive (one per MapCollision) and reset() before every search,
+*  so that after the first search on a map no further memory is allocated.
+*
+*  List membership is tracked with generation stamps: a tile is in the open or closed list only if its stamp
+*  matches the current search generation. This way, reset() does not need to clear the arrays.
 *
-*  All code in the class assumes that the nodes and points provided are within the bounds of the map limits
+*  All code in the class assumes that the points provided are within the bounds of the map limits
 */
 class AStarContainer {
 public:
-	AStarContainer(unsigned int _map_width, unsigned int _map_height, unsigned int _node_limit);
-	AStarContainer(const AStarContainer&); // copy constructor not yet implemented
-
+	AStarContainer();
 	~AStarContainer();
-	int getSize();
-	//assumes that the node is not already in the collection
-	void add(AStarNode* node);
-	//assumes that there is at least 1 node in the collection
-	AStarNode* get_shortest_f();
-	//assumes that the node exists in the collection
-	void remove(AStarNode* node);
-	bool exists(const Point& pos);
-	//assumes that the node exists in the collection
-	AStarNode* get(int x, int y);
-	bool isEmpty();
-	void updateParent(const Point& pos, const Point& parent_pos, float score);
+
+	// prepares the container for a new search. Only allocates if the map is larger than any previous map
+	// nodes are ordered by f = g + h * heuristic_weight. A weight above 1 is faster, but the path may not be the shortest
+	void reset(int _map_width, int _map_height, unsigned int _node_limit, float _heuristic_weight);
+
+	int toIndex(const Point& pos) const { return pos.y * map_width + pos.x; }
+	Point toPoint(int index) const { return Point(index % map_width, index / map_width); }
+
+	// open list
+	unsigned getOpenSize() const { return static_cast<unsigned>(heap.size()); }
+	bool isOpenEmpty() const { return heap.empty(); }
+	bool isOpen(int index) const { return open_gen[index] == generation; }
+	//assumes that the node is not already in the open list
+	void addOpen(int index, int parent_index, float g_cost, float h_cost);
+	//assumes that there is at least 1 node in the open list
+	int getShortestF() const { return heap[0]; }
+	//assumes that the node exists in the open list
+	void removeOpen(int index);
+	void updateParent(int index, int parent_index, float g_cost);
+
+	// closed list
+	unsigned getClosedSize() const { return static_cast<unsigned>(closed.size()); }
+	bool isClosed(int index) const { return closed_gen[index] == generation; }
+	void addClosed(int index);
+	int getShortestH() const;
+
+	float getActualCost(int index) const { return g[index]; }
+	int getParent(int index) const { return parent[index]; }
 
 private:
-	unsigned int size;
+	AStarContainer(const AStarContainer&); // copy constructor not yet implemented
+
+	float getFinalCost(int index) const { return g[index] + h[index] * heuristic_weight; }
+	void setHeapPos(unsigned pos, int index);
+
 	unsigned int node_limit;
-	unsigned int map_width;
-	unsigned int map_height;
+	int map_width;
+	int map_height;
+	unsigned int generation;
+	float heuristic_weight;
 
-	/* This is an array of AStarNode pointers. This is the main data for this collection.
-	*  The size of the array is based on the node limit.
-	*
-	*  The nodes in this array are ordered based on their f value and the node with the lowest f value is always at position 0.
+	/* The open list, stored as a binary heap of tile indices.
+	*  The node with the lowest f value is always at position 0.
 	*  The ordering is not linear, so after positon 0, we cannot assume that position 1 has the second shortest f value.
 	*
-	*  The ordering is based on a binary heap structure.
-	*  Essentially, each node can have up to 2 child nodes and each child node must have a lower f value than its parent.
-	*  This rule must be maintained whenever nodes are added or removed or their f value changes
-	*
-	*  The tree is represented by a 1 dimentional array where position 0 has children at position 1 and 2
-	*  Node 1 would have children at position 3 and 4 and node 2 would have children at position 5 and 6 and so on
-	*
 	*  A more detailed explanation of the structure can be found at the below web address.
-	*  Please note that there is additional code found in this class which is not mentioned in the article. This is to provide an index based on map position.
-	*  Also note that the code within the article is based on arrays with starting position 1, whereas we use 0 based arrays.
 	*  http://www.policyalmanac.org/games/binaryHeaps.htm
 	*/
-	std::vector<AStarNode*> nodes;
-
-	/* This is a 2d array of shorts ([map_width][map_height]) which acts as an index for the main node array.
-	*  Elements can be accessed using cartesian coordinates e.g. map_pos[x][y]
-	*  To access an AStarNode based on map position use: nodes[map_pos[x][y]]
-	*
-	*  The data in this array is initialised as -1, which indicates hat there is no corresponding node for that position
-	*  This must be maintained when nodes are added, removed and re-ordered in the node array
-	*/
-	AStar_Grid map_pos;
-};
-
-/* This class is used to store the closed list of a* nodes
-*  The nodes within this class have no ordering but stil have a map position index
-*/
-class AStarCloseContainer {
-public:
-	AStarCloseContainer(unsigned int _map_width, unsigned int _map_height, unsigned int _node_limit);
-	AStarCloseContainer(const AStarCloseContainer&); // copy constructor not yet implemented
-	~AStarCloseContainer();
-
-	int getSize();
-	void add(AStarNode* node);
-	bool exists(const Point& pos);
-	AStarNode* get(int x, int y);
-	AStarNode* get_shortest_h();
-
-private:
-	unsigned int size;
-	unsigned int node_limit;
-	unsigned int map_width;
-	unsigned int map_height;
-	std::vector<AStarNode*> nodes;
-	AStar_Grid map_pos;
-
+	std::vector<int> heap;
+
+	// closed tile indices, in the order they were closed
+	std::vector<int> closed;
+
+	// per-tile data, indexed by tile index
+	std::vector<float> g;
+	std::vector<float> h;
+	std::vector<int> parent;
+	std::vector<unsigned> heap_pos;
+	std::vector<unsigned> open_gen;
+	std::vector<unsigned> closed_gen;
 };
 
 #endif // ASTARCONTAINER_H
@@ -23,14 +23,33 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "MessageEngine.h"
 #include "RenderDevice.h"
 
+#include "NullRenderDevice.h"
 #include "SDLSoftwareRenderDevice.h"
 #include "SDLHardwareRenderDevice.h"
+#include "StatsRenderDevice.h"
 
 #include "SDLFontEngine.h"
+#include "NullSoundManager.h"
 #include "SDLSoundManager.h"
 #include "SDLInputState.h"
+#include "Settings.h"
+#include "SharedResources.h"
+#include "UtilsParsing.h"
 
 RenderDevice* getRenderDevice(const std::string& name) {
+	// "stats,<renderer>" records draw statistics through another renderer. "stats,null" draws nothing
+	if (name == "stats" || name.compare(0, 6, "stats,") == 0) {
+		std::string backend_name = name;
+		Parse::popFirstString(backend_name);
+		if (backend_name == "null" && !settings->headless)
+			return new StatsRenderDevice(new NullRenderDevice());
+		return new StatsRenderDevice(getRenderDevice(backend_name));
+	}
+
+	// headless mode has no window to render to
+	if (settings->headless)
+		return new NullRenderDevice();
+
 	// "sdl" is the default
 	if (name != "") {
 		if (name == "sdl") return new SDLSoftwareRenderDevice();
@@ -45,7 +64,7 @@ RenderDevice* getRenderDevice(const std::string& name) {
 	}
 }
 
-void createRenderDeviceList(MessageEngine* msg, std::vector<std::string> &rd_name, std::vector<std::string> &rd_desc) {
+void createRenderDeviceList(MessageEngine* _msg, std::vector<std::string> &rd_name, std::vector<std::string> &rd_desc) {
 	rd_name.clear();
 	rd_desc.clear();
 
@@ -53,10 +72,10 @@ void createRenderDeviceList(MessageEngine* msg, std::vector<std::string> &rd_nam
 	rd_desc.resize(2);
 
 	rd_name[0] = "sdl";
-	rd_desc[0] = msg->get("SDL software renderer\n\nOften slower, but less likely to have issues.");
+	rd_desc[0] = _msg->get("SDL software renderer\n\nOften slower, but less likely to have issues.");
 
 	rd_name[1] = "sdl_hardware";
-	rd_desc[1] = msg->get("SDL hardware renderer\n\nThe default renderer that is often faster than the SDL software renderer.");
+	rd_desc[1] = _msg->get("SDL hardware renderer\n\nThe default renderer that is often faster than the SDL software renderer.");
 }
 
 FontEngine* getFontEngine() {
@@ -64,6 +83,9 @@ FontEngine* getFontEngine() {
 }
 
 SoundManager* getSoundManager() {
+	if (settings->headless)
+		return new NullSoundManager();
+
 	return new SDLSoundManager();
 }
 
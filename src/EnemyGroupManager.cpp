@@ -34,7 +34,7 @@ EnemyGroupManager::EnemyGroupManager() {
 		FileParser infile;
 
 		// @CLASS EnemyGroupManager|Description of enemies in enemies/
-		if (!infile.open(enemy_paths[i], FileParser::MOD_FILE, FileParser::ERROR_NORMAL))
+		if (!infile.open(enemy_paths[i], FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE))
 			return;
 
 		Enemy_Level new_enemy;
@@ -22,6 +22,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "EngineSettings.h"
 #include "FileParser.h"
 #include "FontEngine.h"
+#include "MapCollision.h"
 #include "MenuActionBar.h"
 #include "MessageEngine.h"
 #include "ModManager.h"
@@ -95,10 +96,14 @@ void EngineSettings::Misc::load() {
 	passive_trigger_effect_stacking = false;
 	fade_wall_alpha = 63;
 	raycast_resolution = 0.1f;
+	path_cluster_size = 0;
+	flow_field_range = 0;
+	path_budget = 0;
+	path_algorithm = MapCollision::PATH_ALGORITHM_ASTAR;
 
 	FileParser infile;
 	// @CLASS EngineSettings: Misc|Description of engine/misc.txt
-	if (infile.open("engine/misc.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/misc.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			// @ATTR save_hpmp|bool|When saving the game, keep the hero's current HP and MP.
 			if (infile.key == "save_hpmp")
@@ -218,7 +223,7 @@ void EngineSettings::Misc::load() {
 				fade_wall_alpha = static_cast<uint8_t>(Parse::popFirstInt(infile.val));
 			}
 
-			// @ATTR raycast_resolution|float|Determines the number of steps used when testing line-of-sight and line-of-movement. A smaller value equates to more accurate results at the cost of performance. Defaults to 0.1.
+			// @ATTR raycast_resolution|float|Determines the number of steps used when testing line-of-movement. A smaller value equates to more accurate results at the cost of performance. Defaults to 0.1.
 			else if (infile.key == "raycast_resolution") {
 				raycast_resolution = Parse::toFloat(infile.val);
 				if (raycast_resolution <= 0) {
@@ -227,6 +232,43 @@ void EngineSettings::Misc::load() {
 				}
 			}
 
+			// @ATTR path_cluster_size|int|Size in tiles of the clusters used to plan long paths on large maps. Paths that span more than neighbouring clusters are planned on a graph of cluster entrances and then refined locally. Use 0 to disable. Defaults to 0.
+			else if (infile.key == "path_cluster_size") {
+				path_cluster_size = Parse::toInt(infile.val);
+				if (path_cluster_size < 0) {
+					path_cluster_size = 0;
+					infile.error("EngineSettings: path_cluster_size must not be negative.");
+				}
+			}
+
+			// @ATTR flow_field_range|int|Distance in tiles that the shared flow field toward the hero covers. Enemies and allies within this distance that are chasing the hero follow the field instead of computing their own path. Use 0 to disable. Defaults to 0.
+			else if (infile.key == "flow_field_range") {
+				flow_field_range = Parse::toInt(infile.val);
+				if (flow_field_range < 0) {
+					flow_field_range = 0;
+					infile.error("EngineSettings: flow_field_range must not be negative.");
+				}
+			}
+
+			// @ATTR path_budget|int|Maximum number of path nodes that entities may expand per frame when searching for paths. Searches that don't fit are delayed to later frames, and the entity keeps following its previous path in the meantime. Use 0 for no limit. Defaults to 0.
+			else if (infile.key == "path_budget") {
+				path_budget = Parse::toInt(infile.val);
+				if (path_budget < 0) {
+					path_budget = 0;
+					infile.error("EngineSettings: path_budget must not be negative.");
+				}
+			}
+
+			// @ATTR path_algorithm|["astar", "jps"]|Search used by entities to find paths on the collision grid. "jps" (Jump Point Search) expands far fewer nodes and usually finds shorter paths, but each node scans whole lines of tiles, so it is often slower on maps with many scattered obstacles or wide open areas, and it reaches the node limit sooner on long paths. "astar" weights its search toward the target, which is faster on most maps, but its paths may be slightly longer. Defaults to "astar".
+			else if (infile.key == "path_algorithm") {
+				if (infile.val == "astar")
+					path_algorithm = MapCollision::PATH_ALGORITHM_ASTAR;
+				else if (infile.val == "jps")
+					path_algorithm = MapCollision::PATH_ALGORITHM_JPS;
+				else
+					infile.error("EngineSettings: '%s' is not a valid path algorithm.", infile.val.c_str());
+			}
+
 			else infile.error("EngineSettings: '%s' is not a valid key.", infile.key.c_str());
 		}
 		infile.close();
@@ -261,7 +303,7 @@ void EngineSettings::Resolutions::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Resolution|Description of engine/resolutions.txt
-	if (infile.open("engine/resolutions.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/resolutions.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			// @ATTR menu_frame_width|int|Width of frame for New Game, Configuration, etc. menus.
 			if (infile.key == "menu_frame_width")
@@ -333,7 +375,7 @@ void EngineSettings::Gameplay::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Gameplay|Description of engine/gameplay.txt
-	if (infile.open("engine/gameplay.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/gameplay.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			if (infile.key == "enable_playgame") {
 				// @ATTR enable_playgame|bool|Enables the "Play Game" button on the main menu.
@@ -366,7 +408,7 @@ void EngineSettings::Combat::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Combat|Description of engine/combat.txt
-	if (infile.open("engine/combat.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/combat.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			if (infile.key == "absorb_percent") {
 				// @ATTR absorb_percent|float, float : Minimum, Maximum|Limits the percentage of damage that can be absorbed. A max value less than 100 will ensure that the target always takes at least 1 damage from non-elemental attacks.
@@ -459,7 +501,7 @@ void EngineSettings::EquipFlags::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Equip flags|Description of engine/equip_flags.txt
-	if (infile.open("engine/equip_flags.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/equip_flags.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "flag") {
@@ -528,7 +570,7 @@ void EngineSettings::PrimaryStats::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Primary Stats|Description of engine/primary_stats.txt
-	if (infile.open("engine/primary_stats.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/primary_stats.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "stat") {
@@ -603,7 +645,7 @@ void EngineSettings::HeroClasses::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Classes|Description of engine/classes.txt
-	if (infile.open("engine/classes.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/classes.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "class") {
@@ -775,7 +817,7 @@ void EngineSettings::DamageTypes::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Damage Types|Description of engine/damage_types.txt
-	if (infile.open("engine/damage_types.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/damage_types.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "damage_type") {
@@ -846,7 +888,7 @@ void EngineSettings::DamageTypes::load() {
 
 	// For backwards-compatibility, load engine/elements.txt as damage types
 	// @CLASS EngineSettings: Elements|(Deprecated in v1.14.85, use engine/damage_types.txt instead) Description of engine/elements.txt
-	if (infile.open("engine/elements.txt", FileParser::MOD_FILE, FileParser::ERROR_NONE)) {
+	if (infile.open("engine/elements.txt", FileParser::MOD_FILE, FileParser::ERROR_NONE, FileParser::USE_CACHE)) {
 		Utils::logInfo("EngineSettings: Found deprecated file engine/elements.txt. Please use engine/damage_types.txt instead!");
 
 		while (infile.next()) {
@@ -949,7 +991,7 @@ void EngineSettings::DeathPenalty::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Death penalty|Description of engine/death_penalty.txt
-	if (infile.open("engine/death_penalty.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/death_penalty.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			// @ATTR enable|bool|Enable the death penalty.
 			if (infile.key == "enable") enabled = Parse::toBool(infile.val);
@@ -982,7 +1024,7 @@ void EngineSettings::Tooltips::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Tooltips|Description of engine/tooltips.txt
-	if (infile.open("engine/tooltips.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/tooltips.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			// @ATTR tooltip_offset|int|Offset in pixels from the origin point (usually mouse cursor).
 			if (infile.key == "tooltip_offset")
@@ -1032,7 +1074,7 @@ void EngineSettings::Loot::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Loot|Description of engine/loot.txt
-	if (infile.open("engine/loot.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/loot.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			if (infile.key == "tooltip_margin") {
 				// @ATTR tooltip_margin|int|Vertical offset of the loot tooltip from the loot itself.
@@ -1112,7 +1154,7 @@ void EngineSettings::Tileset::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Tileset config|Description of engine/tileset_config.txt
-	if (infile.open("engine/tileset_config.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/tileset_config.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			if (infile.key == "tile_size") {
 				// @ATTR tile_size|int, int : Width, Height|The width and height of a tile.
@@ -1198,7 +1240,7 @@ void EngineSettings::Widgets::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Widgets|Description of engine/widget_settings.txt
-	if (infile.open("engine/widget_settings.txt", FileParser::MOD_FILE, FileParser::ERROR_NONE)) {
+	if (infile.open("engine/widget_settings.txt", FileParser::MOD_FILE, FileParser::ERROR_NONE, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			if (infile.section == "misc") {
 				if (infile.key == "selection_rect_color") {
@@ -1287,7 +1329,7 @@ void EngineSettings::XPTable::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: XP table|Description of engine/xp_table.txt
-	if (infile.open("engine/xp_table.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/xp_table.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while(infile.next()) {
 			if (infile.key == "level") {
 				// @ATTR level|int, int : Level, XP|The amount of XP required for this level.
@@ -1363,7 +1405,7 @@ void EngineSettings::NumberFormat::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Number Format|Description of engine/number_format.txt
-	if (infile.open("engine/number_format.txt", FileParser::MOD_FILE, FileParser::ERROR_NONE)) {
+	if (infile.open("engine/number_format.txt", FileParser::MOD_FILE, FileParser::ERROR_NONE, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			// @ATTR player_statbar|int|Number of digits after the decimal place to display for values in the player's statbars (HP/MP).
 			if (infile.key == "player_statbar")
@@ -1417,7 +1459,7 @@ void EngineSettings::ResourceStats::load() {
 
 	FileParser infile;
 	// @CLASS EngineSettings: Resource Stats|Description of engine/resource_stats.txt
-	if (infile.open("engine/resource_stats.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open("engine/resource_stats.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "resource_stat") {
@@ -77,6 +77,10 @@ public:
 		bool passive_trigger_effect_stacking;
 		uint8_t fade_wall_alpha;
 		float raycast_resolution;
+		int path_cluster_size;
+		int flow_field_range;
+		int path_budget;
+		int path_algorithm; // one of MapCollision::PATH_ALGORITHM_*, but never PATH_ALGORITHM_DEFAULT
 	};
 
 	class Resolutions {
@@ -48,6 +48,8 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include <cassert>
 
+unsigned Entity::next_serial = 0;
+
 Entity::Entity()
 	: sprites(NULL)
 	, sound_attack()
@@ -61,6 +63,7 @@ Entity::Entity()
 	, animationSet(NULL)
 	, stats()
 	, type_filename("")
+	, serial(next_serial++)
 {
 	// MSVC complains if you use 'this' in the init list
 	behavior = new EntityBehavior(this);
@@ -74,6 +77,9 @@ Entity& Entity::operator=(const Entity& e) {
 	if (this == &e)
 		return *this;
 
+	// this is a different entity now
+	serial = next_serial++;
+
 	sprites = e.sprites;
 	sound_attack = e.sound_attack;
 	sound_hit = e.sound_hit;
@@ -37,6 +37,8 @@ class EntityBehavior;
 
 class Entity {
 protected:
+	static unsigned next_serial;
+
 	Image *sprites;
 
 	void move_from_offending_tile();
@@ -95,6 +97,9 @@ public:
 
 	EntityBehavior *behavior;
 
+	// unique to this entity, even if it takes the memory of one that was removed
+	unsigned serial;
+
 	void loadAnimations();
 	virtual std::string getGfxFromType(const std::string& gfx_type);
 	void addRenders(std::vector<Renderable> &r);
@@ -46,11 +46,26 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "StatBlock.h"
 #include "UtilsMath.h"
 
+#include <limits>
+
 const float EntityBehavior::ALLY_FLEE_DISTANCE = 2;
 const float EntityBehavior::ALLY_FOLLOW_DISTANCE_WALK = 5.5;
 const float EntityBehavior::ALLY_FOLLOW_DISTANCE_STOP = 5;
 const float EntityBehavior::ALLY_TELEPORT_DISTANCE = 40;
 
+EntityBehavior::Perception::Perception()
+	: valid(false)
+	, pos()
+	, hero_dist(0)
+	, hero_los(false)
+	, check_hero_los(false)
+	, target(NULL)
+	, target_dist(0)
+	, target_los(false)
+	, check_target_los(false)
+{
+}
+
 EntityBehavior::EntityBehavior(Entity *_e)
 	: e(_e)
 	, path()
@@ -70,12 +85,90 @@ EntityBehavior::EntityBehavior(Entity *_e)
 	, turn_timer()
 	, instant_power(false)
 	, replaced_power_id(0)
+	, perception()
+	, nearest_scratch()
 {
 	// wait when PATH_FOUND_FAIL_THRESHOLD is exceeded
 	path_found_fail_timer.setDuration(settings->max_frames_per_sec * PATH_FOUND_FAIL_WAIT_SECONDS);
 	path_found_fail_timer.reset(Timer::END);
 }
 
+/**
+ * Looks around without changing anything else: the distance to the hero and the nearest entity to target.
+ * EntityManager calls this for every entity before any of them act, possibly from several threads at once, so
+ * nothing but this behavior's perception may be written here. Line-of-sight is filled in afterwards by setSight()
+ */
+void EntityBehavior::think() {
+	perception.valid = false;
+
+	if (e->stats.corpse || e->stats.cur_state == StatBlock::ENTITY_DEAD || e->stats.cur_state == StatBlock::ENTITY_CRITDEAD)
+		return;
+
+	// enemies that haven't been encountered won't act this frame
+	if (!e->stats.hero_ally && !e->stats.encountered && Utils::calcDist(e->stats.pos, pc->stats.pos) > settings->encounter_dist)
+		return;
+
+	perception.pos = e->stats.pos;
+	perception.hero_dist = 0;
+	perception.hero_los = false;
+	perception.check_hero_los = false;
+	if (pc->stats.alive) {
+		perception.hero_dist = Utils::calcDist(e->stats.pos, pc->stats.pos);
+		perception.check_hero_los = (perception.hero_dist < e->stats.threat_range);
+	}
+
+	// AI can target other AI
+	// enemies target allies, while allies target enemies that are in combat
+	SpatialGrid::Filter target_filter(e->stats.hero_ally ? SpatialGrid::ALLIANCE_ENEMY : SpatialGrid::ALLIANCE_ALLY, SpatialGrid::STATE_ALIVE);
+	target_filter.in_combat = e->stats.hero_ally;
+
+	perception.target_dist = 0;
+	perception.target_los = false;
+	perception.target = entitym->spatial_grid.getNearest(e->stats.pos, target_filter, std::numeric_limits<float>::max(), &perception.target_dist, nearest_scratch);
+	perception.check_target_los = (perception.target && pc->stats.alive && perception.target_dist < e->stats.threat_range);
+
+	perception.valid = true;
+}
+
+/**
+ * Adds the line-of-sight checks that the last think() asked for
+ * setSight() must be given the same queries, in the same order, once they have been answered
+ */
+void EntityBehavior::addSightQueries(std::vector<MapVisibility::Query>& queries) const {
+	if (!perception.valid)
+		return;
+
+	if (perception.check_hero_los)
+		queries.push_back(MapVisibility::Query(perception.pos, pc->stats.pos));
+	if (perception.check_target_los)
+		queries.push_back(MapVisibility::Query(perception.pos, perception.target->stats.pos));
+}
+
+/**
+ * Reads the answers to the queries from addSightQueries(), starting at index. index is moved past them
+ */
+void EntityBehavior::setSight(const std::vector<MapVisibility::Query>& queries, size_t& index) {
+	if (!perception.valid)
+		return;
+
+	if (perception.check_hero_los)
+		perception.hero_los = queries[index++].visible;
+	if (perception.check_target_los)
+		perception.target_los = queries[index++].visible;
+}
+
+/**
+ * Line-of-sight for a perception from think() outside of the think phase, one query at a time
+ */
+void EntityBehavior::checkSight() {
+	MapVisibility* visibility = mapr->collider.getVisibility();
+
+	if (perception.check_hero_los)
+		perception.hero_los = visibility->lineOfSight(perception.pos, pc->stats.pos);
+	if (perception.check_target_los)
+		perception.target_los = visibility->lineOfSight(perception.pos, perception.target->stats.pos);
+}
+
 /**
  * One frame of logic for this behavior
  */
@@ -153,10 +246,16 @@ void EntityBehavior::findTarget() {
 	StatBlock *target_stats = NULL;
 	float stealth_threat_range = (e->stats.threat_range * (100 - static_cast<float>(e->stats.hero_stealth))) / 100;
 
+	// the perception from the start of the frame is out of date if this entity has been moved since then
+	if (!perception.valid || perception.pos.x != e->stats.pos.x || perception.pos.y != e->stats.pos.y) {
+		think();
+		checkSight();
+	}
+
 	// check distance and line of sight between enemy and hero
 	// by default, the enemy pursues the hero directly
 	if (pc->stats.alive) {
-		target_dist = Utils::calcDist(e->stats.pos, pc->stats.pos);
+		target_dist = perception.hero_dist;
 		target_stats = &pc->stats;
 	}
 	else {
@@ -172,36 +271,30 @@ void EntityBehavior::findTarget() {
 		mapr->collider.block(e->stats.pos.x, e->stats.pos.y, MapCollision::IS_ALLY);
 		hero_dist = 0;
 		warp_to_hero = false;
+
+		// look around again from the new position
+		think();
+		checkSight();
 	}
 
-	// AI can target other AI
-	for (size_t i = 0; i < entitym->entities.size(); ++i) {
-		Entity* entity = entitym->entities[i];
-		if (!entity->stats.alive)
-			continue;
-
-		if ((!e->stats.hero_ally && entity->stats.hero_ally) || (e->stats.hero_ally && !entity->stats.hero_ally && entity->stats.in_combat)) {
-			float entity_dist = Utils::calcDist(e->stats.pos, entity->stats.pos);
-			if (!target_stats || (e->stats.hero_ally && target_stats->hero)) {
-				// pick the first available target if none is already selected
-				target_stats = &entitym->entities[i]->stats;
-				target_dist = entity_dist;
-				e->stats.in_combat = true;
-			}
-			else if (entity_dist < target_dist) {
-				// pick a new target if it's closer
-				target_stats = &entitym->entities[i]->stats;
-				target_dist = entity_dist;
-			}
-		}
+	// pick the nearest available target if none is already selected. Otherwise, only pick a new target if it's closer
+	bool pick_any_target = (!target_stats || (e->stats.hero_ally && target_stats->hero));
+	if (perception.target && (pick_any_target || perception.target_dist < target_dist)) {
+		target_stats = &perception.target->stats;
+		target_dist = perception.target_dist;
+		if (pick_any_target)
+			e->stats.in_combat = true;
 	}
 
 	// check line-of-sight
 	if (target_stats && target_dist < e->stats.threat_range && pc->stats.alive)
-		los = mapr->collider.lineOfSight(e->stats.pos.x, e->stats.pos.y, target_stats->pos.x, target_stats->pos.y);
+		los = (target_stats == &pc->stats) ? perception.hero_los : perception.target_los;
 	else
 		los = false;
 
+	// the perception is only good for this frame
+	perception.valid = false;
+
 	if (los)
 		e->stats.cooldown_los.reset(Timer::BEGIN);
 
@@ -479,6 +572,9 @@ void EntityBehavior::checkMove() {
 
 	path_found_fail_timer.tick();
 
+	// pick up the result of a queued path search
+	bool path_updated = entitym->path_scheduler.getResult(e, path, path_found);
+
 	// update direction
 	if (e->stats.facing) {
 		turn_timer.tick();
@@ -530,19 +626,16 @@ void EntityBehavior::checkMove() {
 				// target first waypoint
 				if (recalculate_path) {
 					chance_calc_path = -100;
-					path.clear();
-					path_found = mapr->collider.computePath(e->stats.pos, pursue_pos, path, e->stats.movement_type, MapCollision::DEFAULT_PATH_LIMIT);
-
-					if (!path_found) {
-						path_found_fails++;
-						if (path_found_fails >= PATH_FOUND_FAIL_THRESHOLD) {
-							// could not find a path after several tries, so wait a little before the next attempt
-							path_found_fail_timer.reset(Timer::BEGIN);
-						}
+
+					// when chasing the hero, follow the shared flow field if possible
+					// otherwise, queue a path search and keep following the old path until the result arrives
+					if (pursue_pos == pc->stats.pos && mapr->collider.followFlowField(e->stats.pos, path, e->stats.movement_type)) {
+						path_found = true;
+						path_updated = true;
+						entitym->path_scheduler.cancel(e);
 					}
 					else {
-						path_found_fails = 0;
-						path_found_fail_timer.reset(Timer::END);
+						entitym->path_scheduler.request(e, pursue_pos, e->stats.movement_type);
 					}
 				}
 
@@ -553,12 +646,13 @@ void EntityBehavior::checkMove() {
 					if (Utils::calcDist(e->stats.pos, pursue_pos) <= 1.f)
 						path.pop_back();
 				}
-				else if (e->stats.hero_ally && pursue_pos == pc->stats.pos) {
+				else if (e->stats.hero_ally && pursue_pos == pc->stats.pos && !entitym->path_scheduler.isPending(e)) {
 					warp_to_hero = true;
 				}
 			}
 			else {
 				path.clear();
+				entitym->path_scheduler.cancel(e);
 			}
 
 			if (e->stats.charge_speed == 0.0f) {
@@ -568,6 +662,20 @@ void EntityBehavior::checkMove() {
 		}
 	}
 
+	if (path_updated) {
+		if (!path_found) {
+			path_found_fails++;
+			if (path_found_fails >= PATH_FOUND_FAIL_THRESHOLD) {
+				// could not find a path after several tries, so wait a little before the next attempt
+				path_found_fail_timer.reset(Timer::BEGIN);
+			}
+		}
+		else {
+			path_found_fails = 0;
+			path_found_fail_timer.reset(Timer::END);
+		}
+	}
+
 	e->stats.flee_timer.tick();
 	e->stats.flee_cooldown_timer.tick();
 
@@ -30,6 +30,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #ifndef ENTITY_BEHAVIOR_H
 #define ENTITY_BEHAVIOR_H
 
+#include "MapVisibility.h"
 #include "StatBlock.h"
 #include <queue>
 
@@ -37,6 +38,24 @@ class Entity;
 
 class EntityBehavior {
 private:
+	/**
+	 * What an entity knows about its surroundings at the start of a frame
+	 * Filled in by think() and setSight(), and used by findTarget()
+	 */
+	class Perception {
+	public:
+		bool valid;
+		FPoint pos; // where the entity was when it looked around
+		float hero_dist;
+		bool hero_los;
+		bool check_hero_los; // hero_los is only looked up when the hero is in range
+		Entity* target; // the nearest entity it could target
+		float target_dist;
+		bool target_los;
+		bool check_target_los;
+		Perception();
+	};
+
 	static const float ALLY_FLEE_DISTANCE;
 	static const float ALLY_FOLLOW_DISTANCE_WALK;
 	static const float ALLY_FOLLOW_DISTANCE_STOP;
@@ -49,6 +68,7 @@ private:
 	void checkMove();
 	void checkMoveStateStance();
 	void checkMoveStateMove();
+	void checkSight();
 	void checkOnStatePower(StatBlock::AIPower** on_state_power);
 	void updateState();
 	FPoint getWanderPoint();
@@ -82,9 +102,15 @@ protected:
 	bool instant_power;
 	PowerID replaced_power_id;
 
+	Perception perception;
+	std::vector< std::pair<float, unsigned> > nearest_scratch;
+
 public:
 	explicit EntityBehavior(Entity *_e);
 	~EntityBehavior();
+	void think();
+	void addSightQueries(std::vector<MapVisibility::Query>& queries) const;
+	void setSight(const std::vector<MapVisibility::Query>& queries, size_t& index);
 	void logic();
 
 	std::vector<FPoint>& getPath() { return path; }
@@ -48,7 +48,11 @@ EntityManager::EntityManager()
 	: entities()
 	, hero_stealth(0)
 	, player_blocked(false)
-	, player_blocked_timer(settings->max_frames_per_sec / 6) {
+	, player_blocked_timer(settings->max_frames_per_sec / 6)
+	, path_scheduler()
+	, spatial_grid()
+	, think_pool() {
+	think_pool.init(settings->ai_threads);
 	handleNewMap();
 }
 
@@ -115,6 +119,9 @@ void EntityManager::handleNewMap () {
 	Map_Enemy me;
 	std::queue<Entity *> allies;
 
+	// pending paths belong to the previous map
+	path_scheduler.clear();
+
 	// delete existing entities
 	for (unsigned int i=0; i < entities.size(); i++) {
 		if (entities[i]->stats.npc)
@@ -190,6 +197,8 @@ void EntityManager::handleNewMap () {
 		mapr->collider.block(e->stats.pos.x, e->stats.pos.y, MapCollision::IS_ALLY);
 	}
 
+	spatial_grid.rebuild(&entities, mapr->collider.map_size);
+
 	// load entities that can be spawn by avatar's powers
 	for (size_t i = 0; i < pc->stats.powers_list.size(); i++) {
 		PowerID power_index = pc->stats.powers_list[i];
@@ -344,6 +353,18 @@ bool EntityManager::checkPartyMembers() {
 	return false;
 }
 
+/**
+ * Job function for think_pool. Each call handles one slice of the entity list
+ */
+void EntityManager::think(void* data, size_t begin, size_t end) {
+	std::vector<Entity*>& entity_list = *static_cast<std::vector<Entity*>*>(data);
+
+	for (size_t i = begin; i < end; ++i) {
+		if (!entity_list[i]->stats.npc)
+			entity_list[i]->behavior->think();
+	}
+}
+
 /**
  * perform logic() for all entities
  */
@@ -357,20 +378,49 @@ void EntityManager::logic() {
 
 	handleSpawn();
 
+	spatial_grid.rebuild(&entities, mapr->collider.map_size);
+
+	mapr->collider.getVisibility()->nextFrame();
+
+	// every entity looks around first, from where everything is at the start of the frame
+	// this only reads the world, so the work can be split between threads
+	think_pool.run(think, &entities, entities.size());
+
+	// line-of-sight is checked here in one batch, so that repeated checks are answered from the visibility cache
+	sight_queries.clear();
+	for (size_t i = 0; i < entities.size(); ++i) {
+		if (!entities[i]->stats.npc)
+			entities[i]->behavior->addSightQueries(sight_queries);
+	}
+	mapr->collider.getVisibility()->lineOfSight(sight_queries);
+
+	size_t sight_index = 0;
+	for (size_t i = 0; i < entities.size(); ++i) {
+		if (!entities[i]->stats.npc)
+			entities[i]->behavior->setSight(sight_queries, sight_index);
+	}
+
 	bool pc_in_combat = false;
 
-	std::vector<Entity*>::iterator it;
-	for (it = entities.begin(); it != entities.end(); ++it) {
+	for (size_t i = 0; i < entities.size(); ++i) {
+		Entity* e = entities[i];
+
 		// new actions this round
-		(*it)->stats.hero_stealth = hero_stealth;
-		if (!(*it)->stats.npc) {
-			(*it)->logic();
+		e->stats.hero_stealth = hero_stealth;
+		if (!e->stats.npc) {
+			e->logic();
+
+			// keep the grid up to date for the entities that act after this one
+			spatial_grid.update(i);
 
-			if (!pc_in_combat && (*it)->stats.alive && !(*it)->stats.hero_ally && (*it)->stats.in_combat)
+			if (!pc_in_combat && e->stats.alive && !e->stats.hero_ally && e->stats.in_combat)
 				pc_in_combat = true;
 		}
 	}
 
+	// run the path searches that entities requested this frame
+	path_scheduler.logic();
+
 	if (pc_in_combat && !pc->stats.in_combat) {
 		// if a supported controller is connected, change the LED to red when in combat
 		Color led_color(255, 0, 0);
@@ -384,30 +434,53 @@ void EntityManager::logic() {
 }
 
 Entity* EntityManager::entityFocus(const Point& mouse, const FPoint& cam, bool alive_only) {
-	Point p;
-	Rect r;
-
 	Entity* nearest = NULL;
 	float best_distance = std::numeric_limits<float>::max();
 	FPoint mousef = FPoint(mouse);
 	FPoint render_bounds_center;
 
-	for(unsigned int i = 0; i < entities.size(); i++) {
-		if (entities[i]->stats.cur_state == StatBlock::ENTITY_DEAD || entities[i]->stats.cur_state == StatBlock::ENTITY_CRITDEAD) {
+	// only entities on or near the screen can be under the mouse
+	FPoint corners[4];
+	corners[0] = Utils::screenToMap(0, 0, cam.x, cam.y);
+	corners[1] = Utils::screenToMap(settings->view_w, 0, cam.x, cam.y);
+	corners[2] = Utils::screenToMap(0, settings->view_h, cam.x, cam.y);
+	corners[3] = Utils::screenToMap(settings->view_w, settings->view_h, cam.x, cam.y);
+
+	FPoint top_left = corners[0];
+	FPoint bottom_right = corners[0];
+	for (int i = 1; i < 4; ++i) {
+		top_left.x = std::min(top_left.x, corners[i].x);
+		top_left.y = std::min(top_left.y, corners[i].y);
+		bottom_right.x = std::max(bottom_right.x, corners[i].x);
+		bottom_right.y = std::max(bottom_right.y, corners[i].y);
+	}
+
+	Rect view_tiles;
+	view_tiles.x = static_cast<int>(top_left.x) - FOCUS_MARGIN;
+	view_tiles.y = static_cast<int>(top_left.y) - FOCUS_MARGIN;
+	view_tiles.w = static_cast<int>(bottom_right.x) - view_tiles.x + FOCUS_MARGIN + 1;
+	view_tiles.h = static_cast<int>(bottom_right.y) - view_tiles.y + FOCUS_MARGIN + 1;
+
+	spatial_grid.getInRect(view_tiles, SpatialGrid::Filter(), query_result);
+
+	for (size_t i = 0; i < query_result.size(); i++) {
+		Entity* e = query_result[i];
+
+		if (e->stats.cur_state == StatBlock::ENTITY_DEAD || e->stats.cur_state == StatBlock::ENTITY_CRITDEAD) {
 			if (alive_only)
 				continue;
-			else if (entities[i]->stats.corpse && entities[i]->stats.corpse_timer.isEnd() && entities[i]->stats.corpse_has_timeout)
+			else if (e->stats.corpse && e->stats.corpse_timer.isEnd() && e->stats.corpse_has_timeout)
 				continue;
 		}
 
-		Rect render_bounds = entities[i]->getRenderBounds(cam);
+		Rect render_bounds = e->getRenderBounds(cam);
 		if (Utils::isWithinRect(render_bounds, mouse)) {
 			render_bounds_center.x = static_cast<float>(render_bounds.x) + (static_cast<float>(render_bounds.w)/2);
 			render_bounds_center.y = static_cast<float>(render_bounds.y) + (static_cast<float>(render_bounds.h)/2);
 			float distance = Utils::calcDist(mousef, render_bounds_center);
 			if (distance < best_distance) {
 				best_distance = distance;
-				nearest = entities[i];
+				nearest = e;
 			}
 		}
 	}
@@ -415,30 +488,18 @@ Entity* EntityManager::entityFocus(const Point& mouse, const FPoint& cam, bool a
 }
 
 Entity* EntityManager::getNearestEntity(const FPoint& pos, bool get_corpse, float *saved_distance, float max_range) {
-	Entity* nearest = NULL;
+	SpatialGrid::Filter filter(SpatialGrid::ALLIANCE_ANY, get_corpse ? SpatialGrid::STATE_CORPSE : SpatialGrid::STATE_NOT_DEAD);
 	float best_distance = std::numeric_limits<float>::max();
 
-	for (unsigned i=0; i<entities.size(); i++) {
-		if(!get_corpse && (entities[i]->stats.cur_state == StatBlock::ENTITY_DEAD || entities[i]->stats.cur_state == StatBlock::ENTITY_CRITDEAD)) {
-			continue;
-		}
-		if (get_corpse && !entities[i]->stats.corpse) {
-			continue;
-		}
+	// when the distance is saved, the nearest entity is returned even if it is out of range
+	if (saved_distance)
+		max_range = std::numeric_limits<float>::max();
 
-		float distance = Utils::calcDist(pos, entities[i]->stats.pos);
-		if (distance < best_distance) {
-			best_distance = distance;
-			nearest = entities[i];
-		}
-	}
+	Entity* nearest = spatial_grid.getNearest(pos, filter, max_range, &best_distance);
 
 	if (nearest && saved_distance)
 		*saved_distance = best_distance;
 
-	if (!saved_distance && best_distance > max_range)
-		nearest = NULL;
-
 	return nearest;
 }
 
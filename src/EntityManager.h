@@ -27,7 +27,11 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #define ENTITY_MANAGER_H
 
 #include "CommonIncludes.h"
+#include "MapVisibility.h"
+#include "PathScheduler.h"
+#include "SpatialGrid.h"
 #include "Utils.h"
+#include "WorkerPool.h"
 
 class Animation;
 class Entity;
@@ -41,6 +45,13 @@ protected:
 
 	std::vector<Entity> prototypes;
 
+	static const int FOCUS_MARGIN = 8; // in tiles, for sprites that extend onto the screen from off-screen entities
+
+	std::vector<Entity*> query_result;
+	std::vector<MapVisibility::Query> sight_queries;
+
+	static void think(void* data, size_t begin, size_t end);
+
 public:
 	EntityManager();
 	~EntityManager();
@@ -65,6 +76,10 @@ public:
 	bool player_blocked;
 	Timer player_blocked_timer;
 
+	PathScheduler path_scheduler;
+	SpatialGrid spatial_grid;
+	WorkerPool think_pool;
+
 	static const bool GET_CORPSE = true;
 	static const bool IS_ALIVE = true;
 };
@@ -22,6 +22,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "EngineSettings.h"
 #include "EventManager.h"
 #include "FileParser.h"
+#include "FogOfWar.h"
 #include "InputState.h"
 #include "ItemManager.h"
 #include "LootManager.h"
@@ -994,7 +995,7 @@ bool EventManager::executeEventInternal(Event &ev, bool skip_delay) {
 				ec->data[1].Int = random_ec.data[1].Int;
 			}
 
-			if (Filesystem::fileExists(mods->locate(ec->s))) {
+			if (mods->fileExists(ec->s)) {
 				mapr->teleportation = true;
 				mapr->teleport_mapname = ec->s;
 
@@ -1029,7 +1030,7 @@ bool EventManager::executeEventInternal(Event &ev, bool skip_delay) {
 
 			if (ec->s == "collision") {
 				if (tile_x >= 0 && tile_x < mapr->w && tile_y >= 0 && tile_y < mapr->h) {
-					mapr->collider.colmap[tile_x][tile_y] = tile_id;
+					mapr->collider.setTile(tile_x, tile_y, tile_id);
 					mapr->map_change = true;
 				}
 				else
@@ -1041,8 +1042,12 @@ bool EventManager::executeEventInternal(Event &ev, bool skip_delay) {
 					Utils::logError("EventManager: Mapmod at position (%d, %d) contains invalid tile id (%d).", tile_x, tile_y, tile_id);
 				else if (index >= mapr->layers.size())
 					Utils::logError("EventManager: Mapmod at position (%d, %d) is on an invalid layer.", tile_x, tile_y);
-				else if (tile_x >= 0 && tile_x < mapr->w && tile_y >= 0 && tile_y < mapr->h)
-					mapr->layers[index][tile_x][tile_y] = tile_id;
+				else if (tile_x >= 0 && tile_x < mapr->w && tile_y >= 0 && tile_y < mapr->h) {
+					mapr->layers[index](tile_x, tile_y) = tile_id;
+					mapr->invalidateLayerCache(tile_x, tile_y);
+					if (mapr->fogofwar && index == fow->dark_layer_id)
+						fow->updateOcclusion(tile_x, tile_y);
+				}
 				else
 					Utils::logError("EventManager: Mapmod at position (%d, %d) is out of bounds 0-255.", tile_x, tile_y);
 			}
@@ -1055,13 +1060,13 @@ bool EventManager::executeEventInternal(Event &ev, bool skip_delay) {
 
 			if (ec->s == "collision") {
 				if (tile_x >= 0 && tile_x < mapr->w && tile_y >= 0 && tile_y < mapr->h) {
-					unsigned short &map_tile = mapr->collider.colmap[tile_x][tile_y];
+					unsigned short map_tile = mapr->collider.colmap(tile_x, tile_y);
 					if (map_tile == tile_a) {
-						map_tile = tile_b;
+						mapr->collider.setTile(tile_x, tile_y, tile_b);
 						mapr->map_change = true;
 					}
 					else if (map_tile == tile_b) {
-						map_tile = tile_a;
+						mapr->collider.setTile(tile_x, tile_y, tile_a);
 						mapr->map_change = true;
 					}
 				}
@@ -1077,13 +1082,16 @@ bool EventManager::executeEventInternal(Event &ev, bool skip_delay) {
 				else if (index >= mapr->layers.size())
 					Utils::logError("EventManager: Mapmod at position (%d, %d) is on an invalid layer.", tile_x, tile_y);
 				else if (tile_x >= 0 && tile_x < mapr->w && tile_y >= 0 && tile_y < mapr->h) {
-					unsigned short &map_tile = mapr->layers[index][tile_x][tile_y];
+					unsigned short &map_tile = mapr->layers[index](tile_x, tile_y);
 					if (map_tile == tile_a) {
 						map_tile = tile_b;
 					}
 					else if (map_tile == tile_b) {
 						map_tile = tile_a;
 					}
+					mapr->invalidateLayerCache(tile_x, tile_y);
+					if (mapr->fogofwar && index == fow->dark_layer_id)
+						fow->updateOcclusion(tile_x, tile_y);
 				}
 				else
 					Utils::logError("EventManager: Mapmod at position (%d, %d) is out of bounds 0-255.", tile_x, tile_y);
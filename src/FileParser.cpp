@@ -17,28 +17,60 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 */
 
 #include "FileParser.h"
+#include "FileParserCache.h"
 #include "ModManager.h"
+#include "Settings.h"
 #include "SharedResources.h"
 #include "UtilsFileSystem.h"
 #include "UtilsParsing.h"
 
 #include <stdarg.h>
+#include <string.h>
+
+/**
+ * Trim whitespace from both ends of a line without copying it
+ * Uses the same delimiters as Parse::trim()
+ */
+static bool isTrimDelimiter(char c) {
+	return c == ' ' || c == '\f' || c == '\n' || c == '\r' || c == '\t' || c == '\v';
+}
+
+static void trimView(const char*& str, size_t& length) {
+	while (length > 0 && isTrimDelimiter(str[length-1]))
+		length--;
+	while (length > 0 && isTrimDelimiter(str[0])) {
+		str++;
+		length--;
+	}
+}
+
+static bool viewEquals(const char* str, size_t length, const char* other) {
+	size_t other_length = strlen(other);
+	return length == other_length && strncmp(str, other, length) == 0;
+}
 
 FileParser::FileParser()
 	: current_index(0)
 	, is_mod_file(false)
 	, error_mode(ERROR_NORMAL)
 	, requested_filename("")
-	, line("")
+	, buffer_pos(0)
 	, line_number(0)
 	, include_fp(NULL)
+	, cache(NULL)
+	, cache_owner(false)
 	, new_section(false)
 	, section("")
 	, key("")
 	, val("") {
 }
 
-bool FileParser::open(const std::string& _filename, bool _is_mod_file, int _error_mode) {
+bool FileParser::open(const std::string& _filename, bool _is_mod_file, int _error_mode, bool use_cache) {
+	if (cache_owner)
+		delete cache;
+	cache = NULL;
+	cache_owner = false;
+
 	is_mod_file = _is_mod_file;
 	error_mode = _error_mode;
 	requested_filename = _filename;
@@ -52,6 +84,10 @@ bool FileParser::open(const std::string& _filename, bool _is_mod_file, int _erro
 	}
 	current_index = 0;
 	line_number = 0;
+	buffer_pos = 0;
+
+	buffers.clear();
+	buffers.resize(filenames.size());
 
 	if (filenames.empty()) {
 		if (error_mode != ERROR_NONE)
@@ -59,45 +95,47 @@ bool FileParser::open(const std::string& _filename, bool _is_mod_file, int _erro
 		return false;
 	}
 
+	if (use_cache && is_mod_file) {
+		cache = new FileParserCache(_filename);
+		cache_owner = true;
+
+		if (!settings->rebuild_cache && cache->load(filenames))
+			return true;
+
+		// the text will be parsed, and the cache rebuilt once it has been read to the end
+		cache->addSource(_filename, filenames);
+	}
+
 	bool ret = false;
 
 	// Cycle through all filenames from the end, stopping when a file is to overwrite all further files.
+	// Every file read here is kept in memory, so next() doesn't need to read any of them again.
 	for (size_t i=filenames.size(); i>0; i--) {
-		infile.open(filenames[i-1].c_str(), std::ios::in);
-		ret = infile.is_open();
+		ret = loadFile(i-1);
 
 		if (ret) {
-			// This will be the first file to be parsed. Seek to the start of the file and leave it open.
-			if (infile.good() && Parse::trim(Parse::getLine(infile)) != "APPEND") {
-				std::string test_line;
-
-				// get the first non-comment, non blank line
-				while (infile.good()) {
-					test_line = Parse::trim(Parse::getLine(infile));
-					if (Parse::skipLine(test_line))
-						continue;
-					else
-						break;
-				}
-
-				if (test_line != "APPEND") {
-					current_index = static_cast<unsigned>(i)-1;
-					infile.clear(); // reset flags
-					infile.seekg(0, std::ios::beg);
+			current_index = static_cast<unsigned>(i)-1;
+
+			// get the first non-comment, non blank line
+			const char* test_line = NULL;
+			size_t test_length = 0;
+			buffer_pos = 0;
+			while (readLine(test_line, test_length)) {
+				trimView(test_line, test_length);
+				if (test_length == 0 || test_line[0] == '#')
+					continue;
+				else
 					break;
-				}
 			}
+			buffer_pos = 0;
 
-			// don't close the final file if it's the only one with an "APPEND" line
-			if (i > 1) {
-				infile.close();
-				infile.clear();
-			}
+			// This will be the first file to be parsed.
+			if (!viewEquals(test_line, test_length, "APPEND"))
+				break;
 		}
 		else {
 			if (error_mode != ERROR_NONE)
 				Utils::logError("FileParser: Could not open text file: %s", filenames[i-1].c_str());
-			infile.clear();
 		}
 	}
 
@@ -111,9 +149,65 @@ void FileParser::close() {
 		include_fp = NULL;
 	}
 
-	if (infile.is_open())
-		infile.close();
-	infile.clear();
+	if (cache_owner)
+		delete cache;
+	cache = NULL;
+	cache_owner = false;
+
+	buffers.clear();
+	buffer_pos = 0;
+}
+
+FileParser::FileBuffer::FileBuffer()
+	: data(NULL)
+	, size(0)
+	, is_loaded(false)
+{
+}
+
+bool FileParser::loadFile(size_t index) {
+	FileBuffer& buffer = buffers[index];
+	if (buffer.is_loaded)
+		return true;
+
+	if (mods && mods->getPackedFile(filenames[index], buffer.data, buffer.size)) {
+		buffer.is_loaded = true;
+	}
+	else if (Filesystem::readFile(filenames[index], buffer.contents)) {
+		buffer.data = buffer.contents.data();
+		buffer.size = buffer.contents.size();
+		buffer.is_loaded = true;
+	}
+
+	return buffer.is_loaded;
+}
+
+/**
+ * Get the next line from the current file buffer, with a trailing carriage return removed
+ * The line points into the buffer, so it is only valid until the buffer is released
+ *
+ * @return false if there are no lines left
+ */
+bool FileParser::readLine(const char*& line_start, size_t& line_length) {
+	if (current_index >= buffers.size())
+		return false;
+
+	const FileBuffer& buffer = buffers[current_index];
+
+	if (buffer_pos >= buffer.size)
+		return false;
+
+	const char* line_end = static_cast<const char*>(memchr(buffer.data + buffer_pos, '\n', buffer.size - buffer_pos));
+	size_t line_end_pos = line_end ? static_cast<size_t>(line_end - buffer.data) : buffer.size;
+
+	line_start = buffer.data + buffer_pos;
+	line_length = line_end_pos - buffer_pos;
+	buffer_pos = line_end_pos + 1;
+
+	if (line_length > 0 && line_start[line_length-1] == '\r')
+		line_length--;
+
+	return true;
 }
 
 /**
@@ -124,17 +218,22 @@ void FileParser::close() {
  */
 bool FileParser::next() {
 
-	std::string starts_with;
+	const char* line = NULL;
+	size_t line_length = 0;
 	new_section = false;
 
+	if (cache && cache->isLoaded())
+		return cache->nextRecord(new_section, section, key, val);
+
 	while (current_index < filenames.size()) {
-		while (infile.good()) {
+		while (true) {
 			if (include_fp) {
 				if (include_fp->next()) {
 					new_section = include_fp->new_section;
 					section = include_fp->section;
 					key = include_fp->key;
 					val = include_fp->val;
+					addCacheRecord();
 					return true;
 				}
 				else {
@@ -145,34 +244,40 @@ bool FileParser::next() {
 				}
 			}
 
-			line = Parse::trim(Parse::getLine(infile));
+			if (!readLine(line, line_length))
+				break;
+
 			line_number++;
+			trimView(line, line_length);
 
-			if (Parse::skipLine(line))
+			if (line_length == 0 || line[0] == '#')
 				continue;
 
-			starts_with = line.at(0);
-
 			// set new section if this line is a section declaration
-			if (starts_with == "[") {
+			if (line[0] == '[') {
 				new_section = true;
-				section = Parse::getSectionTitle(line);
+
+				const char* bracket = static_cast<const char*>(memchr(line, ']', line_length));
+				if (bracket)
+					section.assign(line + 1, static_cast<size_t>(bracket - line) - 1);
+				else
+					section.clear();
 
 				// keep searching for a key-pair
 				continue;
 			}
 
 			// skip the string used to combine files
-			if (line == "APPEND") continue;
+			if (viewEquals(line, line_length, "APPEND")) continue;
 
 			// read from a separate file
-			std::size_t first_space = line.find(' ');
+			const char* first_space = static_cast<const char*>(memchr(line, ' ', line_length));
 
-			if (first_space != std::string::npos) {
-				std::string directive = line.substr(0, first_space);
+			if (first_space) {
+				size_t directive_length = static_cast<size_t>(first_space - line);
 
-				if (directive == "INCLUDE") {
-					std::string tmp = line.substr(first_space+1);
+				if (viewEquals(line, directive_length, "INCLUDE")) {
+					std::string tmp(first_space + 1, line_length - directive_length - 1);
 
 					if (requested_filename != tmp) {
 						include_fp = new FileParser();
@@ -184,6 +289,15 @@ bool FileParser::next() {
 						if (include_fp) {
 							// INCLUDE file will inherit the current section
 							include_fp->section = section;
+
+							if (cache) {
+								include_fp->cache = cache;
+								cache->addSource(tmp, include_fp->filenames);
+							}
+						}
+						else if (cache) {
+							// a missing INCLUDE file is recorded too, so that the cache is rebuilt once it is added
+							cache->addSource(tmp, mods->list(Filesystem::convertSlashes(tmp), ModManager::LIST_FULL_PATHS));
 						}
 					}
 					else {
@@ -195,23 +309,44 @@ bool FileParser::next() {
 			}
 
 			// this is a keypair. Perform basic parsing and return
-			Parse::getKeyPair(line, key, val);
+			// key and val are assigned in place, so they reuse their existing storage
+			const char* separator = static_cast<const char*>(memchr(line, '=', line_length));
+			if (separator) {
+				const char* key_start = line;
+				size_t key_length = static_cast<size_t>(separator - line);
+				const char* val_start = separator + 1;
+				size_t val_length = line_length - key_length - 1;
+
+				trimView(key_start, key_length);
+				trimView(val_start, val_length);
+				key.assign(key_start, key_length);
+				val.assign(val_start, val_length);
+			}
+			else {
+				key.clear();
+				val.clear();
+			}
+			addCacheRecord();
 			return true;
 		}
 
-		infile.close();
-		infile.clear();
+		// this file has been parsed, so its contents are no longer needed
+		std::string().swap(buffers[current_index].contents);
+		buffers[current_index].data = NULL;
+		buffers[current_index].size = 0;
 
 		current_index++;
-		if (current_index == filenames.size()) return false;
+		if (current_index == filenames.size()) {
+			if (cache_owner)
+				cache->save();
+			return false;
+		}
 
 		line_number = 0;
-		const std::string current_filename = filenames[current_index];
-		infile.open(current_filename.c_str(), std::ios::in);
-		if (!infile.is_open()) {
+		buffer_pos = 0;
+		if (!loadFile(current_index)) {
 			if (error_mode != ERROR_NONE)
-				Utils::logError("FileParser: Could not open text file: %s", current_filename.c_str());
-			infile.clear();
+				Utils::logError("FileParser: Could not open text file: %s", filenames[current_index].c_str());
 			return false;
 		}
 		// a new file starts a new section
@@ -226,12 +361,13 @@ bool FileParser::next() {
  * Get an unparsed, unfiltered line from the input file
  */
 std::string FileParser::getRawLine() {
-	line = "";
+	const char* line = NULL;
+	size_t line_length = 0;
 
-	if (infile.good()) {
-		line = Parse::getLine(infile);
-	}
-	return line;
+	if (readLine(line, line_length))
+		return std::string(line, line_length);
+
+	return "";
 }
 
 void FileParser::error(const char* format, ...) {
@@ -246,16 +382,41 @@ void FileParser::error(const char* format, ...) {
 }
 
 void FileParser::errorBuf(const char* buffer) {
+	std::string filename;
+	unsigned line;
+	getPosition(filename, line);
+
+	std::stringstream ss;
+	ss << "[" << filename << ":" << line << "] " << buffer;
+	Utils::logError(ss.str().c_str());
+}
+
+/**
+ * Get the file and line of the current key pair
+ */
+void FileParser::getPosition(std::string& filename, unsigned& line) {
 	if (include_fp) {
-		include_fp->errorBuf(buffer);
+		include_fp->getPosition(filename, line);
+	}
+	else if (cache && cache->isLoaded()) {
+		cache->getPosition(filename, line);
 	}
 	else {
-		std::stringstream ss;
-		ss << "[" << filenames[current_index] << ":" << line_number << "] " << buffer;
-		Utils::logError(ss.str().c_str());
+		filename = filenames[current_index];
+		line = line_number;
 	}
 }
 
+void FileParser::addCacheRecord() {
+	if (!cache_owner)
+		return;
+
+	std::string filename;
+	unsigned line;
+	getPosition(filename, line);
+	cache->addRecord(new_section, section, key, val, filename, line);
+}
+
 void FileParser::incrementLineNum() {
 	line_number++;
 }
@@ -27,9 +27,15 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include "CommonIncludes.h"
 
+class FileParserCache;
+
 class FileParser {
 private:
 	void errorBuf(const char* buffer);
+	bool loadFile(size_t index);
+	bool readLine(const char*& line_start, size_t& line_length);
+	void getPosition(std::string& filename, unsigned& line);
+	void addCacheRecord();
 
 	std::vector<std::string> filenames;
 	unsigned current_index;
@@ -37,19 +43,38 @@ private:
 	int error_mode;
 	std::string requested_filename;
 
-	std::ifstream infile;
-	std::string line;
+	class FileBuffer {
+	public:
+		FileBuffer();
+
+		// only used for files read from disk; files in a mod archive are parsed from the archive itself
+		std::string contents;
+		const char* data;
+		size_t size;
+		bool is_loaded;
+	};
+
+	// the contents of each file are read once and parsed in place
+	// buffers are indexed the same as filenames, and are released once they're parsed
+	std::vector<FileBuffer> buffers;
+	size_t buffer_pos;
 
 	unsigned line_number;
 
 	FileParser* include_fp;
 
+	// only the FileParser that opened the cache adds records to it
+	// INCLUDE parsers share it, so that their files are added as sources
+	FileParserCache* cache;
+	bool cache_owner;
+
 public:
 	enum {
 		ERROR_NONE = 0,
 		ERROR_NORMAL = 1
 	};
 	static const bool MOD_FILE = true;
+	static const bool USE_CACHE = true;
 
 	FileParser();
 	~FileParser();
@@ -67,9 +92,14 @@ public:
 	 * NO_ERROR - when enabled, suppresses the error message when a file can't
 	 * be opened
 	 *
+	 * @param use_cache
+	 * Optional, mod files only. Reads the key/value pairs from a FileParserCache
+	 * when it is still valid, and saves one after the text has been fully parsed.
+	 * getRawLine() can't be used with a cache.
+	 *
 	 * @return true if file could be opened successfully for reading.
 	 */
-	bool open(const std::string& filename, bool _is_mod_file, int _error_mode);
+	bool open(const std::string& filename, bool _is_mod_file, int _error_mode, bool use_cache = false);
 
 	void close();
 	bool next();
@@ -0,0 +1,351 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+
+#include "FileParserCache.h"
+#include "ModManager.h"
+#include "Settings.h"
+#include "SharedResources.h"
+#include "Utils.h"
+#include "UtilsFileSystem.h"
+
+#include <string.h>
+
+namespace {
+
+const char MAGIC[] = "FLAREPARSERCACHE";
+const size_t MAGIC_LENGTH = sizeof(MAGIC) - 1;
+
+enum {
+	RECORD_NEW_SECTION = 1,
+	RECORD_SECTION_CHANGED = 2
+};
+
+template <typename T>
+void writeValue(std::string& buffer, T value) {
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeString(std::string& buffer, const std::string& s) {
+	writeValue(buffer, static_cast<uint32_t>(s.size()));
+	buffer.append(s);
+}
+
+template <typename T>
+bool readValue(const std::string& buffer, size_t& pos, T& value) {
+	if (buffer.size() - pos < sizeof(T))
+		return false;
+
+	memcpy(&value, buffer.data() + pos, sizeof(T));
+	pos += sizeof(T);
+	return true;
+}
+
+bool readString(const std::string& buffer, size_t& pos, std::string& s) {
+	uint32_t length;
+	if (!readValue(buffer, pos, length) || buffer.size() - pos < length)
+		return false;
+
+	s.assign(buffer, pos, length);
+	pos += length;
+	return true;
+}
+
+} // namespace
+
+FileParserCache::FileParserCache(const std::string& _requested_filename)
+	: requested_filename(_requested_filename)
+	, loaded(false)
+	, buffer_pos(0)
+	, records_left(0)
+	, record_file(0)
+	, record_line(0)
+	, record_count(0)
+{
+	cache_filename = Filesystem::convertSlashes(_requested_filename);
+	for (size_t i = 0; i < cache_filename.size(); ++i) {
+		if (cache_filename[i] == '/' || cache_filename[i] == '\\' || cache_filename[i] == ':')
+			cache_filename[i] = '_';
+	}
+	cache_filename = settings->path_user + "cache/" + cache_filename + ".bin";
+}
+
+FileParserCache::~FileParserCache() {
+}
+
+/**
+ * Reads the cache file and checks that it was built from the given files
+ * The first source is always the requested file, so its file list is passed in by FileParser::open() rather than resolved again.
+ *
+ * @return true if the cached records can be used in place of the text files
+ */
+bool FileParserCache::load(const std::vector<std::string>& filenames) {
+	loaded = false;
+
+	if (!Filesystem::readFile(cache_filename, buffer))
+		return false;
+
+	buffer_pos = 0;
+	bool valid = readHeader() && !sources.empty() && sources[0].filename == requested_filename && checkSource(sources[0].filename, filenames);
+	for (size_t i = 1; valid && i < sources.size(); ++i) {
+		valid = checkSource(sources[i].filename, mods->list(Filesystem::convertSlashes(sources[i].filename), ModManager::LIST_FULL_PATHS));
+	}
+
+	if (!valid) {
+		std::string().swap(buffer);
+		sources.clear();
+		files.clear();
+		return false;
+	}
+
+	// the source list is only needed for the check above
+	sources.clear();
+
+	loaded = true;
+	return true;
+}
+
+/**
+ * Reads the source list and the file table, and checks that every record is complete
+ * buffer_pos is left at the first record
+ */
+bool FileParserCache::readHeader() {
+	if (buffer.compare(0, MAGIC_LENGTH, MAGIC) != 0)
+		return false;
+	buffer_pos = MAGIC_LENGTH;
+
+	uint32_t version;
+	if (!readValue(buffer, buffer_pos, version) || version != VERSION)
+		return false;
+
+	uint32_t source_count;
+	if (!readValue(buffer, buffer_pos, source_count))
+		return false;
+
+	sources.clear();
+	for (uint32_t i = 0; i < source_count; ++i) {
+		Source source;
+		uint32_t file_count;
+		if (!readString(buffer, buffer_pos, source.filename) || !readValue(buffer, buffer_pos, file_count))
+			return false;
+
+		for (uint32_t j = 0; j < file_count; ++j) {
+			SourceFile file;
+			if (!readString(buffer, buffer_pos, file.path) || !readValue(buffer, buffer_pos, file.size) || !readValue(buffer, buffer_pos, file.mtime))
+				return false;
+			source.files.push_back(file);
+		}
+		sources.push_back(source);
+	}
+
+	uint32_t file_count;
+	if (!readValue(buffer, buffer_pos, file_count))
+		return false;
+
+	files.clear();
+	for (uint32_t i = 0; i < file_count; ++i) {
+		files.push_back("");
+		if (!readString(buffer, buffer_pos, files.back()))
+			return false;
+	}
+
+	if (!readValue(buffer, buffer_pos, records_left))
+		return false;
+
+	// walk the records once, so that a damaged cache is rejected here instead of part way through parsing
+	size_t records_start = buffer_pos;
+	std::string tmp;
+	for (uint32_t i = 0; i < records_left; ++i) {
+		uint8_t flags;
+		uint32_t file;
+		uint32_t line;
+		if (!readValue(buffer, buffer_pos, flags) || !readValue(buffer, buffer_pos, file) || !readValue(buffer, buffer_pos, line) || file >= files.size())
+			return false;
+		if ((flags & RECORD_SECTION_CHANGED) && !readString(buffer, buffer_pos, tmp))
+			return false;
+		if (!readString(buffer, buffer_pos, tmp) || !readString(buffer, buffer_pos, tmp))
+			return false;
+	}
+	if (buffer_pos != buffer.size())
+		return false;
+
+	buffer_pos = records_start;
+	record_section.clear();
+	return true;
+}
+
+/**
+ * Compares the stored files of a source with the files that it resolves to now
+ */
+bool FileParserCache::checkSource(const std::string& source_filename, const std::vector<std::string>& filenames) {
+	const Source* source = NULL;
+	for (size_t i = 0; i < sources.size(); ++i) {
+		if (sources[i].filename == source_filename) {
+			source = &sources[i];
+			break;
+		}
+	}
+
+	if (!source || source->files.size() != filenames.size())
+		return false;
+
+	for (size_t i = 0; i < filenames.size(); ++i) {
+		const SourceFile& file = source->files[i];
+		uint64_t size;
+		int64_t mtime;
+		if (file.path != filenames[i] || !mods->getFileInfo(filenames[i], size, mtime) || file.size != size || file.mtime != mtime)
+			return false;
+	}
+
+	return true;
+}
+
+bool FileParserCache::isLoaded() {
+	return loaded;
+}
+
+/**
+ * Reads the next cached key/value pair
+ *
+ * @return false if there are no records left
+ */
+bool FileParserCache::nextRecord(bool& new_section, std::string& section, std::string& key, std::string& val) {
+	if (!loaded || records_left == 0)
+		return false;
+
+	// records were checked in readHeader(), so these reads can't fail
+	uint8_t flags = 0;
+	readValue(buffer, buffer_pos, flags);
+	readValue(buffer, buffer_pos, record_file);
+	readValue(buffer, buffer_pos, record_line);
+	if (flags & RECORD_SECTION_CHANGED)
+		readString(buffer, buffer_pos, record_section);
+	readString(buffer, buffer_pos, key);
+	readString(buffer, buffer_pos, val);
+
+	new_section = (flags & RECORD_NEW_SECTION) != 0;
+	section = record_section;
+
+	records_left--;
+	return true;
+}
+
+/**
+ * Gets the file and line that the current record was read from, for error messages
+ */
+void FileParserCache::getPosition(std::string& filename, unsigned& line) {
+	filename = (record_file < files.size()) ? files[record_file] : requested_filename;
+	line = record_line;
+}
+
+/**
+ * Adds a source to the cache being built. This is called for the requested file and for each INCLUDE file.
+ */
+void FileParserCache::addSource(const std::string& source_filename, const std::vector<std::string>& filenames) {
+	for (size_t i = 0; i < sources.size(); ++i) {
+		if (sources[i].filename == source_filename)
+			return;
+	}
+
+	Source source;
+	source.filename = source_filename;
+	for (size_t i = 0; i < filenames.size(); ++i) {
+		SourceFile file;
+		file.path = filenames[i];
+		file.size = 0;
+		file.mtime = 0;
+		// a missing file is stored as empty, so that the cache is rebuilt once it exists
+		mods->getFileInfo(filenames[i], file.size, file.mtime);
+		source.files.push_back(file);
+	}
+	sources.push_back(source);
+}
+
+uint32_t FileParserCache::getFileIndex(const std::string& filename) {
+	for (size_t i = files.size(); i > 0; --i) {
+		if (files[i-1] == filename)
+			return static_cast<uint32_t>(i-1);
+	}
+
+	files.push_back(filename);
+	return static_cast<uint32_t>(files.size() - 1);
+}
+
+void FileParserCache::addRecord(bool new_section, const std::string& section, const std::string& key, const std::string& val, const std::string& filename, unsigned line) {
+	uint8_t flags = 0;
+	if (new_section)
+		flags |= RECORD_NEW_SECTION;
+	if (record_count == 0 || section != last_section)
+		flags |= RECORD_SECTION_CHANGED;
+
+	writeValue(records, flags);
+	writeValue(records, getFileIndex(filename));
+	writeValue(records, static_cast<uint32_t>(line));
+	if (flags & RECORD_SECTION_CHANGED) {
+		writeString(records, section);
+		last_section = section;
+	}
+	writeString(records, key);
+	writeString(records, val);
+
+	record_count++;
+}
+
+/**
+ * Writes the sources and records that were added while parsing the text files
+ */
+void FileParserCache::save() {
+	std::string out;
+	out.reserve(records.size() + 1024);
+
+	out.append(MAGIC, MAGIC_LENGTH);
+	writeValue(out, VERSION);
+
+	writeValue(out, static_cast<uint32_t>(sources.size()));
+	for (size_t i = 0; i < sources.size(); ++i) {
+		writeString(out, sources[i].filename);
+		writeValue(out, static_cast<uint32_t>(sources[i].files.size()));
+		for (size_t j = 0; j < sources[i].files.size(); ++j) {
+			writeString(out, sources[i].files[j].path);
+			writeValue(out, sources[i].files[j].size);
+			writeValue(out, sources[i].files[j].mtime);
+		}
+	}
+
+	writeValue(out, static_cast<uint32_t>(files.size()));
+	for (size_t i = 0; i < files.size(); ++i) {
+		writeString(out, files[i]);
+	}
+
+	writeValue(out, record_count);
+	out.append(records);
+
+	Filesystem::createDir(settings->path_user + "cache/");
+
+	std::ofstream outfile(cache_filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!outfile.is_open()) {
+		Utils::logError("FileParserCache: Could not write cache file: %s", cache_filename.c_str());
+		return;
+	}
+
+	outfile.write(out.data(), static_cast<std::streamsize>(out.size()));
+	if (outfile.fail())
+		Utils::logError("FileParserCache: Could not write cache file: %s", cache_filename.c_str());
+	outfile.close();
+
+	std::string().swap(records);
+}
@@ -0,0 +1,94 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+
+/**
+ * class FileParserCache
+ *
+ * A binary copy of the key/value pairs that a FileParser read from a set of mod files.
+ *
+ * The cache is stored in PATH_USER/cache/, one file per requested filename. It records every source file that the
+ * stream was built from, including INCLUDE files, along with their sizes and modification times. load() fails if
+ * the files that ModManager resolves for each source differ in any way, and the FileParser then parses the text
+ * and saves a new cache.
+ *
+ * Values are stored in native byte order, since the cache never leaves the machine it was built on.
+ */
+
+#ifndef FILE_PARSER_CACHE_H
+#define FILE_PARSER_CACHE_H
+
+#include "CommonIncludes.h"
+
+#include <stdint.h>
+
+class FileParserCache {
+private:
+	class SourceFile {
+	public:
+		std::string path;
+		uint64_t size;
+		int64_t mtime;
+	};
+
+	class Source {
+	public:
+		std::string filename;
+		std::vector<SourceFile> files;
+	};
+
+	bool readHeader();
+	bool checkSource(const std::string& source_filename, const std::vector<std::string>& filenames);
+	uint32_t getFileIndex(const std::string& filename);
+
+	std::string requested_filename;
+	std::string cache_filename;
+
+	std::vector<Source> sources;
+	std::vector<std::string> files;
+
+	// reading
+	bool loaded;
+	std::string buffer;
+	size_t buffer_pos;
+	uint32_t records_left;
+	std::string record_section;
+	uint32_t record_file;
+	uint32_t record_line;
+
+	// writing
+	std::string records;
+	uint32_t record_count;
+	std::string last_section;
+
+public:
+	static const uint32_t VERSION = 1;
+
+	FileParserCache(const std::string& _requested_filename);
+	~FileParserCache();
+
+	bool load(const std::vector<std::string>& filenames);
+	bool isLoaded();
+	bool nextRecord(bool& new_section, std::string& section, std::string& key, std::string& val);
+	void getPosition(std::string& filename, unsigned& line);
+
+	void addSource(const std::string& source_filename, const std::vector<std::string>& filenames);
+	void addRecord(bool new_section, const std::string& section, const std::string& key, const std::string& val, const std::string& filename, unsigned line);
+	void save();
+};
+
+#endif
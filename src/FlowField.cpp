@@ -0,0 +1,226 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "FlowField.h"
+#include "MapCollision.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+	const int FLOW_NEIGHBOURS[8][2] = {
+		{-1, 0}, {0, -1}, {1, 0}, {0, 1},
+		{-1, -1}, {1, -1}, {-1, 1}, {1, 1}
+	};
+}
+
+FlowField::FlowField()
+	: collider(NULL)
+	, movement_type(0)
+	, range(0)
+	, diagonal_step_cost(0)
+	, front(0)
+	, has_front(false)
+	, building(false)
+{
+	generation[0] = generation[1] = 0;
+}
+
+FlowField::~FlowField() {
+}
+
+/**
+ * Prepares the field for the current map. A range of 0 disables the field
+ */
+void FlowField::init(MapCollision* _collider, int _movement_type, int _range) {
+	collider = _collider;
+	movement_type = _movement_type;
+	range = std::max(_range, 0);
+	diagonal_step_cost = Utils::calcDist(FPoint(0,0), FPoint(1,1));
+
+	has_front = false;
+	building = false;
+	queue.clear();
+
+	size_t tile_count = (range > 0) ? static_cast<size_t>(collider->map_size.x * collider->map_size.y) : 0;
+	for (int i = 0; i < 2; ++i) {
+		dist[i].resize(tile_count);
+		dist_gen[i].assign(tile_count, 0);
+		generation[i] = 0;
+	}
+}
+
+/**
+ * Starts building a new field toward the target in the back buffer
+ */
+void FlowField::startBuild(const Point& target) {
+	int back = 1 - front;
+
+	generation[back]++;
+	if (generation[back] == 0) {
+		dist_gen[back].assign(dist_gen[back].size(), 0);
+		generation[back] = 1;
+	}
+
+	back_target = target;
+	building = true;
+	queue.clear();
+
+	int index = target.y * collider->map_size.x + target.x;
+	dist[back][index] = 0;
+	dist_gen[back][index] = generation[back];
+	queue.push_back(std::pair<float, int>(0, index));
+}
+
+/**
+ * Continues the Dijkstra search in the back buffer, settling at most 'budget' tiles
+ */
+void FlowField::expand(unsigned budget) {
+	int back = 1 - front;
+	const int map_w = collider->map_size.x;
+	const int map_h = collider->map_size.y;
+	const float max_dist = static_cast<float>(range);
+
+	while (!queue.empty() && budget > 0) {
+		std::pop_heap(queue.begin(), queue.end(), std::greater< std::pair<float, int> >());
+		std::pair<float, int> top = queue.back();
+		queue.pop_back();
+
+		// skip stale entries that were improved after they were queued
+		if (top.first > dist[back][top.second])
+			continue;
+
+		budget--;
+
+		int x = top.second % map_w;
+		int y = top.second / map_w;
+
+		for (int i = 0; i < 8; ++i) {
+			int nx = x + FLOW_NEIGHBOURS[i][0];
+			int ny = y + FLOW_NEIGHBOURS[i][1];
+
+			if (nx < 0 || ny < 0 || nx >= map_w || ny >= map_h)
+				continue;
+			if (!collider->isValidStaticTile(nx, ny, movement_type))
+				continue;
+
+			float next_dist = top.first + ((i < 4) ? 1.f : diagonal_step_cost);
+			if (next_dist > max_dist)
+				continue;
+
+			int index = ny * map_w + nx;
+			if (dist_gen[back][index] == generation[back] && dist[back][index] <= next_dist)
+				continue;
+
+			dist[back][index] = next_dist;
+			dist_gen[back][index] = generation[back];
+			queue.push_back(std::pair<float, int>(next_dist, index));
+			std::push_heap(queue.begin(), queue.end(), std::greater< std::pair<float, int> >());
+		}
+	}
+
+	if (queue.empty()) {
+		// the new field is complete, so start using it
+		front = back;
+		front_target = back_target;
+		has_front = true;
+		building = false;
+	}
+}
+
+/**
+ * Called once per frame with the target's tile. Settles up to 'budget' tiles of the field being built
+ */
+void FlowField::update(const Point& target, unsigned budget) {
+	if (!isEnabled() || !collider)
+		return;
+
+	if (target.x < 0 || target.y < 0 || target.x >= collider->map_size.x || target.y >= collider->map_size.y)
+		return;
+
+	// a build in progress is finished even if the target has moved since it started
+	// restarting it instead would mean a field that takes several frames is never completed while the target keeps moving
+	if (!building) {
+		if (has_front && target.x == front_target.x && target.y == front_target.y)
+			return;
+
+		startBuild(target);
+	}
+
+	expand(budget);
+}
+
+/**
+ * The collision map changed, so the field needs to be rebuilt
+ * The current field is kept in use until the new one is complete
+ */
+void FlowField::invalidate() {
+	if (building)
+		startBuild(back_target);
+	else if (has_front)
+		startBuild(front_target);
+}
+
+/**
+ * Gets the walking distance from a tile to the target
+ * @return false if the tile was not reached by the field
+ */
+bool FlowField::getDistance(const Point& tile, float& distance) const {
+	if (!has_front)
+		return false;
+
+	if (tile.x < 0 || tile.y < 0 || tile.x >= collider->map_size.x || tile.y >= collider->map_size.y)
+		return false;
+
+	int index = tile.y * collider->map_size.x + tile.x;
+	if (dist_gen[front][index] != generation[front])
+		return false;
+
+	distance = dist[front][index];
+	return true;
+}
+
+/**
+ * Finds the neighbouring tile that is closest to the target
+ * Tiles that are currently blocked by entities are skipped, except for the target tile itself
+ * @return false if the tile is not in the field or no neighbour gets closer to the target
+ */
+bool FlowField::getNextTile(const Point& tile, Point& next, int collide_type) const {
+	float best_dist;
+	if (!getDistance(tile, best_dist))
+		return false;
+
+	bool found = false;
+
+	for (int i = 0; i < 8; ++i) {
+		Point neighbour(tile.x + FLOW_NEIGHBOURS[i][0], tile.y + FLOW_NEIGHBOURS[i][1]);
+
+		float neighbour_dist;
+		if (!getDistance(neighbour, neighbour_dist) || neighbour_dist >= best_dist)
+			continue;
+
+		bool is_target = (neighbour.x == front_target.x && neighbour.y == front_target.y);
+		if (!is_target && !collider->isValidPosition(static_cast<float>(neighbour.x) + 0.5f, static_cast<float>(neighbour.y) + 0.5f, movement_type, collide_type))
+			continue;
+
+		best_dist = neighbour_dist;
+		next = neighbour;
+		found = true;
+	}
+
+	return found;
+}
@@ -0,0 +1,80 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class FlowField
+ *
+ * Distance field toward a single target tile (the hero), shared by every entity that is chasing it.
+ *
+ * Instead of each entity running its own A* search, the field stores the walking distance from every tile
+ * within range to the target. An entity follows the field by stepping to the neighbouring tile with the
+ * smallest distance.
+ *
+ * The field is double-buffered. When the target moves to a new tile, a new field is built in the back buffer
+ * over several frames, a limited number of tiles at a time. Until it is complete, the previous field stays in use.
+ * If the target moves again during a build, that build is still finished first, and the next one starts from the
+ * target's tile at that point.
+ *
+ * Tiles occupied by entities are treated as walkable here. They are avoided when choosing the next step.
+ */
+
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include "CommonIncludes.h"
+#include "Utils.h"
+
+class MapCollision;
+
+class FlowField {
+private:
+	void startBuild(const Point& target);
+	void expand(unsigned budget);
+
+	MapCollision* collider;
+	int movement_type;
+	int range;
+	float diagonal_step_cost;
+
+	// the field in use and the one being built. Tiles that were not reached have a stale generation stamp
+	std::vector<float> dist[2];
+	std::vector<unsigned> dist_gen[2];
+	unsigned generation[2];
+	int front;
+
+	Point front_target;
+	Point back_target;
+	bool has_front;
+	bool building;
+
+	std::vector< std::pair<float, int> > queue;
+
+public:
+	FlowField();
+	~FlowField();
+
+	void init(MapCollision* _collider, int _movement_type, int _range);
+	void update(const Point& target, unsigned budget);
+	void invalidate();
+
+	bool isEnabled() { return range > 0; }
+	bool isReady() { return has_front; }
+	bool getDistance(const Point& tile, float& distance) const;
+	bool getNextTile(const Point& tile, Point& next, int collide_type) const;
+};
+
+#endif
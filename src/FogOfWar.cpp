@@ -55,6 +55,9 @@ FogOfWar::FogOfWar()
 	, color_dark(0,0,0)
 	, update_minimap(true)
 	, loaded(false)
+	, occlusion_radius(0)
+	, occlusion_w(0)
+	, occlusion_h(0)
 	, prev_hero_pos(-1, -1) {
 }
 
@@ -193,19 +196,19 @@ void FogOfWar::logic() {
 void FogOfWar::handleIntramapTeleport() {
 	calcBoundaries();
 
-	for (int x = bounds.x; x <= bounds.w; x++) {
-		for (int y = bounds.y; y <= bounds.h; y++) {
+	for (int y = bounds.y; y <= bounds.h; y++) {
+		for (int x = bounds.x; x <= bounds.w; x++) {
 			if (x>=0 && y>=0 && x < mapr->w && y < mapr->h) {
-				mapr->layers[fog_layer_id][x][y] = TILE_HIDDEN;
+				mapr->layers[fog_layer_id](x, y) = TILE_HIDDEN;
 			}
 		}
 	}
 }
 
 Color FogOfWar::getTileColorMod(const int_fast16_t x, const int_fast16_t y) {
-	if (mapr->layers[dark_layer_id][x][y] == 0 && mapr->layers[fog_layer_id][x][y] > 0)
+	if (mapr->layers[dark_layer_id](x, y) == 0 && mapr->layers[fog_layer_id](x, y) > 0)
 		return color_fog;
-	else if (mapr->layers[dark_layer_id][x][y] > 0)
+	else if (mapr->layers[dark_layer_id](x, y) > 0)
 		return color_dark;
 	else
 		return color_sight;
@@ -237,16 +240,21 @@ void FogOfWar::updateTiles() {
 	calcBoundaries();
 	const unsigned short * mask = &def_mask[0];
 
-	for (int x = bounds.x; x <= bounds.w; x++) {
-		for (int y = bounds.y; y <= bounds.h; y++) {
+	for (int y = bounds.y; y <= bounds.h; y++) {
+		for (int x = bounds.x; x <= bounds.w; x++) {
 			if (x>=0 && y>=0 && x < mapr->w && y < mapr->h) {
-				unsigned short prev_dark_tile = mapr->layers[dark_layer_id][x][y];
+				unsigned short prev_dark_tile = mapr->layers[dark_layer_id](x, y);
 
-				mapr->layers[dark_layer_id][x][y] &= *mask;
-				mapr->layers[fog_layer_id][x][y] = *mask;
+				mapr->layers[dark_layer_id](x, y) &= *mask;
+				mapr->layers[fog_layer_id](x, y) = *mask;
 
-				if (prev_dark_tile != mapr->layers[dark_layer_id][x][y]) {
+				if (prev_dark_tile != mapr->layers[dark_layer_id](x, y)) {
 					update_minimap = true;
+					mapr->invalidateLayerCache(x, y);
+
+					// dark tiles are only ever revealed here, so tiles can only lose their occlusion bit
+					if (prev_dark_tile == TILE_HIDDEN)
+						clearOcclusion(x, y);
 				}
 			}
 			mask++;
@@ -254,6 +262,147 @@ void FogOfWar::updateTiles() {
 	}
 }
 
+/**
+ * Returns how far, in tiles, the corners of any tile in the tileset can be from the tile's own position
+ */
+int FogOfWar::getOcclusionRadius(const TileSet& tile_set) {
+	const FPoint origin = Utils::screenToMap(0, 0, 0, 0);
+	float max_dist = 0;
+
+	for (size_t i = 0; i < tile_set.tiles.size(); ++i) {
+		const Tile_Def& tile = tile_set.tiles[i];
+		if (!tile.tile)
+			continue;
+
+		const Rect clip = tile.tile->getClip();
+		for (int k = 0; k < 4; ++k) {
+			const int corner_x = -tile.offset.x + ((k & 1) ? clip.w : 0);
+			const int corner_y = -tile.offset.y + ((k & 2) ? clip.h : 0);
+			const FPoint p = Utils::screenToMap(corner_x, corner_y, 0, 0);
+
+			max_dist = std::max(max_dist, std::max(fabsf(p.x - origin.x), fabsf(p.y - origin.y)));
+		}
+	}
+
+	// the margin covers the offset to the tile center and rounding to whole pixels
+	return static_cast<int>(ceilf(max_dist)) + 2;
+}
+
+/**
+ * Builds the occlusion mask for the whole map. With it, the renderers can skip most tiles under the dark layer
+ * without converting each tile's corners back to map positions. tile_set is the tileset of the map's other layers
+ */
+void FogOfWar::calcOcclusion(const TileSet& tile_set) {
+	occluded.clear();
+	occlusion_w = mapr->w;
+	occlusion_h = mapr->h;
+
+	if (mapr->fogofwar != TYPE_OVERLAY || dark_layer_id >= mapr->layers.size() || occlusion_w <= 0 || occlusion_h <= 0)
+		return;
+
+	occlusion_radius = std::max(getOcclusionRadius(tile_set), getOcclusionRadius(tset_fog));
+	if (occlusion_radius > OCCLUSION_RADIUS_MAX) {
+		Utils::logInfo("FogOfWar: Tiles are too large for the occlusion mask. Hidden tiles will be checked one by one.");
+		return;
+	}
+
+	const Map_Layer& dark_layer = mapr->layers[dark_layer_id];
+	const size_t w = static_cast<size_t>(occlusion_w);
+	const size_t h = static_cast<size_t>(occlusion_h);
+	const size_t radius = static_cast<size_t>(occlusion_radius);
+
+	// first pass: whether all tiles within the radius on the same row are hidden
+	// second pass: the same for the columns of the first pass, which covers the whole square
+	std::vector<bool> row_hidden(w * h);
+	std::vector<size_t> visible_count(std::max(w, h) + 1);
+
+	for (size_t y = 0; y < h; ++y) {
+		for (size_t x = 0; x < w; ++x)
+			visible_count[x + 1] = visible_count[x] + (dark_layer(x, y) != TILE_HIDDEN ? 1 : 0);
+
+		for (size_t x = 0; x < w; ++x) {
+			const size_t x0 = (x > radius) ? x - radius : 0;
+			const size_t x1 = std::min(x + radius + 1, w);
+			row_hidden[y * w + x] = (visible_count[x1] == visible_count[x0]);
+		}
+	}
+
+	occluded.resize(w * h);
+	for (size_t x = 0; x < w; ++x) {
+		for (size_t y = 0; y < h; ++y)
+			visible_count[y + 1] = visible_count[y] + (row_hidden[y * w + x] ? 0 : 1);
+
+		for (size_t y = 0; y < h; ++y) {
+			const size_t y0 = (y > radius) ? y - radius : 0;
+			const size_t y1 = std::min(y + radius + 1, h);
+			occluded[y * w + x] = (visible_count[y1] == visible_count[y0]);
+		}
+	}
+}
+
+/**
+ * Returns true if all dark layer tiles within the occlusion radius of (x, y) are hidden
+ */
+bool FogOfWar::checkOcclusion(int x, int y) {
+	const Map_Layer& dark_layer = mapr->layers[dark_layer_id];
+	const int x0 = std::max(x - occlusion_radius, 0);
+	const int y0 = std::max(y - occlusion_radius, 0);
+	const int x1 = std::min(x + occlusion_radius, occlusion_w - 1);
+	const int y1 = std::min(y + occlusion_radius, occlusion_h - 1);
+
+	for (int j = y0; j <= y1; ++j) {
+		for (int i = x0; i <= x1; ++i) {
+			if (dark_layer(i, j) != TILE_HIDDEN)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Clears the occlusion bit of every tile that could cover the dark layer tile at (x, y)
+ */
+void FogOfWar::clearOcclusion(int x, int y) {
+	if (occluded.empty())
+		return;
+
+	const int x0 = std::max(x - occlusion_radius, 0);
+	const int y0 = std::max(y - occlusion_radius, 0);
+	const int x1 = std::min(x + occlusion_radius, occlusion_w - 1);
+	const int y1 = std::min(y + occlusion_radius, occlusion_h - 1);
+
+	for (int j = y0; j <= y1; ++j) {
+		for (int i = x0; i <= x1; ++i) {
+			occluded[static_cast<size_t>(j * occlusion_w + i)] = false;
+		}
+	}
+}
+
+/**
+ * Updates the occlusion mask after the dark layer tile at (x, y) was changed by something other than updateTiles()
+ */
+void FogOfWar::updateOcclusion(int x, int y) {
+	if (occluded.empty())
+		return;
+
+	if (mapr->layers[dark_layer_id](x, y) != TILE_HIDDEN) {
+		clearOcclusion(x, y);
+		return;
+	}
+
+	const int x0 = std::max(x - occlusion_radius, 0);
+	const int y0 = std::max(y - occlusion_radius, 0);
+	const int x1 = std::min(x + occlusion_radius, occlusion_w - 1);
+	const int y1 = std::min(y + occlusion_radius, occlusion_h - 1);
+
+	for (int j = y0; j <= y1; ++j) {
+		for (int i = x0; i <= x1; ++i) {
+			occluded[static_cast<size_t>(j * occlusion_w + i)] = checkOcclusion(i, j);
+		}
+	}
+}
+
 void FogOfWar::loadHeader(FileParser &infile) {
 	if (infile.key == "radius") {
 		// @ATTR header.radius|int|Fog of war mask radius, also how far the player can see.
@@ -350,11 +499,11 @@ void FogOfWar::loadDefMask(FileParser &infile) {
 		if (def_tiles.empty())
 			return;
 
-		def_mask = new short unsigned[(mask_radius*2+1) * (mask_radius*2+1)];
+		const int mask_size = mask_radius*2+1;
+		def_mask = new short unsigned[mask_size * mask_size]();
 		std::string val;
 		std::string tile_def;
 		std::map<std::string, int>::iterator it;
-		int k = 0;
 
 		for (int j=0; j<mask_radius*2+1; j++) {
 			val = infile.getRawLine();
@@ -380,7 +529,8 @@ void FogOfWar::loadDefMask(FileParser &infile) {
 				tile_def = Parse::popFirstString(val, ',');
 				it = def_tiles.find(tile_def);
 				if (it != def_tiles.end()) {
-					def_mask[k++] = static_cast<unsigned short>(it->second);
+					// each row of the definition is one column of tiles, but the mask is stored in map order (row-major)
+					def_mask[i * mask_size + j] = static_cast<unsigned short>(it->second);
 				}
 				else
 					infile.error("FogOfWar: Tile definition '%s' not found.", tile_def.c_str());
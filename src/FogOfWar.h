@@ -57,6 +57,14 @@ public:
 	int load();
 	Color getTileColorMod(const int_fast16_t x, const int_fast16_t y);
 
+	void calcOcclusion(const TileSet& tile_set);
+	void updateOcclusion(int x, int y);
+
+	// true if every dark layer tile that a tile drawn at (x, y) could cover is hidden
+	bool isOccluded(const int_fast16_t x, const int_fast16_t y) const {
+		return !occluded.empty() && occluded[static_cast<size_t>(y * occlusion_w + x)];
+	}
+
 	FogOfWar();
 	~FogOfWar();
 
@@ -84,6 +92,19 @@ private:
 	void calcMiniBoundaries();
 	void updateTiles();
 
+	// larger tiles are always checked corner by corner
+	static const int OCCLUSION_RADIUS_MAX = 16;
+
+	int getOcclusionRadius(const TileSet& tile_set);
+	bool checkOcclusion(int x, int y);
+	void clearOcclusion(int x, int y);
+
+	// one bit per tile, set when all dark layer tiles within occlusion_radius are hidden
+	std::vector<bool> occluded;
+	int occlusion_radius;
+	int occlusion_w;
+	int occlusion_h;
+
 	FPoint prev_hero_pos;
 };
 
@@ -83,6 +83,13 @@ FontEngine::~FontEngine() {
 	Utils::logInfo("Cleaning up: FontEngine");
 }
 
+/**
+ * Drops every image the font engine keeps, e.g. when the render context that owns them is destroyed
+ */
+void FontEngine::clearImages() {
+	text_cache.clear();
+}
+
 Color FontEngine::getColor(size_t color_id) {
 	if (color_id < font_colors.size())
 		return font_colors[color_id];
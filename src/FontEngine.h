@@ -22,6 +22,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #define FONT_ENGINE_H
 
 #include "CommonIncludes.h"
+#include "TextCache.h"
 #include "Utils.h"
 
 class FontStyle {
@@ -96,6 +97,9 @@ public:
 	virtual Point calcSize(const std::string& text) = 0;
 	virtual std::string trimTextToWidth(const std::string& text, const int width, const bool use_ellipsis, size_t left_pos) = 0;
 
+	TextCache* getTextCache() { return &text_cache; }
+	virtual void clearImages();
+
 	int cursor_y;
 
 protected:
@@ -107,6 +111,9 @@ protected:
 
 	std::vector<Color> font_colors;
 
+	// rendered strings and their sizes
+	TextCache text_cache;
+
 private:
 	static const size_t BUILDER_RESERVE = 128;
 };
@@ -213,7 +213,7 @@ void GameSlotPreview::loadDefaultGraphics() {
 
 	// fall back to default if it exists
 	for (size_t i = 0; i < layer_reference_order.size(); ++i) {
-		bool exists = Filesystem::fileExists(mods->locate("animations/avatar/" + stats->gfx_base + "/default_" + layer_reference_order[i] + ".txt"));
+		bool exists = mods->fileExists("animations/avatar/" + stats->gfx_base + "/default_" + layer_reference_order[i] + ".txt");
 		if (exists) {
 			default_gfx.push_back("default_" + layer_reference_order[i]);
 		}
@@ -32,6 +32,7 @@ GameState::GameState()
 	, force_refresh_background(false)
 	, save_settings_on_exit(true)
 	, load_counter(0)
+	, render_alpha(1)
 	, requestedGameState(NULL)
 	, exitRequested(false)
 	, loading_tip(new WidgetTooltip())
@@ -54,6 +55,7 @@ GameState& GameState::operator=(const GameState& other) {
 	force_refresh_background = other.force_refresh_background;
 	save_settings_on_exit = other.save_settings_on_exit;
 	load_counter = other.load_counter;
+	render_alpha = other.render_alpha;
 	requestedGameState = other.requestedGameState;
 	exitRequested = other.exitRequested;
 	loading_tip = new WidgetTooltip();
@@ -53,6 +53,9 @@ public:
 
 	int load_counter;
 
+	// how far rendering is between the last two logic frames, from 0 to 1. Set by GameSwitcher::render()
+	float render_alpha;
+
 protected:
 	GameState* requestedGameState;
 	bool exitRequested;
@@ -80,6 +80,8 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include <cassert>
 
+uint64_t GameStatePlay::timings[GameStatePlay::TIMING_COUNT] = {0, 0, 0, 0, 0, 0, 0, 0};
+
 GameStatePlay::GameStatePlay()
 	: GameState()
 	, enemy(NULL)
@@ -850,11 +852,31 @@ void GameStatePlay::updateActionBar(unsigned index) {
 	}
 }
 
+void GameStatePlay::resetTimings() {
+	for (int i = 0; i < TIMING_COUNT; ++i) {
+		timings[i] = 0;
+	}
+}
+
+/**
+ * Adds the time since start_ticks to a subsystem, then moves start_ticks to now for the next one
+ */
+void GameStatePlay::addTiming(int subsystem, uint64_t& start_ticks) {
+	uint64_t now_ticks = SDL_GetPerformanceCounter();
+	timings[subsystem] += now_ticks - start_ticks;
+	start_ticks = now_ticks;
+}
+
 /**
  * Process all actions for a single frame
  * This includes some message passing between child object
  */
 void GameStatePlay::logic() {
+	if (settings->render_interpolation)
+		render_interpolation.saveState();
+	else
+		render_interpolation.clear();
+
 	if (inpt->window_resized)
 		refreshWidgets();
 
@@ -863,7 +885,9 @@ void GameStatePlay::logic() {
 	checkCutscene();
 
 	// check menus first (top layer gets mouse click priority)
+	uint64_t ticks = SDL_GetPerformanceCounter();
 	menu->logic();
+	addTiming(TIMING_MENU, ticks);
 
 	if (!isPaused()) {
 		if (!second_timer.isEnd())
@@ -885,16 +909,26 @@ void GameStatePlay::logic() {
 		checkTitle();
 
 		menu->act->checkAction(pc->action_queue);
+		ticks = SDL_GetPerformanceCounter();
 		pc->logic();
+		addTiming(TIMING_PC, ticks);
 
 		// transfer hero data to enemies, for AI use
 		if (pc->stats.get(Stats::STEALTH) > 100) entitym->hero_stealth = 100;
 		else entitym->hero_stealth = pc->stats.get(Stats::STEALTH);
 
+		// entities that chase the hero share a path toward the hero's current tile
+		mapr->collider.updateFlowFields(pc->stats.pos);
+		addTiming(TIMING_FLOW_FIELDS, ticks);
+
 		entitym->logic();
+		addTiming(TIMING_ENTITYM, ticks);
 		hazards->logic();
+		addTiming(TIMING_HAZARDS, ticks);
 		loot->logic();
+		addTiming(TIMING_LOOT, ticks);
 		npcs->logic();
+		addTiming(TIMING_NPCS, ticks);
 
 		comb->logic(mapr->cam.pos);
 	}
@@ -918,8 +952,10 @@ void GameStatePlay::logic() {
 	checkNotifications();
 	checkCancel();
 
+	ticks = SDL_GetPerformanceCounter();
 	mapr->logic(isPaused());
 	mapr->enemies_cleared = entitym->isCleared();
+	addTiming(TIMING_MAPR, ticks);
 	quests->logic();
 
 	pc->checkTransform();
@@ -1025,6 +1061,10 @@ void GameStatePlay::render() {
 	if (mapr->is_spawn_map)
 		return;
 
+	// draw moving objects between the last two logic frames
+	if (settings->render_interpolation && !isPaused())
+		render_interpolation.begin(render_alpha);
+
 	// Create a list of Renderables from all objects not already on the map.
 	// split the list into the beings alive (may move) and dead beings (must not move)
 	std::vector<Renderable> rens;
@@ -1060,6 +1100,8 @@ void GameStatePlay::render() {
 	// attacked, even if you have menus open
 	if (!isPaused())
 		comb->render();
+
+	render_interpolation.end();
 }
 
 bool GameStatePlay::isPaused() {
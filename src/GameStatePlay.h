@@ -29,6 +29,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include "CommonIncludes.h"
 #include "GameState.h"
+#include "RenderInterpolation.h"
 #include "Utils.h"
 
 class Avatar;
@@ -95,9 +96,30 @@ private:
 
 	bool is_first_map_load;
 
+	RenderInterpolation render_interpolation;
+
 	static const unsigned UPDATE_ACTIONBAR_ALL = 0;
 
+	void addTiming(int subsystem, uint64_t& start_ticks);
+
 public:
+	enum {
+		TIMING_PC = 0,
+		TIMING_ENTITYM = 1,
+		TIMING_HAZARDS = 2,
+		TIMING_LOOT = 3,
+		TIMING_NPCS = 4,
+		TIMING_MAPR = 5,
+		TIMING_MENU = 6,
+		TIMING_FLOW_FIELDS = 7,
+		TIMING_COUNT = 8
+	};
+
+	// performance counter ticks spent in the logic of each subsystem, summed over every frame since resetTimings()
+	// these are shared between instances, so that timing can continue across a reload of the game state
+	static uint64_t timings[TIMING_COUNT];
+	static void resetTimings();
+
 	GameStatePlay();
 	~GameStatePlay();
 	void refreshWidgets();
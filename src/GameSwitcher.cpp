@@ -252,7 +252,10 @@ void GameSwitcher::logic() {
 	}
 }
 
-void GameSwitcher::showFPS(float fps) {
+/**
+ * With render interpolation, the logic frame rate and the interpolation of the current frame are shown as well
+ */
+void GameSwitcher::showFPS(float fps, float ticks_per_sec, float render_alpha) {
 	if (settings->show_fps && settings->show_hud) {
 		if (!label_fps) label_fps = new WidgetLabel();
 		if (fps_update.isEnd()) {
@@ -261,6 +264,8 @@ void GameSwitcher::showFPS(float fps) {
 			float avg_fps = (fps + last_fps) / 2.f;
 			last_fps = fps;
 			std::string sfps = msg->getv("%s FPS", Utils::floatToString(avg_fps, 2).c_str());
+			if (settings->render_interpolation && ticks_per_sec >= 0)
+				sfps += ", " + msg->getv("%s ticks/s, alpha %s", Utils::floatToString(ticks_per_sec, 1).c_str(), Utils::floatToString(render_alpha, 2).c_str());
 			Rect pos = fps_position;
 			label_fps->setPos(pos.x, pos.y);
 			label_fps->setText(sfps);
@@ -317,7 +322,11 @@ bool GameSwitcher::isPaused() {
 	return currentState->isPaused();
 }
 
-void GameSwitcher::render() {
+/**
+ * render_alpha is how far the frame is between the last two logic frames, used for render interpolation
+ */
+void GameSwitcher::render(float render_alpha) {
+	render_device->setDrawCategory(RenderDevice::DRAW_MENU);
 	render_device->loadQueuedImages();
 
 	if (anim)
@@ -332,6 +341,7 @@ void GameSwitcher::render() {
 		render_device->render(background_frame);
 	}
 
+	currentState->render_alpha = render_alpha;
 	currentState->render();
 	tooltipm->render();
 	curs->render();
@@ -76,8 +76,8 @@ public:
 	bool isLoadingFrame();
 	bool isPaused();
 	void logic();
-	void render();
-	void showFPS(float fps);
+	void render(float render_alpha);
+	void showFPS(float fps, float ticks_per_sec, float render_alpha);
 	void saveUserSettings();
 	bool done;
 };
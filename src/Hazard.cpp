@@ -38,6 +38,8 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include <cmath>
 
+unsigned Hazard::next_serial = 0;
+
 Hazard::Hazard(MapCollision *_collider)
 	: active(true)
 	, remove_now(false)
@@ -57,6 +59,7 @@ Hazard::Hazard(MapCollision *_collider)
 	, power(NULL)
 	, power_index(0)
 	, parent(NULL)
+	, serial(next_serial++)
 	, collider(_collider)
 	, activeAnimation(NULL)
 	, animation_name("")
@@ -72,6 +75,9 @@ Hazard& Hazard::operator=(const Hazard& other) {
 	if (this == &other)
 		return *this;
 
+	// this is a different hazard now
+	serial = next_serial++;
+
 	active = other.active;
 	remove_now = other.remove_now;
 	hit_wall = other.hit_wall;
@@ -278,6 +284,7 @@ void Hazard::addRenderable(std::vector<Renderable> &r, std::vector<Renderable> &
 		re.map_pos.x = pos.x;
 		re.map_pos.y = pos.y;
 		re.prio = (power->on_floor ? 0 : 2);
+		re.type = Renderable::TYPE_HAZARD;
 		(power->on_floor ? r_dead : r).push_back(re);
 	}
 }
@@ -81,9 +81,14 @@ public:
 
 	FPoint prev_pos;
 
+	// unique to this hazard, even if it takes the memory of one that was removed
+	unsigned serial;
+
 private:
     void reflect();
 
+	static unsigned next_serial;
+
 	const MapCollision *collider;
 	Animation *activeAnimation;
 	std::string animation_name;
@@ -40,7 +40,8 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "UtilsMath.h"
 
 HazardManager::HazardManager()
-	: last_enemy(NULL)
+	: hazard_targets()
+	, last_enemy(NULL)
 {
 }
 
@@ -107,8 +108,9 @@ void HazardManager::logic() {
 		if (hazard->isDangerousNow()) {
 
 			// process hazards that can hurt enemies & allies
-			for (size_t eindex = 0; eindex < entitym->entities.size(); eindex++) {
-				Entity *e = entitym->entities[eindex];
+			entitym->spatial_grid.getInRadius(hazard->pos, hazard->power->radius, SpatialGrid::Filter(), hazard_targets);
+			for (size_t eindex = 0; eindex < hazard_targets.size(); eindex++) {
+				Entity *e = hazard_targets[eindex];
 
 				// hero/ally powers can only hit allies if target_party is true
 				if ((hazard->source_type == Power::SOURCE_TYPE_HERO || hazard->source_type == Power::SOURCE_TYPE_ALLY) && e->stats.hero_ally && !hazard->power->target_party) {
@@ -121,15 +123,14 @@ void HazardManager::logic() {
 				}
 
 				// only check living enemies
+				// the grid query already limits targets to the ones within the hazard radius
 				if (e->stats.hp > 0 && hazard->active) {
-					if (Utils::isWithinRadius(hazard->pos, hazard->power->radius, e->stats.pos)) {
-						if (!hazard->hasEntity(e)) {
-							// hit!
-							hazard->addEntity(e);
-							hitEntity(hindex, e->takeHit(*hazard));
-							if (!hazard->power->beacon) {
-								last_enemy = e;
-							}
+					if (!hazard->hasEntity(e)) {
+						// hit!
+						hazard->addEntity(e);
+						hitEntity(hindex, e->takeHit(*hazard));
+						if (!hazard->power->beacon) {
+							last_enemy = e;
 						}
 					}
 				}
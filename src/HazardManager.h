@@ -36,6 +36,8 @@ class HazardManager {
 private:
 	void hitEntity(size_t index, const bool hit);
 
+	std::vector<Entity*> hazard_targets;
+
 public:
 	HazardManager();
 	~HazardManager();
@@ -420,7 +420,7 @@ void ItemManager::loadItems(const std::string& filename) {
 	FileParser infile;
 
 	// @CLASS ItemManager: Items|Description of Items in items/items.txt.
-	if (!infile.open(filename, FileParser::MOD_FILE, FileParser::ERROR_NORMAL))
+	if (!infile.open(filename, FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE))
 		return;
 
 	// used to clear vectors when overriding items
@@ -794,7 +794,7 @@ void ItemManager::loadTypes(const std::string& filename) {
 	item_types.resize(1);
 
 	// @CLASS ItemManager: Types|Definition of a item types, items/types.txt...
-	if (infile.open(filename, FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open(filename, FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "type") {
@@ -903,7 +903,7 @@ void ItemManager::loadQualities(const std::string& filename) {
 	item_qualities.resize(1);
 
 	// @CLASS ItemManager: Qualities|Definition of a item qualities, items/types.txt...
-	if (infile.open(filename, FileParser::MOD_FILE, FileParser::ERROR_NORMAL)) {
+	if (infile.open(filename, FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE)) {
 		while (infile.next()) {
 			if (infile.new_section) {
 				if (infile.section == "quality") {
@@ -1067,7 +1067,7 @@ void ItemManager::loadSets(const std::string& filename) {
 	FileParser infile;
 
 	// @CLASS ItemManager: Sets|Definition of a item sets, items/sets.txt...
-	if (!infile.open(filename, FileParser::MOD_FILE, FileParser::ERROR_NORMAL))
+	if (!infile.open(filename, FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE))
 		return;
 
 	bool clear_bonus = true;
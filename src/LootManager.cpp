@@ -607,6 +607,7 @@ void LootManager::addRenders(std::vector<Renderable> &ren, std::vector<Renderabl
 			Renderable r = it->animation->getCurrentFrame(0);
 			r.map_pos.x = it->pos.x;
 			r.map_pos.y = it->pos.y;
+			r.type = Renderable::TYPE_LOOT;
 
 			(it->animation->isLastFrame() ? ren_dead : ren).push_back(r);
 		}
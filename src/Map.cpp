@@ -174,6 +174,7 @@ void SpawnLevel::applyToStatBlock(StatBlock *src_stats, StatBlock *ratio_stats)
 
 Map::Map()
 	: filename("")
+	, layer_format(LAYER_FORMAT_DEC)
 	, procgen_doors_max(0)
 	, procgen_door_spacing_min(0)
 	, procgen_branches_per_door_level_max(0)
@@ -311,6 +312,7 @@ int Map::load(const std::string& fname, bool load_procgen_cache) {
 			procGenFillArea(ec_procgen->s, procgen_regions[0].location);
 
 			MapSaver map_saver(this);
+			map_saver.setLayerFormat(LAYER_FORMAT_RLE);
 			Utils::logInfo("Saving map: %s", fname.c_str());
 			map_saver.saveMap(procgen_filename, "");
 
@@ -338,10 +340,7 @@ int Map::load(const std::string& fname, bool load_procgen_cache) {
 	if (std::find(layernames.begin(), layernames.end(), "collision") == layernames.end()) {
 		layernames.push_back("collision");
 		layers.resize(layers.size()+1);
-		layers.back().resize(w);
-		for (size_t i=0; i<layers.back().size(); ++i) {
-			layers.back()[i].resize(h, 0);
-		}
+		layers.back().assign(w, h, 0);
 	}
 
 	if (fogofwar) {
@@ -375,19 +374,13 @@ int Map::load(const std::string& fname, bool load_procgen_cache) {
 		if (std::find(layernames.begin(), layernames.end(), "fow_fog") == layernames.end()) {
 			layernames.push_back("fow_fog");
 			layers.resize(layers.size()+1);
-			layers.back().resize(w);
-			for (size_t i=0; i<layers.back().size(); ++i) {
-				layers.back()[i].resize(h, FogOfWar::TILE_HIDDEN);
-			}
+			layers.back().assign(w, h, FogOfWar::TILE_HIDDEN);
 		}
 
 		if (std::find(layernames.begin(), layernames.end(), "fow_dark") == layernames.end()) {
 			layernames.push_back("fow_dark");
 			layers.resize(layers.size()+1);
-			layers.back().resize(w);
-			for (size_t i=0; i<layers.back().size(); ++i) {
-				layers.back()[i].resize(h, FogOfWar::TILE_HIDDEN);
-			}
+			layers.back().assign(w, h, FogOfWar::TILE_HIDDEN);
 		}
 	}
 
@@ -542,18 +535,22 @@ bool Map::loadLayer(FileParser &infile, bool exit_on_fail) {
 	if (infile.key == "type") {
 		// @ATTR layer.type|string|Map layer type.
 		layers.resize(layers.size()+1);
-		layers.back().resize(w);
-		for (size_t i=0; i<layers.back().size(); ++i) {
-			layers.back()[i].resize(h);
-		}
+		layers.back().assign(w, h, 0);
 		layernames.push_back(infile.val);
+		layer_format = LAYER_FORMAT_DEC;
 	}
 	else if (infile.key == "format") {
-		// @ATTR layer.format|string|Format for map layer, must be 'dec'
-		if (infile.val != "dec") {
-			infile.error("Map: The format of a layer must be 'dec'!");
+		// @ATTR layer.format|["dec", "rle"]|Format for map layer data. 'dec' is a comma-separated list of tile IDs. 'rle' is the same, but repeated tile IDs can be written once as 'count*id'. Defaults to 'dec'.
+		if (infile.val == "dec") {
+			layer_format = LAYER_FORMAT_DEC;
+		}
+		else if (infile.val == "rle") {
+			layer_format = LAYER_FORMAT_RLE;
+		}
+		else {
+			infile.error("Map: The format of a layer must be 'dec' or 'rle'!");
 			if (exit_on_fail) {
-				Utils::logErrorDialog("Map: The format of a layer must be 'dec'!");
+				Utils::logErrorDialog("Map: The format of a layer must be 'dec' or 'rle'!");
 				mods->resetModConfig();
 				Utils::Exit(1);
 			}
@@ -567,16 +564,15 @@ bool Map::loadLayer(FileParser &infile, bool exit_on_fail) {
 		for (int j=0; j<h; j++) {
 			std::string val = infile.getRawLine();
 			infile.incrementLineNum();
-			if (!val.empty() && val[val.length()-1] != ',') {
-				val += ',';
-			}
+
+			bool row_ok;
+			if (layer_format == LAYER_FORMAT_RLE)
+				row_ok = loadLayerRowRLE(val, layers.back().getRow(j));
+			else
+				row_ok = loadLayerRowDec(val, layers.back().getRow(j));
 
 			// verify the width of this row
-			int comma_count = 0;
-			for (unsigned i=0; i<val.length(); ++i) {
-				if (val[i] == ',') comma_count++;
-			}
-			if (comma_count != w) {
+			if (!row_ok) {
 				infile.error("Map: A row of layer data has a width not equal to %d.", w);
 				if (exit_on_fail) {
 					mods->resetModConfig();
@@ -584,9 +580,6 @@ bool Map::loadLayer(FileParser &infile, bool exit_on_fail) {
 				}
 				return false;
 			}
-
-			for (int i=0; i<w; i++)
-				layers.back()[i][j] = static_cast<unsigned short>(Parse::popFirstInt(val));
 		}
 	}
 	else {
@@ -596,6 +589,56 @@ bool Map::loadLayer(FileParser &infile, bool exit_on_fail) {
 	return true;
 }
 
+/**
+ * Reads one row of 'dec' layer data into tiles. Returns false if the row doesn't have exactly w values
+ */
+bool Map::loadLayerRowDec(const std::string& row, unsigned short* tiles) {
+	// the last value may or may not be followed by a comma
+	int comma_count = 0;
+	for (size_t i = 0; i < row.length(); ++i) {
+		if (row[i] == ',') comma_count++;
+	}
+	if (!row.empty() && row[row.length()-1] != ',')
+		comma_count++;
+
+	if (comma_count != w)
+		return false;
+
+	size_t pos = 0;
+	for (int i = 0; i < w; i++)
+		tiles[i] = static_cast<unsigned short>(Parse::nextInt(row, pos));
+
+	return true;
+}
+
+/**
+ * Reads one row of 'rle' layer data into tiles. Each comma-separated value is either a tile ID, or 'count*id' for a
+ * run of the same tile ID. Returns false if the row doesn't add up to exactly w tiles
+ */
+bool Map::loadLayerRowRLE(const std::string& row, unsigned short* tiles) {
+	int x = 0;
+	size_t pos = 0;
+
+	while (pos < row.length()) {
+		size_t value_end = row.find(',', pos);
+		size_t run_pos = row.find('*', pos);
+
+		int count = 1;
+		if (run_pos < value_end)
+			count = Parse::nextInt(row, pos, '*');
+
+		unsigned short value = static_cast<unsigned short>(Parse::nextInt(row, pos, ','));
+
+		if (count < 1 || count > w - x)
+			return false;
+
+		std::fill(tiles + x, tiles + x + count, value);
+		x += count;
+	}
+
+	return x == w;
+}
+
 void Map::loadEnemyGroup(FileParser &infile, Map_Group *group) {
 	if (infile.key == "type") {
 		// @ATTR enemygroup.type|string|(IGNORED BY ENGINE) The "type" field, as used by Tiled and other mapping tools.
@@ -1491,19 +1534,19 @@ void Map::copyTileLayer(Map* src, size_t layer_index, size_t src_x, size_t src_y
 		return;
 
 	if (src_w == 0)
-		src_w = src->layers[layer_index].size();
+		src_w = src->layers[layer_index].getWidth();
 	if (src_h == 0)
-		src_h = src->layers[layer_index].size();
+		src_h = src->layers[layer_index].getHeight();
 
-	for (size_t x = src_x; x < src_w; ++x) {
-		if (x + x_offset >= w)
+	for (size_t y = src_y; y < src_h; ++y) {
+		if (y + y_offset >= h)
 			continue;
 
-		for (size_t y = src_y; y < src_h; ++y) {
-			if (y + y_offset >= h)
+		for (size_t x = src_x; x < src_w; ++x) {
+			if (x + x_offset >= w)
 				continue;
 
-			layers[layer_index][x + x_offset][y + y_offset] = src->layers[layer_index][x][y];
+			layers[layer_index](x + x_offset, y + y_offset) = src->layers[layer_index](x, y);
 		}
 	}
 }
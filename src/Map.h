@@ -208,6 +208,8 @@ protected:
 
 	void loadHeader(FileParser &infile);
 	bool loadLayer(FileParser &infile, bool exit_on_fail = EXIT_ON_FAIL);
+	bool loadLayerRowDec(const std::string& row, unsigned short* tiles);
+	bool loadLayerRowRLE(const std::string& row, unsigned short* tiles);
 	void loadEnemyGroup(FileParser &infile, Map_Group *group);
 	void loadNPC(FileParser &infile);
 
@@ -228,6 +230,9 @@ protected:
 
 	std::vector<Point> procgen_branch_roots;
 
+	// format of the layer that is being loaded
+	int layer_format;
+
 	int procgen_doors_max;
 	int procgen_door_spacing_min;
 	int procgen_branches_per_door_level_max;
@@ -235,6 +240,11 @@ protected:
 public:
 	static const bool LOAD_PROCGEN_CACHE = true;
 
+	enum {
+		LAYER_FORMAT_DEC = 0,
+		LAYER_FORMAT_RLE = 1
+	};
+
 	Map();
 	~Map();
 	std::string getFilename() { return filename; }
@@ -30,12 +30,11 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #define NDEBUG
 #endif
 
-#include "AStarContainer.h"
-#include "AStarNode.h"
 #include "EngineSettings.h"
 #include "MapCollision.h"
 #include "SharedResources.h"
 
+#include <algorithm>
 #include <cfloat>
 #include <math.h>
 #include <cassert>
@@ -45,32 +44,105 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 // so if an entity has a position of (1-MIN_TILE_GAP, 0) and moves to the east, they will move to (1,0)
 const float MapCollision::MIN_TILE_GAP = 0.001f;
 
+// neighbour tiles in the order they are evaluated by computePath()
+const Point MapCollision::NEIGHBOUR_OFFSETS[8] = {
+	Point(-1, -1), Point(-1, 1), Point(1, -1), Point(1, 1),
+	Point(-1, 0), Point(0, -1), Point(1, 0), Point(0, 1)
+};
+
+// weighting the A* heuristic finds paths faster, at the cost of paths that are sometimes a little longer
+const float MapCollision::GRID_PATH_HEURISTIC_WEIGHT = 2.f;
+
+// JPS only expands a few nodes per search, so it can afford an exact heuristic and always find a shortest path
+const float MapCollision::JUMP_PATH_HEURISTIC_WEIGHT = 1.f;
+
 MapCollision::MapCollision()
 	: has_empty_tile(false)
 	, raycast_resolution(eset->misc.raycast_resolution)
 	, raycast_resolution_recip(1.f / eset->misc.raycast_resolution)
+	, diagonal_step_cost(Utils::calcDist(FPoint(0,0), FPoint(1,1)))
+	, path_expansions(0)
 	, map_size(Point())
 {
-	colmap.resize(1);
-	colmap[0].resize(1);
+	colmap.assign(1, 1, 0);
+	colflags.resize(1, 0);
 }
 
-void MapCollision::setMap(const Map_Layer& _colmap, unsigned short w, unsigned short h) {
+void MapCollision::setMap(const Map_Layer& _colmap) {
 	has_empty_tile = false;
 
-	colmap.resize(w);
-	for (unsigned i=0; i<w; ++i) {
-		colmap[i].resize(h);
-	}
-	for (unsigned i=0; i<w; i++)
-		for (unsigned j=0; j<h; j++) {
-			colmap[i][j] = _colmap[i][j];
-			if (colmap[i][j] == 0)
+	colmap = _colmap;
+	map_size.x = colmap.getWidth();
+	map_size.y = colmap.getHeight();
+
+	colflags.resize(static_cast<size_t>(map_size.x * map_size.y));
+	visibility.init(map_size.x, map_size.y);
+	for (int j = 0; j < map_size.y; ++j) {
+		for (int i = 0; i < map_size.x; ++i) {
+			colflags[j * map_size.x + i] = getTileFlags(colmap(i, j));
+			if (colflags[j * map_size.x + i] & FLAG_WALL)
+				visibility.setBlocked(i, j, true);
+			if (colmap(i, j) == 0)
 				has_empty_tile = true;
 		}
+	}
+
+	hierarchy_normal.init(this, MOVE_NORMAL, eset->misc.path_cluster_size);
+	hierarchy_normal.build();
+	hierarchy_flying.init(this, MOVE_FLYING, eset->misc.path_cluster_size);
+	hierarchy_flying.build();
 
-	map_size.x = w;
-	map_size.y = h;
+	flow_field_normal.init(this, MOVE_NORMAL, eset->misc.flow_field_range);
+	flow_field_flying.init(this, MOVE_FLYING, eset->misc.flow_field_range);
+}
+
+/**
+ * Changes a collision tile and marks the surrounding path clusters and the flow fields for rebuilding
+ */
+void MapCollision::setTile(const int& tile_x, const int& tile_y, unsigned short tile_id) {
+	if (isTileOutsideMap(tile_x, tile_y))
+		return;
+
+	setTileValue(tile_x, tile_y, tile_id);
+	if (tile_id == BLOCKS_NONE)
+		has_empty_tile = true;
+
+	hierarchy_normal.invalidateTile(tile_x, tile_y);
+	hierarchy_flying.invalidateTile(tile_x, tile_y);
+
+	flow_field_normal.invalidate();
+	flow_field_flying.invalidate();
+}
+
+/**
+ * Converts a collision tile value to the flags used for collision checks
+ */
+uint8_t MapCollision::getTileFlags(unsigned short tile) {
+	switch (tile) {
+		case BLOCKS_NONE:
+		case MAP_ONLY:
+		case MAP_ONLY_ALT:
+			return 0;
+		case BLOCKS_ALL:
+		case BLOCKS_ALL_HIDDEN:
+			return FLAG_WALL | FLAG_SOLID;
+		case BLOCKS_ENTITIES:
+			return FLAG_ENTITY;
+		case BLOCKS_ENEMIES:
+			return FLAG_ALLY;
+		default:
+			// BLOCKS_MOVEMENT, BLOCKS_MOVEMENT_HIDDEN and unknown values
+			return FLAG_SOLID;
+	}
+}
+
+/**
+ * Sets a collision tile value without checking bounds or updating path structures
+ */
+void MapCollision::setTileValue(const int& tile_x, const int& tile_y, unsigned short tile) {
+	colmap(tile_x, tile_y) = tile;
+	colflags[tile_y * map_size.x + tile_x] = getTileFlags(tile);
+	visibility.setBlocked(tile_x, tile_y, (colflags[tile_y * map_size.x + tile_x] & FLAG_WALL) != 0);
 }
 
 int sgn(float f) {
@@ -229,7 +301,7 @@ bool MapCollision::isWall(const float& x, const float& y) const {
 	if (isTileOutsideMap(tile_x, tile_y)) return true;
 
 	// collision type check
-	return (colmap[tile_x][tile_y] == BLOCKS_ALL || colmap[tile_x][tile_y] == BLOCKS_ALL_HIDDEN);
+	return (colflags[tile_y * map_size.x + tile_x] & FLAG_WALL) != 0;
 }
 
 /**
@@ -239,14 +311,14 @@ bool MapCollision::isValidTile(const int& tile_x, const int& tile_y, int movemen
 	// outside the map isn't valid
 	if (isTileOutsideMap(tile_x,tile_y)) return false;
 
+	const uint8_t flags = colflags[tile_y * map_size.x + tile_x];
+
 	if (collide_type == COLLIDE_TYPE_ALL_ENTITIES) {
-		if (colmap[tile_x][tile_y] == BLOCKS_ENEMIES)
-			return false;
-		if (colmap[tile_x][tile_y] == BLOCKS_ENTITIES)
+		if (flags & (FLAG_ENTITY | FLAG_ALLY))
 			return false;
 	}
 	else if (collide_type == COLLIDE_TYPE_HERO) {
-		if (colmap[tile_x][tile_y] == BLOCKS_ENEMIES && !eset->misc.enable_ally_collision)
+		if ((flags & FLAG_ALLY) && !eset->misc.enable_ally_collision)
 			return true;
 	}
 
@@ -256,14 +328,27 @@ bool MapCollision::isValidTile(const int& tile_x, const int& tile_y, int movemen
 
 	// flying creatures can't be in walls
 	if (movement_type == MOVE_FLYING) {
-		return (!(colmap[tile_x][tile_y] == BLOCKS_ALL || colmap[tile_x][tile_y] == BLOCKS_ALL_HIDDEN));
+		return (flags & FLAG_WALL) == 0;
 	}
 
-	if (colmap[tile_x][tile_y] == MAP_ONLY || colmap[tile_x][tile_y] == MAP_ONLY_ALT)
-		return true;
-
 	// normal creatures can only be in empty spaces
-	return (colmap[tile_x][tile_y] == BLOCKS_NONE) || (collide_type == COLLIDE_TYPE_HAZARD && (colmap[tile_x][tile_y] == BLOCKS_ENEMIES || colmap[tile_x][tile_y] == BLOCKS_ENTITIES));
+	if (flags & FLAG_SOLID)
+		return false;
+
+	// hazards ignore tiles that are blocked by entities
+	if (flags & (FLAG_ENTITY | FLAG_ALLY))
+		return collide_type == COLLIDE_TYPE_HAZARD;
+
+	return true;
+}
+
+/**
+ * Is this tile valid for this movement type when ignoring entities?
+ * Used by path structures that are shared between entities, since entities move around
+ */
+bool MapCollision::isValidStaticTile(const int& tile_x, const int& tile_y, int movement_type) const {
+	// hazards ignore tiles blocked by entities, which is the same test we want here
+	return isValidTile(tile_x, tile_y, movement_type, COLLIDE_TYPE_HAZARD);
 }
 
 /**
@@ -305,15 +390,7 @@ bool MapCollision::lineCheck(const float& x1, const float& y1, const float& x2,
 	step_y *= raycast_resolution;
 
 
-	if (check_type == CHECK_SIGHT) {
-		for (int i=0; i<steps; i++) {
-			x += step_x;
-			y += step_y;
-			if (isWall(x, y))
-				return false;
-		}
-	}
-	else if (check_type == CHECK_MOVEMENT) {
+	if (check_type == CHECK_MOVEMENT) {
 		for (int i=0; i<steps; i++) {
 			x += step_x;
 			y += step_y;
@@ -326,7 +403,7 @@ bool MapCollision::lineCheck(const float& x1, const float& y1, const float& x2,
 }
 
 bool MapCollision::lineOfSight(const float& x1, const float& y1, const float& x2, const float& y2) {
-	return lineCheck(x1, y1, x2, y2, CHECK_SIGHT, MOVE_NORMAL);
+	return visibility.lineOfSight(FPoint(x1, y1), FPoint(x2, y2));
 }
 
 bool MapCollision::lineOfMovement(const float& x1, const float& y1, const float& x2, const float& y2, int movement_type) {
@@ -339,8 +416,8 @@ bool MapCollision::lineOfMovement(const float& x1, const float& y1, const float&
 	int tile_x = int(x2);
 	int tile_y = int(y2);
 	bool target_blocks = false;
-	int target_blocks_type = colmap[tile_x][tile_y];
-	if (colmap[tile_x][tile_y] == BLOCKS_ENTITIES || colmap[tile_x][tile_y] == BLOCKS_ENEMIES) {
+	int target_blocks_type = colmap(tile_x, tile_y);
+	if (target_blocks_type == BLOCKS_ENTITIES || target_blocks_type == BLOCKS_ENEMIES) {
 		target_blocks = true;
 		unblock(x2,y2);
 	}
@@ -384,12 +461,139 @@ bool MapCollision::isFacing(const float& x1, const float& y1, char direction, co
 * Compute a path from (x1,y1) to (x2,y2)
 * Store waypoint inside path
 * limit is the maximum number of explored node
+* algorithm is one of PATH_ALGORITHM_*
 * @return true if a path is found
 */
-bool MapCollision::computePath(const FPoint& start_pos, const FPoint& end_pos, std::vector<FPoint> &path, int movement_type, unsigned int limit) {
+bool MapCollision::computePath(const FPoint& start_pos, const FPoint& end_pos, std::vector<FPoint> &path, int movement_type, unsigned int limit, int algorithm) {
 
 	if (isOutsideMap(end_pos.x, end_pos.y)) return false;
 
+	if (algorithm == PATH_ALGORITHM_DEFAULT)
+		algorithm = eset->misc.path_algorithm;
+	bool jump_search = (algorithm == PATH_ALGORITHM_JPS);
+
+	// long paths with the default limit are planned on the cluster graph first
+	if (limit == DEFAULT_PATH_LIMIT) {
+		PathHierarchy* hierarchy = getPathHierarchy(movement_type);
+		if (hierarchy && hierarchy->isEnabled() && !hierarchy->isNearby(Point(start_pos), Point(end_pos))) {
+			if (computeHierarchicalPath(hierarchy, start_pos, end_pos, path, movement_type, jump_search))
+				return true;
+		}
+	}
+
+	if (jump_search)
+		return computeJumpPath(start_pos, end_pos, path, movement_type, limit);
+
+	return computeGridPath(start_pos, end_pos, path, movement_type, limit);
+}
+
+PathHierarchy* MapCollision::getPathHierarchy(int movement_type) {
+	if (movement_type == MOVE_NORMAL)
+		return &hierarchy_normal;
+	else if (movement_type == MOVE_FLYING)
+		return &hierarchy_flying;
+
+	return NULL;
+}
+
+/**
+ * Continues building the flow fields toward the target (normally the hero)
+ * Should be called once per frame, before entities move
+ */
+void MapCollision::updateFlowFields(const FPoint& target) {
+	if (isOutsideMap(target.x, target.y))
+		return;
+
+	flow_field_normal.update(Point(target), FLOW_FIELD_BUDGET);
+	flow_field_flying.update(Point(target), FLOW_FIELD_BUDGET);
+}
+
+/**
+ * Builds a short path toward the flow field target, starting from start_pos
+ * Like computePath(), the path is stored from end to start, so path.back() is the next waypoint
+ * @return true if a path is found
+ */
+bool MapCollision::followFlowField(const FPoint& start_pos, std::vector<FPoint> &path, int movement_type) {
+	FlowField* flow_field = getFlowField(movement_type);
+	if (!flow_field || !flow_field->isReady())
+		return false;
+
+	Point current(start_pos);
+	Point next;
+
+	// only the first step avoids other entities, since they will have moved by the time we get further
+	// the path is left untouched if there is no first step
+	if (!flow_field->getNextTile(current, next, COLLIDE_TYPE_ALL_ENTITIES))
+		return false;
+
+	path.clear();
+
+	for (unsigned i = 0; i < FLOW_FIELD_PATH_LENGTH; ++i) {
+		path.push_back(collisionToMap(next));
+		current = next;
+
+		if (!flow_field->getNextTile(current, next, COLLIDE_TYPE_HAZARD))
+			break;
+	}
+
+	std::reverse(path.begin(), path.end());
+
+	return !path.empty();
+}
+
+FlowField* MapCollision::getFlowField(int movement_type) {
+	if (movement_type == MOVE_NORMAL)
+		return &flow_field_normal;
+	else if (movement_type == MOVE_FLYING)
+		return &flow_field_flying;
+
+	return NULL;
+}
+
+/**
+ * Refine an abstract path into tiles, one segment at a time
+ * Segments are short, so each one is a cheap grid search. These searches also take entities into account.
+ * @return true if a path is found
+ */
+bool MapCollision::computeHierarchicalPath(PathHierarchy* hierarchy, const FPoint& start_pos, const FPoint& end_pos, std::vector<FPoint> &path, int movement_type, bool jump_search) {
+	if (!hierarchy->findPath(Point(start_pos), Point(end_pos), hierarchy_waypoints))
+		return false;
+
+	if (!path.empty())
+		path.clear();
+
+	const unsigned segment_limit = static_cast<unsigned>(hierarchy->getClusterSize() * hierarchy->getClusterSize() * 4);
+
+	// waypoints are stored from end to start, so refining segments in that order builds the path in the expected order
+	for (size_t i = 0; i < hierarchy_waypoints.size(); ++i) {
+		FPoint segment_end = collisionToMap(hierarchy_waypoints[i]);
+		FPoint segment_start = (i + 1 < hierarchy_waypoints.size()) ? collisionToMap(hierarchy_waypoints[i+1]) : start_pos;
+
+		if (jump_search)
+			computeJumpPath(segment_start, segment_end, hierarchy_segment, movement_type, segment_limit);
+		else
+			computeGridPath(segment_start, segment_end, hierarchy_segment, movement_type, segment_limit);
+
+		// if a segment can't be completed (e.g. entities are in the way), only keep the path that leads up to the obstacle
+		if (hierarchy_segment.empty() || Point(hierarchy_segment.front()).x != hierarchy_waypoints[i].x || Point(hierarchy_segment.front()).y != hierarchy_waypoints[i].y) {
+			path.clear();
+		}
+
+		for (size_t j = 0; j < hierarchy_segment.size(); ++j) {
+			if (path.empty() || !(path.back() == hierarchy_segment[j]))
+				path.push_back(hierarchy_segment[j]);
+		}
+	}
+
+	return !path.empty();
+}
+
+/**
+ * A* search on the collision grid
+ * @return true if a path is found
+ */
+bool MapCollision::computeGridPath(const FPoint& start_pos, const FPoint& end_pos, std::vector<FPoint> &path, int movement_type, unsigned int limit) {
+
 	// default limit set to 10% of the total map size
 	if (limit == 0)
 		limit = (map_size.x * map_size.y) / 10;
@@ -404,93 +608,291 @@ bool MapCollision::computePath(const FPoint& start_pos, const FPoint& end_pos, s
 
 	// if the target square has an entity, temporarily clear it to compute the path
 	bool target_blocks = false;
-	int target_blocks_type = colmap[end.x][end.y];
-	if (colmap[end.x][end.y] == BLOCKS_ENTITIES || colmap[end.x][end.y] == BLOCKS_ENEMIES) {
+	int target_blocks_type = colmap(end.x, end.y);
+	if (target_blocks_type == BLOCKS_ENTITIES || target_blocks_type == BLOCKS_ENEMIES) {
 		target_blocks = true;
 		unblock(end_pos.x, end_pos.y);
 	}
 
-	Point current = start;
-	AStarNode* node = new AStarNode(start);
-	node->setActualCost(0);
-	node->setEstimatedCost(Utils::calcDist(FPoint(start),FPoint(end)));
-	node->setParent(current);
+	astar.reset(map_size.x, map_size.y, limit, GRID_PATH_HEURISTIC_WEIGHT);
 
-	AStarContainer open(map_size.x, map_size.y, limit);
-	AStarCloseContainer close(map_size.x, map_size.y, limit);
+	const int start_index = astar.toIndex(start);
+	const int end_index = astar.toIndex(end);
+	Point current = start;
+	int current_index = start_index;
 
-	open.add(node);
+	astar.addOpen(start_index, start_index, 0, Utils::calcDist(FPoint(start),FPoint(end)));
 
-	while (!open.isEmpty() && static_cast<unsigned>(close.getSize()) < limit) {
-		node = open.get_shortest_f();
+	while (!astar.isOpenEmpty() && astar.getClosedSize() < limit) {
+		current_index = astar.getShortestF();
+		current = astar.toPoint(current_index);
 
-		current.x = node->getX();
-		current.y = node->getY();
-		close.add(node);
-		open.remove(node);
+		astar.addClosed(current_index);
+		astar.removeOpen(current_index);
 
-		if ( current.x == end.x && current.y == end.y)
+		if (current_index == end_index)
 			break; //path found !
 
-		//limit evaluated nodes to the size of the map
-		std::list<Point> neighbours = node->getNeighbours(map_size.x, map_size.y);
-
 		// for every neighbour of current node
-		for (std::list<Point>::iterator it=neighbours.begin(); it != neighbours.end(); ++it)	{
-			Point neighbour = *it;
-
+		for (int i = 0; i < 8; ++i) {
 			// do not exceed the node limit when adding nodes
-			if (static_cast<unsigned>(open.getSize()) >= limit) {
+			if (astar.getOpenSize() >= limit) {
 				break;
 			}
 
+			// neighbours along the top and left edges (x == 0 or y == 0) have never been considered
+			// we keep it that way so that paths stay the same
+			if ((NEIGHBOUR_OFFSETS[i].x < 0 && current.x <= 1) || (NEIGHBOUR_OFFSETS[i].x > 0 && current.x >= map_size.x - 1))
+				continue;
+			if ((NEIGHBOUR_OFFSETS[i].y < 0 && current.y <= 1) || (NEIGHBOUR_OFFSETS[i].y > 0 && current.y >= map_size.y - 1))
+				continue;
+
+			Point neighbour(current.x + NEIGHBOUR_OFFSETS[i].x, current.y + NEIGHBOUR_OFFSETS[i].y);
+
 			// if neighbour is not free of any collision, skip it
 			if (!isValidTile(neighbour.x,neighbour.y,movement_type, MapCollision::COLLIDE_TYPE_ALL_ENTITIES))
 				continue;
+
+			int neighbour_index = astar.toIndex(neighbour);
+
 			// if nabour is already in close, skip it
-			if(close.exists(neighbour))
+			if (astar.isClosed(neighbour_index))
 				continue;
 
+			float step_cost = (NEIGHBOUR_OFFSETS[i].x != 0 && NEIGHBOUR_OFFSETS[i].y != 0) ? diagonal_step_cost : 1;
+			float g_cost = astar.getActualCost(current_index) + step_cost;
+
 			// if neighbour isn't inside open, add it as a new Node
-			if(!open.exists(neighbour)) {
-				AStarNode* newNode = new AStarNode(neighbour);
-				newNode->setActualCost(node->getActualCost() + Utils::calcDist(FPoint(current),FPoint(neighbour)));
-				newNode->setParent(current);
-				newNode->setEstimatedCost(Utils::calcDist(FPoint(neighbour),FPoint(end)));
-				open.add(newNode);
+			if (!astar.isOpen(neighbour_index)) {
+				astar.addOpen(neighbour_index, current_index, g_cost, Utils::calcDist(FPoint(neighbour),FPoint(end)));
 			}
 			// else, update it's cost if better
-			else {
-				AStarNode* i = open.get(neighbour.x, neighbour.y);
-				if (node->getActualCost() + Utils::calcDist(FPoint(current),FPoint(neighbour)) < i->getActualCost()) {
-					Point pos(i->getX(), i->getY());
-					Point parent_pos(node->getX(), node->getY());
-					open.updateParent(pos, parent_pos, node->getActualCost() + Utils::calcDist(FPoint(current),FPoint(neighbour)));
-				}
+			else if (g_cost < astar.getActualCost(neighbour_index)) {
+				astar.updateParent(neighbour_index, current_index, g_cost);
 			}
 		}
 	}
 
-	if (!(current.x == end.x && current.y == end.y)) {
+	path_expansions += astar.getClosedSize();
 
+	if (current_index != end_index) {
 		//couldnt find the target so map a path to the closest node found
-		node = close.get_shortest_h();
-		current.x = node->getX();
-		current.y = node->getY();
+		current_index = astar.getShortestH();
+		if (current_index == -1)
+			current_index = start_index;
+	}
+	else {
+		// store path from end to start
+		path.push_back(collisionToMap(end));
+	}
+
+	while (current_index != start_index) {
+		path.push_back(collisionToMap(astar.toPoint(current_index)));
+		current_index = astar.getParent(current_index);
+	}
+
+	// reblock target if needed
+	if (target_blocks) block(end_pos.x, end_pos.y, target_blocks_type == BLOCKS_ENEMIES);
+
+	return !path.empty();
+}
+
+/**
+ * Can a jump pass through this tile?
+ * Tiles along the top and left edges are excluded, since computeGridPath() never steps onto them
+ */
+bool MapCollision::isJumpTile(int x, int y, int movement_type) const {
+	return x >= 1 && y >= 1 && isValidTile(x, y, movement_type, COLLIDE_TYPE_ALL_ENTITIES);
+}
+
+/**
+ * Moves from (x,y) in direction (dx,dy) until reaching a tile that has to be expanded by computeJumpPath()
+ * That is the end tile, or a tile with a neighbour that can only be reached optimally through it
+ * Diagonal moves may cut corners, like they do in computeGridPath()
+ * Every tile visited, including those of the straight scans started from a diagonal, uses up one unit of scan_budget
+ * @return the tile index of the jump point, or -1 if the line is blocked or the budget runs out first
+ */
+int MapCollision::jump(int x, int y, int dx, int dy, const Point& end, int movement_type, unsigned& scan_budget) const {
+	while (true) {
+		if (scan_budget == 0)
+			return -1;
+		scan_budget--;
+
+		x += dx;
+		y += dy;
+
+		if (!isJumpTile(x, y, movement_type))
+			return -1;
+
+		if (x == end.x && y == end.y)
+			return y * map_size.x + x;
+
+		if (dx != 0 && dy != 0) {
+			if ((!isJumpTile(x - dx, y, movement_type) && isJumpTile(x - dx, y + dy, movement_type)) ||
+			    (!isJumpTile(x, y - dy, movement_type) && isJumpTile(x + dx, y - dy, movement_type)))
+				return y * map_size.x + x;
+
+			// a diagonal move stops where one of its straight components finds a jump point
+			if (jump(x, y, dx, 0, end, movement_type, scan_budget) != -1 || jump(x, y, 0, dy, end, movement_type, scan_budget) != -1)
+				return y * map_size.x + x;
+		}
+		else if (dx != 0) {
+			if ((!isJumpTile(x, y + 1, movement_type) && isJumpTile(x + dx, y + 1, movement_type)) ||
+			    (!isJumpTile(x, y - 1, movement_type) && isJumpTile(x + dx, y - 1, movement_type)))
+				return y * map_size.x + x;
+		}
+		else {
+			if ((!isJumpTile(x + 1, y, movement_type) && isJumpTile(x + 1, y + dy, movement_type)) ||
+			    (!isJumpTile(x - 1, y, movement_type) && isJumpTile(x - 1, y + dy, movement_type)))
+				return y * map_size.x + x;
+		}
+	}
+}
+
+/**
+ * Jump Point Search on the collision grid
+ * Only tiles where the path may change direction are added to the open list. The tiles in between are filled in
+ * when the path is stored, so the result has the same form as computeGridPath()
+ * The limit also bounds the tiles visited by the jumps (JUMP_PATH_SCANS_PER_NODE per node), so that expansions can't
+ * scan across the whole map. If it runs out, the path leads to the closest tile found, like computeGridPath()
+ * @return true if a path is found
+ */
+bool MapCollision::computeJumpPath(const FPoint& start_pos, const FPoint& end_pos, std::vector<FPoint> &path, int movement_type, unsigned int limit) {
+
+	// default limit set to 10% of the total map size
+	if (limit == 0)
+		limit = (map_size.x * map_size.y) / 10;
 
-		while (!(current.x == start.x && current.y == start.y)) {
-			path.push_back(collisionToMap(current));
-			current = close.get(current.x, current.y)->getParent();
+	// path must be empty
+	if (!path.empty())
+		path.clear();
+
+	// convert start & end to MapCollision precision
+	Point start(start_pos);
+	Point end(end_pos);
+
+	// if the target square has an entity, temporarily clear it to compute the path
+	bool target_blocks = false;
+	int target_blocks_type = colmap(end.x, end.y);
+	if (target_blocks_type == BLOCKS_ENTITIES || target_blocks_type == BLOCKS_ENEMIES) {
+		target_blocks = true;
+		unblock(end_pos.x, end_pos.y);
+	}
+
+	astar.reset(map_size.x, map_size.y, limit, JUMP_PATH_HEURISTIC_WEIGHT);
+
+	const int start_index = astar.toIndex(start);
+	const int end_index = astar.toIndex(end);
+	Point current = start;
+	int current_index = start_index;
+
+	astar.addOpen(start_index, start_index, 0, Utils::calcDist(FPoint(start),FPoint(end)));
+
+	Point directions[8];
+	unsigned scan_budget = limit * JUMP_PATH_SCANS_PER_NODE;
+
+	while (!astar.isOpenEmpty() && astar.getClosedSize() < limit && scan_budget > 0) {
+		current_index = astar.getShortestF();
+		current = astar.toPoint(current_index);
+
+		astar.addClosed(current_index);
+		astar.removeOpen(current_index);
+
+		if (current_index == end_index)
+			break; //path found !
+
+		// only search in the directions that can't be reached more cheaply without passing through this tile
+		int direction_count = 0;
+		if (current_index == start_index) {
+			for (int i = 0; i < 8; ++i) {
+				directions[direction_count++] = NEIGHBOUR_OFFSETS[i];
+			}
 		}
+		else {
+			Point parent = astar.toPoint(astar.getParent(current_index));
+			int dx = (current.x > parent.x) - (current.x < parent.x);
+			int dy = (current.y > parent.y) - (current.y < parent.y);
+
+			if (dx != 0 && dy != 0) {
+				directions[direction_count++] = Point(dx, 0);
+				directions[direction_count++] = Point(0, dy);
+				directions[direction_count++] = Point(dx, dy);
+				if (!isJumpTile(current.x - dx, current.y, movement_type))
+					directions[direction_count++] = Point(-dx, dy);
+				if (!isJumpTile(current.x, current.y - dy, movement_type))
+					directions[direction_count++] = Point(dx, -dy);
+			}
+			else if (dx != 0) {
+				directions[direction_count++] = Point(dx, 0);
+				if (!isJumpTile(current.x, current.y + 1, movement_type))
+					directions[direction_count++] = Point(dx, 1);
+				if (!isJumpTile(current.x, current.y - 1, movement_type))
+					directions[direction_count++] = Point(dx, -1);
+			}
+			else {
+				directions[direction_count++] = Point(0, dy);
+				if (!isJumpTile(current.x + 1, current.y, movement_type))
+					directions[direction_count++] = Point(1, dy);
+				if (!isJumpTile(current.x - 1, current.y, movement_type))
+					directions[direction_count++] = Point(-1, dy);
+			}
+		}
+
+		for (int i = 0; i < direction_count; ++i) {
+			// do not exceed the node limit when adding nodes
+			if (astar.getOpenSize() >= limit) {
+				break;
+			}
+
+			int jump_index = jump(current.x, current.y, directions[i].x, directions[i].y, end, movement_type, scan_budget);
+			if (jump_index == -1 || astar.isClosed(jump_index))
+				continue;
+
+			Point jump_point = astar.toPoint(jump_index);
+			int steps_x = abs(jump_point.x - current.x);
+			int steps_y = abs(jump_point.y - current.y);
+			float step_cost = diagonal_step_cost * static_cast<float>(std::min(steps_x, steps_y)) + static_cast<float>(abs(steps_x - steps_y));
+			float g_cost = astar.getActualCost(current_index) + step_cost;
+
+			if (!astar.isOpen(jump_index)) {
+				astar.addOpen(jump_index, current_index, g_cost, Utils::calcDist(FPoint(jump_point),FPoint(end)));
+			}
+			else if (g_cost < astar.getActualCost(jump_index)) {
+				astar.updateParent(jump_index, current_index, g_cost);
+			}
+		}
+	}
+
+	path_expansions += astar.getClosedSize();
+
+	if (current_index != end_index) {
+		//couldnt find the target so map a path to the closest node found
+		current_index = astar.getShortestH();
+		if (current_index == -1)
+			current_index = start_index;
 	}
 	else {
 		// store path from end to start
 		path.push_back(collisionToMap(end));
-		while (!(current.x == start.x && current.y == start.y)) {
-			path.push_back(collisionToMap(current));
-			current = close.get(current.x, current.y)->getParent();
+	}
+
+	// jump points are joined by straight or diagonal lines, so every tile in between is added to the path
+	while (current_index != start_index) {
+		int parent_index = astar.getParent(current_index);
+		Point tile = astar.toPoint(current_index);
+		Point parent = astar.toPoint(parent_index);
+		int dx = (parent.x > tile.x) - (parent.x < tile.x);
+		int dy = (parent.y > tile.y) - (parent.y < tile.y);
+
+		while (tile.x != parent.x || tile.y != parent.y) {
+			path.push_back(collisionToMap(tile));
+			tile.x += dx;
+			tile.y += dy;
 		}
+
+		current_index = parent_index;
 	}
+
 	// reblock target if needed
 	if (target_blocks) block(end_pos.x, end_pos.y, target_blocks_type == BLOCKS_ENEMIES);
 
@@ -504,11 +906,11 @@ void MapCollision::block(const float& map_x, const float& map_y, bool is_ally) {
 	if (isTileOutsideMap(tile_x, tile_y))
 		return;
 
-	if (colmap[tile_x][tile_y] == BLOCKS_NONE) {
+	if (colmap(tile_x, tile_y) == BLOCKS_NONE) {
 		if(is_ally)
-			colmap[tile_x][tile_y] = BLOCKS_ENEMIES;
+			setTileValue(tile_x, tile_y, BLOCKS_ENEMIES);
 		else
-			colmap[tile_x][tile_y] = BLOCKS_ENTITIES;
+			setTileValue(tile_x, tile_y, BLOCKS_ENTITIES);
 	}
 
 }
@@ -520,8 +922,8 @@ void MapCollision::unblock(const float& map_x, const float& map_y) {
 	if (isTileOutsideMap(tile_x, tile_y))
 		return;
 
-	if (colmap[tile_x][tile_y] == BLOCKS_ENTITIES || colmap[tile_x][tile_y] == BLOCKS_ENEMIES) {
-		colmap[tile_x][tile_y] = BLOCKS_NONE;
+	if (colmap(tile_x, tile_y) == BLOCKS_ENTITIES || colmap(tile_x, tile_y) == BLOCKS_ENEMIES) {
+		setTileValue(tile_x, tile_y, BLOCKS_NONE);
 	}
 
 }
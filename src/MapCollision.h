@@ -26,21 +26,40 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #ifndef MAP_COLLISION_H
 #define MAP_COLLISION_H
 
+#include "AStarContainer.h"
 #include "CommonIncludes.h"
+#include "FlowField.h"
+#include "MapLayer.h"
+#include "MapVisibility.h"
+#include "PathHierarchy.h"
 #include "Utils.h"
 
-typedef std::vector< std::vector<unsigned short> > Map_Layer;
-
 class MapCollision {
 private:
 	static const float MIN_TILE_GAP;
+	static const Point NEIGHBOUR_OFFSETS[8];
+	static const float GRID_PATH_HEURISTIC_WEIGHT;
+	static const float JUMP_PATH_HEURISTIC_WEIGHT;
+	static const unsigned JUMP_PATH_SCANS_PER_NODE = 8; // tiles jumps may visit per node of the limit, like the 8 neighbours checked by an A* expansion
+	static const unsigned FLOW_FIELD_BUDGET = 4096; // tiles settled per flow field per frame
+	static const unsigned FLOW_FIELD_PATH_LENGTH = 8;
 
 	// collision check types
 	enum {
-		CHECK_MOVEMENT = 1,
-		CHECK_SIGHT = 2
+		CHECK_MOVEMENT = 1
 	};
 
+	// bits of the packed per-tile collision flags
+	enum {
+		FLAG_WALL = 1, // blocks sight and all non-intangible movement
+		FLAG_SOLID = 2, // blocks normal movement
+		FLAG_ENTITY = 4, // BLOCKS_ENTITIES
+		FLAG_ALLY = 8 // BLOCKS_ENEMIES
+	};
+
+	static uint8_t getTileFlags(unsigned short tile);
+	void setTileValue(const int& tile_x, const int& tile_y, unsigned short tile);
+
 	bool isTileOutsideMap(const int& tile_x, const int& tile_y) const;
 
 	bool lineCheck(const float& x1, const float& y1, const float& x2, const float& y2, int check_type, int movement_type);
@@ -56,16 +75,51 @@ private:
 
 	FPoint collisionToMap(const Point& p);
 
+	bool computeGridPath(const FPoint& start_pos, const FPoint& end_pos, std::vector<FPoint> &path, int movement_type, unsigned int limit);
+	bool computeJumpPath(const FPoint& start_pos, const FPoint& end_pos, std::vector<FPoint> &path, int movement_type, unsigned int limit);
+	bool computeHierarchicalPath(PathHierarchy* hierarchy, const FPoint& start_pos, const FPoint& end_pos, std::vector<FPoint> &path, int movement_type, bool jump_search);
+
+	bool isJumpTile(int x, int y, int movement_type) const;
+	int jump(int x, int y, int dx, int dy, const Point& end, int movement_type, unsigned& scan_budget) const;
+
 	bool has_empty_tile;
 
+	// collision flags for each tile, derived from colmap (index = y * map_size.x + x)
+	std::vector<uint8_t> colflags;
+
 	float raycast_resolution;
 	float raycast_resolution_recip;
 
+	// reused by computePath() so that path queries don't allocate memory
+	AStarContainer astar;
+	float diagonal_step_cost;
+	unsigned path_expansions; // running total of tiles closed by computePath(), used to budget path searches
+
+	// abstract graphs used to plan long paths. Intangible movement has no obstacles, so it doesn't need one
+	PathHierarchy hierarchy_normal;
+	PathHierarchy hierarchy_flying;
+	std::vector<Point> hierarchy_waypoints;
+	std::vector<FPoint> hierarchy_segment;
+
+	// distance fields toward the hero, shared by all entities chasing it
+	FlowField flow_field_normal;
+	FlowField flow_field_flying;
+
+	// sight-blocking bitmap and per-frame cache used by lineOfSight()
+	MapVisibility visibility;
+
 public:
 	// const flags
 	static const bool IS_ALLY = true;
 	static const int DEFAULT_PATH_LIMIT = 0;
 
+	// path search algorithms
+	enum {
+		PATH_ALGORITHM_DEFAULT = 0, // the one set by path_algorithm in the engine settings
+		PATH_ALGORITHM_ASTAR = 1,
+		PATH_ALGORITHM_JPS = 2
+	};
+
 	// collision type
 	enum {
 		COLLIDE_TYPE_NONE = 0,
@@ -99,20 +153,31 @@ public:
 	MapCollision();
 	~MapCollision();
 
-	void setMap(const Map_Layer& _colmap, unsigned short w, unsigned short h);
+	void setMap(const Map_Layer& _colmap);
 	bool move(float &x, float &y, float step_x, float step_y, int movement_type, int collide_type);
 
 	bool isOutsideMap(const float& tile_x, const float& tile_y) const;
 	bool isWall(const float& x, const float& y) const;
 
 	bool isValidPosition(const float& x, const float& y, int movement_type, int collide_type) const;
+	bool isValidStaticTile(const int& tile_x, const int& tile_y, int movement_type) const;
 
 	bool lineOfSight(const float& x1, const float& y1, const float& x2, const float& y2);
 	bool lineOfMovement(const float& x1, const float& y1, const float& x2, const float& y2, int movement_type);
 
 	bool isFacing(const float& x1, const float& y1, char direction, const float& x2, const float& y2);
 
-	bool computePath(const FPoint& start, const FPoint& end, std::vector<FPoint> &path, int movement_type, unsigned int limit);
+	bool computePath(const FPoint& start, const FPoint& end, std::vector<FPoint> &path, int movement_type, unsigned int limit, int algorithm = PATH_ALGORITHM_DEFAULT);
+	PathHierarchy* getPathHierarchy(int movement_type);
+	unsigned getPathExpansions() { return path_expansions; }
+
+	void updateFlowFields(const FPoint& target);
+	bool followFlowField(const FPoint& start_pos, std::vector<FPoint> &path, int movement_type);
+	FlowField* getFlowField(int movement_type);
+
+	MapVisibility* getVisibility() { return &visibility; }
+
+	void setTile(const int& tile_x, const int& tile_y, unsigned short tile_id);
 
 	void block(const float& map_x, const float& map_y, bool is_ally);
 	void unblock(const float& map_x, const float& map_y);
@@ -125,6 +190,7 @@ public:
 
 	bool hasEmptyTile() { return has_empty_tile; }
 
+	// read-only outside of this class. Use setTile(), block() and unblock() to change it, so that colflags stays in sync
 	Map_Layer colmap;
 	Point map_size;
 };
@@ -0,0 +1,55 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "MapLayer.h"
+
+Map_Layer::Map_Layer()
+	: tiles()
+	, width(0)
+	, height(0)
+{
+}
+
+Map_Layer::Map_Layer(unsigned short _width, unsigned short _height, unsigned short value)
+	: tiles()
+	, width(0)
+	, height(0)
+{
+	assign(_width, _height, value);
+}
+
+Map_Layer::~Map_Layer() {
+}
+
+/**
+ * Resizes the layer and sets every tile to value. Existing tiles are not preserved
+ */
+void Map_Layer::assign(unsigned short _width, unsigned short _height, unsigned short value) {
+	width = _width;
+	height = _height;
+	tiles.assign(static_cast<size_t>(width) * height, value);
+}
+
+void Map_Layer::fill(unsigned short value) {
+	tiles.assign(tiles.size(), value);
+}
+
+void Map_Layer::clear() {
+	tiles.clear();
+	width = 0;
+	height = 0;
+}
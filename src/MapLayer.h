@@ -0,0 +1,58 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class Map_Layer
+ *
+ * A 2D grid of tile values, stored in a single contiguous array in row-major order (index = y * width + x).
+ * Walking a row is a linear walk through memory, which matches the order that map layers are loaded and rendered.
+ *
+ * The accessors do not check bounds. Callers are expected to check against getWidth()/getHeight() where needed.
+ */
+
+#ifndef MAP_LAYER_H
+#define MAP_LAYER_H
+
+#include "CommonIncludes.h"
+
+class Map_Layer {
+public:
+	Map_Layer();
+	Map_Layer(unsigned short _width, unsigned short _height, unsigned short value);
+	~Map_Layer();
+
+	void assign(unsigned short _width, unsigned short _height, unsigned short value);
+	void fill(unsigned short value);
+	void clear();
+
+	unsigned short& operator()(size_t x, size_t y) { return tiles[y * width + x]; }
+	const unsigned short& operator()(size_t x, size_t y) const { return tiles[y * width + x]; }
+
+	unsigned short* getRow(size_t y) { return &tiles[y * width]; }
+	const unsigned short* getRow(size_t y) const { return &tiles[y * width]; }
+
+	unsigned short getWidth() const { return width; }
+	unsigned short getHeight() const { return height; }
+	bool empty() const { return tiles.empty(); }
+
+private:
+	std::vector<unsigned short> tiles;
+	unsigned short width;
+	unsigned short height;
+};
+
+#endif
@@ -0,0 +1,187 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "MapLayerCache.h"
+#include "RenderDevice.h"
+
+MapLayerCache::Chunk::Chunk()
+	: sprite(NULL)
+	, last_used(0)
+{
+}
+
+MapLayerCache::MapLayerCache()
+	: budget(0)
+	, memory_used(0)
+	, frame(1)
+	, frame_memory_used(0)
+	, hit_count(0)
+	, rebuild_count(0)
+	, evict_count(0)
+{
+}
+
+MapLayerCache::~MapLayerCache() {
+	clear();
+}
+
+/**
+ * Drops every chunk and resets the counters
+ */
+void MapLayerCache::clear() {
+	while (!chunks.empty()) {
+		erase(chunks.begin());
+	}
+
+	memory_used = 0;
+	frame_memory_used = 0;
+	hit_count = rebuild_count = evict_count = 0;
+}
+
+/**
+ * Sets the most memory the chunk images may take up. A budget of 0 disables the cache
+ */
+void MapLayerCache::setBudget(size_t bytes) {
+	if (bytes == budget)
+		return;
+
+	budget = bytes;
+	clear();
+}
+
+void MapLayerCache::nextFrame() {
+	frame++;
+	frame_memory_used = 0;
+}
+
+/**
+ * Returns the chunk that contains a pixel coordinate. Rounds down, since pixels can be left of or above the origin
+ */
+int MapLayerCache::toChunk(int pixel) {
+	if (pixel >= 0)
+		return pixel / CHUNK_SIZE;
+	return -((-pixel + CHUNK_SIZE - 1) / CHUNK_SIZE);
+}
+
+/**
+ * Chunk coordinates can be negative, so they are offset before being packed
+ */
+uint64_t MapLayerCache::getKey(size_t layer, int chunk_x, int chunk_y) {
+	return (static_cast<uint64_t>(layer) << 32) | (static_cast<uint64_t>((chunk_x + 0x8000) & 0xffff) << 16) | static_cast<uint64_t>((chunk_y + 0x8000) & 0xffff);
+}
+
+void MapLayerCache::erase(std::map<uint64_t, Chunk>::iterator it) {
+	if (it->second.sprite) {
+		memory_used -= static_cast<size_t>(CHUNK_SIZE * CHUNK_SIZE * 4);
+		delete it->second.sprite;
+	}
+	chunks.erase(it);
+}
+
+/**
+ * Looks up a chunk and marks it as used in this frame. Returns false if the chunk needs to be rendered.
+ * On success, sprite is the chunk image, or NULL if the chunk is empty
+ */
+bool MapLayerCache::get(size_t layer, int chunk_x, int chunk_y, Sprite** sprite) {
+	std::map<uint64_t, Chunk>::iterator it = chunks.find(getKey(layer, chunk_x, chunk_y));
+	if (it == chunks.end())
+		return false;
+
+	if (it->second.last_used != frame && it->second.sprite)
+		frame_memory_used += static_cast<size_t>(CHUNK_SIZE * CHUNK_SIZE * 4);
+
+	it->second.last_used = frame;
+	*sprite = it->second.sprite;
+	hit_count++;
+	return true;
+}
+
+/**
+ * Returns true if the budget has room for chunk_count more chunks next to the ones already used in this frame.
+ * Checked before a layer is drawn, so that a layer that doesn't fit isn't partly rendered again every frame
+ */
+bool MapLayerCache::canFit(size_t chunk_count) {
+	return frame_memory_used + chunk_count * static_cast<size_t>(CHUNK_SIZE * CHUNK_SIZE * 4) <= budget;
+}
+
+/**
+ * Makes room for one more chunk image, dropping the least recently used chunks if needed.
+ * Returns false if there is no room without dropping a chunk that is used in this frame
+ */
+bool MapLayerCache::reserve() {
+	const size_t chunk_bytes = static_cast<size_t>(CHUNK_SIZE * CHUNK_SIZE * 4);
+
+	while (memory_used + chunk_bytes > budget) {
+		std::map<uint64_t, Chunk>::iterator oldest = chunks.end();
+		for (std::map<uint64_t, Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+			if (it->second.sprite && it->second.last_used != frame && (oldest == chunks.end() || it->second.last_used < oldest->second.last_used))
+				oldest = it;
+		}
+
+		if (oldest == chunks.end())
+			return false;
+
+		erase(oldest);
+		evict_count++;
+	}
+
+	return true;
+}
+
+/**
+ * Adds a newly rendered chunk. The cache takes ownership of the sprite, which may be NULL for an empty chunk.
+ * reserve() must have been called first for a chunk with a sprite
+ */
+void MapLayerCache::store(size_t layer, int chunk_x, int chunk_y, Sprite* sprite) {
+	Chunk& chunk = chunks[getKey(layer, chunk_x, chunk_y)];
+	if (chunk.sprite) {
+		memory_used -= static_cast<size_t>(CHUNK_SIZE * CHUNK_SIZE * 4);
+		delete chunk.sprite;
+	}
+
+	chunk.sprite = sprite;
+	chunk.last_used = frame;
+	if (sprite) {
+		memory_used += static_cast<size_t>(CHUNK_SIZE * CHUNK_SIZE * 4);
+		frame_memory_used += static_cast<size_t>(CHUNK_SIZE * CHUNK_SIZE * 4);
+	}
+
+	rebuild_count++;
+}
+
+/**
+ * Drops the chunks of the first layer_count layers that overlap an area of the map's pixel space
+ */
+void MapLayerCache::invalidate(size_t layer_count, const Rect& area) {
+	if (chunks.empty())
+		return;
+
+	const int x0 = toChunk(area.x);
+	const int y0 = toChunk(area.y);
+	const int x1 = toChunk(area.x + area.w);
+	const int y1 = toChunk(area.y + area.h);
+
+	for (size_t layer = 0; layer < layer_count; ++layer) {
+		for (int chunk_y = y0; chunk_y <= y1; ++chunk_y) {
+			for (int chunk_x = x0; chunk_x <= x1; ++chunk_x) {
+				std::map<uint64_t, Chunk>::iterator it = chunks.find(getKey(layer, chunk_x, chunk_y));
+				if (it != chunks.end())
+					erase(it);
+			}
+		}
+	}
+}
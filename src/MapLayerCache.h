@@ -0,0 +1,92 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class MapLayerCache
+ *
+ * Holds pre-rendered chunks of the map layers that are drawn below the object layer.
+ *
+ * Chunks are square areas of the map's pixel space, which is the screen space with the top corner of tile (0, 0) at
+ * the origin. So a chunk covers the same tiles no matter where the camera is. Each chunk of each layer is stored as
+ * one image, or as nothing if no tile reaches into it.
+ *
+ * The total size of the images is kept within a memory budget. When a new chunk doesn't fit, the chunks that were
+ * used least recently are dropped, but never the ones that were used in the current frame.
+ */
+
+#ifndef MAP_LAYER_CACHE_H
+#define MAP_LAYER_CACHE_H
+
+#include "CommonIncludes.h"
+#include "Utils.h"
+
+class Sprite;
+
+class MapLayerCache {
+public:
+	// width and height of a chunk, in pixels
+	static const int CHUNK_SIZE = 256;
+
+private:
+	class Chunk {
+	public:
+		Sprite* sprite;
+		unsigned last_used;
+		Chunk();
+	};
+
+	static uint64_t getKey(size_t layer, int chunk_x, int chunk_y);
+	void erase(std::map<uint64_t, Chunk>::iterator it);
+
+	std::map<uint64_t, Chunk> chunks;
+
+	size_t budget;
+	size_t memory_used;
+	unsigned frame;
+	size_t frame_memory_used;
+
+	unsigned hit_count;
+	unsigned rebuild_count;
+	unsigned evict_count;
+
+public:
+	MapLayerCache();
+	~MapLayerCache();
+
+	void clear();
+	void setBudget(size_t bytes);
+	void nextFrame();
+
+	static int toChunk(int pixel);
+
+	bool get(size_t layer, int chunk_x, int chunk_y, Sprite** sprite);
+	bool canFit(size_t chunk_count);
+	bool reserve();
+	void store(size_t layer, int chunk_x, int chunk_y, Sprite* sprite);
+	void invalidate(size_t layer_count, const Rect& area);
+
+	bool isEnabled() { return budget > 0; }
+
+	// counters since the cache was last cleared
+	unsigned getHitCount() { return hit_count; }
+	unsigned getRebuildCount() { return rebuild_count; }
+	unsigned getEvictCount() { return evict_count; }
+	size_t getChunkCount() { return chunks.size(); }
+	size_t getMemoryUsed() { return memory_used; }
+};
+
+#endif
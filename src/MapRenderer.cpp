@@ -53,6 +53,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "Utils.h"
 #include "UtilsFileSystem.h"
 #include "UtilsMath.h"
+#include "WidgetLabel.h"
 #include "WidgetTooltip.h"
 
 #include <stdint.h>
@@ -65,6 +66,8 @@ MapRenderer::MapRenderer()
 	, tip_pos()
 	, show_tooltip(false)
 	, drawn_hero(false)
+	, sort_ticks(0)
+	, label_sort_stats(NULL)
 	, cam()
 	, map_change(false)
 	, teleportation(false)
@@ -189,6 +192,10 @@ int MapRenderer::load(const std::string& fname) {
 	// clear combat text
 	comb->clear();
 
+	// the first frame of the new map has nothing in common with the last frame of the old one
+	render_order.clear();
+	render_order_dead.clear();
+
 	show_tooltip = false;
 	is_spawn_map = (fname == "maps/spawn.txt");
 
@@ -198,13 +205,11 @@ int MapRenderer::load(const std::string& fname) {
 
 	for (unsigned i = 0; i < layers.size(); ++i) {
 		if (layernames[i] == "collision") {
-			short width = static_cast<short>(layers[i].size());
-			if (width == 0) {
+			if (layers[i].getWidth() == 0) {
 				Utils::logError("MapRenderer: Map width is 0. Can't set collision layer.");
 				break;
 			}
-			short height = static_cast<short>(layers[i][0].size());
-			collider.setMap(layers[i], width, height);
+			collider.setMap(layers[i]);
 			removeLayer(i);
 		}
 	}
@@ -228,9 +233,9 @@ int MapRenderer::load(const std::string& fname) {
 
 	std::vector<unsigned> corrupted;
 	for (unsigned i = 0; i < layers.size(); ++i) {
-		for (unsigned x = 0; x < layers[i].size(); ++x) {
-			for (unsigned y = 0; y < layers[i][x].size(); ++y) {
-				const unsigned tile_id = layers[i][x][y];
+		for (unsigned y = 0; y < layers[i].getHeight(); ++y) {
+			for (unsigned x = 0; x < layers[i].getWidth(); ++x) {
+				const unsigned tile_id = layers[i](x, y);
 				TileSet* tile_set = &tset;
 
 				if (fogofwar == FogOfWar::TYPE_OVERLAY) {
@@ -245,7 +250,7 @@ int MapRenderer::load(const std::string& fname) {
 					if (std::find(corrupted.begin(), corrupted.end(), tile_id) == corrupted.end()) {
 						corrupted.push_back(tile_id);
 					}
-					layers[i][x][y] = 0;
+					layers[i](x, y) = 0;
 				}
 			}
 		}
@@ -263,7 +268,13 @@ int MapRenderer::load(const std::string& fname) {
 
 	render_device->setBackgroundColor(background_color);
 
-	drawn_tiles = Map_Layer(w, std::vector<unsigned short>(h, 0));
+	drawn_tiles.assign(w, h, 0);
+
+	layer_cache.clear();
+	layer_cache_static.assign(layers.size(), true);
+
+	if (fogofwar)
+		fow->calcOcclusion(tset);
 
 	return 0;
 }
@@ -328,10 +339,6 @@ void MapRenderer::logic(bool paused) {
 	cam.logic();
 }
 
-bool priocompare(const Renderable &r1, const Renderable &r2) {
-	return r1.prio < r2.prio;
-}
-
 /**
  * Sort in the same order as the tiles are drawn
  * Depends upon the map implementation
@@ -357,6 +364,13 @@ void calculatePriosOrtho(std::vector<Renderable> &r) {
 
 void MapRenderer::render(std::vector<Renderable> &r, std::vector<Renderable> &r_dead) {
 	drawn_hero = false;
+	render_device->setDrawCategory(RenderDevice::DRAW_MAP);
+
+	// chunk images may be lost when the window changes
+	if (inpt->window_resized)
+		invalidateLayerCache();
+	layer_cache.setBudget(static_cast<size_t>(std::max(settings->layer_cache_size, 0)) * 1024 * 1024);
+	layer_cache.nextFrame();
 
 	map_parallax.render(cam.shake, "");
 
@@ -386,33 +400,250 @@ void MapRenderer::render(std::vector<Renderable> &r, std::vector<Renderable> &r_
 	if (eset->tileset.orientation == eset->tileset.TILESET_ORTHOGONAL) {
 		calculatePriosOrtho(r);
 		calculatePriosOrtho(r_dead);
-		std::sort(r.begin(), r.end(), priocompare);
-		std::sort(r_dead.begin(), r_dead.end(), priocompare);
-		renderOrtho(r, r_dead);
 	}
 	else {
 		calculatePriosIso(r);
 		calculatePriosIso(r_dead);
-		std::sort(r.begin(), r.end(), priocompare);
-		std::sort(r_dead.begin(), r_dead.end(), priocompare);
-		renderIso(r, r_dead);
 	}
+
+	uint64_t start_ticks = SDL_GetPerformanceCounter();
+	render_order.sort(r);
+	render_order_dead.sort(r_dead);
+	sort_ticks = SDL_GetPerformanceCounter() - start_ticks;
+
+	if (eset->tileset.orientation == eset->tileset.TILESET_ORTHOGONAL)
+		renderOrtho(render_order.list, render_order_dead.list);
+	else
+		renderIso(render_order.list, render_order_dead.list);
+
+	render_device->setDrawCategory(RenderDevice::DRAW_MENU);
 }
 
-void MapRenderer::drawRenderable(std::vector<Renderable>::iterator r_cursor) {
-	if (r_cursor->image != NULL) {
+void MapRenderer::drawRenderable(Renderable* r) {
+	if (r->image != NULL) {
 		Rect dest;
-		Point p = Utils::mapToScreen(r_cursor->map_pos.x, r_cursor->map_pos.y, cam.shake.x, cam.shake.y);
-		dest.x = p.x - r_cursor->offset.x;
-		dest.y = p.y - r_cursor->offset.y;
-		render_device->render(*r_cursor, dest);
+		Point p = Utils::mapToScreen(r->map_pos.x, r->map_pos.y, cam.shake.x, cam.shake.y);
+		dest.x = p.x - r->offset.x;
+		dest.y = p.y - r->offset.y;
+
+		if (r->type == Renderable::TYPE_LOOT)
+			render_device->setDrawCategory(RenderDevice::DRAW_LOOT);
+		else if (r->type == Renderable::TYPE_HAZARD)
+			render_device->setDrawCategory(RenderDevice::DRAW_HAZARD);
+		else
+			render_device->setDrawCategory(RenderDevice::DRAW_ENTITY);
+
+		render_device->render(*r, dest);
+		render_device->setDrawCategory(RenderDevice::DRAW_MAP);
 
-		if (r_cursor->type == Renderable::TYPE_HERO) {
+		if (r->type == Renderable::TYPE_HERO) {
 			drawn_hero = true;
 		}
 	}
 }
 
+/**
+ * Returns the position of a tile's center in the map's pixel space, which has the top corner of tile (0, 0) at its
+ * origin. Adding mapToScreen(0, 0) gives the same screen position that renderIsoLayer() and renderOrthoLayer() use
+ */
+Point MapRenderer::getTilePixelPos(int x, int y) {
+	Point p;
+	if (eset->tileset.orientation == eset->tileset.TILESET_ORTHOGONAL) {
+		p.x = x * eset->tileset.tile_w;
+		p.y = y * eset->tileset.tile_h;
+	}
+	else {
+		p.x = (x - y) * eset->tileset.tile_w_half;
+		p.y = (x + y) * eset->tileset.tile_h_half;
+	}
+	return centerTile(p);
+}
+
+/**
+ * Returns true if all four corners of the tile at (x, y), drawn at dest, are under hidden fog of war tiles
+ * Deep inside hidden areas, the fog of war occlusion mask answers this without looking at the corners
+ */
+bool MapRenderer::isTileHiddenByFow(const int_fast16_t x, const int_fast16_t y, const Tile_Def& tile, const Point& dest) {
+	const Map_Layer& dark_layer = layers[fow->dark_layer_id];
+	if (dark_layer(x, y) != FogOfWar::TILE_HIDDEN)
+		return false;
+
+	if (fow->isOccluded(x, y))
+		return true;
+
+	const Rect clip = tile.tile->getClip();
+
+	const Point corners[4] = {
+		Point(dest.x, dest.y),
+		Point(dest.x + clip.w, dest.y),
+		Point(dest.x, dest.y + clip.h),
+		Point(dest.x + clip.w, dest.y + clip.h)
+	};
+
+	for (int k = 0; k < 4; ++k) {
+		Point p(Utils::screenToMap(corners[k].x, corners[k].y, cam.shake.x, cam.shake.y));
+
+		//limit to map bounds
+		p.x = std::max(0, std::min(p.x, w-1));
+		p.y = std::max(0, std::min(p.y, h-1));
+
+		if (dark_layer(p.x, p.y) != FogOfWar::TILE_HIDDEN)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Draws a layer below the object layer using pre-rendered chunks. Missing chunks are rendered first.
+ * Returns false without drawing anything if the layer has to be drawn tile by tile instead
+ */
+bool MapRenderer::renderCachedLayer(size_t index) {
+	// tinted tiles change color as the hero moves, which the chunk images can't show
+	if (!layer_cache.isEnabled() || fogofwar == FogOfWar::TYPE_TINT || index >= layer_cache_static.size() || !layer_cache_static[index])
+		return false;
+
+	const int chunk_size = MapLayerCache::CHUNK_SIZE;
+	const Point origin = Utils::mapToScreen(0, 0, cam.shake.x, cam.shake.y);
+	const int chunk_x0 = MapLayerCache::toChunk(-origin.x);
+	const int chunk_y0 = MapLayerCache::toChunk(-origin.y);
+	const int chunk_x1 = MapLayerCache::toChunk(settings->view_w - 1 - origin.x);
+	const int chunk_y1 = MapLayerCache::toChunk(settings->view_h - 1 - origin.y);
+
+	if (!layer_cache.canFit(static_cast<size_t>((chunk_x1 - chunk_x0 + 1) * (chunk_y1 - chunk_y0 + 1))))
+		return false;
+
+	std::vector<Sprite*> chunk_sprites;
+	std::vector<Point> chunk_pos;
+
+	for (int chunk_y = chunk_y0; chunk_y <= chunk_y1; ++chunk_y) {
+		for (int chunk_x = chunk_x0; chunk_x <= chunk_x1; ++chunk_x) {
+			Sprite* sprite = NULL;
+			if (!layer_cache.get(index, chunk_x, chunk_y, &sprite) && !renderLayerChunk(index, chunk_x, chunk_y, &sprite))
+				return false;
+
+			if (sprite) {
+				chunk_sprites.push_back(sprite);
+				chunk_pos.push_back(Point(origin.x + chunk_x * chunk_size, origin.y + chunk_y * chunk_size));
+			}
+		}
+	}
+
+	for (size_t i = 0; i < chunk_sprites.size(); ++i) {
+		chunk_sprites[i]->setDestFromPoint(chunk_pos[i]);
+		render_device->render(chunk_sprites[i]);
+	}
+
+	return true;
+}
+
+/**
+ * Draws the tiles of a layer that reach into a chunk onto a new image, in the same order as renderIsoLayer() and
+ * renderOrthoLayer(), and stores it in the cache. Returns false if the chunk can't be cached
+ */
+bool MapRenderer::renderLayerChunk(size_t index, int chunk_x, int chunk_y, Sprite** sprite) {
+	const Map_Layer& layerdata = layers[index];
+	const int chunk_size = MapLayerCache::CHUNK_SIZE;
+	const Rect chunk_area(chunk_x * chunk_size, chunk_y * chunk_size, chunk_size, chunk_size);
+	const Point origin = Utils::mapToScreen(0, 0, cam.shake.x, cam.shake.y);
+	const bool is_ortho = (eset->tileset.orientation == eset->tileset.TILESET_ORTHOGONAL);
+
+	// tiles can reach past their own cell by up to the size of the largest tile
+	const float margin_x = static_cast<float>((tset.max_size_x + 1) * eset->tileset.tile_w);
+	const float margin_y = static_cast<float>((tset.max_size_y + 1) * eset->tileset.tile_h);
+	const float left = static_cast<float>(chunk_area.x) - margin_x;
+	const float right = static_cast<float>(chunk_area.x + chunk_area.w) + margin_x;
+	const float top = static_cast<float>(chunk_area.y) - margin_y;
+	const float bottom = static_cast<float>(chunk_area.y + chunk_area.h) + margin_y;
+
+	// rows and columns to check. For isometric maps, rows are x+y and columns are x-y
+	int row_min, row_max, col_min, col_max;
+	if (is_ortho) {
+		row_min = std::max(0, static_cast<int>(floorf(top / eset->tileset.tile_h)));
+		row_max = std::min(h-1, static_cast<int>(floorf(bottom / eset->tileset.tile_h)));
+		col_min = std::max(0, static_cast<int>(floorf(left / eset->tileset.tile_w)));
+		col_max = std::min(w-1, static_cast<int>(floorf(right / eset->tileset.tile_w)));
+	}
+	else {
+		row_min = std::max(0, static_cast<int>(floorf(top / eset->tileset.tile_h_half)));
+		row_max = std::min(w+h-2, static_cast<int>(floorf(bottom / eset->tileset.tile_h_half)));
+		col_min = std::max(-(h-1), static_cast<int>(floorf(left / eset->tileset.tile_w_half)));
+		col_max = std::min(w-1, static_cast<int>(floorf(right / eset->tileset.tile_w_half)));
+	}
+
+	Image* image = NULL;
+
+	for (int row = row_min; row <= row_max; ++row) {
+		for (int col = col_min; col <= col_max; ++col) {
+			int i = col;
+			int j = row;
+			if (!is_ortho) {
+				if ((row + col) % 2 != 0)
+					continue;
+				i = (row + col) / 2;
+				j = (row - col) / 2;
+				if (i < 0 || j < 0 || i >= w || j >= h)
+					continue;
+			}
+
+			const unsigned short current_tile = layerdata(i, j);
+			if (!current_tile)
+				continue;
+
+			const Tile_Def &tile = tset.tiles[current_tile];
+			if (!tile.tile)
+				continue;
+
+			if (tset.isAnimated(current_tile)) {
+				layer_cache_static[index] = false;
+				if (image)
+					image->unref();
+				return false;
+			}
+
+			const Point center = getTilePixelPos(i, j);
+			Rect clip = tile.tile->getClip();
+			Rect dest(center.x - tile.offset.x, center.y - tile.offset.y, clip.w, clip.h);
+
+			if (dest.x >= chunk_area.x + chunk_area.w || dest.x + dest.w <= chunk_area.x || dest.y >= chunk_area.y + chunk_area.h || dest.y + dest.h <= chunk_area.y)
+				continue;
+
+			//skip rendering tiles that are underneath fow hidden tiles
+			if (fogofwar == FogOfWar::TYPE_OVERLAY && isTileHiddenByFow(i, j, tile, Point(origin.x + dest.x, origin.y + dest.y)))
+				continue;
+
+			if (!image) {
+				if (!layer_cache.reserve())
+					return false;
+
+				image = render_device->createImage(chunk_size, chunk_size);
+				if (!image)
+					return false;
+			}
+
+			dest.x -= chunk_area.x;
+			dest.y -= chunk_area.y;
+			render_device->renderToImage(tile.tile->getGraphics(), clip, image, dest);
+		}
+	}
+
+	// the tiles were blended onto a clear image, so the chunk has to be drawn as premultiplied alpha
+	if (image && !render_device->finishComposedImage(image)) {
+		layer_cache_static[index] = false;
+		image->unref();
+		return false;
+	}
+
+	*sprite = NULL;
+	if (image) {
+		*sprite = image->createSprite();
+		image->unref();
+	}
+
+	layer_cache.store(index, chunk_x, chunk_y, *sprite);
+	return true;
+}
+
 void MapRenderer::renderIsoLayer(const Map_Layer& layerdata, const TileSet& tile_set) {
 	int_fast16_t i; // first index of the map array
 	int_fast16_t j; // second index of the map array
@@ -456,7 +687,7 @@ void MapRenderer::renderIsoLayer(const Map_Layer& layerdata, const TileSet& tile
 			++tiles_width;
 			p.x += eset->tileset.tile_w;
 
-			if (const uint_fast16_t current_tile = layerdata[i][j]) {
+			if (const uint_fast16_t current_tile = layerdata(i, j)) {
 				const Tile_Def &tile = tile_set.tiles[current_tile];
 				if (tile.tile) {
 					dest.x = p.x - tile.offset.x;
@@ -465,44 +696,8 @@ void MapRenderer::renderIsoLayer(const Map_Layer& layerdata, const TileSet& tile
 					//skip rendering tiles that are underneath fow hidden tiles
 					if (fogofwar == FogOfWar::TYPE_OVERLAY) {
 						if (&layerdata != &layers[fow->dark_layer_id]) {
-							if (layers[fow->dark_layer_id][i][j] == FogOfWar::TILE_HIDDEN) {
-
-								//check tile's corners
-								Point t_l(Utils::screenToMap(dest.x, dest.y, cam.shake.x, cam.shake.y));
-								Point t_r(Utils::screenToMap(dest.x + tile.tile->getClip().w, dest.y, cam.shake.x, cam.shake.y));
-								Point b_l(Utils::screenToMap(dest.x, dest.y + tile.tile->getClip().h, cam.shake.x, cam.shake.y));
-								Point b_r(Utils::screenToMap(dest.x + tile.tile->getClip().w, dest.y + tile.tile->getClip().h, cam.shake.x, cam.shake.y));
-
-								//limit to map bounds
-								if (t_l.x < 0) t_l.x = 0;
-								if (t_l.x >= w) t_l.x = w-1;
-								if (t_l.y < 0) t_l.y = 0;
-								if (t_l.y >= h) t_l.y = h-1;
-
-								if (t_r.x < 0) t_r.x = 0;
-								if (t_r.x >= w) t_r.x = w-1;
-								if (t_r.y < 0) t_r.y = 0;
-								if (t_r.y >= h) t_r.y = h-1;
-
-								if (b_l.x < 0) b_l.x = 0;
-								if (b_l.x >= w) b_l.x = w-1;
-								if (b_l.y < 0) b_l.y = 0;
-								if (b_l.y >= h) b_l.y = h-1;
-
-								if (b_r.x < 0) b_r.x = 0;
-								if (b_r.x >= w) b_r.x = w-1;
-								if (b_r.y < 0) b_r.y = 0;
-								if (b_r.y >= h) b_r.y = h-1;
-
-								if (layers[fow->dark_layer_id][t_l.x][t_l.y] == FogOfWar::TILE_HIDDEN) {
-									if (layers[fow->dark_layer_id][t_r.x][t_r.y] == FogOfWar::TILE_HIDDEN) {
-										if (layers[fow->dark_layer_id][b_l.x][b_l.y] == FogOfWar::TILE_HIDDEN) {
-											if (layers[fow->dark_layer_id][b_r.x][b_r.y] == FogOfWar::TILE_HIDDEN) {
-												continue;
-											}
-										}
-									}
-								}
+							if (isTileHiddenByFow(i, j, tile, dest)) {
+								continue;
 							}
 						}
 					}
@@ -531,27 +726,26 @@ void MapRenderer::renderIsoLayer(const Map_Layer& layerdata, const TileSet& tile
 	}
 }
 
-void MapRenderer::renderIsoBackObjects(std::vector<Renderable> &r) {
-	std::vector<Renderable>::iterator it;
-	for (it = r.begin(); it != r.end(); ++it)
-		drawRenderable(it);
+void MapRenderer::renderIsoBackObjects(std::vector<Renderable*> &r) {
+	for (size_t i = 0; i < r.size(); ++i)
+		drawRenderable(r[i]);
 }
 
-void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
+void MapRenderer::renderIsoFrontObjects(std::vector<Renderable*> &r) {
 	Point dest;
 
 	const Point upperleft(Utils::screenToMap(0, 0, cam.shake.x, cam.shake.y));
 	const int_fast16_t max_tiles_width = static_cast<int_fast16_t>((settings->view_w / eset->tileset.tile_w) + 2 * tset.max_size_x);
 	const int_fast16_t max_tiles_height = static_cast<int_fast16_t>(((settings->view_h / eset->tileset.tile_h) + 2 * tset.max_size_y)*2);
 
-	std::vector<Renderable>::iterator r_cursor = r.begin();
-	std::vector<Renderable>::iterator r_end = r.end();
+	std::vector<Renderable*>::iterator r_cursor = r.begin();
+	std::vector<Renderable*>::iterator r_end = r.end();
 
 	// object layer
 	int_fast16_t j = static_cast<int_fast16_t>(upperleft.y - tset.max_size_y + tset.max_size_x);
 	int_fast16_t i = static_cast<int_fast16_t>(upperleft.x - tset.max_size_y - tset.max_size_x);
 
-	while (r_cursor != r_end && (static_cast<int>(r_cursor->map_pos.x) + static_cast<int>(r_cursor->map_pos.y) < i + j || static_cast<int>(r_cursor->map_pos.x) < i)) // implicit floor
+	while (r_cursor != r_end && (static_cast<int>((*r_cursor)->map_pos.x) + static_cast<int>((*r_cursor)->map_pos.y) < i + j || static_cast<int>((*r_cursor)->map_pos.x) < i)) // implicit floor
 		++r_cursor;
 
 	if (index_objectlayer >= layers.size())
@@ -568,11 +762,7 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 		render_behind_none.pop();
 	}
 
-	for (size_t dtw = 0; dtw < w; ++dtw) {
-		for (size_t dth = 0; dth < h; ++dth) {
-			drawn_tiles[dtw][dth] = 0;
-		}
-	}
+	drawn_tiles.fill(0);
 
 	for (uint_fast16_t y = max_tiles_height ; y; --y) {
 		int_fast16_t tiles_width = 0;
@@ -603,10 +793,10 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 
 			bool draw_tile = true;
 
-			std::vector<Renderable>::iterator r_pre_cursor = r_cursor;
+			std::vector<Renderable*>::iterator r_pre_cursor = r_cursor;
 			while (r_pre_cursor != r_end) {
-				int r_cursor_x = static_cast<int>(r_pre_cursor->map_pos.x);
-				int r_cursor_y = static_cast<int>(r_pre_cursor->map_pos.y);
+				int r_cursor_x = static_cast<int>((*r_pre_cursor)->map_pos.x);
+				int r_cursor_y = static_cast<int>((*r_pre_cursor)->map_pos.y);
 
 				if ((r_cursor_x-1 == i && r_cursor_y+1 == j) || (r_cursor_x+1 == i && r_cursor_y-1 == j)) {
 					draw_tile = false;
@@ -618,8 +808,8 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 				++r_pre_cursor;
 			}
 
-			if (draw_tile && !drawn_tiles[i][j]) {
-				if (const uint_fast16_t current_tile = current_layer[i][j]) {
+			if (draw_tile && !drawn_tiles(i, j)) {
+				if (const uint_fast16_t current_tile = current_layer(i, j)) {
 					const Tile_Def &tile = tset.tiles[current_tile];
 					if (tile.tile) {
 						dest.x = p.x - tile.offset.x;
@@ -629,44 +819,8 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 						//skip rendering tiles that are underneath fow hidden tiles
 						if (fogofwar == FogOfWar::TYPE_OVERLAY) {
 							if (&current_layer != &layers[fow->dark_layer_id]) {
-								if (layers[fow->dark_layer_id][i][j] == FogOfWar::TILE_HIDDEN) {
-
-									//check tile's corners
-									Point t_l(Utils::screenToMap(dest.x, dest.y, cam.shake.x, cam.shake.y));
-									Point t_r(Utils::screenToMap(dest.x + tile.tile->getClip().w, dest.y, cam.shake.x, cam.shake.y));
-									Point b_l(Utils::screenToMap(dest.x, dest.y + tile.tile->getClip().h, cam.shake.x, cam.shake.y));
-									Point b_r(Utils::screenToMap(dest.x + tile.tile->getClip().w, dest.y + tile.tile->getClip().h, cam.shake.x, cam.shake.y));
-
-									//limit to map bounds
-									if (t_l.x < 0) t_l.x = 0;
-									if (t_l.x >= w) t_l.x = w-1;
-									if (t_l.y < 0) t_l.y = 0;
-									if (t_l.y >= h) t_l.y = h-1;
-
-									if (t_r.x < 0) t_r.x = 0;
-									if (t_r.x >= w) t_r.x = w-1;
-									if (t_r.y < 0) t_r.y = 0;
-									if (t_r.y >= h) t_r.y = h-1;
-
-									if (b_l.x < 0) b_l.x = 0;
-									if (b_l.x >= w) b_l.x = w-1;
-									if (b_l.y < 0) b_l.y = 0;
-									if (b_l.y >= h) b_l.y = h-1;
-
-									if (b_r.x < 0) b_r.x = 0;
-									if (b_r.x >= w) b_r.x = w-1;
-									if (b_r.y < 0) b_r.y = 0;
-									if (b_r.y >= h) b_r.y = h-1;
-
-									if (layers[fow->dark_layer_id][t_l.x][t_l.y] == FogOfWar::TILE_HIDDEN) {
-										if (layers[fow->dark_layer_id][t_r.x][t_r.y] == FogOfWar::TILE_HIDDEN) {
-											if (layers[fow->dark_layer_id][b_l.x][b_l.y] == FogOfWar::TILE_HIDDEN) {
-												if (layers[fow->dark_layer_id][b_r.x][b_r.y] == FogOfWar::TILE_HIDDEN) {
-													continue;
-												}
-											}
-										}
-									}
+								if (isTileHiddenByFow(i, j, tile, dest)) {
+									continue;
 								}
 							}
 						}
@@ -679,7 +833,7 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 							fadeOverlapTile(tile, i, j, current_layer);
 						}
 						render_device->render(tile.tile);
-						drawn_tiles[i][j] = 1;
+						drawn_tiles(i, j) = 1;
 					}
 				}
 			}
@@ -705,18 +859,18 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 
 			while (r_cursor != r_end) {
 				// implicit floor by int cast
-				int r_cursor_x = static_cast<int>(r_cursor->map_pos.x);
-				int r_cursor_y = static_cast<int>(r_cursor->map_pos.y);
+				int r_cursor_x = static_cast<int>((*r_cursor)->map_pos.x);
+				int r_cursor_y = static_cast<int>((*r_cursor)->map_pos.y);
 
 				if (r_cursor_x+1 == i && r_cursor_y-1 == j) {
 					draw_SW_tile = true;
 
 					// r_cursor left/right side
-					Point r_cursor_left = Utils::mapToScreen(r_cursor->map_pos.x, r_cursor->map_pos.y, cam.shake.x, cam.shake.y);
-					r_cursor_left.y -= r_cursor->offset.y;
+					Point r_cursor_left = Utils::mapToScreen((*r_cursor)->map_pos.x, (*r_cursor)->map_pos.y, cam.shake.x, cam.shake.y);
+					r_cursor_left.y -= (*r_cursor)->offset.y;
 					Point r_cursor_right = r_cursor_left;
-					r_cursor_left.x -= r_cursor->offset.x;
-					r_cursor_right.x += r_cursor->src.w - r_cursor->offset.x;
+					r_cursor_left.x -= (*r_cursor)->offset.x;
+					r_cursor_right.x += (*r_cursor)->src.w - (*r_cursor)->offset.x;
 
 					bool is_behind_SW = false;
 					bool is_behind_NE = false;
@@ -724,7 +878,7 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 					// HACK: the code here that determines if a Renderable is going to be behind the SW or NE tile does not account for entities that are made up of multiple Renderables
 					// this primarily affects the player, who is made up of several pieces of equipment. So we use the hero_bounds rect here to make sure our test encompasses the entire sprite
 					// HOWEVER, non-player characters also support multiple layers, so this "fix" is incomplete
-					if (r_cursor->type == Renderable::TYPE_HERO) {
+					if ((*r_cursor)->type == Renderable::TYPE_HERO) {
 						r_cursor_left.x = hero_bounds.x;
 						r_cursor_left.y = hero_bounds.y + hero_bounds.h;
 
@@ -743,11 +897,11 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 					}
 
 					if (is_behind_SW)
-						render_behind_SW.push(r_cursor);
+						render_behind_SW.push(*r_cursor);
 					else if (is_behind_NE)
-						render_behind_NE.push(r_cursor);
+						render_behind_NE.push(*r_cursor);
 					else
-						render_behind_none.push(r_cursor);
+						render_behind_none.push(*r_cursor);
 
 					++r_cursor;
 				}
@@ -762,8 +916,8 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 			}
 
 			// draw the south-west tile
-			if (draw_SW_tile && i-2 >= 0 && j+2 < h && !drawn_tiles[i-2][j+2]) {
-				if (const uint_fast16_t current_tile = current_layer[i-2][j+2]) {
+			if (draw_SW_tile && i-2 >= 0 && j+2 < h && !drawn_tiles(i-2, j+2)) {
+				if (const uint_fast16_t current_tile = current_layer(i-2, j+2)) {
 					const Tile_Def &tile = tset.tiles[current_tile];
 					if (tile.tile) {
 						dest.x = tile_SW_center.x - tile.offset.x;
@@ -777,7 +931,7 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 							fadeOverlapTile(tile, i-2, j+2, current_layer);
 						}
 						render_device->render(tile.tile);
-						drawn_tiles[i-2][j+2] = 1;
+						drawn_tiles(i-2, j+2) = 1;
 					}
 				}
 			}
@@ -788,8 +942,8 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 			}
 
 			// draw the north-east tile
-			if (!draw_tile && i < w && j < h && !drawn_tiles[i][j]) {
-				if (const uint_fast16_t current_tile = current_layer[i][j]) {
+			if (!draw_tile && i < w && j < h && !drawn_tiles(i, j)) {
+				if (const uint_fast16_t current_tile = current_layer(i, j)) {
 					const Tile_Def &tile = tset.tiles[current_tile];
 					if (tile.tile) {
 						dest.x = tile_NE_center.x - tile.offset.x;
@@ -803,7 +957,7 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 							fadeOverlapTile(tile, i, j, current_layer);
 						}
 						render_device->render(tile.tile);
-						drawn_tiles[i][j] = 1;
+						drawn_tiles(i, j) = 1;
 					}
 				}
 			}
@@ -820,16 +974,17 @@ void MapRenderer::renderIsoFrontObjects(std::vector<Renderable> &r) {
 		else
 			j++;
 
-		while (r_cursor != r_end && (static_cast<int>(r_cursor->map_pos.x) + static_cast<int>(r_cursor->map_pos.y) < i + j || static_cast<int>(r_cursor->map_pos.x) <= i)) // implicit floor by int cast
+		while (r_cursor != r_end && (static_cast<int>((*r_cursor)->map_pos.x) + static_cast<int>((*r_cursor)->map_pos.y) < i + j || static_cast<int>((*r_cursor)->map_pos.x) <= i)) // implicit floor by int cast
 			++r_cursor;
 	}
 }
 
-void MapRenderer::renderIso(std::vector<Renderable> &r, std::vector<Renderable> &r_dead) {
+void MapRenderer::renderIso(std::vector<Renderable*> &r, std::vector<Renderable*> &r_dead) {
 	size_t index = 0;
 
 	while (index < index_objectlayer) {
-		renderIsoLayer(layers[index], tset);
+		if (!renderCachedLayer(index))
+			renderIsoLayer(layers[index], tset);
 		map_parallax.render(cam.shake, layernames[index]);
 		index++;
 	}
@@ -882,7 +1037,7 @@ void MapRenderer::renderOrthoLayer(const Map_Layer& layerdata, const TileSet& ti
 		p = centerTile(p);
 		for (i = starti; i < max_tiles_width; i++) {
 
-			if (const unsigned short current_tile = layerdata[i][j]) {
+			if (const unsigned short current_tile = layerdata(i, j)) {
 				const Tile_Def &tile = tile_set.tiles[current_tile];
 				if (tile.tile) {
 					dest.x = p.x - tile.offset.x;
@@ -893,44 +1048,8 @@ void MapRenderer::renderOrthoLayer(const Map_Layer& layerdata, const TileSet& ti
 					//skip rendering tiles that are underneath fow hidden tiles
 					if (fogofwar == FogOfWar::TYPE_OVERLAY) {
 						if (&layerdata != &layers[fow->dark_layer_id]) {
-							if (layers[fow->dark_layer_id][i][j] == FogOfWar::TILE_HIDDEN) {
-
-								//check tile's corners
-								Point t_l(Utils::screenToMap(dest.x, dest.y, cam.shake.x, cam.shake.y));
-								Point t_r(Utils::screenToMap(dest.x + tile.tile->getClip().w, dest.y, cam.shake.x, cam.shake.y));
-								Point b_l(Utils::screenToMap(dest.x, dest.y + tile.tile->getClip().h, cam.shake.x, cam.shake.y));
-								Point b_r(Utils::screenToMap(dest.x + tile.tile->getClip().w, dest.y + tile.tile->getClip().h, cam.shake.x, cam.shake.y));
-
-								//limit to map bounds
-								if (t_l.x < 0) t_l.x = 0;
-								if (t_l.x >= w) t_l.x = w-1;
-								if (t_l.y < 0) t_l.y = 0;
-								if (t_l.y >= h) t_l.y = h-1;
-
-								if (t_r.x < 0) t_r.x = 0;
-								if (t_r.x >= w) t_r.x = w-1;
-								if (t_r.y < 0) t_r.y = 0;
-								if (t_r.y >= h) t_r.y = h-1;
-
-								if (b_l.x < 0) b_l.x = 0;
-								if (b_l.x >= w) b_l.x = w-1;
-								if (b_l.y < 0) b_l.y = 0;
-								if (b_l.y >= h) b_l.y = h-1;
-
-								if (b_r.x < 0) b_r.x = 0;
-								if (b_r.x >= w) b_r.x = w-1;
-								if (b_r.y < 0) b_r.y = 0;
-								if (b_r.y >= h) b_r.y = h-1;
-
-								if (layers[fow->dark_layer_id][t_l.x][t_l.y] == FogOfWar::TILE_HIDDEN) {
-									if (layers[fow->dark_layer_id][t_r.x][t_r.y] == FogOfWar::TILE_HIDDEN) {
-										if (layers[fow->dark_layer_id][b_l.x][b_l.y] == FogOfWar::TILE_HIDDEN) {
-											if (layers[fow->dark_layer_id][b_r.x][b_r.y] == FogOfWar::TILE_HIDDEN) {
-												skip_tile_render = true;
-											}
-										}
-									}
-								}
+							if (isTileHiddenByFow(i, j, tile, dest)) {
+								skip_tile_render = true;
 							}
 						}
 					}
@@ -953,20 +1072,19 @@ void MapRenderer::renderOrthoLayer(const Map_Layer& layerdata, const TileSet& ti
 	}
 }
 
-void MapRenderer::renderOrthoBackObjects(std::vector<Renderable> &r) {
+void MapRenderer::renderOrthoBackObjects(std::vector<Renderable*> &r) {
 	// some renderables are drawn above the background and below the objects
-	std::vector<Renderable>::iterator it;
-	for (it = r.begin(); it != r.end(); ++it)
-		drawRenderable(it);
+	for (size_t i = 0; i < r.size(); ++i)
+		drawRenderable(r[i]);
 }
 
-void MapRenderer::renderOrthoFrontObjects(std::vector<Renderable> &r) {
+void MapRenderer::renderOrthoFrontObjects(std::vector<Renderable*> &r) {
 
 	short int i;
 	short int j;
 	Point dest;
-	std::vector<Renderable>::iterator r_cursor = r.begin();
-	std::vector<Renderable>::iterator r_end = r.end();
+	std::vector<Renderable*>::iterator r_cursor = r.begin();
+	std::vector<Renderable*>::iterator r_end = r.end();
 
 	const Point upperleft(Utils::screenToMap(0, 0, cam.shake.x, cam.shake.y));
 
@@ -975,7 +1093,7 @@ void MapRenderer::renderOrthoFrontObjects(std::vector<Renderable> &r) {
 	const short max_tiles_width  = std::min(w, static_cast<short unsigned int>(starti + (settings->view_w / eset->tileset.tile_w) + 2 * tset.max_size_x));
 	const short max_tiles_height = std::min(h, static_cast<short unsigned int>(startj + (settings->view_h / eset->tileset.tile_h) + 2 * tset.max_size_y));
 
-	while (r_cursor != r_end && static_cast<int>(r_cursor->map_pos.y) < startj)
+	while (r_cursor != r_end && static_cast<int>((*r_cursor)->map_pos.y) < startj)
 		++r_cursor;
 
 	if (index_objectlayer >= layers.size())
@@ -986,7 +1104,7 @@ void MapRenderer::renderOrthoFrontObjects(std::vector<Renderable> &r) {
 		p = centerTile(p);
 		for (i = starti; i<max_tiles_width; i++) {
 
-			if (const unsigned short current_tile = layers[index_objectlayer][i][j]) {
+			if (const unsigned short current_tile = layers[index_objectlayer](i, j)) {
 				const Tile_Def &tile = tset.tiles[current_tile];
 				if (tile.tile) {
 					dest.x = p.x - tile.offset.x;
@@ -998,44 +1116,8 @@ void MapRenderer::renderOrthoFrontObjects(std::vector<Renderable> &r) {
 					//skip rendering tiles that are underneath fow hidden tiles
 					if (fogofwar == FogOfWar::TYPE_OVERLAY) {
 						if (&layers[index_objectlayer] != &layers[fow->dark_layer_id]) {
-							if (layers[fow->dark_layer_id][i][j] == FogOfWar::TILE_HIDDEN) {
-
-								//check tile's corners
-								Point t_l(Utils::screenToMap(dest.x, dest.y, cam.shake.x, cam.shake.y));
-								Point t_r(Utils::screenToMap(dest.x + tile.tile->getClip().w, dest.y, cam.shake.x, cam.shake.y));
-								Point b_l(Utils::screenToMap(dest.x, dest.y + tile.tile->getClip().h, cam.shake.x, cam.shake.y));
-								Point b_r(Utils::screenToMap(dest.x + tile.tile->getClip().w, dest.y + tile.tile->getClip().h, cam.shake.x, cam.shake.y));
-
-								//limit to map bounds
-								if (t_l.x < 0) t_l.x = 0;
-								if (t_l.x >= w) t_l.x = w-1;
-								if (t_l.y < 0) t_l.y = 0;
-								if (t_l.y >= h) t_l.y = h-1;
-
-								if (t_r.x < 0) t_r.x = 0;
-								if (t_r.x >= w) t_r.x = w-1;
-								if (t_r.y < 0) t_r.y = 0;
-								if (t_r.y >= h) t_r.y = h-1;
-
-								if (b_l.x < 0) b_l.x = 0;
-								if (b_l.x >= w) b_l.x = w-1;
-								if (b_l.y < 0) b_l.y = 0;
-								if (b_l.y >= h) b_l.y = h-1;
-
-								if (b_r.x < 0) b_r.x = 0;
-								if (b_r.x >= w) b_r.x = w-1;
-								if (b_r.y < 0) b_r.y = 0;
-								if (b_r.y >= h) b_r.y = h-1;
-
-								if (layers[fow->dark_layer_id][t_l.x][t_l.y] == FogOfWar::TILE_HIDDEN) {
-									if (layers[fow->dark_layer_id][t_r.x][t_r.y] == FogOfWar::TILE_HIDDEN) {
-										if (layers[fow->dark_layer_id][b_l.x][b_l.y] == FogOfWar::TILE_HIDDEN) {
-											if (layers[fow->dark_layer_id][b_r.x][b_r.y] == FogOfWar::TILE_HIDDEN) {
-												skip_tile_render = true;
-											}
-										}
-									}
-								}
+							if (isTileHiddenByFow(i, j, tile, dest)) {
+								skip_tile_render = true;
 							}
 						}
 					}
@@ -1054,22 +1136,23 @@ void MapRenderer::renderOrthoFrontObjects(std::vector<Renderable> &r) {
 			}
 			p.x += eset->tileset.tile_w;
 
-			while (r_cursor != r_end && static_cast<int>(r_cursor->map_pos.y) == j && static_cast<int>(r_cursor->map_pos.x) < i) // implicit floor
+			while (r_cursor != r_end && static_cast<int>((*r_cursor)->map_pos.y) == j && static_cast<int>((*r_cursor)->map_pos.x) < i) // implicit floor
 				++r_cursor;
 
 			// some renderable entities go in this layer
-			while (r_cursor != r_end && static_cast<int>(r_cursor->map_pos.y) == j && static_cast<int>(r_cursor->map_pos.x) == i) // implicit floor
-				drawRenderable(r_cursor++);
+			while (r_cursor != r_end && static_cast<int>((*r_cursor)->map_pos.y) == j && static_cast<int>((*r_cursor)->map_pos.x) == i) // implicit floor
+				drawRenderable(*r_cursor++);
 		}
-		while (r_cursor != r_end && static_cast<int>(r_cursor->map_pos.y) <= j) // implicit floor
+		while (r_cursor != r_end && static_cast<int>((*r_cursor)->map_pos.y) <= j) // implicit floor
 			++r_cursor;
 	}
 }
 
-void MapRenderer::renderOrtho(std::vector<Renderable> &r, std::vector<Renderable> &r_dead) {
+void MapRenderer::renderOrtho(std::vector<Renderable*> &r, std::vector<Renderable*> &r_dead) {
 	unsigned index = 0;
 	while (index < index_objectlayer) {
-		renderOrthoLayer(layers[index], tset);
+		if (!renderCachedLayer(index))
+			renderOrthoLayer(layers[index], tset);
 		map_parallax.render(cam.shake, layernames[index]);
 		index++;
 	}
@@ -1294,7 +1377,7 @@ void MapRenderer::checkHotspots() {
 						Point p = Utils::mapToScreen(float(x), float(y), cam.shake.x, cam.shake.y);
 						p = centerTile(p);
 
-						if (const short current_tile = layers[index][x][y]) {
+						if (const short current_tile = layers[index](x, y)) {
 							// first check if mouse pointer is in rectangle of that tile:
 							const Tile_Def &tile = tset.tiles[current_tile];
 							if (tile.tile) {
@@ -1490,7 +1573,7 @@ Point MapRenderer::centerTile(const Point& p) {
 
 void MapRenderer::getTileBounds(const int_fast16_t x, const int_fast16_t y, const Map_Layer& layerdata, Rect& bounds, Point& center) {
 	if (x >= 0 && x < w && y >= 0 && y < h) {
-		if (const uint_fast16_t tile_index = layerdata[x][y]) {
+		if (const uint_fast16_t tile_index = layerdata(x, y)) {
 			const Tile_Def &tile = tset.tiles[tile_index];
 			if (!tile.tile)
 				return;
@@ -1630,6 +1713,57 @@ void MapRenderer::drawDevHUD() {
 
 		render_device->drawEllipse(p0.x - radius, p0.y - radius/distort, p0.x + radius, p0.y + radius/distort, color_hazard, 15);
 	}
+
+	// render list sort
+	{
+		if (!label_sort_stats)
+			label_sort_stats = new WidgetLabel();
+
+		size_t sort_count = render_order.list.size() + render_order_dead.list.size();
+		float sort_ms = static_cast<float>(sort_ticks) * 1000.f / static_cast<float>(SDL_GetPerformanceFrequency());
+		std::string sort_method = (render_order.wasCoherent() && (render_order_dead.wasCoherent() || render_order_dead.list.empty())) ? msg->get("coherent") : msg->get("full");
+
+		label_sort_stats->setPos(cross_size, settings->view_h / 2);
+		label_sort_stats->setText(msg->getv("Render sort: %u renderables, %.3f ms (%s)", static_cast<unsigned>(sort_count), sort_ms, sort_method.c_str()));
+		label_sort_stats->setColor(color_cam);
+		label_sort_stats->render();
+	}
+
+	// draw statistics
+	{
+		std::vector<std::string> lines;
+		render_device->getStatsText(lines);
+
+		while (labels_render_stats.size() < lines.size()) {
+			labels_render_stats.push_back(new WidgetLabel());
+		}
+
+		const int line_height = font->getLineHeight();
+		for (size_t i = 0; i < lines.size(); ++i) {
+			labels_render_stats[i]->setPos(cross_size, settings->view_h / 2 + static_cast<int>(i + 1) * line_height);
+			labels_render_stats[i]->setText(lines[i]);
+			labels_render_stats[i]->setColor(color_cam);
+			labels_render_stats[i]->render();
+		}
+	}
+}
+
+/**
+ * Drops every cached chunk, e.g. when the render context that holds their images is destroyed
+ */
+void MapRenderer::invalidateLayerCache() {
+	layer_cache.clear();
+}
+
+/**
+ * Called when the tile at (x, y) changes on any layer, including the fog of war layers
+ */
+void MapRenderer::invalidateLayerCache(int x, int y) {
+	const Point center = getTilePixelPos(x, y);
+	const int reach_x = (tset.max_size_x + 1) * eset->tileset.tile_w;
+	const int reach_y = (tset.max_size_y + 1) * eset->tileset.tile_h;
+
+	layer_cache.invalidate(index_objectlayer, Rect(center.x - reach_x, center.y - reach_y, reach_x * 2, reach_y * 2));
 }
 
 void MapRenderer::setMapParallax(const std::string& mp_filename) {
@@ -1772,6 +1906,10 @@ MapRenderer::~MapRenderer() {
 	clearEvents();
 	clearObjects();
 	delete tip;
+	delete label_sort_stats;
+	for (size_t i = 0; i < labels_render_stats.size(); ++i) {
+		delete labels_render_stats[i];
+	}
 
 	/* unload sounds */
 	snd->reset();
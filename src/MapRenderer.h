@@ -32,13 +32,16 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "CommonIncludes.h"
 #include "Map.h"
 #include "MapCollision.h"
+#include "MapLayerCache.h"
 #include "MapParallax.h"
+#include "RenderOrder.h"
 #include "TileSet.h"
 #include "TooltipData.h"
 #include "Utils.h"
 
 class FileParser;
 class Sprite;
+class WidgetLabel;
 class WidgetTooltip;
 
 class MapRenderer : public Map {
@@ -56,21 +59,27 @@ private:
 
 	void clearObjects();
 
-	void drawRenderable(std::vector<Renderable>::iterator r_cursor);
+	void drawRenderable(Renderable* r);
 
 	void renderIsoLayer(const Map_Layer& layerdata, const TileSet& tile_set);
 
+	// renders a background layer from pre-rendered chunks
+	bool renderCachedLayer(size_t index);
+	bool renderLayerChunk(size_t index, int chunk_x, int chunk_y, Sprite** sprite);
+	Point getTilePixelPos(int x, int y);
+	bool isTileHiddenByFow(const int_fast16_t x, const int_fast16_t y, const Tile_Def& tile, const Point& dest);
+
 	// renders only objects
-	void renderIsoBackObjects(std::vector<Renderable> &r);
+	void renderIsoBackObjects(std::vector<Renderable*> &r);
 
 	// renders interleaved objects and layer
-	void renderIsoFrontObjects(std::vector<Renderable> &r);
-	void renderIso(std::vector<Renderable> &r, std::vector<Renderable> &r_dead);
+	void renderIsoFrontObjects(std::vector<Renderable*> &r);
+	void renderIso(std::vector<Renderable*> &r, std::vector<Renderable*> &r_dead);
 
 	void renderOrthoLayer(const Map_Layer& layerdata, const TileSet& tile_set);
-	void renderOrthoBackObjects(std::vector<Renderable> &r);
-	void renderOrthoFrontObjects(std::vector<Renderable> &r);
-	void renderOrtho(std::vector<Renderable> &r, std::vector<Renderable> &r_dead);
+	void renderOrthoBackObjects(std::vector<Renderable*> &r);
+	void renderOrthoFrontObjects(std::vector<Renderable*> &r);
+	void renderOrtho(std::vector<Renderable*> &r, std::vector<Renderable*> &r_dead);
 
 	void clearLayers();
 
@@ -88,12 +97,27 @@ private:
 
 	MapParallax map_parallax;
 
-	std::vector<std::vector<Renderable>::iterator> hidden_entities;
+	// pre-rendered chunks of the layers below the object layer
+	MapLayerCache layer_cache;
+
+	// false for layers that can't be cached, because they contain animated tiles
+	std::vector<bool> layer_cache_static;
+
+	// drawing order of the live and dead Renderables
+	RenderOrder render_order;
+	RenderOrder render_order_dead;
+
+	// time spent sorting both lists last frame, shown on the dev HUD
+	uint64_t sort_ticks;
+	WidgetLabel *label_sort_stats;
+
+	// one label per line of draw statistics, when using StatsRenderDevice
+	std::vector<WidgetLabel*> labels_render_stats;
 
 	// for isometric rendering
-	std::queue<std::vector<Renderable>::iterator> render_behind_SW;
-	std::queue<std::vector<Renderable>::iterator> render_behind_NE;
-	std::queue<std::vector<Renderable>::iterator> render_behind_none;
+	std::queue<Renderable*> render_behind_SW;
+	std::queue<Renderable*> render_behind_NE;
+	std::queue<Renderable*> render_behind_none;
 	Map_Layer drawn_tiles;
 
 public:
@@ -132,6 +156,11 @@ public:
 
 	void drawProcgenChunkMap(Image* canvas);
 
+	// drops cached layer chunks that could show the tile at (x, y)
+	void invalidateLayerCache();
+	void invalidateLayerCache(int x, int y);
+	MapLayerCache* getLayerCache() { return &layer_cache; }
+
 	// cam is where on the map the camera is pointing
 	Camera cam;
 
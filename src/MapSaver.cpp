@@ -25,7 +25,10 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "Utils.h"
 #include "UtilsFileSystem.h"
 
-MapSaver::MapSaver(Map *_map) : map(_map) {
+MapSaver::MapSaver(Map *_map)
+	: map(_map)
+	, layer_format(Map::LAYER_FORMAT_DEC)
+{
 	EVENT_COMPONENT_NAME[EventComponent::TOOLTIP] = "tooltip";
 	EVENT_COMPONENT_NAME[EventComponent::POWER] = "power";
 	EVENT_COMPONENT_NAME[EventComponent::POWER_PATH] = "power_path";
@@ -131,6 +134,12 @@ bool MapSaver::saveMap(const std::string& file, const std::string& tileset_defin
 	return saveMap(tileset_definitions);
 }
 
+/**
+ * Map::LAYER_FORMAT_RLE is smaller and faster to load, but harder to edit by hand
+ */
+void MapSaver::setLayerFormat(int format) {
+	layer_format = format;
+}
 
 void MapSaver::writeHeader(std::ofstream& map_file) {
 	map_file << "[header]" << std::endl;
@@ -180,22 +189,52 @@ void MapSaver::writeLayers(std::ofstream& map_file) {
 		map_file << "[layer]" << std::endl;
 
 		map_file << "type=" << map->layernames[i] << std::endl;
-		map_file << "data=" << std::endl;
+		writeLayerData(map_file, map->layers[i], layer_format);
+	}
+}
+
+/**
+ * Writes the format (if not 'dec') and data keys of a layer, followed by an empty line
+ */
+void MapSaver::writeLayerData(std::ostream& map_file, const Map_Layer& layer, int format) {
+	const size_t width = layer.getWidth();
+	const size_t height = layer.getHeight();
+
+	if (format == Map::LAYER_FORMAT_RLE)
+		map_file << "format=rle" << std::endl;
+	map_file << "data=" << std::endl;
+
+	std::stringstream data;
+	for (size_t line = 0; line < height; line++) {
+		const unsigned short* row = layer.getRow(line);
 
-		std::string layer = "";
-		for (int line = 0; line < map->h; line++) {
-			std::stringstream map_row;
-			for (int tile = 0; tile < map->w; tile++) {
-				map_row << map->layers[i][tile][line] << ",";
+		if (format == Map::LAYER_FORMAT_RLE) {
+			size_t tile = 0;
+			while (tile < width) {
+				size_t run = 1;
+				while (tile + run < width && row[tile + run] == row[tile])
+					run++;
+
+				if (tile > 0)
+					data << ",";
+				if (run > 1)
+					data << run << "*";
+				data << row[tile];
+
+				tile += run;
 			}
-			layer += map_row.str();
-			layer += '\n';
 		}
-		layer.erase(layer.end()-2, layer.end());
-		layer += '\n';
-
-		map_file << layer << std::endl;
+		else {
+			for (size_t tile = 0; tile < width; tile++) {
+				data << row[tile];
+				if (tile + 1 < width || line + 1 < height)
+					data << ",";
+			}
+		}
+		data << '\n';
 	}
+
+	map_file << data.str() << std::endl;
 }
 
 
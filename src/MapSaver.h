@@ -32,6 +32,9 @@ public:
 
 	bool saveMap(const std::string& tileset_definitions);
 	bool saveMap(const std::string& file, const std::string& tileset_definitions);
+	void setLayerFormat(int format);
+
+	static void writeLayerData(std::ostream& map_file, const Map_Layer& layer, int format);
 
 private:
 	void writeHeader(std::ofstream& map_file);
@@ -44,6 +47,7 @@ private:
 
 	Map* map;
 	std::string dest_file;
+	int layer_format;
 
 	std::string EVENT_COMPONENT_NAME[EventComponent::EVENT_COMPONENT_COUNT];
 
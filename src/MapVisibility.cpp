@@ -0,0 +1,196 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "MapVisibility.h"
+
+MapVisibility::Query::Query(const FPoint& _source, const FPoint& _target)
+	: source(_source)
+	, target(_target)
+	, visible(false)
+{
+}
+
+MapVisibility::CacheEntry::CacheEntry()
+	: source(0)
+	, target(0)
+	, frame(0)
+	, visible(false)
+{
+}
+
+MapVisibility::MapVisibility()
+	: width(0)
+	, height(0)
+	, frame(1)
+	, query_count(0)
+	, hit_count(0)
+	, last_query_count(0)
+	, last_hit_count(0)
+{
+}
+
+MapVisibility::~MapVisibility() {
+}
+
+/**
+ * Clears the sight bitmap for a map of the given size. All tiles start out as not blocking sight
+ */
+void MapVisibility::init(int _width, int _height) {
+	width = _width;
+	height = _height;
+	blocked.assign((static_cast<size_t>(width * height) + 31) / 32, 0);
+
+	cache.assign(CACHE_SIZE, CacheEntry());
+	frame = 1;
+	query_count = hit_count = 0;
+	last_query_count = last_hit_count = 0;
+}
+
+void MapVisibility::setBlocked(int x, int y, bool is_blocked) {
+	const size_t index = static_cast<size_t>(y * width + x);
+	const uint32_t bit = 1u << (index & 31);
+
+	if (((blocked[index >> 5] & bit) != 0) == is_blocked)
+		return;
+
+	if (is_blocked)
+		blocked[index >> 5] |= bit;
+	else
+		blocked[index >> 5] &= ~bit;
+
+	// cached results may have passed through this tile
+	invalidate();
+}
+
+/**
+ * Starts a new frame for the cache and the counters. Called once per logic frame
+ */
+void MapVisibility::nextFrame() {
+	last_query_count = query_count;
+	last_hit_count = hit_count;
+	query_count = hit_count = 0;
+
+	invalidate();
+}
+
+/**
+ * Drops all cached results by moving on to a new cache frame
+ */
+void MapVisibility::invalidate() {
+	frame++;
+
+	// on wrap-around, old entries could match the new frame
+	if (frame == 0) {
+		cache.assign(CACHE_SIZE, CacheEntry());
+		frame = 1;
+	}
+}
+
+bool MapVisibility::isBlocked(int x, int y) const {
+	const size_t index = static_cast<size_t>(y * width + x);
+	return (blocked[index >> 5] & (1u << (index & 31))) != 0;
+}
+
+/**
+ * Walks every tile crossed by the line between the centers of source and target, using integer steps only.
+ * The source tile itself is not checked; the target tile is.
+ * Where the line passes exactly through a corner, it is blocked only if both tiles beside the corner block sight
+ */
+bool MapVisibility::traverse(const Point& source, const Point& target) const {
+	const int dx = abs(target.x - source.x);
+	const int dy = abs(target.y - source.y);
+	const int step_x = (target.x > source.x) ? 1 : -1;
+	const int step_y = (target.y > source.y) ? 1 : -1;
+
+	int x = source.x;
+	int y = source.y;
+	int ix = 0;
+	int iy = 0;
+
+	while (ix < dx || iy < dy) {
+		// compares where the line crosses the next vertical and horizontal tile borders
+		const int decision = (1 + 2 * ix) * dy - (1 + 2 * iy) * dx;
+
+		if (decision == 0) {
+			if (isBlocked(x + step_x, y) && isBlocked(x, y + step_y))
+				return false;
+			x += step_x;
+			y += step_y;
+			ix++;
+			iy++;
+		}
+		else if (decision < 0) {
+			x += step_x;
+			ix++;
+		}
+		else {
+			y += step_y;
+			iy++;
+		}
+
+		if (isBlocked(x, y))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Converts both positions to tiles. Returns false if either is outside the map
+ */
+bool MapVisibility::getTiles(const FPoint& source, const FPoint& target, Point& source_tile, Point& target_tile) const {
+	if (source.x < 0 || source.y < 0 || target.x < 0 || target.y < 0)
+		return false;
+
+	source_tile = Point(source);
+	target_tile = Point(target);
+	return source_tile.x < width && source_tile.y < height && target_tile.x < width && target_tile.y < height;
+}
+
+bool MapVisibility::lineOfSight(const FPoint& source, const FPoint& target) {
+	Point source_tile, target_tile;
+	if (!getTiles(source, target, source_tile, target_tile))
+		return false;
+
+	query_count++;
+
+	const unsigned source_index = static_cast<unsigned>(source_tile.y * width + source_tile.x);
+	const unsigned target_index = static_cast<unsigned>(target_tile.y * width + target_tile.x);
+
+	// multiplicative hash, using the top bits of the product
+	CacheEntry& entry = cache[((source_index ^ (target_index * 31u)) * 2654435761u) >> (32 - CACHE_BITS)];
+	if (entry.frame == frame && entry.source == source_index && entry.target == target_index) {
+		hit_count++;
+		return entry.visible;
+	}
+
+	entry.source = source_index;
+	entry.target = target_index;
+	entry.frame = frame;
+	entry.visible = traverse(source_tile, target_tile);
+
+	return entry.visible;
+}
+
+/**
+ * Answers a batch of queries. The results are also stored in the cache for the rest of the frame
+ */
+void MapVisibility::lineOfSight(std::vector<Query>& queries) {
+	for (size_t i = 0; i < queries.size(); ++i) {
+		queries[i].visible = lineOfSight(queries[i].source, queries[i].target);
+	}
+}
@@ -0,0 +1,92 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class MapVisibility
+ *
+ * Answers line-of-sight queries between map tiles.
+ *
+ * Sight-blocking tiles are kept in a bitmap, one bit per tile. A query walks the tiles crossed by the line between
+ * the centers of the source and target tiles with integer steps, so the result only depends on the two tiles.
+ *
+ * Results are cached for the current frame, keyed by (source tile, target tile). The cache is a fixed-size table
+ * where a new result replaces any older one in its slot. Entries from previous frames are ignored.
+ */
+
+#ifndef MAP_VISIBILITY_H
+#define MAP_VISIBILITY_H
+
+#include "CommonIncludes.h"
+#include "Utils.h"
+
+class MapVisibility {
+public:
+	class Query {
+	public:
+		FPoint source;
+		FPoint target;
+		bool visible;
+		Query(const FPoint& _source, const FPoint& _target);
+	};
+
+private:
+	static const unsigned CACHE_BITS = 12;
+	static const unsigned CACHE_SIZE = 1 << CACHE_BITS;
+
+	class CacheEntry {
+	public:
+		unsigned source;
+		unsigned target;
+		unsigned frame;
+		bool visible;
+		CacheEntry();
+	};
+
+	void invalidate();
+	bool isBlocked(int x, int y) const;
+	bool traverse(const Point& source, const Point& target) const;
+	bool getTiles(const FPoint& source, const FPoint& target, Point& source_tile, Point& target_tile) const;
+
+	int width;
+	int height;
+	std::vector<uint32_t> blocked;
+
+	std::vector<CacheEntry> cache;
+	unsigned frame;
+
+	unsigned query_count;
+	unsigned hit_count;
+	unsigned last_query_count;
+	unsigned last_hit_count;
+
+public:
+	MapVisibility();
+	~MapVisibility();
+
+	void init(int _width, int _height);
+	void setBlocked(int x, int y, bool is_blocked);
+	void nextFrame();
+
+	bool lineOfSight(const FPoint& source, const FPoint& target);
+	void lineOfSight(std::vector<Query>& queries);
+
+	// counters from the last complete frame
+	unsigned getQueryCount() { return last_query_count; }
+	unsigned getHitCount() { return last_hit_count; }
+};
+
+#endif
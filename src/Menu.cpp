@@ -24,8 +24,10 @@ FLARE.  If not, see http://www.gnu.org/licenses/
  * The base class for Menu objects
  */
 
+#include "InputState.h"
 #include "Menu.h"
 #include "RenderDevice.h"
+#include "Settings.h"
 #include "SharedResources.h"
 #include "SoundManager.h"
 #include "Utils.h"
@@ -37,11 +39,13 @@ Menu::Menu()
 	, alignment(Utils::ALIGN_TOPLEFT)
 	, sfx_open(0)
 	, sfx_close(0)
-	, background(NULL) {
+	, background(NULL)
+	, layer_sprite(NULL) {
 }
 
 Menu::~Menu() {
 	if (background) delete background;
+	clearLayer();
 }
 
 void Menu::setBackground(const std::string& background_image) {
@@ -90,6 +94,104 @@ void Menu::render() {
 		render_device->render(background);
 }
 
+/**
+ * Draws the menu from its cached layer. The layer is only redrawn by renderContents() when getLayerState() or
+ * getLayerArea() change, so menus that stay the same between frames cost a single sprite.
+ * Returns false if the layer can't be used, in which case the caller should use renderContents() instead
+ */
+bool Menu::renderLayer() {
+	if (!settings->retained_hud || !render_device->supportsLayers()) {
+		clearLayer();
+		return false;
+	}
+
+	Rect area = getLayerArea();
+	if (area.w <= 0 || area.h <= 0)
+		return false;
+
+	if (layer_sprite && (inpt->window_resized || layer_sprite->getGraphicsWidth() != area.w || layer_sprite->getGraphicsHeight() != area.h))
+		clearLayer();
+
+	bool dirty = false;
+	if (!layer_sprite) {
+		Image *graphics = render_device->createImage(area.w, area.h);
+		if (!graphics)
+			return false;
+
+		layer_sprite = graphics->createSprite();
+		graphics->unref();
+		dirty = true;
+	}
+
+	layer_state_next.clear();
+	getLayerState(layer_state_next);
+
+	if (dirty || area.x != layer_area.x || area.y != layer_area.y || layer_state_next != layer_state) {
+		if (!render_device->beginLayer(layer_sprite->getGraphics(), Point(area.x, area.y))) {
+			clearLayer();
+			return false;
+		}
+
+		renderContents();
+		render_device->endLayer();
+
+		layer_area = area;
+		layer_state.swap(layer_state_next);
+	}
+
+	layer_sprite->setDest(area.x, area.y);
+	render_device->render(layer_sprite);
+	return true;
+}
+
+/**
+ * Draws the parts of the menu that are kept in the layer. Positions are in screen coordinates
+ */
+void Menu::renderContents() {
+	Menu::render();
+}
+
+/**
+ * Adds every value that changes what renderContents() draws, other than the layer area
+ */
+void Menu::getLayerState(std::vector<unsigned long>&) {
+}
+
+/**
+ * The screen area that renderContents() draws to
+ */
+Rect Menu::getLayerArea() {
+	return window_area;
+}
+
+/**
+ * Grows area to also cover rect. An empty area becomes rect
+ */
+void Menu::addToLayerArea(Rect& area, const Rect& rect) {
+	if (rect.w <= 0 || rect.h <= 0)
+		return;
+
+	if (area.w <= 0 || area.h <= 0) {
+		area = rect;
+		return;
+	}
+
+	int x1 = std::max(area.x + area.w, rect.x + rect.w);
+	int y1 = std::max(area.y + area.h, rect.y + rect.h);
+	area.x = std::min(area.x, rect.x);
+	area.y = std::min(area.y, rect.y);
+	area.w = x1 - area.x;
+	area.h = y1 - area.y;
+}
+
+void Menu::clearLayer() {
+	if (layer_sprite) {
+		delete layer_sprite;
+		layer_sprite = NULL;
+	}
+	layer_state.clear();
+}
+
 /**
  * Aligns the menu relative to one of these positions:
  * topleft, top, topright, left, center, right, bottomleft, bottom, bottomright
@@ -58,10 +58,24 @@ public:
 	virtual void defocusTabLists();
 
 protected:
+	bool renderLayer();
+	virtual void renderContents();
+	virtual void getLayerState(std::vector<unsigned long>& state);
+	virtual Rect getLayerArea();
+	static void addToLayerArea(Rect& area, const Rect& rect);
+
 	Sprite *background;
 
 private:
+	void clearLayer();
+
 	Point window_area_base;
+
+	// cached drawing of renderContents(), redrawn when the layer state or area changes
+	Sprite *layer_sprite;
+	Rect layer_area;
+	std::vector<unsigned long> layer_state;
+	std::vector<unsigned long> layer_state_next;
 };
 
 #endif
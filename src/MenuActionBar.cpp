@@ -443,6 +443,21 @@ void MenuActionBar::logic() {
 }
 
 void MenuActionBar::render() {
+	for (unsigned i = 0; i < slots_count; i++) {
+		if (slots[i])
+			slots[i]->show_disabled_overlay = (hotkeys[i] != 0);
+	}
+
+	for (unsigned i=0; i<MENU_COUNT; i++) {
+		if (menus[i]->enabled)
+			menus[i]->highlight = (requires_attention[i] && menus[i]->enabled && !menus[i]->in_focus);
+	}
+
+	if (!renderLayer())
+		renderContents();
+}
+
+void MenuActionBar::renderContents() {
 
 	Menu::render();
 
@@ -450,8 +465,6 @@ void MenuActionBar::render() {
 	for (unsigned i = 0; i < slots_count; i++) {
 		if (!slots[i]) continue;
 
-		slots[i]->show_disabled_overlay = (hotkeys[i] != 0);
-
 		if (hotkeys[i] == 0 || powers_overlap_slots) {
 			// TODO move this to WidgetSlot?
 			if (sprite_emptyslot) {
@@ -465,12 +478,45 @@ void MenuActionBar::render() {
 	// render primary menu buttons
 	for (unsigned i=0; i<MENU_COUNT; i++) {
 		if (menus[i]->enabled) {
-			menus[i]->highlight = (requires_attention[i] && menus[i]->enabled && !menus[i]->in_focus);
 			menus[i]->render();
 		}
 	}
 }
 
+void MenuActionBar::getLayerState(std::vector<unsigned long>& state) {
+	// hotkey labels are reloaded while drawing
+	state.push_back(inpt->refresh_hotkeys);
+
+	for (unsigned i = 0; i < slots_count; i++) {
+		if (!slots[i]) continue;
+
+		state.push_back(hotkeys[i] == 0);
+		slots[i]->getRenderState(state);
+	}
+
+	for (unsigned i=0; i<MENU_COUNT; i++) {
+		state.push_back(menus[i]->enabled);
+		if (menus[i]->enabled)
+			menus[i]->getRenderState(state);
+	}
+}
+
+Rect MenuActionBar::getLayerArea() {
+	Rect area = window_area;
+
+	for (unsigned i = 0; i < slots_count; i++) {
+		if (slots[i])
+			addToLayerArea(area, slots[i]->pos);
+	}
+
+	for (unsigned i=0; i<MENU_COUNT; i++) {
+		if (menus[i]->enabled)
+			addToLayerArea(area, menus[i]->pos);
+	}
+
+	return area;
+}
+
 /**
  * On mouseover, show tooltip for buttons
  */
@@ -133,6 +133,11 @@ public:
 	WidgetSlot* touch_slot;
 
 	bool enable_gamepad_nav;
+
+protected:
+	void renderContents();
+	void getLayerState(std::vector<unsigned long>& state);
+	Rect getLayerArea();
 };
 
 #endif
@@ -208,6 +208,14 @@ void MenuActiveEffects::logic() {
 }
 
 void MenuActiveEffects::render() {
+	if (effect_icons.empty())
+		return;
+
+	if (!renderLayer())
+		renderContents();
+}
+
+void MenuActiveEffects::renderContents() {
 	for (size_t i = 0; i < effect_icons.size(); ++i) {
 		Point icon_pos(effect_icons[i].pos.x, effect_icons[i].pos.y);
 		icons->setIcon(effect_icons[i].icon, icon_pos);
@@ -225,6 +233,29 @@ void MenuActiveEffects::render() {
 	}
 }
 
+void MenuActiveEffects::getLayerState(std::vector<unsigned long>& state) {
+	for (size_t i = 0; i < effect_icons.size(); ++i) {
+		state.push_back(static_cast<unsigned long>(effect_icons[i].icon));
+		state.push_back(static_cast<unsigned long>(effect_icons[i].pos.x));
+		state.push_back(static_cast<unsigned long>(effect_icons[i].pos.y));
+		state.push_back(static_cast<unsigned long>(effect_icons[i].overlay.y));
+		state.push_back(static_cast<unsigned long>(effect_icons[i].stacks));
+	}
+}
+
+/**
+ * Icons can wrap outside of the menu area
+ */
+Rect MenuActiveEffects::getLayerArea() {
+	Rect area;
+	for (size_t i = 0; i < effect_icons.size(); ++i) {
+		addToLayerArea(area, effect_icons[i].pos);
+		if (effect_icons[i].stacksLabel)
+			addToLayerArea(area, *effect_icons[i].stacksLabel->getBounds());
+	}
+	return area;
+}
+
 void MenuActiveEffects::renderTooltips(const Point& position) {
 	TooltipData tip_data;
 
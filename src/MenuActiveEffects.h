@@ -74,6 +74,11 @@ public:
 	void logic();
 	void render();
 	void renderTooltips(const Point& position);
+
+protected:
+	void renderContents();
+	void getLayerState(std::vector<unsigned long>& state);
+	Rect getLayerArea();
 };
 
 #endif
@@ -22,6 +22,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "Avatar.h"
 #include "CampaignManager.h"
 #include "Entity.h"
+#include "EngineSettings.h"
 #include "EntityManager.h"
 #include "EventManager.h"
 #include "FileParser.h"
@@ -37,6 +38,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "NPCManager.h"
 #include "PowerManager.h"
 #include "RenderDevice.h"
+#include "SDLSoftwareBlitter.h"
 #include "Settings.h"
 #include "SharedGameResources.h"
 #include "SharedResources.h"
@@ -321,16 +323,16 @@ void MenuDevConsole::getTileInfo() {
 
 	std::stringstream ss;
 	for (size_t i = 0; i < mapr->layers.size(); ++i) {
-		if (mapr->layers[i][tile.x][tile.y] == 0)
+		if (mapr->layers[i](tile.x, tile.y) == 0)
 			continue;
 		ss.str("");
-		ss << "    " << mapr->layernames[i] << "=" << mapr->layers[i][tile.x][tile.y];
+		ss << "    " << mapr->layernames[i] << "=" << mapr->layers[i](tile.x, tile.y);
 		log_history->add(ss.str(), WidgetLog::MSG_NORMAL);
 	}
 
 	ss.str("");
-	ss << "    " << "collision=" << mapr->collider.colmap[tile.x][tile.y] << " (";
-	switch(mapr->collider.colmap[tile.x][tile.y]) {
+	ss << "    " << "collision=" << mapr->collider.colmap(tile.x, tile.y) << " (";
+	switch(mapr->collider.colmap(tile.x, tile.y)) {
 		case MapCollision::BLOCKS_NONE: ss << msg->get("none"); break;
 		case MapCollision::BLOCKS_ALL: ss << msg->get("wall"); break;
 		case MapCollision::BLOCKS_MOVEMENT: ss << msg->get("short wall / pit"); break;
@@ -473,6 +475,17 @@ void MenuDevConsole::execute() {
 	}
 
 	if (args[0] == "help") {
+		log_history->add("ai_threads [n] - " + msg->get("sets the number of threads used by entity AI. 0 uses one per CPU core. Without n, prints the current count"), WidgetLog::MSG_UNIQUE);
+		log_history->add("layer_cache - " + msg->get("prints the size and counters of the pre-rendered background layer cache"), WidgetLog::MSG_UNIQUE);
+		log_history->add("text_cache - " + msg->get("prints the size and counters of the rendered text cache"), WidgetLog::MSG_UNIQUE);
+		log_history->add("mod_index - " + msg->get("prints the size of the mod file index and its lookup counters"), WidgetLog::MSG_UNIQUE);
+		log_history->add("los_stats - " + msg->get("prints the line-of-sight counters from the last frame"), WidgetLog::MSG_UNIQUE);
+		log_history->add("path_stats - " + msg->get("prints the path search counters from the last frame"), WidgetLog::MSG_UNIQUE);
+		log_history->add("render_stats - " + msg->get("prints the number of sprites and draw calls from the last frame"), WidgetLog::MSG_UNIQUE);
+		log_history->add("bench_collision - " + msg->get("times collision checks and a walk over every map layer on the current map"), WidgetLog::MSG_UNIQUE);
+		log_history->add("bench_path - " + msg->get("times A* and JPS path finding between a fixed set of walkable tiles on the current map"), WidgetLog::MSG_UNIQUE);
+		log_history->add("bench_parse - " + msg->get("times parsing every data file in the engine, menus, items, powers, enemies, npcs and cutscenes directories"), WidgetLog::MSG_UNIQUE);
+		log_history->add("bench_blit - " + msg->get("times the software renderer's blit kernels and checks them against SDL_BlitSurface()"), WidgetLog::MSG_UNIQUE);
 		log_history->add("procgen_map - " + msg->get("For procedural maps, prints a color-coded map."), WidgetLog::MSG_UNIQUE);
 		log_history->add("add_power - " + msg->get("adds a power to the action bar"), WidgetLog::MSG_UNIQUE);
 		log_history->add("toggle_fps - " + msg->get("turns on/off the display of the FPS counter"), WidgetLog::MSG_UNIQUE);
@@ -690,6 +703,235 @@ void MenuDevConsole::execute() {
 			mapr->drawProcgenChunkMap(log_history->setupDrawBuffer(chunk_map_h));
 		}
 	}
+	else if (args[0] == "bench_path") {
+		// this is a console command rather than a separate benchmark program, since loading a map needs the mods,
+		// engine settings and tileset that only a running game has set up
+		int path_count = (args.size() > 1) ? Parse::toInt(args[1]) : 1000;
+
+		MapCollision* collider = &mapr->collider;
+		std::vector<FPoint> walkable;
+		for (int x = 0; x < collider->map_size.x; ++x) {
+			for (int y = 0; y < collider->map_size.y; ++y) {
+				FPoint tile(static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f);
+				if (collider->isValidPosition(tile.x, tile.y, MapCollision::MOVE_NORMAL, MapCollision::COLLIDE_TYPE_NONE))
+					walkable.push_back(tile);
+			}
+		}
+
+		if (walkable.size() < 2 || path_count <= 0) {
+			log_history->setNextColor(font->getColor(FontEngine::COLOR_MENU_PENALTY));
+			log_history->add(msg->get("ERROR: This map has no walkable tiles to test"), WidgetLog::MSG_UNIQUE);
+		}
+		else {
+			// start and end tiles are picked with fixed strides so that runs are repeatable
+			// every pair is searched with both algorithms, so their results can be compared
+			const int algorithms[2] = { MapCollision::PATH_ALGORITHM_ASTAR, MapCollision::PATH_ALGORITHM_JPS };
+			const char* algorithm_names[2] = { "A*", "JPS" };
+			float total_ms[2] = { 0, 0 };
+			unsigned expansions[2] = { 0, 0 };
+			int paths_found[2] = { 0, 0 };
+			int equal_paths = 0;
+			int shorter_paths = 0;
+			int longer_paths = 0;
+			int slower_searches = 0;
+
+			std::vector<FPoint> path;
+			for (int i = 0; i < path_count; ++i) {
+				const FPoint& start_pos = walkable[(static_cast<size_t>(i) * 7919) % walkable.size()];
+				const FPoint& end_pos = walkable[(static_cast<size_t>(i) * 104729 + walkable.size() / 2) % walkable.size()];
+				float path_length[2] = { 0, 0 };
+				float path_ms[2] = { 0, 0 };
+
+				for (int j = 0; j < 2; ++j) {
+					unsigned start_expansions = collider->getPathExpansions();
+					uint64_t start_ticks = SDL_GetPerformanceCounter();
+					bool found = collider->computePath(start_pos, end_pos, path, MapCollision::MOVE_NORMAL, MapCollision::DEFAULT_PATH_LIMIT, algorithms[j]);
+					uint64_t end_ticks = SDL_GetPerformanceCounter();
+
+					path_ms[j] = static_cast<float>(end_ticks - start_ticks) * 1000.f / static_cast<float>(SDL_GetPerformanceFrequency());
+					total_ms[j] += path_ms[j];
+					expansions[j] += collider->getPathExpansions() - start_expansions;
+
+					// only paths that reach the end tile are compared
+					if (found && Point(path.front()).x == Point(end_pos).x && Point(path.front()).y == Point(end_pos).y) {
+						paths_found[j]++;
+						FPoint prev = start_pos;
+						for (size_t k = path.size(); k > 0; --k) {
+							path_length[j] += Utils::calcDist(prev, path[k-1]);
+							prev = path[k-1];
+						}
+					}
+				}
+
+				if (path_length[0] > 0 && path_length[1] > 0) {
+					if (fabs(path_length[0] - path_length[1]) < 0.01f)
+						equal_paths++;
+					else if (path_length[1] < path_length[0])
+						shorter_paths++;
+					else
+						longer_paths++;
+				}
+
+				if (path_ms[1] > path_ms[0])
+					slower_searches++;
+			}
+
+			for (int j = 1; j >= 0; --j) {
+				std::string result = msg->getv("%s: %d paths (%d found) in %.2f ms, %.4f ms per path, %u nodes expanded", algorithm_names[j], path_count, paths_found[j], total_ms[j], total_ms[j] / static_cast<float>(path_count), expansions[j]);
+				Utils::logInfo("MenuDevConsole: %s: %s", mapr->getFilename().c_str(), result.c_str());
+				log_history->add(result, WidgetLog::MSG_UNIQUE);
+			}
+
+			std::string comparison = msg->getv("JPS paths: %d equal in length to A*, %d shorter, %d longer. JPS was slower for %d of %d paths", equal_paths, shorter_paths, longer_paths, slower_searches, path_count);
+			Utils::logInfo("MenuDevConsole: %s: %s", mapr->getFilename().c_str(), comparison.c_str());
+			log_history->add(comparison, WidgetLog::MSG_UNIQUE);
+		}
+	}
+	else if (args[0] == "bench_collision") {
+		int pass_count = (args.size() > 1) ? Parse::toInt(args[1]) : 100;
+		if (pass_count <= 0)
+			pass_count = 1;
+
+		MapCollision* collider = &mapr->collider;
+
+		// every tile is checked once per pass, in the same row-major order the renderer walks the map
+		int valid_tiles = 0;
+		uint64_t start_ticks = SDL_GetPerformanceCounter();
+		for (int i = 0; i < pass_count; ++i) {
+			for (int y = 0; y < collider->map_size.y; ++y) {
+				for (int x = 0; x < collider->map_size.x; ++x) {
+					if (collider->isValidPosition(static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f, MapCollision::MOVE_NORMAL, MapCollision::COLLIDE_TYPE_ALL_ENTITIES))
+						valid_tiles++;
+				}
+			}
+		}
+		uint64_t end_ticks = SDL_GetPerformanceCounter();
+		float collision_ms = static_cast<float>(end_ticks - start_ticks) * 1000.f / static_cast<float>(SDL_GetPerformanceFrequency());
+
+		unsigned long tile_sum = 0;
+		start_ticks = SDL_GetPerformanceCounter();
+		for (int i = 0; i < pass_count; ++i) {
+			for (size_t layer = 0; layer < mapr->layers.size(); ++layer) {
+				const Map_Layer& current_layer = mapr->layers[layer];
+				for (unsigned short y = 0; y < current_layer.getHeight(); ++y) {
+					const unsigned short* row = current_layer.getRow(y);
+					for (unsigned short x = 0; x < current_layer.getWidth(); ++x) {
+						tile_sum += row[x];
+					}
+				}
+			}
+		}
+		end_ticks = SDL_GetPerformanceCounter();
+		float layer_ms = static_cast<float>(end_ticks - start_ticks) * 1000.f / static_cast<float>(SDL_GetPerformanceFrequency());
+
+		std::string collision_result = msg->getv("Collision: %d passes over %dx%d tiles (%d valid) in %.2f ms", pass_count, collider->map_size.x, collider->map_size.y, valid_tiles / pass_count, collision_ms);
+		std::string layer_result = msg->getv("Layers: %d passes over %d layers in %.2f ms (checksum %lu)", pass_count, static_cast<int>(mapr->layers.size()), layer_ms, tile_sum / static_cast<unsigned long>(pass_count));
+		Utils::logInfo("MenuDevConsole: %s: %s", mapr->getFilename().c_str(), collision_result.c_str());
+		Utils::logInfo("MenuDevConsole: %s: %s", mapr->getFilename().c_str(), layer_result.c_str());
+		log_history->add(layer_result, WidgetLog::MSG_UNIQUE);
+		log_history->add(collision_result, WidgetLog::MSG_UNIQUE);
+	}
+	else if (args[0] == "bench_parse") {
+		int pass_count = (args.size() > 1) ? Parse::toInt(args[1]) : 10;
+		if (pass_count <= 0)
+			pass_count = 1;
+
+		// these are the directories that are parsed at startup
+		const char* dirs[] = { "engine", "menus", "items", "powers", "enemies", "npcs", "cutscenes" };
+		std::vector<std::string> files;
+		for (size_t i = 0; i < sizeof(dirs) / sizeof(dirs[0]); ++i) {
+			std::vector<std::string> dir_files = mods->list(dirs[i], !ModManager::LIST_FULL_PATHS);
+			files.insert(files.end(), dir_files.begin(), dir_files.end());
+		}
+
+		unsigned long key_count = 0;
+		uint64_t start_ticks = SDL_GetPerformanceCounter();
+		for (int i = 0; i < pass_count; ++i) {
+			for (size_t j = 0; j < files.size(); ++j) {
+				FileParser infile;
+				if (!infile.open(files[j], FileParser::MOD_FILE, FileParser::ERROR_NONE))
+					continue;
+				while (infile.next()) {
+					key_count++;
+				}
+				infile.close();
+			}
+		}
+		uint64_t end_ticks = SDL_GetPerformanceCounter();
+		float parse_ms = static_cast<float>(end_ticks - start_ticks) * 1000.f / static_cast<float>(SDL_GetPerformanceFrequency());
+
+		std::string result = msg->getv("Parsing: %d passes over %d files (%lu keys) in %.2f ms, %.2f ms per pass", pass_count, static_cast<int>(files.size()), key_count / static_cast<unsigned long>(pass_count), parse_ms, parse_ms / static_cast<float>(pass_count));
+		Utils::logInfo("MenuDevConsole: %s", result.c_str());
+		log_history->add(result, WidgetLog::MSG_UNIQUE);
+	}
+	else if (args[0] == "bench_blit") {
+		int iterations = (args.size() > 1) ? Parse::toInt(args[1]) : 100;
+		if (iterations <= 0)
+			iterations = 1;
+
+		SDLSoftwareBlitter blitter;
+		for (int kernel = 0; kernel < SDLSoftwareBlitter::KERNEL_COUNT; ++kernel) {
+			if (!blitter.isKernelAvailable(kernel))
+				continue;
+
+			std::string result = std::string(SDLSoftwareBlitter::getKernelName(kernel)) + ":";
+			unsigned mismatches = 0;
+			for (int mode = 0; mode < SDLSoftwareBlitter::MODE_COUNT; ++mode) {
+				result += std::string(" ") + SDLSoftwareBlitter::getModeName(mode) + " " + Utils::floatToString(blitter.benchmark(kernel, mode, iterations), 1);
+				mismatches += blitter.checkKernel(kernel, mode);
+			}
+			result += msg->getv(" MP/s, %u pixels differ from SDL", mismatches);
+
+			Utils::logInfo("MenuDevConsole: %s", result.c_str());
+			log_history->add(result, WidgetLog::MSG_UNIQUE);
+		}
+		log_history->add(msg->getv("Blit kernel in use: %s", SDLSoftwareBlitter::getKernelName(blitter.getKernel())), WidgetLog::MSG_UNIQUE);
+	}
+	else if (args[0] == "mod_index") {
+		const ModManager::IndexStats& stats = mods->getIndexStats();
+		log_history->add(msg->getv("Mod index: %u files in %u directories, %u mod directories", stats.file_count, stats.dir_count, stats.root_count), WidgetLog::MSG_UNIQUE);
+		log_history->add(msg->getv("Mod index built in %.2f ms%s", stats.build_ms, (stats.loaded_from_cache ? msg->get(" (cached)").c_str() : "")), WidgetLog::MSG_UNIQUE);
+		log_history->add(msg->getv("Locate: %u calls, %u cached, %u not found", stats.locate_count, stats.locate_cache_hits, stats.locate_misses), WidgetLog::MSG_UNIQUE);
+		log_history->add(msg->getv("List: %u calls", stats.list_count), WidgetLog::MSG_UNIQUE);
+		log_history->add(msg->getv("Lookups: %u from the index, %u on disk", stats.index_lookups, stats.disk_lookups), WidgetLog::MSG_UNIQUE);
+	}
+	else if (args[0] == "path_stats") {
+		PathScheduler* ps = &entitym->path_scheduler;
+		log_history->add(msg->getv("Path requests: %u queued, %u served, %u merged", ps->getQueuedCount(), ps->getServedCount(), ps->getMergedCount()), WidgetLog::MSG_UNIQUE);
+		log_history->add(msg->getv("Path nodes expanded: %u (budget: %d)", ps->getExpansionCount(), eset->misc.path_budget), WidgetLog::MSG_UNIQUE);
+	}
+	else if (args[0] == "los_stats") {
+		MapVisibility* visibility = mapr->collider.getVisibility();
+		unsigned query_count = visibility->getQueryCount();
+		unsigned hit_count = visibility->getHitCount();
+		float hit_rate = (query_count > 0) ? static_cast<float>(hit_count) * 100.f / static_cast<float>(query_count) : 0;
+		log_history->add(msg->getv("Line-of-sight checks: %u, cache hits: %u (%.1f%%)", query_count, hit_count, hit_rate), WidgetLog::MSG_UNIQUE);
+	}
+	else if (args[0] == "layer_cache") {
+		MapLayerCache* layer_cache = mapr->getLayerCache();
+		float memory_mb = static_cast<float>(layer_cache->getMemoryUsed()) / (1024.f * 1024.f);
+		log_history->add(msg->getv("Layer cache: %u chunks, %.1f/%d MB", static_cast<unsigned>(layer_cache->getChunkCount()), memory_mb, settings->layer_cache_size), WidgetLog::MSG_UNIQUE);
+		log_history->add(msg->getv("Chunk hits: %u, rebuilds: %u, evictions: %u", layer_cache->getHitCount(), layer_cache->getRebuildCount(), layer_cache->getEvictCount()), WidgetLog::MSG_UNIQUE);
+	}
+	else if (args[0] == "text_cache") {
+		TextCache* text_cache = font->getTextCache();
+		float memory_mb = static_cast<float>(text_cache->getMemoryUsed()) / (1024.f * 1024.f);
+		log_history->add(msg->getv("Text cache: %u images, %.1f/%d MB", static_cast<unsigned>(text_cache->getImageCount()), memory_mb, settings->text_cache_size), WidgetLog::MSG_UNIQUE);
+		log_history->add(msg->getv("Image hits: %u, misses: %u, evictions: %u", text_cache->getHitCount(), text_cache->getMissCount(), text_cache->getEvictCount()), WidgetLog::MSG_UNIQUE);
+		log_history->add(msg->getv("Size hits: %u, misses: %u", text_cache->getSizeHitCount(), text_cache->getSizeMissCount()), WidgetLog::MSG_UNIQUE);
+	}
+	else if (args[0] == "render_stats") {
+		log_history->add(msg->getv("Sprites: %u, draw calls: %u", render_device->getSpriteCount(), render_device->getDrawCallCount()), WidgetLog::MSG_UNIQUE);
+		log_history->add(msg->getv("Batching: %s", (settings->render_batching ? "on" : "off")), WidgetLog::MSG_UNIQUE);
+		log_history->add(msg->getv("Retained HUD: %s", ((settings->retained_hud && render_device->supportsLayers()) ? "on" : "off")), WidgetLog::MSG_UNIQUE);
+	}
+	else if (args[0] == "ai_threads") {
+		if (args.size() > 1) {
+			settings->ai_threads = std::max(Parse::toInt(args[1]), 0);
+			entitym->think_pool.init(settings->ai_threads);
+		}
+		log_history->add(msg->getv("AI threads: %d", entitym->think_pool.getThreadCount()), WidgetLog::MSG_UNIQUE);
+	}
 	else if (starts_with_slash || args[0] == "exec") {
 		if (args.size() > 1) {
 			Event evnt;
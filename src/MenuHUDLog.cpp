@@ -41,6 +41,7 @@ MenuHUDLog::MenuHUDLog()
 	, click_to_dismiss(false)
 	, start_at_bottom(true)
 	, overlay_at_bottom(true)
+	, msg_add_count(0)
 	, hide_overlay(false)
 {
 
@@ -123,6 +124,22 @@ void MenuHUDLog::render() {
 
 	hide_overlay = true;
 
+	if (!renderLayer())
+		renderContents();
+}
+
+void MenuHUDLog::renderContents() {
+	size_t first_visible = placeMessages();
+	for (size_t i = msg_buffer.size(); i > first_visible; i--) {
+		render_device->render(msg_buffer[i-1]);
+	}
+}
+
+/**
+ * Sets the position of each new message, starting with the newest
+ * @return the index of the oldest message that is shown, or msg_buffer.size() if none are
+ */
+size_t MenuHUDLog::placeMessages() {
 	Rect dest;
 	dest.x = window_area.x + paragraph_spacing;
 
@@ -134,9 +151,8 @@ void MenuHUDLog::render() {
 			if (msg_age[i-1] > 0 && dest.y > window_area.y && msg_buffer[i-1]) {
 				dest.y -= msg_buffer[i-1]->getGraphicsHeight() + paragraph_spacing;
 				msg_buffer[i-1]->setDestFromRect(dest);
-				render_device->render(msg_buffer[i-1]);
 			}
-			else return; // no more new messages
+			else return i; // no more new messages
 		}
 	}
 	else {
@@ -149,17 +165,43 @@ void MenuHUDLog::render() {
 				msg_height += msg_buffer[i-1]->getGraphicsHeight();
 
 			if (msg_age[i-1] > 0 && dest.y + msg_height < window_area.y + window_area.h && msg_buffer[i-1]) {
-				// dest.y -= msg_buffer[i-1]->getGraphicsHeight() + paragraph_spacing;
 				msg_buffer[i-1]->setDestFromRect(dest);
-				render_device->render(msg_buffer[i-1]);
 				dest.y += msg_height;
 			}
-			else return; // no more new messages
+			else return i; // no more new messages
 		}
 	}
 
+	return 0;
 }
 
+/**
+ * With start_at_bottom, the oldest message shown can start above the menu area
+ */
+Rect MenuHUDLog::getLayerArea() {
+	Rect area = window_area;
+
+	size_t first_visible = placeMessages();
+	for (size_t i = msg_buffer.size(); i > first_visible; i--) {
+		Rect bounds;
+		bounds.x = msg_buffer[i-1]->getDest().x;
+		bounds.y = msg_buffer[i-1]->getDest().y;
+		bounds.w = msg_buffer[i-1]->getGraphicsWidth();
+		bounds.h = msg_buffer[i-1]->getGraphicsHeight();
+		addToLayerArea(area, bounds);
+	}
+
+	return area;
+}
+
+
+/**
+ * Messages are only added at the end and removed from the start, so counting both is enough to find changes
+ */
+void MenuHUDLog::getLayerState(std::vector<unsigned long>& state) {
+	state.push_back(msg_add_count);
+	state.push_back(static_cast<unsigned long>(msg_buffer.size()));
+}
 
 /**
  * Displays the last message with a shaded background
@@ -234,6 +276,7 @@ void MenuHUDLog::add(const std::string& s, int type) {
 		font->renderShadowed(log_msg.back(), 0, 0, FontEngine::JUSTIFY_LEFT, graphics, window_area.w - (paragraph_spacing*2), font->getColor(FontEngine::COLOR_MENU_NORMAL));
 		msg_buffer.push_back(graphics->createSprite());
 		graphics->unref();
+		msg_add_count++;
 	}
 	else if (!msg_age.empty()) {
 		msg_age.back() = calcDuration(log_msg.back());
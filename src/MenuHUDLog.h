@@ -31,6 +31,7 @@ class MenuHUDLog : public Menu {
 private:
 
 	int calcDuration(const std::string& s);
+	size_t placeMessages();
 
 	std::vector<std::string> log_msg;
 	std::vector<int> msg_age;
@@ -44,6 +45,9 @@ private:
 	bool start_at_bottom;
 	bool overlay_at_bottom;
 
+	// number of messages added so far, to find changes for the layer
+	unsigned long msg_add_count;
+
 public:
 	enum {
 		MSG_NORMAL = 0,
@@ -60,6 +64,11 @@ public:
 	void renderOverlay();
 
 	bool hide_overlay;
+
+protected:
+	void renderContents();
+	Rect getLayerArea();
+	void getLayerState(std::vector<unsigned long>& state);
 };
 
 #endif
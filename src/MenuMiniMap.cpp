@@ -389,17 +389,17 @@ void MenuMiniMap::updateOrtho(MapCollision *collider, Sprite** tile_surface, int
 		target_img->beginPixelBatch(clip);
 	}
 
-	for (int i=bounds->x; i<bounds->w; i++) {
-		for (int j=bounds->y; j<bounds->h; j++) {
+	for (int j=bounds->y; j<bounds->h; j++) {
+		for (int i=bounds->x; i<bounds->w; i++) {
 			bool draw_tile = true;
-			int tile_type = collider->colmap[i][j];
+			int tile_type = collider->colmap(i, j);
 
 			if (tile_type == 1 || tile_type == 5) draw_color = color_wall;
 			else if (tile_type == 2 || tile_type == 6) draw_color = color_obst;
 			else draw_tile = false;
 
 			if (eset->misc.fogofwar > 0) {
-				tile_type = mapr->layers[fow->dark_layer_id][i][j];
+				tile_type = mapr->layers[fow->dark_layer_id](i, j);
 				if (tile_type != 0) draw_tile = false;
 			}
 
@@ -462,9 +462,9 @@ void MenuMiniMap::updateIso(MapCollision *collider, Sprite** tile_surface, int z
 		target_img->beginPixelBatch(clip);
 	}
 
-	for (int i=bounds->x; i<bounds->w; i++) {
-		for (int j=bounds->y; j<bounds->h; j++) {
-			tile_type = collider->colmap[i][j];
+	for (int j=bounds->y; j<bounds->h; j++) {
+		for (int i=bounds->x; i<bounds->w; i++) {
+			tile_type = collider->colmap(i, j);
 			bool draw_tile = true;
 
 			if (tile_type == 1 || tile_type == 5) draw_color = color_wall;
@@ -473,7 +473,7 @@ void MenuMiniMap::updateIso(MapCollision *collider, Sprite** tile_surface, int z
 
 			// fog of war
 			if (eset->misc.fogofwar > 0) {
-				tile_type = mapr->layers[fow->dark_layer_id][i][j];
+				tile_type = mapr->layers[fow->dark_layer_id](i, j);
 				if (tile_type != 0) draw_tile = false;
 			}
 
@@ -584,7 +584,7 @@ void MenuMiniMap::fillEntities() {
 			for (int j=event_pos.x; j<event_pos.x + mapr->events[i].location.w; ++j) {
 				for (int k=event_pos.y; k<event_pos.y + mapr->events[i].location.h; ++k) {
 					if (mapr->fogofwar)
-						if (mapr->layers[fow->dark_layer_id][event_pos.x][event_pos.y] == FogOfWar::TILE_HIDDEN) continue;
+						if (mapr->layers[fow->dark_layer_id](event_pos.x, event_pos.y) == FogOfWar::TILE_HIDDEN) continue;
 
 					if (Utils::calcDist(pc->stats.pos, FPoint(j, k)) <= visible_radius) {
 						entities.push_back(new PixelEntity(j, k, &color_teleport));
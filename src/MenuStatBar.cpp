@@ -59,6 +59,8 @@ MenuStatBar::MenuStatBar(short _type, size_t _resource_stat_index)
 	, resource_stat_index(_resource_stat_index)
 	, bar_fill_offset()
 	, bar_fill_size(-1, -1)
+	, bar_length(0)
+	, show_label(false)
 {
 	std::string type_filename;
 	if (type == TYPE_HP)
@@ -227,31 +229,20 @@ bool MenuStatBar::disappear() {
 	return false;
 }
 
-void MenuStatBar::render() {
-
-	if (disappear()) return;
-
-	Rect src;
-	Rect dest;
-
-	// position elements based on the window position
+/**
+ * The bar position on screen
+ */
+Rect MenuStatBar::getBarDest() {
 	Rect bar_dest = bar_pos;
 	bar_dest.x = bar_pos.x+window_area.x;
 	bar_dest.y = bar_pos.y+window_area.y;
+	return bar_dest;
+}
 
-	// draw bar background
-	dest.x = bar_dest.x;
-	dest.y = bar_dest.y;
-	src.x = 0;
-	src.y = 0;
-	src.w = bar_pos.w;
-	src.h = bar_pos.h;
-	setBackgroundClip(src);
-	setBackgroundDest(dest);
-	Menu::render();
-
-	int bar_length = 0;
-
+/**
+ * Sets bar_length from the current stat value
+ */
+void MenuStatBar::updateBarLength() {
 	if (type == TYPE_XP) {
 		unsigned long stat_cur_clamped = std::min(stat_cur.Unsigned, stat_max.Unsigned);
 		unsigned long normalized_cur = stat_cur_clamped - std::min(stat_cur_clamped, stat_min.Unsigned);
@@ -282,6 +273,85 @@ void MenuStatBar::render() {
 		if (bar_length == 0 && normalized_cur > 0)
 			bar_length = 1;
 	}
+}
+
+/**
+ * Sets the label text and position. The label is only shown if enabled in the settings or on mouseover
+ */
+void MenuStatBar::updateLabel() {
+	show_label = false;
+
+	if (text_pos.hidden)
+		return;
+
+	Rect bar_dest = getBarDest();
+
+	if (settings->statbar_labels || (inpt->usingMouse() && Utils::isWithinRect(bar_dest, inpt->mouse) && !menu->exit->visible)) {
+		std::stringstream ss;
+		if (!custom_string.empty())
+			ss << custom_string;
+		else if (type == TYPE_XP)
+			// TYPE_XP uses a custom string, so this won't apply in normal circumstances
+			ss << stat_cur.Unsigned << "/" << stat_max.Unsigned;
+		else
+			ss << Utils::floatToString(stat_cur.Float, eset->number_format.player_statbar) << "/" << Utils::floatToString(stat_max.Float, eset->number_format.player_statbar);
+
+		label->setText(ss.str());
+		label->setColor(font->getColor(FontEngine::COLOR_MENU_NORMAL));
+
+		if (custom_text_pos) {
+			label->setPos(bar_dest.x + text_pos.x, bar_dest.y + text_pos.y);
+			label->setJustify(text_pos.justify);
+			label->setVAlign(text_pos.valign);
+			label->setFont(text_pos.font_style);
+		}
+		else {
+			if (bar) {
+				// position bar text relative to bar fill if possible
+				int fill_y = bar_dest.y + bar_fill_offset.y;
+				if (orientation == VERTICAL)
+					fill_y += bar_fill_size.y - bar_length;
+				label->setPos(bar_dest.x + bar_fill_offset.x + bar_fill_size.x/2, fill_y + bar_fill_size.y/2);
+			}
+			else {
+				label->setPos(bar_dest.x + bar_pos.w/2, bar_dest.y + bar_pos.h/2);
+			}
+			label->setJustify(FontEngine::JUSTIFY_CENTER);
+			label->setVAlign(LabelInfo::VALIGN_CENTER);
+		}
+
+		show_label = true;
+	}
+}
+
+void MenuStatBar::render() {
+
+	if (disappear()) return;
+
+	updateBarLength();
+	updateLabel();
+
+	if (!renderLayer())
+		renderContents();
+}
+
+void MenuStatBar::renderContents() {
+	Rect src;
+	Rect dest;
+
+	// position elements based on the window position
+	Rect bar_dest = getBarDest();
+
+	// draw bar background
+	dest.x = bar_dest.x;
+	dest.y = bar_dest.y;
+	src.x = 0;
+	src.y = 0;
+	src.w = bar_pos.w;
+	src.h = bar_pos.h;
+	setBackgroundClip(src);
+	setBackgroundDest(dest);
+	Menu::render();
 
 	// draw bar progress based on orientation
 	if (orientation == HORIZONTAL) {
@@ -308,43 +378,36 @@ void MenuStatBar::render() {
 	}
 
 	// if mouseover, draw text
-	if (!text_pos.hidden) {
-
-		if (settings->statbar_labels || (inpt->usingMouse() && Utils::isWithinRect(bar_dest, inpt->mouse) && !menu->exit->visible)) {
-			std::stringstream ss;
-			if (!custom_string.empty())
-				ss << custom_string;
-			else if (type == TYPE_XP)
-				// TYPE_XP uses a custom string, so this won't apply in normal circumstances
-				ss << stat_cur.Unsigned << "/" << stat_max.Unsigned;
-			else
-				ss << Utils::floatToString(stat_cur.Float, eset->number_format.player_statbar) << "/" << Utils::floatToString(stat_max.Float, eset->number_format.player_statbar);
-
-			label->setText(ss.str());
-			label->setColor(font->getColor(FontEngine::COLOR_MENU_NORMAL));
-
-			if (custom_text_pos) {
-				label->setPos(bar_dest.x + text_pos.x, bar_dest.y + text_pos.y);
-				label->setJustify(text_pos.justify);
-				label->setVAlign(text_pos.valign);
-				label->setFont(text_pos.font_style);
-			}
-			else {
-				if (bar) {
-					// position bar text relative to bar fill if possible
-					label->setPos(dest.x + bar_fill_size.x/2, dest.y + bar_fill_size.y/2);
-				}
-				else {
-					label->setPos(bar_dest.x + bar_pos.w/2, bar_dest.y + bar_pos.h/2);
-				}
-				label->setJustify(FontEngine::JUSTIFY_CENTER);
-				label->setVAlign(LabelInfo::VALIGN_CENTER);
-			}
-			label->render();
-		}
+	if (show_label)
+		label->render();
+}
+
+void MenuStatBar::getLayerState(std::vector<unsigned long>& state) {
+	state.push_back(static_cast<unsigned long>(bar_length));
+	state.push_back(show_label);
+
+	if (show_label) {
+		Rect* bounds = label->getBounds();
+		state.push_back(Utils::hashString(label->getText()));
+		state.push_back(static_cast<unsigned long>(bounds->x));
+		state.push_back(static_cast<unsigned long>(bounds->y));
+		state.push_back(static_cast<unsigned long>(bounds->w));
+		state.push_back(static_cast<unsigned long>(bounds->h));
 	}
 }
 
+/**
+ * The label can be placed outside of the menu area
+ */
+Rect MenuStatBar::getLayerArea() {
+	Rect area = window_area;
+	addToLayerArea(area, getBarDest());
+	if (show_label)
+		addToLayerArea(area, *label->getBounds());
+
+	return area;
+}
+
 MenuStatBar::~MenuStatBar() {
 	if (bar) delete bar;
 	delete label;
@@ -35,6 +35,9 @@ class WidgetLabel;
 class MenuStatBar : public Menu {
 private:
 	bool disappear();
+	Rect getBarDest();
+	void updateBarLength();
+	void updateLabel();
 
 	enum {
 		HORIZONTAL = 0,
@@ -65,7 +68,8 @@ private:
 	Timer timeout;
 	Point bar_fill_offset;
 	Point bar_fill_size;
-
+	int bar_length;
+	bool show_label;
 
 public:
 	enum {
@@ -80,6 +84,11 @@ public:
 	void loadGraphics();
 	void update();
 	void render();
+
+protected:
+	void renderContents();
+	void getLayerState(std::vector<unsigned long>& state);
+	Rect getLayerArea();
 };
 
 #endif
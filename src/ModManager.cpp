@@ -18,6 +18,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 
 #include "CommonIncludes.h"
 #include "ModManager.h"
+#include "PackArchive.h"
 #include "Platform.h"
 #include "Settings.h"
 #include "SharedResources.h"
@@ -113,6 +114,25 @@ std::string Mod::getLocaleDescription(const std::string& lang) {
 		return description;
 }
 
+ModManager::IndexStats::IndexStats()
+	: root_count(0)
+	, archive_count(0)
+	, dir_count(0)
+	, file_count(0)
+	, build_ms(0)
+	, loaded_from_cache(false)
+	, locate_count(0)
+	, locate_cache_hits(0)
+	, locate_misses(0)
+	, list_count(0)
+	, index_lookups(0)
+	, disk_lookups(0) {
+}
+
+ModManager::IndexDir::IndexDir()
+	: mtime(0) {
+}
+
 const std::string ModManager::FALLBACK_MOD = "default";
 const std::string ModManager::FALLBACK_GAME = "default";
 
@@ -128,13 +148,30 @@ ModManager::ModManager(const std::vector<std::string> *_cmd_line_mods)
 	Filesystem::getDirList(settings->path_data + "mods", mod_dirs_other);
 	Filesystem::getDirList(settings->path_user + "mods", mod_dirs_other);
 
+	// archived mods are named after their archive, without the extension
+	std::vector<std::string> mod_archives;
+	Filesystem::getFileList(settings->path_data + "mods", PackArchive::EXTENSION, mod_archives);
+	Filesystem::getFileList(settings->path_user + "mods", PackArchive::EXTENSION, mod_archives);
+	for (size_t i = 0; i < mod_archives.size(); ++i) {
+		size_t name_start = mod_archives[i].find_last_of("/\\") + 1;
+		mod_dirs_other.push_back(mod_archives[i].substr(name_start, mod_archives[i].length() - name_start - PackArchive::EXTENSION.length()));
+	}
+
 	for (unsigned i=0; i<mod_dirs_other.size(); ++i) {
 		if (find(mod_dirs.begin(), mod_dirs.end(), mod_dirs_other[i]) == mod_dirs.end())
 			mod_dirs.push_back(mod_dirs_other[i]);
 	}
 
+	// all archives are opened here, before any other thread can read from them through openRW()
+	for (size_t i = 0; i < mod_dirs.size(); ++i) {
+		for (size_t j = 0; j < mod_paths.size(); ++j) {
+			openArchive(getModRoot(j, mod_dirs[i]));
+		}
+	}
+
 	loadModList();
 	applyDepends();
+	buildIndex();
 
 	std::string active_mods_str = "Active mods: ";
 	for (size_t i = 0; i < mod_list.size(); ++i) {
@@ -245,19 +282,24 @@ void ModManager::loadModList() {
  */
 std::string ModManager::locate(const std::string& _filename) {
 	std::string filename = Filesystem::convertSlashes(_filename);
+	index_stats.locate_count++;
 
 	// if we have this location already cached, return it
-	if (loc_cache.find(filename) != loc_cache.end()) {
-		return loc_cache[filename];
+	std::map<std::string,std::string>::iterator it = loc_cache.find(filename);
+	if (it != loc_cache.end()) {
+		index_stats.locate_cache_hits++;
+		return it->second;
 	}
 
 	// search through mods for the first instance of this filename
+	bool is_indexed = isIndexedPath(filename);
 	std::string test_path;
 
 	for (size_t i = mod_list.size(); i > 0; i--) {
 		for (size_t j = 0; j < mod_paths.size(); j++) {
-			test_path = Filesystem::convertSlashes(mod_paths[j] + "mods/" + mod_list[i-1].name + "/" + filename);
-			if (Filesystem::fileExists(test_path)) {
+			std::string root = getModRoot(j, mod_list[i-1].name);
+			test_path = Filesystem::convertSlashes(root + "/" + filename);
+			if (indexedFileExists(root, test_path, is_indexed)) {
 				loc_cache[filename] = test_path;
 				return test_path;
 			}
@@ -265,32 +307,31 @@ std::string ModManager::locate(const std::string& _filename) {
 	}
 
 	// all else failing, simply return the filename if it exists
+	// files outside of the mods don't change while the game is running, so this result can be cached too
 	test_path = Filesystem::convertSlashes(settings->path_data + filename);
-	if (!Filesystem::fileExists(test_path))
+	index_stats.disk_lookups++;
+	if (!Filesystem::fileExists(test_path)) {
 		test_path = "";
+		index_stats.locate_misses++;
+	}
 
+	loc_cache[filename] = test_path;
 	return test_path;
 }
 
-void amendPathToVector(const std::string &path, std::vector<std::string> &vec) {
-	if (Filesystem::pathExists(path)) {
-		if (Filesystem::isDirectory(path)) {
-			Filesystem::getFileList(path, "txt", vec);
-		}
-		else {
-			vec.push_back(path);
-		}
-	}
-}
-
 std::vector<std::string> ModManager::list(const std::string &path, bool full_paths) {
 	std::vector<std::string> ret;
 	std::string test_path;
+	std::string converted_path = Filesystem::convertSlashes(path);
+	bool is_indexed = isIndexedPath(converted_path);
+
+	index_stats.list_count++;
 
 	for (size_t i = 0; i < mod_list.size(); ++i) {
 		for (size_t j = mod_paths.size(); j > 0; j--) {
-			test_path = Filesystem::convertSlashes(mod_paths[j-1] + "mods/" + mod_list[i].name + "/" + path);
-			amendPathToVector(test_path, ret);
+			std::string root = getModRoot(j-1, mod_list[i].name);
+			test_path = Filesystem::convertSlashes(root + "/" + path);
+			amendPathToVector(root, test_path, is_indexed, ret);
 		}
 	}
 
@@ -298,8 +339,6 @@ std::vector<std::string> ModManager::list(const std::string &path, bool full_pat
 	if (ret.empty()) return ret;
 
 	if (!full_paths) {
-		std::string converted_path = Filesystem::convertSlashes(path);
-
 		// reduce the each file path down to be relative to mods/
 		for (unsigned i=0; i<ret.size(); ++i) {
 			size_t start = ret[i].rfind(converted_path);
@@ -307,18 +346,502 @@ std::vector<std::string> ModManager::list(const std::string &path, bool full_pat
 				ret[i] = ret[i].substr(start, ret[i].length());
 		}
 
-		// remove duplicates
-		for (unsigned i = 0; i < ret.size(); ++i) {
-			for (unsigned j = 0; j < i; ++j) {
-				if (ret[i] == ret[j]) {
-					ret.erase(ret.begin()+j);
+		// remove duplicates, keeping the last instance of each file
+		std::set<std::string> found;
+		std::vector<std::string> unique;
+		for (size_t i = ret.size(); i > 0; --i) {
+			if (found.insert(ret[i-1]).second)
+				unique.push_back(ret[i-1]);
+		}
+		ret.assign(unique.rbegin(), unique.rend());
+	}
+
+	return ret;
+}
+
+const ModManager::IndexStats& ModManager::getIndexStats() {
+	return index_stats;
+}
+
+bool ModManager::fileExists(const std::string& filename) {
+	return !locate(filename).empty();
+}
+
+/**
+ * If the path is inside a mod archive, gets the contents of the file without copying them
+ *
+ * @return false if the path isn't in an archive, or the archive doesn't have this file
+ */
+bool ModManager::getPackedFile(const std::string& path, const char*& data, size_t& size) {
+	std::string archive_path;
+	PackArchive* archive = findArchive(path, archive_path);
+	return archive && archive->getFile(archive_path, data, size);
+}
+
+/**
+ * Reads a file from an archive or from disk
+ */
+bool ModManager::readFile(const std::string& path, std::string& buffer) {
+	const char* data;
+	size_t size;
+	if (getPackedFile(path, data, size)) {
+		buffer.assign(data, size);
+		return true;
+	}
+
+	return Filesystem::readFile(path, buffer);
+}
+
+/**
+ * Gets the size and modification time of a file. Files in an archive have the modification time of the archive.
+ */
+bool ModManager::getFileInfo(const std::string& path, uint64_t& size, int64_t& mtime) {
+	std::string archive_path;
+	PackArchive* archive = findArchive(path, archive_path);
+	if (archive) {
+		const char* data;
+		size_t packed_size;
+		if (!archive->getFile(archive_path, data, packed_size))
+			return false;
+
+		size = packed_size;
+		mtime = archive->getModifiedTime();
+		return true;
+	}
+
+	return Filesystem::getFileInfo(path, size, mtime);
+}
+
+/**
+ * Opens a file for SDL loaders such as IMG_Load_RW()
+ * Files in an archive are read from memory. The caller owns the returned SDL_RWops.
+ */
+SDL_RWops* ModManager::openRW(const std::string& path) {
+	const char* data;
+	size_t size;
+	if (getPackedFile(path, data, size))
+		return SDL_RWFromConstMem(data, static_cast<int>(size));
+
+	return SDL_RWFromFile(path.c_str(), "rb");
+}
+
+/**
+ * Opens the archive for a mod directory, if the directory doesn't exist and an archive does
+ * This is only done in the constructor, so that the list of archives never changes while it may be read by other threads.
+ */
+void ModManager::openArchive(const std::string& root) {
+	if (archives.find(root) != archives.end())
+		return;
+
+	PackArchive* archive = NULL;
+	std::string archive_filename = root + PackArchive::EXTENSION;
+	if (!Filesystem::isDirectory(root, false) && Filesystem::fileExists(archive_filename)) {
+		archive = new PackArchive();
+		if (archive->open(archive_filename)) {
+			index_stats.archive_count++;
+			Utils::logInfo("ModManager: Using archive '%s' (%u files)", archive_filename.c_str(), static_cast<unsigned>(archive->getPaths().size()));
+		}
+		else {
+			delete archive;
+			archive = NULL;
+		}
+	}
+
+	archives[root] = archive;
+}
+
+/**
+ * Gets the archive for a mod directory, or NULL if that mod doesn't have one
+ */
+PackArchive* ModManager::getArchive(const std::string& root) const {
+	std::map<std::string, PackArchive*>::const_iterator it = archives.find(root);
+	if (it != archives.end())
+		return it->second;
+
+	return NULL;
+}
+
+/**
+ * Finds the archive that holds a full path, as returned by locate() or list()
+ * archive_path is set to the path relative to the archive.
+ */
+PackArchive* ModManager::findArchive(const std::string& path, std::string& archive_path) {
+	std::string converted_path = Filesystem::convertSlashes(path);
+
+	for (size_t i = 0; i < mod_paths.size(); ++i) {
+		std::string prefix = Filesystem::convertSlashes(mod_paths[i] + "mods/", Filesystem::KEEP_TRAILING_SLASH);
+		if (converted_path.compare(0, prefix.length(), prefix) != 0)
+			continue;
+
+		size_t name_end = converted_path.find_first_of("/\\", prefix.length());
+		if (name_end == std::string::npos)
+			return NULL;
+
+		PackArchive* archive = getArchive(converted_path.substr(0, name_end));
+		if (archive)
+			archive_path = converted_path.substr(name_end + 1);
+		return archive;
+	}
+
+	return NULL;
+}
+
+/**
+ * Opens a file from an archive or from disk as a stream
+ * If the file can't be read, the stream is left in a failed state.
+ */
+bool ModManager::openStream(const std::string& path, std::istringstream& stream) {
+	std::string contents;
+	bool ret = readFile(path, contents);
+
+	stream.clear();
+	stream.str(contents);
+	if (!ret)
+		stream.setstate(std::ios::failbit);
+
+	return ret;
+}
+
+std::string ModManager::getModRoot(size_t path_index, const std::string& mod_name) {
+	return Filesystem::convertSlashes(mod_paths[path_index] + "mods/" + mod_name);
+}
+
+/**
+ * Index every active mod in every mod path
+ * With --cache-mod-index, the index is read from PATH_USER/cache/ when none of its directories have changed
+ */
+void ModManager::buildIndex() {
+	uint64_t start_ticks = SDL_GetPerformanceCounter();
+
+	index_stats.loaded_from_cache = settings->cache_mod_index && !settings->rebuild_cache && loadIndex();
+
+	if (!index_stats.loaded_from_cache) {
+		for (size_t i = 0; i < mod_list.size(); ++i) {
+			for (size_t j = 0; j < mod_paths.size(); ++j) {
+				indexRoot(getModRoot(j, mod_list[i].name));
+			}
+		}
+
+		if (settings->cache_mod_index)
+			saveIndex();
+	}
+
+	uint64_t end_ticks = SDL_GetPerformanceCounter();
+	index_stats.build_ms = static_cast<float>(end_ticks - start_ticks) * 1000.f / static_cast<float>(SDL_GetPerformanceFrequency());
+
+	Utils::logInfo("ModManager: Indexed %u files in %u directories in %.2f ms%s", index_stats.file_count, index_stats.dir_count, index_stats.build_ms, (index_stats.loaded_from_cache ? " (cached)" : ""));
+}
+
+/**
+ * Adds a mod directory to the index, if it hasn't been added already
+ * Mods that are enabled after the index was built are added the first time they are searched.
+ */
+void ModManager::indexRoot(const std::string& root) {
+	if (std::find(index_roots.begin(), index_roots.end(), root) != index_roots.end())
+		return;
+
+	index_roots.push_back(root);
+	index_stats.root_count++;
+
+	if (Filesystem::isDirectory(root, false)) {
+		indexDir(root, 0);
+	}
+	else {
+		PackArchive* archive = getArchive(root);
+		if (archive)
+			indexArchive(root, archive);
+	}
+}
+
+void ModManager::indexDir(const std::string& path, unsigned depth) {
+	// the depth limit guards against symbolic links that point back up the tree
+	const unsigned MAX_DEPTH = 32;
+
+	std::string key = getIndexKey(path);
+	if (depth > MAX_DEPTH || index_dirs.find(key) != index_dirs.end())
+		return;
+
+	IndexDir& dir = index_dirs[key];
+	uint64_t size;
+	Filesystem::getFileInfo(path, size, dir.mtime);
+
+	std::vector<std::string> dirs;
+	Filesystem::getDirContents(path, dir.files, dirs);
+
+	for (size_t i = 0; i < dir.files.size(); ++i) {
+		index_files.insert(getIndexKey(Filesystem::convertSlashes(path + "/" + dir.files[i])));
+	}
+
+	index_stats.dir_count++;
+	index_stats.file_count += static_cast<unsigned>(dir.files.size());
+
+	for (size_t i = 0; i < dirs.size(); ++i) {
+		indexDir(Filesystem::convertSlashes(path + "/" + dirs[i]), depth + 1);
+	}
+}
+
+/**
+ * Adds the files in an archive to the index, along with every directory that contains them
+ */
+void ModManager::indexArchive(const std::string& root, PackArchive* archive) {
+	const std::vector<std::string>& paths = archive->getPaths();
+
+	IndexDir& root_dir = index_dirs[getIndexKey(root)];
+	root_dir.mtime = archive->getModifiedTime();
+	index_stats.dir_count++;
+
+	for (size_t i = 0; i < paths.size(); ++i) {
+		std::string path = Filesystem::convertSlashes(root + "/" + paths[i]);
+		index_files.insert(getIndexKey(path));
+		index_stats.file_count++;
+
+		// walk up to the root, adding any directory that hasn't been seen yet
+		std::string name = path;
+		size_t sep = name.find_last_of("/\\");
+		bool is_file = true;
+		while (sep != std::string::npos && sep >= root.length()) {
+			std::string dir_path = name.substr(0, sep);
+			std::string dir_key = getIndexKey(dir_path);
+			bool is_new = index_dirs.find(dir_key) == index_dirs.end();
+
+			IndexDir& dir = index_dirs[dir_key];
+			if (is_file)
+				dir.files.push_back(name.substr(sep + 1));
+
+			if (!is_new)
+				break;
+
+			dir.mtime = root_dir.mtime;
+			index_stats.dir_count++;
+
+			name = dir_path;
+			sep = name.find_last_of("/\\");
+			is_file = false;
+		}
+	}
+}
+
+/**
+ * Root types for the saved index: 0 = missing, 1 = directory, 2 = archive
+ */
+int ModManager::getRootType(const std::string& root) {
+	if (Filesystem::isDirectory(root, false))
+		return 1;
+	else if (Filesystem::fileExists(root + PackArchive::EXTENSION))
+		return 2;
+	return 0;
+}
+
+/**
+ * Reads the index saved by saveIndex()
+ * Adding or removing a file changes the modification time of its directory, so the saved index is
+ * only used if it has the same mod directories as now, and none of its directories have been modified.
+ */
+bool ModManager::loadIndex() {
+	std::string buffer;
+	if (!Filesystem::readFile(settings->path_user + "cache/mod_index.txt", buffer))
+		return false;
+
+	std::vector<std::string> expected_roots;
+	for (size_t i = 0; i < mod_list.size(); ++i) {
+		for (size_t j = 0; j < mod_paths.size(); ++j) {
+			expected_roots.push_back(getModRoot(j, mod_list[i].name));
+		}
+	}
+
+	bool valid = true;
+	size_t root_index = 0;
+	IndexDir* dir = NULL;
+	std::string dir_path;
+	size_t pos = 0;
+
+	while (valid && pos < buffer.size()) {
+		size_t line_end = buffer.find('\n', pos);
+		if (line_end == std::string::npos)
+			line_end = buffer.size();
+		std::string line = buffer.substr(pos, line_end - pos);
+		pos = line_end + 1;
+
+		if (Parse::skipLine(line))
+			continue;
+
+		size_t first_tab = line.find('\t');
+		size_t second_tab = (first_tab == std::string::npos) ? std::string::npos : line.find('\t', first_tab + 1);
+		std::string type = line.substr(0, first_tab);
+
+		if (type == "file" && dir && first_tab != std::string::npos) {
+			dir->files.push_back(line.substr(first_tab + 1));
+			index_files.insert(getIndexKey(Filesystem::convertSlashes(dir_path + "/" + dir->files.back())));
+			index_stats.file_count++;
+		}
+		else if (type == "dir" && second_tab != std::string::npos) {
+			dir_path = line.substr(second_tab + 1);
+
+			uint64_t size;
+			int64_t mtime;
+			int64_t saved_mtime = 0;
+			std::stringstream mtime_stream(line.substr(first_tab + 1, second_tab - first_tab - 1));
+			mtime_stream >> saved_mtime;
+			if (!Filesystem::getFileInfo(dir_path, size, mtime) || mtime != saved_mtime) {
+				valid = false;
+				break;
+			}
+
+			dir = &index_dirs[getIndexKey(dir_path)];
+			dir->mtime = mtime;
+			index_stats.dir_count++;
+		}
+		else if (type == "root" && second_tab != std::string::npos) {
+			std::string root = line.substr(second_tab + 1);
+			int root_type = Parse::toInt(line.substr(first_tab + 1, second_tab - first_tab - 1));
+			if (root_index >= expected_roots.size() || root != expected_roots[root_index] || root_type != getRootType(root)) {
+				valid = false;
+				break;
+			}
+
+			index_roots.push_back(root);
+			index_stats.root_count++;
+			root_index++;
+			dir = NULL;
+
+			// archives are indexed from their own table of contents, which is always current
+			if (root_type == 2) {
+				PackArchive* archive = getArchive(root);
+				if (!archive) {
+					valid = false;
 					break;
 				}
+				indexArchive(root, archive);
 			}
 		}
+		else {
+			valid = false;
+		}
 	}
 
-	return ret;
+	if (!valid || root_index != expected_roots.size()) {
+		index_dirs.clear();
+		index_files.clear();
+		index_roots.clear();
+		unsigned archive_count = index_stats.archive_count;
+		index_stats = IndexStats();
+		index_stats.archive_count = archive_count;
+		return false;
+	}
+
+	return true;
+}
+
+void ModManager::saveIndex() {
+	Filesystem::createDir(settings->path_user + "cache/");
+
+	std::string filename = settings->path_user + "cache/mod_index.txt";
+	std::ofstream outfile(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!outfile.is_open()) {
+		Utils::logError("ModManager: Could not write mod index: %s", filename.c_str());
+		return;
+	}
+
+	outfile << "# Flare mod index. Generated by --cache-mod-index, do not edit.\n";
+
+	for (size_t i = 0; i < index_roots.size(); ++i) {
+		const std::string& root = index_roots[i];
+		std::string root_key = getIndexKey(root);
+		int root_type = getRootType(root);
+		outfile << "root\t" << root_type << "\t" << root << "\n";
+
+		if (root_type != 1)
+			continue;
+
+		// every directory below the root starts with the root's path
+		std::map<std::string, IndexDir>::iterator it = index_dirs.lower_bound(root_key);
+		for (; it != index_dirs.end() && it->first.compare(0, root_key.size(), root_key) == 0; ++it) {
+			if (it->first.size() > root_key.size() && it->first[root_key.size()] != '/' && it->first[root_key.size()] != '\\')
+				continue;
+
+			outfile << "dir\t" << it->second.mtime << "\t" << it->first << "\n";
+			for (size_t j = 0; j < it->second.files.size(); ++j) {
+				outfile << "file\t" << it->second.files[j] << "\n";
+			}
+		}
+	}
+
+	if (outfile.fail())
+		Utils::logError("ModManager: Could not write mod index: %s", filename.c_str());
+	outfile.close();
+}
+
+bool ModManager::indexedFileExists(const std::string& root, const std::string& path, bool is_indexed) {
+	if (!is_indexed) {
+		index_stats.disk_lookups++;
+		return Filesystem::fileExists(path);
+	}
+
+	indexRoot(root);
+	index_stats.index_lookups++;
+	return index_files.find(getIndexKey(path)) != index_files.end();
+}
+
+/**
+ * Adds the path to the list if it is a file, or the text files in it if it is a directory
+ */
+void ModManager::amendPathToVector(const std::string& root, const std::string& path, bool is_indexed, std::vector<std::string>& vec) {
+	if (!is_indexed) {
+		index_stats.disk_lookups++;
+		if (Filesystem::pathExists(path)) {
+			if (Filesystem::isDirectory(path)) {
+				Filesystem::getFileList(path, "txt", vec);
+			}
+			else {
+				vec.push_back(path);
+			}
+		}
+		return;
+	}
+
+	indexRoot(root);
+	index_stats.index_lookups++;
+
+	std::string key = getIndexKey(path);
+	std::map<std::string, IndexDir>::iterator it = index_dirs.find(key);
+	if (it != index_dirs.end()) {
+		const std::vector<std::string>& files = it->second.files;
+		for (size_t i = 0; i < files.size(); ++i) {
+			// same filter as Filesystem::getFileList()
+			if (files[i].length() > 3 && files[i].compare(files[i].length() - 3, 3, "txt") == 0)
+				vec.push_back(Filesystem::convertSlashes(path + "/" + files[i]));
+		}
+	}
+	else if (index_files.find(key) != index_files.end()) {
+		vec.push_back(path);
+	}
+}
+
+/**
+ * Paths with empty, "." or ".." components would have to be resolved before they could be found in the index,
+ * so those are checked on disk instead
+ */
+bool ModManager::isIndexedPath(const std::string& filename) {
+	std::string test = "/" + filename + "/";
+	for (size_t i = 0; i < test.size(); ++i) {
+		if (test[i] == '\\')
+			test[i] = '/';
+	}
+
+	return test.find("//") == std::string::npos && test.find("/./") == std::string::npos && test.find("/../") == std::string::npos;
+}
+
+/**
+ * Windows and macOS file systems ignore case by default, so the index does as well
+ */
+std::string ModManager::getIndexKey(const std::string& path) {
+#if defined(_WIN32) || defined(__APPLE__)
+	std::string key = path;
+	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+	return key;
+#else
+	return path;
+#endif
 }
 
 void ModManager::setPaths() {
@@ -337,7 +860,7 @@ void ModManager::setPaths() {
 
 Mod ModManager::loadMod(const std::string& name) {
 	Mod mod;
-	std::ifstream infile;
+	std::istringstream infile;
 	std::string line, key, val;
 
 	mod.name = name;
@@ -347,9 +870,7 @@ Mod ModManager::loadMod(const std::string& name) {
 	// @CLASS ModManager|Description of mod settings.txt
 	for (size_t i = 0; i < mod_paths.size(); ++i) {
 		std::string path = Filesystem::convertSlashes(mod_paths[i] + "mods/" + name + "/settings.txt");
-		infile.open(path.c_str(), std::ios::in);
-
-		if (infile.is_open()) {
+		if (openStream(path, infile)) {
 			settings_loaded = true;
 		}
 
@@ -422,13 +943,10 @@ Mod ModManager::loadMod(const std::string& name) {
 				Utils::logError("ModManager: Mod '%s' contains invalid key: '%s'", name.c_str(), key.c_str());
 			}
 		}
-		infile.close();
 		infile.clear();
 
 		path = Filesystem::convertSlashes(mod_paths[i] + "mods/" + name + "/engine/gameplay.txt");
-		infile.open(path.c_str(), std::ios::in);
-
-		if (infile.is_open()) {
+		if (openStream(path, infile)) {
 			gameplay_loaded = true;
 		}
 
@@ -447,7 +965,6 @@ Mod ModManager::loadMod(const std::string& name) {
 				mod.is_game_mod = Parse::toBool(val);
 			}
 		}
-		infile.close();
 		infile.clear();
 
 		if (settings_loaded && gameplay_loaded)
@@ -591,6 +1108,13 @@ void ModManager::resetModConfig() {
 	Filesystem::removeFile(config_path);
 }
 
+/**
+ * Closes all archives. Anything that still reads from one, such as streamed music or an open font, must be closed first.
+ */
 ModManager::~ModManager() {
 	Utils::logInfo("Cleaning up: ModManager");
+
+	for (std::map<std::string, PackArchive*>::iterator it = archives.begin(); it != archives.end(); ++it) {
+		delete it->second;
+	}
 }
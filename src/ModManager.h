@@ -21,6 +21,15 @@ class ModManager
 
 ModManager maintains a list of active mods and provides functions for checking
 mods in priority order when loading data files.
+
+Instead of probing the disk for every lookup, the directory tree of each active
+mod is walked once and kept in an index. locate() and list() are answered from
+the index, including lookups for files that don't exist.
+
+A mod can also be a .flarepak archive in place of its directory (see
+PackArchive). Paths inside an archive are resolved as if the directory
+existed, and loaders get their contents through getPackedFile(), readFile()
+or openRW() instead of opening them directly.
 */
 
 #ifndef MOD_MANAGER_H
@@ -28,6 +37,9 @@ mods in priority order when loading data files.
 
 #include "CommonIncludes.h"
 
+#include <stdint.h>
+
+class PackArchive;
 class Version;
 
 class Mod {
@@ -55,13 +67,70 @@ public:
 };
 
 class ModManager {
+public:
+	class IndexStats {
+	public:
+		IndexStats();
+
+		unsigned root_count;
+		unsigned archive_count;
+		unsigned dir_count;
+		unsigned file_count;
+		float build_ms;
+		bool loaded_from_cache;
+
+		unsigned locate_count;
+		unsigned locate_cache_hits;
+		unsigned locate_misses;
+		unsigned list_count;
+		unsigned index_lookups;
+		unsigned disk_lookups;
+	};
+
 private:
+	class IndexDir {
+	public:
+		IndexDir();
+
+		int64_t mtime;
+		std::vector<std::string> files; // in the order that the directory listed them
+	};
+
 	void loadModList();
 	void setPaths();
 
+	std::string getModRoot(size_t path_index, const std::string& mod_name);
+	void buildIndex();
+	void indexRoot(const std::string& root);
+	void indexDir(const std::string& path, unsigned depth);
+	void indexArchive(const std::string& root, PackArchive* archive);
+	int getRootType(const std::string& root);
+	bool loadIndex();
+	void saveIndex();
+	bool indexedFileExists(const std::string& root, const std::string& path, bool is_indexed);
+	void amendPathToVector(const std::string& root, const std::string& path, bool is_indexed, std::vector<std::string>& vec);
+
+	static bool isIndexedPath(const std::string& filename);
+	static std::string getIndexKey(const std::string& path);
+
+	void openArchive(const std::string& root);
+	PackArchive* getArchive(const std::string& root) const;
+	PackArchive* findArchive(const std::string& path, std::string& archive_path);
+
 	std::map<std::string,std::string> loc_cache;
 	std::vector<std::string> mod_paths;
 
+	// keys are full paths, see getIndexKey()
+	std::map<std::string, IndexDir> index_dirs;
+	std::set<std::string> index_files;
+	std::vector<std::string> index_roots;
+
+	IndexStats index_stats;
+
+	// keyed by mod directory, NULL if that mod has no archive
+	// filled in by the constructor, and only read after that, since image loading threads use it
+	std::map<std::string, PackArchive*> archives;
+
 	const std::vector<std::string> *cmd_line_mods;
 
 public:
@@ -91,6 +160,19 @@ public:
 	// that can be passed to locate() later
 	std::vector<std::string> list(const std::string& path, bool full_paths);
 
+	const IndexStats& getIndexStats();
+
+	// Returns true if the located file exists. Unlike Filesystem::fileExists(), this includes files in archives.
+	bool fileExists(const std::string& filename);
+
+	// Functions for reading located files, which may be inside an archive.
+	// The data from getPackedFile() is owned by the archive, and is valid until the ModManager is deleted.
+	bool getPackedFile(const std::string& path, const char*& data, size_t& size);
+	bool readFile(const std::string& path, std::string& buffer);
+	bool getFileInfo(const std::string& path, uint64_t& size, int64_t& mtime);
+	bool openStream(const std::string& path, std::istringstream& stream);
+	SDL_RWops* openRW(const std::string& path);
+
 	std::vector<std::string> mod_dirs;
 	std::vector<Mod> mod_list;
 };
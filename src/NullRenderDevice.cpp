@@ -0,0 +1,257 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include <SDL_image.h>
+
+#include "CursorManager.h"
+#include "EngineSettings.h"
+#include "IconManager.h"
+#include "InputState.h"
+#include "ModManager.h"
+#include "SharedResources.h"
+#include "Settings.h"
+
+#include "NullRenderDevice.h"
+#include "SDLFontEngine.h"
+
+NullImage::NullImage(RenderDevice *_device)
+	: Image(_device)
+	, width(0)
+	, height(0) {
+}
+
+NullImage::~NullImage() {
+}
+
+int NullImage::getWidth() const {
+	return width;
+}
+
+int NullImage::getHeight() const {
+	return height;
+}
+
+void NullImage::fillWithColor(const Color&) {
+}
+
+void NullImage::drawPixel(int, int, const Color&) {
+}
+
+void NullImage::drawLine(int, int, int, int, const Color&) {
+}
+
+void NullImage::drawFilledRect(int, int, int, int, const Color&) {
+}
+
+/**
+ * Deletes the original image and returns a pointer to the resized version
+ */
+Image* NullImage::resize(int _width, int _height) {
+	if (_width <= 0 || _height <= 0)
+		return NULL;
+
+	NullImage *scaled = new NullImage(device);
+	scaled->width = _width;
+	scaled->height = _height;
+
+	this->unref();
+	return scaled;
+}
+
+NullRenderDevice::NullRenderDevice() {
+	Utils::logInfo("RenderDevice: Using NullRenderDevice (nothing will be drawn)");
+
+	fullscreen = false;
+	hwsurface = false;
+	vsync = false;
+	texture_filter = false;
+
+	min_screen.x = eset->resolutions.min_screen_w;
+	min_screen.y = eset->resolutions.min_screen_h;
+}
+
+int NullRenderDevice::createContextInternal() {
+	// there is no window, so the video options don't matter
+	settings->safe_video = false;
+	settings->fullscreen = false;
+
+	if (!is_initialized) {
+		if (settings->screen_w < eset->resolutions.min_screen_w)
+			settings->screen_w = eset->resolutions.min_screen_w;
+		if (settings->screen_h < eset->resolutions.min_screen_h)
+			settings->screen_h = eset->resolutions.min_screen_h;
+
+		ignore_texture_filter = eset->resolutions.ignore_texture_filter;
+		is_initialized = true;
+
+		Utils::logInfo("RenderDevice: Virtual screen size is %dx%d", settings->screen_w, settings->screen_h);
+	}
+
+	windowResize();
+
+	// load persistent resources
+	delete icons;
+	icons = new IconManager();
+	delete curs;
+	curs = new CursorManager();
+
+	return 0;
+}
+
+void NullRenderDevice::createContextError() {
+	Utils::logError("NullRenderDevice: createContext() failed");
+}
+
+int NullRenderDevice::render(Renderable&, Rect&) {
+	return 0;
+}
+
+int NullRenderDevice::render(Sprite *r) {
+	if (r == NULL)
+		return -1;
+
+	return 0;
+}
+
+int NullRenderDevice::renderToImage(Image* src_image, Rect&, Image* dest_image, Rect&) {
+	if (!src_image || !dest_image) return -1;
+
+	return 0;
+}
+
+/**
+ * The text isn't drawn, but the image gets the size that the text would have
+ */
+Image* NullRenderDevice::renderTextToImage(FontStyle* font_style, const std::string& text, const Color&, bool) {
+	int w = 0;
+	int h = 0;
+
+	if (TTF_SizeUTF8(static_cast<SDLFontStyle *>(font_style)->ttfont, text.c_str(), &w, &h) != 0 || w == 0)
+		return NULL;
+
+	NullImage *image = new NullImage(this);
+	image->width = w;
+	image->height = h;
+
+	return image;
+}
+
+void NullRenderDevice::drawPixel(int, int, const Color&) {
+}
+
+void NullRenderDevice::drawLine(int, int, int, int, const Color&) {
+}
+
+void NullRenderDevice::drawRectangle(const Point&, const Point&, const Color&) {
+}
+
+void NullRenderDevice::blankScreen() {
+}
+
+void NullRenderDevice::commitFrame() {
+	inpt->window_resized = false;
+}
+
+void NullRenderDevice::destroyContext() {
+	releaseContextImages();
+	reload_graphics = true;
+
+	if (icons) {
+		delete icons;
+		icons = NULL;
+	}
+	if (curs) {
+		delete curs;
+		curs = NULL;
+	}
+}
+
+Image *NullRenderDevice::createImage(int width, int height) {
+	NullImage *image = new NullImage(this);
+	image->width = width;
+	image->height = height;
+
+	return image;
+}
+
+void NullRenderDevice::setGamma(float) {
+}
+
+void NullRenderDevice::resetGamma() {
+}
+
+void NullRenderDevice::updateTitleBar() {
+}
+
+unsigned short NullRenderDevice::getRefreshRate() {
+	return 0;
+}
+
+/**
+ * The file is decoded to check that it exists and to get its size. The pixels are not kept
+ */
+Image *NullRenderDevice::loadImage(const std::string& filename, int error_type) {
+	// lookup image in cache
+	Image *img;
+	img = cacheLookup(filename);
+	if (img != NULL) return img;
+
+	SDL_Surface *surface = IMG_Load_RW(mods->openRW(mods->locate(filename)), 1);
+	if (!surface) {
+		if (error_type != ERROR_NONE)
+			Utils::logError("NullRenderDevice: Couldn't load image: '%s'. %s", filename.c_str(), IMG_GetError());
+
+		if (error_type == ERROR_EXIT) {
+			mods->resetModConfig();
+			Utils::Exit(1);
+		}
+
+		return NULL;
+	}
+
+	NullImage *image = new NullImage(this);
+	image->width = surface->w;
+	image->height = surface->h;
+	SDL_FreeSurface(surface);
+
+	// store image to cache
+	cacheStore(filename, image);
+	return image;
+}
+
+void NullRenderDevice::getWindowSize(short unsigned *screen_w, short unsigned *screen_h) {
+	*screen_w = settings->screen_w;
+	*screen_h = settings->screen_h;
+}
+
+void NullRenderDevice::windowResize() {
+	windowResizeInternal();
+	settings->updateScreenVars();
+}
+
+/**
+ * Images are loaded one at a time, since nothing is gained from threads here
+ */
+void NullRenderDevice::loadQueuedImages() {
+	for (size_t i = 0; i < image_queue.size(); ++i) {
+		Image *image = loadImage(image_queue[i].filename, image_queue[i].error_type);
+		if (image)
+			image_queue_cleanup.push_back(image);
+	}
+
+	image_queue.clear();
+}
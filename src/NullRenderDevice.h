@@ -0,0 +1,87 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#ifndef NULLRENDERDEVICE_H
+#define NULLRENDERDEVICE_H
+
+#include "RenderDevice.h"
+
+/** Provide a rendering device that draws nothing.
+ *
+ * Used by headless mode, where there is no window to draw to. Images only
+ * keep their size, so that code which lays things out by image size still
+ * behaves the same. All drawing calls do nothing.
+ *
+ * @class NullRenderDevice
+ * @see RenderDevice
+ *
+ */
+
+
+class NullImage : public Image {
+public:
+	explicit NullImage(RenderDevice *device);
+	virtual ~NullImage();
+	int getWidth() const;
+	int getHeight() const;
+
+	void fillWithColor(const Color& color);
+	void drawPixel(int x, int y, const Color& color);
+	void drawLine(int x0, int y0, int x1, int y1, const Color& color);
+	void drawFilledRect(int x, int y, int w, int h, const Color& color);
+	Image* resize(int width, int height);
+
+	int width;
+	int height;
+};
+
+class NullRenderDevice : public RenderDevice {
+public:
+
+	NullRenderDevice();
+
+	virtual int render(Renderable& r, Rect& dest);
+	virtual int render(Sprite* r);
+	virtual int renderToImage(Image* src_image, Rect& src, Image* dest_image, Rect& dest);
+
+	Image* renderTextToImage(FontStyle* font_style, const std::string& text, const Color& color, bool blended);
+	void drawPixel(int x, int y, const Color& color);
+	void drawLine(int x0, int y0, int x1, int y1, const Color& color);
+	void drawRectangle(const Point& p0, const Point& p1, const Color& color);
+	void blankScreen();
+	void commitFrame();
+	void destroyContext();
+	void windowResize();
+	Image *createImage(int width, int height);
+	void setGamma(float g);
+	void resetGamma();
+	void updateTitleBar();
+	unsigned short getRefreshRate();
+
+	Image* loadImage(const std::string& filename, int error_type);
+
+	void loadQueuedImages();
+
+protected:
+	int createContextInternal();
+	void createContextError();
+
+private:
+	void getWindowSize(short unsigned *screen_w, short unsigned *screen_h);
+};
+
+#endif // NULLRENDERDEVICE_H
@@ -0,0 +1,80 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "NullSoundManager.h"
+
+NullSoundManager::NullSoundManager()
+	: SoundManager() {
+	Utils::logInfo("SoundManager: Using NullSoundManager (no audio device)");
+}
+
+NullSoundManager::~NullSoundManager() {
+}
+
+SoundID NullSoundManager::load(const std::string&, const std::string&) {
+	return 0;
+}
+
+void NullSoundManager::unload(SoundID) {
+}
+
+void NullSoundManager::play(SoundID, const std::string&, const FPoint&, bool, bool) {
+}
+
+void NullSoundManager::pauseChannel(const std::string&) {
+}
+
+void NullSoundManager::pauseAll() {
+}
+
+void NullSoundManager::resumeAll() {
+}
+
+void NullSoundManager::setVolumeSFX(int) {
+}
+
+void NullSoundManager::loadMusic(const std::string&) {
+}
+
+void NullSoundManager::unloadMusic() {
+}
+
+void NullSoundManager::playMusic() {
+}
+
+void NullSoundManager::stopMusic() {
+}
+
+void NullSoundManager::setVolumeMusic(int) {
+}
+
+bool NullSoundManager::isPlayingMusic() {
+	return false;
+}
+
+void NullSoundManager::logic() {
+}
+
+void NullSoundManager::reset() {
+}
+
+/**
+ * Nothing is ever played, so this always returns the "no sound" value
+ */
+SoundID NullSoundManager::getLastPlayedSID() {
+	return static_cast<SoundID>(-1);
+}
@@ -0,0 +1,208 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+
+#include "PackArchive.h"
+#include "Utils.h"
+#include "UtilsFileSystem.h"
+
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#define PACK_ARCHIVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+uint64_t readLE(const char* p, size_t bytes) {
+	uint64_t value = 0;
+	for (size_t i = bytes; i > 0; --i) {
+		value = (value << 8) | static_cast<unsigned char>(p[i-1]);
+	}
+	return value;
+}
+
+} // namespace
+
+const char PackArchive::MAGIC[] = "FLAREPAK";
+const std::string PackArchive::EXTENSION = ".flarepak";
+
+PackArchive::Entry::Entry()
+	: offset(0)
+	, size(0) {
+}
+
+PackArchive::PackArchive()
+	: data(NULL)
+	, data_size(0)
+	, is_mapped(false)
+	, mtime(0) {
+}
+
+PackArchive::~PackArchive() {
+	close();
+}
+
+bool PackArchive::open(const std::string& _filename) {
+	close();
+	filename = Filesystem::convertSlashes(_filename);
+
+	uint64_t size = 0;
+	if (!Filesystem::getFileInfo(filename, size, mtime))
+		return false;
+
+#ifdef PACK_ARCHIVE_MMAP
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd != -1) {
+		if (size > 0) {
+			void* mapping = mmap(NULL, static_cast<size_t>(size), PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping != MAP_FAILED) {
+				data = static_cast<const char*>(mapping);
+				data_size = static_cast<size_t>(size);
+				is_mapped = true;
+			}
+		}
+		::close(fd);
+	}
+#endif
+
+	if (!is_mapped) {
+		if (!Filesystem::readFile(filename, buffer))
+			return false;
+		data = buffer.data();
+		data_size = buffer.size();
+	}
+
+	if (!readIndex()) {
+		Utils::logError("PackArchive: '%s' is not a valid archive.", filename.c_str());
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void PackArchive::close() {
+#ifdef PACK_ARCHIVE_MMAP
+	if (is_mapped)
+		munmap(const_cast<char*>(data), data_size);
+#endif
+
+	data = NULL;
+	data_size = 0;
+	is_mapped = false;
+	std::string().swap(buffer);
+
+	entries.clear();
+	paths.clear();
+}
+
+bool PackArchive::readIndex() {
+	if (data_size < HEADER_SIZE || memcmp(data, MAGIC, MAGIC_LENGTH) != 0)
+		return false;
+
+	uint32_t version = static_cast<uint32_t>(readLE(data + 8, 4));
+	uint32_t entry_count = static_cast<uint32_t>(readLE(data + 12, 4));
+	uint64_t index_offset = readLE(data + 16, 8);
+
+	if (version != VERSION) {
+		Utils::logError("PackArchive: '%s' has version %u, but only version %u is supported.", filename.c_str(), version, VERSION);
+		return false;
+	}
+
+	if (index_offset < HEADER_SIZE || index_offset > data_size)
+		return false;
+
+	size_t pos = static_cast<size_t>(index_offset);
+	for (uint32_t i = 0; i < entry_count; ++i) {
+		if (data_size - pos < 2)
+			return false;
+		size_t path_length = static_cast<size_t>(readLE(data + pos, 2));
+		pos += 2;
+
+		if (data_size - pos < path_length + 28)
+			return false;
+		std::string path(data + pos, path_length);
+		pos += path_length;
+
+		Entry entry;
+		entry.offset = readLE(data + pos, 8);
+		entry.size = readLE(data + pos + 8, 8);
+		uint64_t stored_size = readLE(data + pos + 16, 8);
+		uint32_t method = static_cast<uint32_t>(readLE(data + pos + 24, 4));
+		pos += 28;
+
+		// file data lies between the header and the entry table
+		if (entry.offset < HEADER_SIZE || entry.offset > index_offset || entry.size > index_offset - entry.offset)
+			return false;
+
+		if (method != METHOD_STORE || stored_size != entry.size) {
+			Utils::logError("PackArchive: '%s' in '%s' uses an unsupported storage method.", path.c_str(), filename.c_str());
+			continue;
+		}
+
+		if (entries.insert(std::make_pair(getKey(path), entry)).second)
+			paths.push_back(path);
+	}
+
+	return true;
+}
+
+/**
+ * Gets the contents of a file in the archive
+ * The data is owned by the archive, and is valid until the archive is closed
+ */
+bool PackArchive::getFile(const std::string& path, const char*& file_data, size_t& file_size) {
+	std::map<std::string, Entry>::iterator it = entries.find(getKey(path));
+	if (it == entries.end())
+		return false;
+
+	file_data = data + it->second.offset;
+	file_size = static_cast<size_t>(it->second.size);
+	return true;
+}
+
+const std::vector<std::string>& PackArchive::getPaths() {
+	return paths;
+}
+
+const std::string& PackArchive::getFilename() {
+	return filename;
+}
+
+int64_t PackArchive::getModifiedTime() {
+	return mtime;
+}
+
+/**
+ * Archive paths always use '/', and ignore case where the file system usually does (see ModManager::getIndexKey())
+ */
+std::string PackArchive::getKey(const std::string& path) {
+	std::string key = path;
+	for (size_t i = 0; i < key.size(); ++i) {
+		if (key[i] == '\\')
+			key[i] = '/';
+	}
+#if defined(_WIN32) || defined(__APPLE__)
+	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+#endif
+	return key;
+}
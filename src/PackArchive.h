@@ -0,0 +1,96 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+
+/**
+ * class PackArchive
+ *
+ * Read access to a .flarepak archive, which holds the files of one mod in a single file.
+ *
+ * An archive at PATH/mods/NAME.flarepak is used in place of the directory PATH/mods/NAME, if that directory doesn't
+ * exist. ModManager resolves paths inside the archive as if the directory existed, and loaders get the contents of
+ * those files from getFile() instead of opening them.
+ *
+ * Where possible, the archive is memory-mapped, so getFile() returns a pointer into the mapping and nothing is read
+ * until it is used. Elsewhere, the whole archive is read into memory when it is opened. Either way, the data stays
+ * valid until the archive is closed, which allows music and fonts to be streamed from it.
+ *
+ * Format, with all integers little-endian:
+ * - header: "FLAREPAK", uint32 version, uint32 entry count, uint64 offset of the entry table
+ * - the data of every file
+ * - entry table: uint16 path length, path, uint64 offset, uint64 size, uint64 stored size, uint32 method
+ *
+ * Paths are relative to the mod directory and use '/' as the separator. The only method is METHOD_STORE; the field
+ * is reserved for compressed entries.
+ */
+
+#ifndef PACK_ARCHIVE_H
+#define PACK_ARCHIVE_H
+
+#include "CommonIncludes.h"
+
+#include <stdint.h>
+
+class PackArchive {
+private:
+	class Entry {
+	public:
+		Entry();
+
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	bool readIndex();
+
+	std::string filename;
+	std::map<std::string, Entry> entries;
+	std::vector<std::string> paths;
+
+	const char* data;
+	size_t data_size;
+	std::string buffer; // used when the archive can't be memory-mapped
+	bool is_mapped;
+
+	int64_t mtime;
+
+public:
+	static const char MAGIC[];
+	static const size_t MAGIC_LENGTH = 8;
+	static const size_t HEADER_SIZE = 24;
+	static const uint32_t VERSION = 1;
+	static const std::string EXTENSION;
+
+	enum {
+		METHOD_STORE = 0
+	};
+
+	PackArchive();
+	~PackArchive();
+
+	bool open(const std::string& _filename);
+	void close();
+
+	bool getFile(const std::string& path, const char*& file_data, size_t& file_size);
+	const std::vector<std::string>& getPaths();
+	const std::string& getFilename();
+	int64_t getModifiedTime();
+
+	static std::string getKey(const std::string& path);
+};
+
+#endif
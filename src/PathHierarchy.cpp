@@ -0,0 +1,535 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class PathHierarchy
+ */
+
+#include "MapCollision.h"
+#include "PathHierarchy.h"
+
+#include <cfloat>
+#include <cstdlib>
+#include <functional>
+
+PathHierarchy::Edge::Edge(int _target, float _cost)
+	: target(_target)
+	, cost(_cost)
+{
+}
+
+PathHierarchy::Node::Node()
+	: pos()
+	, cluster(-1)
+	, partner(-1)
+	, active(false)
+{
+}
+
+PathHierarchy::PathHierarchy()
+	: collider(NULL)
+	, movement_type(MapCollision::MOVE_NORMAL)
+	, cluster_size(0)
+	, clusters_w(0)
+	, clusters_h(0)
+	, diagonal_step_cost(Utils::calcDist(FPoint(0,0), FPoint(1,1)))
+	, has_dirty_clusters(false)
+	, generation(0)
+{
+}
+
+PathHierarchy::~PathHierarchy() {
+}
+
+void PathHierarchy::init(MapCollision* _collider, int _movement_type, int _cluster_size) {
+	collider = _collider;
+	movement_type = _movement_type;
+	cluster_size = _cluster_size;
+
+	nodes.clear();
+	free_nodes.clear();
+	borders_v.clear();
+	borders_h.clear();
+	dirty_clusters.clear();
+	has_dirty_clusters = false;
+	clusters_w = clusters_h = 0;
+
+	search_g.clear();
+	search_parent.clear();
+	search_gen.clear();
+	closed_gen.clear();
+	goal_gen.clear();
+	generation = 0;
+}
+
+/**
+ * Entities are ignored here, since they move around
+ * Tiles on the top and left map edges are never used by MapCollision::computePath(), so we exclude them too
+ */
+bool PathHierarchy::isPassable(int x, int y) const {
+	if (x < 1 || y < 1)
+		return false;
+
+	return collider->isValidStaticTile(x, y, movement_type);
+}
+
+int PathHierarchy::getCluster(const Point& p) const {
+	return (p.y / cluster_size) * clusters_w + (p.x / cluster_size);
+}
+
+Rect PathHierarchy::getClusterBounds(int cluster) const {
+	Rect r;
+	r.x = (cluster % clusters_w) * cluster_size;
+	r.y = (cluster / clusters_w) * cluster_size;
+	r.w = std::min(cluster_size, collider->map_size.x - r.x);
+	r.h = std::min(cluster_size, collider->map_size.y - r.y);
+	return r;
+}
+
+/**
+ * Collect the nodes inside a cluster from the (up to) four borders it shares with its neighbours
+ */
+void PathHierarchy::getClusterNodes(int cluster, std::vector<int>& cluster_nodes) const {
+	cluster_nodes.clear();
+
+	const int cx = cluster % clusters_w;
+	const int cy = cluster / clusters_w;
+
+	const std::vector<int>* borders[4] = {NULL, NULL, NULL, NULL};
+	if (cx > 0) borders[0] = &borders_v[cluster - 1];
+	if (cx < clusters_w - 1) borders[1] = &borders_v[cluster];
+	if (cy > 0) borders[2] = &borders_h[cluster - clusters_w];
+	if (cy < clusters_h - 1) borders[3] = &borders_h[cluster];
+
+	for (int i = 0; i < 4; ++i) {
+		if (!borders[i])
+			continue;
+
+		for (size_t j = 0; j < borders[i]->size(); ++j) {
+			int id = (*borders[i])[j];
+			if (nodes[id].cluster == cluster)
+				cluster_nodes.push_back(id);
+		}
+	}
+}
+
+int PathHierarchy::addNode(const Point& pos) {
+	int id;
+	if (!free_nodes.empty()) {
+		id = free_nodes.back();
+		free_nodes.pop_back();
+	}
+	else {
+		id = static_cast<int>(nodes.size());
+		nodes.push_back(Node());
+	}
+
+	nodes[id].pos = pos;
+	nodes[id].cluster = getCluster(pos);
+	nodes[id].partner = -1;
+	nodes[id].active = true;
+	nodes[id].edges.clear();
+
+	return id;
+}
+
+void PathHierarchy::addTransition(std::vector<int>& border, const Point& a, const Point& b) {
+	int node_a = addNode(a);
+	int node_b = addNode(b);
+	nodes[node_a].partner = node_b;
+	nodes[node_b].partner = node_a;
+	border.push_back(node_a);
+	border.push_back(node_b);
+}
+
+/**
+ * Places transition nodes on the border between the cluster at (cluster_x, cluster_y) and its right (vertical) or bottom neighbour
+ * Short openings get a single transition in the middle, longer ones get a transition at each end
+ */
+void PathHierarchy::buildBorder(int cluster_x, int cluster_y, bool vertical) {
+	const int border_id = cluster_y * clusters_w + cluster_x;
+	std::vector<int>& border = vertical ? borders_v[border_id] : borders_h[border_id];
+
+	for (size_t i = 0; i < border.size(); ++i) {
+		nodes[border[i]].active = false;
+		nodes[border[i]].edges.clear();
+		free_nodes.push_back(border[i]);
+	}
+	border.clear();
+
+	// first tile on the near side of the border, and the direction to walk along it
+	Point near_tile, step, across;
+	int length;
+	if (vertical) {
+		near_tile = Point((cluster_x + 1) * cluster_size - 1, cluster_y * cluster_size);
+		step = Point(0, 1);
+		across = Point(1, 0);
+		length = std::min(cluster_size, collider->map_size.y - near_tile.y);
+	}
+	else {
+		near_tile = Point(cluster_x * cluster_size, (cluster_y + 1) * cluster_size - 1);
+		step = Point(1, 0);
+		across = Point(0, 1);
+		length = std::min(cluster_size, collider->map_size.x - near_tile.x);
+	}
+
+	int opening_start = -1;
+	for (int i = 0; i <= length; ++i) {
+		bool open = false;
+		if (i < length) {
+			Point a(near_tile.x + step.x * i, near_tile.y + step.y * i);
+			open = isPassable(a.x, a.y) && isPassable(a.x + across.x, a.y + across.y);
+		}
+
+		if (open && opening_start == -1) {
+			opening_start = i;
+		}
+		else if (!open && opening_start != -1) {
+			int opening_end = i - 1;
+			if (opening_end - opening_start < 5) {
+				int mid = (opening_start + opening_end) / 2;
+				Point a(near_tile.x + step.x * mid, near_tile.y + step.y * mid);
+				addTransition(border, a, Point(a.x + across.x, a.y + across.y));
+			}
+			else {
+				Point a(near_tile.x + step.x * opening_start, near_tile.y + step.y * opening_start);
+				addTransition(border, a, Point(a.x + across.x, a.y + across.y));
+				a = Point(near_tile.x + step.x * opening_end, near_tile.y + step.y * opening_end);
+				addTransition(border, a, Point(a.x + across.x, a.y + across.y));
+			}
+			opening_start = -1;
+		}
+	}
+}
+
+/**
+ * Dijkstra search from source that does not leave the cluster
+ * Results are stored in cluster_dist, indexed relative to the cluster bounds
+ */
+void PathHierarchy::searchCluster(const Point& source, int cluster) {
+	const Rect bounds = getClusterBounds(cluster);
+
+	cluster_dist.assign(static_cast<size_t>(bounds.w * bounds.h), FLT_MAX);
+	queue.clear();
+
+	int source_index = (source.y - bounds.y) * bounds.w + (source.x - bounds.x);
+	cluster_dist[source_index] = 0;
+	queue.push_back(std::pair<float, int>(0, source_index));
+
+	while (!queue.empty()) {
+		std::pop_heap(queue.begin(), queue.end(), std::greater< std::pair<float, int> >());
+		float dist = queue.back().first;
+		int index = queue.back().second;
+		queue.pop_back();
+
+		if (dist > cluster_dist[index])
+			continue;
+
+		int x = index % bounds.w;
+		int y = index / bounds.w;
+
+		for (int dx = -1; dx <= 1; ++dx) {
+			for (int dy = -1; dy <= 1; ++dy) {
+				if (dx == 0 && dy == 0)
+					continue;
+
+				int nx = x + dx;
+				int ny = y + dy;
+				if (nx < 0 || ny < 0 || nx >= bounds.w || ny >= bounds.h)
+					continue;
+				if (!isPassable(bounds.x + nx, bounds.y + ny))
+					continue;
+
+				float new_dist = dist + ((dx != 0 && dy != 0) ? diagonal_step_cost : 1);
+				int neighbour_index = ny * bounds.w + nx;
+				if (new_dist < cluster_dist[neighbour_index]) {
+					cluster_dist[neighbour_index] = new_dist;
+					queue.push_back(std::pair<float, int>(new_dist, neighbour_index));
+					std::push_heap(queue.begin(), queue.end(), std::greater< std::pair<float, int> >());
+				}
+			}
+		}
+	}
+}
+
+void PathHierarchy::buildClusterEdges(int cluster) {
+	const Rect bounds = getClusterBounds(cluster);
+	std::vector<int> cluster_nodes;
+	getClusterNodes(cluster, cluster_nodes);
+
+	for (size_t i = 0; i < cluster_nodes.size(); ++i) {
+		nodes[cluster_nodes[i]].edges.clear();
+	}
+
+	// distances are symmetric, so each pair only needs to be searched once
+	for (size_t i = 0; i < cluster_nodes.size(); ++i) {
+		searchCluster(nodes[cluster_nodes[i]].pos, cluster);
+
+		for (size_t j = i + 1; j < cluster_nodes.size(); ++j) {
+			const Point& p = nodes[cluster_nodes[j]].pos;
+			float dist = cluster_dist[(p.y - bounds.y) * bounds.w + (p.x - bounds.x)];
+			if (dist != FLT_MAX) {
+				nodes[cluster_nodes[i]].edges.push_back(Edge(cluster_nodes[j], dist));
+				nodes[cluster_nodes[j]].edges.push_back(Edge(cluster_nodes[i], dist));
+			}
+		}
+	}
+}
+
+void PathHierarchy::build() {
+	nodes.clear();
+	free_nodes.clear();
+	has_dirty_clusters = false;
+
+	if (cluster_size <= 0 || !collider || collider->map_size.x <= 0 || collider->map_size.y <= 0)
+		return;
+
+	clusters_w = (collider->map_size.x + cluster_size - 1) / cluster_size;
+	clusters_h = (collider->map_size.y + cluster_size - 1) / cluster_size;
+
+	const size_t cluster_count = static_cast<size_t>(clusters_w * clusters_h);
+	borders_v.assign(cluster_count, std::vector<int>());
+	borders_h.assign(cluster_count, std::vector<int>());
+	dirty_clusters.assign(cluster_count, false);
+
+	for (int cy = 0; cy < clusters_h; ++cy) {
+		for (int cx = 0; cx < clusters_w; ++cx) {
+			if (cx < clusters_w - 1)
+				buildBorder(cx, cy, true);
+			if (cy < clusters_h - 1)
+				buildBorder(cx, cy, false);
+		}
+	}
+
+	for (size_t i = 0; i < cluster_count; ++i) {
+		buildClusterEdges(static_cast<int>(i));
+	}
+}
+
+void PathHierarchy::invalidateTile(int x, int y) {
+	if (cluster_size <= 0 || dirty_clusters.empty())
+		return;
+
+	dirty_clusters[getCluster(Point(x, y))] = true;
+	has_dirty_clusters = true;
+}
+
+/**
+ * A changed tile can open or close entrances on any border of its cluster
+ * So we rebuild those borders, then the edges of every cluster that touches them
+ */
+void PathHierarchy::rebuildDirtyClusters() {
+	std::set<int> rebuild_edges;
+
+	for (size_t i = 0; i < dirty_clusters.size(); ++i) {
+		if (!dirty_clusters[i])
+			continue;
+
+		dirty_clusters[i] = false;
+
+		const int cluster = static_cast<int>(i);
+		const int cx = cluster % clusters_w;
+		const int cy = cluster / clusters_w;
+
+		rebuild_edges.insert(cluster);
+		if (cx > 0) {
+			buildBorder(cx - 1, cy, true);
+			rebuild_edges.insert(cluster - 1);
+		}
+		if (cx < clusters_w - 1) {
+			buildBorder(cx, cy, true);
+			rebuild_edges.insert(cluster + 1);
+		}
+		if (cy > 0) {
+			buildBorder(cx, cy - 1, false);
+			rebuild_edges.insert(cluster - clusters_w);
+		}
+		if (cy < clusters_h - 1) {
+			buildBorder(cx, cy, false);
+			rebuild_edges.insert(cluster + clusters_w);
+		}
+	}
+
+	for (std::set<int>::iterator it = rebuild_edges.begin(); it != rebuild_edges.end(); ++it) {
+		buildClusterEdges(*it);
+	}
+
+	has_dirty_clusters = false;
+}
+
+/**
+ * Paths between the same or neighbouring clusters are short enough for a regular search
+ */
+bool PathHierarchy::isNearby(const Point& start, const Point& end) {
+	if (cluster_size <= 0)
+		return true;
+
+	return abs(start.x / cluster_size - end.x / cluster_size) <= 1 && abs(start.y / cluster_size - end.y / cluster_size) <= 1;
+}
+
+size_t PathHierarchy::getNodeCount() {
+	return nodes.size() - free_nodes.size();
+}
+
+/**
+ * Find a path on the abstract graph
+ * The resulting waypoints are stored from end to start (excluding start) so they can be refined in the same order as MapCollision paths
+ * @return true if a path is found
+ */
+bool PathHierarchy::findPath(const Point& start, const Point& end, std::vector<Point>& waypoints) {
+	waypoints.clear();
+
+	if (!isEnabled() || !isPassable(start.x, start.y) || !isPassable(end.x, end.y))
+		return false;
+
+	if (has_dirty_clusters)
+		rebuildDirtyClusters();
+
+	const int start_cluster = getCluster(start);
+	const int end_cluster = getCluster(end);
+
+	// per-node search data; the two extra slots are the start and goal
+	const int start_id = static_cast<int>(nodes.size());
+	const int goal_id = start_id + 1;
+	if (search_g.size() < nodes.size() + 2) {
+		search_g.resize(nodes.size() + 2);
+		search_parent.resize(nodes.size() + 2);
+		search_gen.resize(nodes.size() + 2, 0);
+		closed_gen.resize(nodes.size() + 2, 0);
+		goal_gen.resize(nodes.size() + 2, 0);
+	}
+	generation++;
+	if (generation == 0) {
+		search_gen.assign(search_gen.size(), 0);
+		closed_gen.assign(closed_gen.size(), 0);
+		goal_gen.assign(goal_gen.size(), 0);
+		generation = 1;
+	}
+
+	// connect the start tile to the nodes in its cluster
+	searchCluster(start, start_cluster);
+	Rect bounds = getClusterBounds(start_cluster);
+	getClusterNodes(start_cluster, cluster_node_list);
+	start_nodes.clear();
+	start_costs.clear();
+	for (size_t i = 0; i < cluster_node_list.size(); ++i) {
+		const Point& p = nodes[cluster_node_list[i]].pos;
+		float dist = cluster_dist[(p.y - bounds.y) * bounds.w + (p.x - bounds.x)];
+		if (dist != FLT_MAX) {
+			start_nodes.push_back(cluster_node_list[i]);
+			start_costs.push_back(dist);
+		}
+	}
+
+	// connect the nodes in the goal cluster to the goal tile
+	searchCluster(end, end_cluster);
+	bounds = getClusterBounds(end_cluster);
+	getClusterNodes(end_cluster, cluster_node_list);
+	if (goal_costs.size() < nodes.size())
+		goal_costs.resize(nodes.size());
+	bool has_goal_nodes = false;
+	for (size_t i = 0; i < cluster_node_list.size(); ++i) {
+		const Point& p = nodes[cluster_node_list[i]].pos;
+		float dist = cluster_dist[(p.y - bounds.y) * bounds.w + (p.x - bounds.x)];
+		if (dist != FLT_MAX) {
+			goal_gen[cluster_node_list[i]] = generation;
+			goal_costs[cluster_node_list[i]] = dist;
+			has_goal_nodes = true;
+		}
+	}
+
+	if (start_nodes.empty() || !has_goal_nodes)
+		return false;
+
+	// A* over the abstract graph
+	const FPoint goal_pos(end);
+	queue.clear();
+	search_gen[start_id] = generation;
+	search_g[start_id] = 0;
+	search_parent[start_id] = -1;
+	queue.push_back(std::pair<float, int>(Utils::calcDist(FPoint(start), goal_pos), start_id));
+
+	bool found = false;
+	while (!queue.empty()) {
+		std::pop_heap(queue.begin(), queue.end(), std::greater< std::pair<float, int> >());
+		int current = queue.back().second;
+		queue.pop_back();
+
+		if (closed_gen[current] == generation)
+			continue;
+		closed_gen[current] = generation;
+
+		if (current == goal_id) {
+			found = true;
+			break;
+		}
+
+		// gather the outgoing edges of the current node
+		const float current_g = search_g[current];
+		const size_t edge_count = (current == start_id) ? start_nodes.size() : nodes[current].edges.size() + 2;
+
+		for (size_t i = 0; i < edge_count; ++i) {
+			int target;
+			float cost;
+
+			if (current == start_id) {
+				target = start_nodes[i];
+				cost = start_costs[i];
+			}
+			else if (i < nodes[current].edges.size()) {
+				target = nodes[current].edges[i].target;
+				cost = nodes[current].edges[i].cost;
+			}
+			else if (i == nodes[current].edges.size()) {
+				target = nodes[current].partner;
+				cost = 1;
+			}
+			else {
+				if (goal_gen[current] != generation)
+					continue;
+				target = goal_id;
+				cost = goal_costs[current];
+			}
+
+			if (target < 0 || closed_gen[target] == generation)
+				continue;
+
+			float new_g = current_g + cost;
+			if (search_gen[target] != generation || new_g < search_g[target]) {
+				search_gen[target] = generation;
+				search_g[target] = new_g;
+				search_parent[target] = current;
+
+				float h = (target == goal_id) ? 0 : Utils::calcDist(FPoint(nodes[target].pos), goal_pos);
+				queue.push_back(std::pair<float, int>(new_g + h, target));
+				std::push_heap(queue.begin(), queue.end(), std::greater< std::pair<float, int> >());
+			}
+		}
+	}
+
+	if (!found)
+		return false;
+
+	waypoints.push_back(end);
+	for (int id = search_parent[goal_id]; id != start_id && id != -1; id = search_parent[id]) {
+		const Point& p = nodes[id].pos;
+		if (waypoints.back().x != p.x || waypoints.back().y != p.y)
+			waypoints.push_back(p);
+	}
+
+	return true;
+}
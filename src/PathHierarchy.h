@@ -0,0 +1,117 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class PathHierarchy
+ *
+ * Abstract graph over the collision map used to plan long paths (HPA*).
+ *
+ * The map is split into square clusters. Wherever two neighbouring clusters share walkable border tiles,
+ * a pair of nodes (one on each side) is placed. Nodes in the same cluster are connected with the cost of
+ * the shortest path between them that stays inside the cluster.
+ *
+ * Tiles occupied by entities are treated as walkable here. They are handled when the abstract path is
+ * refined into a tile path by MapCollision.
+ */
+
+#ifndef PATH_HIERARCHY_H
+#define PATH_HIERARCHY_H
+
+#include "CommonIncludes.h"
+#include "Utils.h"
+
+class MapCollision;
+
+class PathHierarchy {
+private:
+	class Edge {
+	public:
+		int target;
+		float cost;
+		Edge(int _target, float _cost);
+	};
+
+	class Node {
+	public:
+		Point pos;
+		int cluster;
+		int partner; // the node on the other side of the cluster border
+		bool active;
+		std::vector<Edge> edges; // connections to other nodes in the same cluster
+		Node();
+	};
+
+	bool isPassable(int x, int y) const;
+	int getCluster(const Point& p) const;
+	Rect getClusterBounds(int cluster) const;
+	void getClusterNodes(int cluster, std::vector<int>& cluster_node_list) const;
+
+	int addNode(const Point& pos);
+	void addTransition(std::vector<int>& border, const Point& a, const Point& b);
+	void buildBorder(int cluster_x, int cluster_y, bool vertical);
+	void buildClusterEdges(int cluster);
+	void searchCluster(const Point& source, int cluster);
+	void rebuildDirtyClusters();
+
+	MapCollision* collider;
+	int movement_type;
+	int cluster_size;
+	int clusters_w;
+	int clusters_h;
+	float diagonal_step_cost;
+
+	std::vector<Node> nodes;
+	std::vector<int> free_nodes;
+
+	// node ids created by each border, indexed by the cluster to the left (vertical) or above (horizontal)
+	std::vector< std::vector<int> > borders_v;
+	std::vector< std::vector<int> > borders_h;
+
+	std::vector<bool> dirty_clusters;
+	bool has_dirty_clusters;
+
+	// scratch space reused between searches
+	std::vector<float> cluster_dist;
+	std::vector< std::pair<float, int> > queue;
+	std::vector<int> cluster_node_list;
+	std::vector<int> start_nodes;
+	std::vector<float> start_costs;
+	std::vector<float> goal_costs;
+	std::vector<float> search_g;
+	std::vector<int> search_parent;
+	std::vector<unsigned> search_gen;
+	std::vector<unsigned> closed_gen;
+	std::vector<unsigned> goal_gen;
+	unsigned generation;
+
+public:
+	PathHierarchy();
+	~PathHierarchy();
+
+	void init(MapCollision* _collider, int _movement_type, int _cluster_size);
+	void build();
+	void invalidateTile(int x, int y);
+
+	bool isEnabled() { return cluster_size > 0 && !nodes.empty(); }
+	bool isNearby(const Point& start, const Point& end);
+	int getClusterSize() { return cluster_size; }
+	size_t getNodeCount();
+
+	bool findPath(const Point& start, const Point& end, std::vector<Point>& waypoints);
+};
+
+#endif
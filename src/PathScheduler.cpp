@@ -0,0 +1,242 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "EngineSettings.h"
+#include "Entity.h"
+#include "MapRenderer.h"
+#include "PathScheduler.h"
+#include "SharedGameResources.h"
+#include "SharedResources.h"
+
+PathScheduler::Request::Request()
+	: owner(NULL)
+	, dest()
+	, movement_type(0)
+{
+}
+
+PathScheduler::Result::Result()
+	: owner(NULL)
+	, path()
+	, found(false)
+{
+}
+
+PathScheduler::PathScheduler()
+	: count_queued(0)
+	, count_served(0)
+	, count_merged(0)
+	, count_expansions(0)
+{
+}
+
+PathScheduler::~PathScheduler() {
+}
+
+/**
+ * Queues a path search from the owner's position to dest
+ * If the owner already has a queued request, it is updated instead
+ */
+void PathScheduler::request(Entity* owner, const FPoint& dest, int movement_type) {
+	for (size_t i = 0; i < requests.size(); ++i) {
+		if (requests[i].owner == owner) {
+			requests[i].dest = dest;
+			requests[i].movement_type = movement_type;
+			return;
+		}
+	}
+
+	Request r;
+	r.owner = owner;
+	r.dest = dest;
+	r.movement_type = movement_type;
+	requests.push_back(r);
+}
+
+/**
+ * Drops any queued request and unclaimed result for the owner
+ */
+void PathScheduler::cancel(Entity* owner) {
+	for (size_t i = requests.size(); i > 0; --i) {
+		if (requests[i-1].owner == owner)
+			requests.erase(requests.begin() + (i-1));
+	}
+	for (size_t i = results.size(); i > 0; --i) {
+		if (results[i-1].owner == owner) {
+			results[i-1].path.swap(results.back().path);
+			results[i-1].owner = results.back().owner;
+			results[i-1].found = results.back().found;
+			results.pop_back();
+		}
+	}
+}
+
+bool PathScheduler::isPending(Entity* owner) {
+	for (size_t i = 0; i < requests.size(); ++i) {
+		if (requests[i].owner == owner)
+			return true;
+	}
+	for (size_t i = 0; i < results.size(); ++i) {
+		if (results[i].owner == owner)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * If a search for the owner has finished, its path replaces the contents of 'path'
+ * @return true if a result was available
+ */
+bool PathScheduler::getResult(Entity* owner, std::vector<FPoint>& path, bool& found) {
+	for (size_t i = 0; i < results.size(); ++i) {
+		if (results[i].owner != owner)
+			continue;
+
+		path.swap(results[i].path);
+		found = results[i].found;
+
+		results[i].path.swap(results.back().path);
+		results[i].owner = results.back().owner;
+		results[i].found = results.back().found;
+		results.pop_back();
+		return true;
+	}
+	return false;
+}
+
+PathScheduler::Result& PathScheduler::addResult(Entity* owner) {
+	// an entity only keeps its most recent result
+	for (size_t i = 0; i < results.size(); ++i) {
+		if (results[i].owner == owner) {
+			results[i].path.clear();
+			results[i].found = false;
+			return results[i];
+		}
+	}
+
+	results.resize(results.size() + 1);
+	results.back().owner = owner;
+	return results.back();
+}
+
+/**
+ * Tries to reuse a path that was computed for another entity with the same destination
+ * The entity needs to be close to a node of the path and be able to walk straight to it
+ */
+bool PathScheduler::sharePath(const std::vector<FPoint>& source_path, Entity* owner, int movement_type, std::vector<FPoint>& path) {
+	const FPoint& pos = owner->stats.pos;
+	const float merge_dist = static_cast<float>(MERGE_DISTANCE);
+
+	// the entity is standing on its own tile, so clear it while testing movement
+	Point tile(pos);
+	unsigned short tile_type = mapr->collider.colmap(tile.x, tile.y);
+	bool pos_blocks = (tile_type == MapCollision::BLOCKS_ENTITIES || tile_type == MapCollision::BLOCKS_ENEMIES);
+	if (pos_blocks)
+		mapr->collider.unblock(pos.x, pos.y);
+
+	// paths are stored from end to start, so the first suitable node is the one that skips the most of the path
+	size_t join = source_path.size();
+	for (size_t i = 0; i < source_path.size(); ++i) {
+		if (Utils::calcDist(pos, source_path[i]) > merge_dist)
+			continue;
+
+		if (mapr->collider.lineOfMovement(pos.x, pos.y, source_path[i].x, source_path[i].y, movement_type)) {
+			join = i;
+			break;
+		}
+	}
+
+	if (pos_blocks)
+		mapr->collider.block(pos.x, pos.y, tile_type == MapCollision::BLOCKS_ENEMIES);
+
+	if (join == source_path.size())
+		return false;
+
+	path.assign(source_path.begin(), source_path.begin() + join + 1);
+	return true;
+}
+
+/**
+ * Runs queued searches until this frame's node budget is used up
+ */
+void PathScheduler::logic() {
+	const unsigned budget = static_cast<unsigned>(eset->misc.path_budget);
+	const unsigned expansions_start = mapr->collider.getPathExpansions();
+
+	count_served = 0;
+	count_merged = 0;
+	count_expansions = 0;
+
+	size_t next = 0;
+	while (next < requests.size() && (budget == 0 || count_expansions < budget)) {
+		Request leader = requests[next];
+		next++;
+
+		// this request was merged with an earlier one
+		if (!leader.owner)
+			continue;
+
+		Result& result = addResult(leader.owner);
+		result.found = mapr->collider.computePath(leader.owner->stats.pos, leader.dest, result.path, leader.movement_type, MapCollision::DEFAULT_PATH_LIMIT);
+		count_served++;
+		count_expansions = mapr->collider.getPathExpansions() - expansions_start;
+
+		if (!result.found)
+			continue;
+
+		// copy the path, since adding results may move it
+		Point dest_tile(leader.dest);
+		shared_path = result.path;
+
+		for (size_t i = next; i < requests.size(); ++i) {
+			if (!requests[i].owner || requests[i].movement_type != leader.movement_type)
+				continue;
+
+			Point tile(requests[i].dest);
+			if (tile.x != dest_tile.x || tile.y != dest_tile.y)
+				continue;
+
+			// if the entity is too far from the shared path, it will get its own search
+			if (sharePath(shared_path, requests[i].owner, requests[i].movement_type, merged_path)) {
+				Result& merged = addResult(requests[i].owner);
+				merged.path.swap(merged_path);
+				merged.found = true;
+				requests[i].owner = NULL;
+				count_merged++;
+			}
+		}
+	}
+
+	// remove handled requests, keeping the order of the rest
+	size_t count = 0;
+	for (size_t i = next; i < requests.size(); ++i) {
+		if (requests[i].owner)
+			requests[count++] = requests[i];
+	}
+	requests.resize(count);
+
+	count_queued = static_cast<unsigned>(requests.size());
+}
+
+/**
+ * Drops all requests and results. Used when changing maps
+ */
+void PathScheduler::clear() {
+	requests.clear();
+	results.clear();
+	count_queued = count_served = count_merged = count_expansions = 0;
+}
@@ -0,0 +1,93 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class PathScheduler
+ *
+ * Queues path searches for entities and runs them at the end of the entity logic phase.
+ *
+ * Each frame, searches are run until the number of expanded path nodes exceeds the budget set by the
+ * path_budget engine setting. Any remaining requests wait for the next frame. Until its result arrives,
+ * an entity keeps following its previous path.
+ *
+ * Requests that share a destination tile and movement type are merged: once one of them is solved,
+ * the others reuse its path if they can walk straight onto it.
+ */
+
+#ifndef PATH_SCHEDULER_H
+#define PATH_SCHEDULER_H
+
+#include "CommonIncludes.h"
+#include "Utils.h"
+
+class Entity;
+
+class PathScheduler {
+private:
+	static const int MERGE_DISTANCE = 3; // how far away from a shared path an entity can be to use it
+
+	class Request {
+	public:
+		Entity* owner;
+		FPoint dest;
+		int movement_type;
+		Request();
+	};
+
+	class Result {
+	public:
+		Entity* owner;
+		std::vector<FPoint> path;
+		bool found;
+		Result();
+	};
+
+	Result& addResult(Entity* owner);
+	bool sharePath(const std::vector<FPoint>& source_path, Entity* owner, int movement_type, std::vector<FPoint>& path);
+
+	std::vector<Request> requests;
+	std::vector<Result> results;
+
+	// scratch space used when merging requests
+	std::vector<FPoint> shared_path;
+	std::vector<FPoint> merged_path;
+
+	// counters for the most recent frame
+	unsigned count_queued;
+	unsigned count_served;
+	unsigned count_merged;
+	unsigned count_expansions;
+
+public:
+	PathScheduler();
+	~PathScheduler();
+
+	void request(Entity* owner, const FPoint& dest, int movement_type);
+	void cancel(Entity* owner);
+	bool isPending(Entity* owner);
+	bool getResult(Entity* owner, std::vector<FPoint>& path, bool& found);
+
+	void logic();
+	void clear();
+
+	unsigned getQueuedCount() { return count_queued; }
+	unsigned getServedCount() { return count_served; }
+	unsigned getMergedCount() { return count_merged; }
+	unsigned getExpansionCount() { return count_expansions; }
+};
+
+#endif
@@ -203,7 +203,7 @@ void PowerManager::loadEffects() {
 	FileParser infile;
 
 	// @CLASS PowerManager: Effects|Description of powers/effects.txt
-	if (!infile.open("powers/effects.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL))
+	if (!infile.open("powers/effects.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE))
 		return;
 
 	EffectDef temp;
@@ -334,7 +334,7 @@ void PowerManager::loadPowers() {
 	FileParser infile;
 
 	// @CLASS PowerManager: Powers|Description of powers/powers.txt
-	if (!infile.open("powers/powers.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL))
+	if (!infile.open("powers/powers.txt", FileParser::MOD_FILE, FileParser::ERROR_NORMAL, FileParser::USE_CACHE))
 		return;
 
 	bool clear_post_effects = false;
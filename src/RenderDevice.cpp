@@ -17,9 +17,12 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 */
 
 #include "EngineSettings.h"
+#include "FontEngine.h"
+#include "MapRenderer.h"
 #include "ModManager.h"
 #include "RenderDevice.h"
 #include "Settings.h"
+#include "SharedGameResources.h"
 #include "SharedResources.h"
 #include "UtilsMath.h"
 
@@ -32,11 +35,13 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 Image::Image(RenderDevice *_device)
 	: device(_device)
 	, ref_counter(1) {
+	device->image_create_count++;
 }
 
 Image::~Image() {
 	// remove this image from the cache
 	device->freeImage(this);
+	device->image_destroy_count++;
 }
 
 void Image::ref() {
@@ -173,6 +178,13 @@ RenderDevice::RenderDevice()
 	, is_initialized(false)
 	, reload_graphics(false)
 	, ddpi(0)
+	, sprite_count(0)
+	, draw_call_count(0)
+	, last_sprite_count(0)
+	, last_draw_call_count(0)
+	, image_create_count(0)
+	, image_destroy_count(0)
+	, draw_category(DRAW_MENU)
 {
 }
 
@@ -264,6 +276,18 @@ void RenderDevice::cacheRemoveAll() {
 	}
 }
 
+/**
+ * Frees the images that are kept outside of the image cache, but belong to the current context just the same
+ */
+void RenderDevice::releaseContextImages() {
+	cacheRemoveAll();
+
+	if (font)
+		font->clearImages();
+	if (mapr)
+		mapr->invalidateLayerCache();
+}
+
 bool RenderDevice::localToGlobal(Sprite *r) {
 	m_clip = r->getClip();
 
@@ -309,6 +333,50 @@ bool RenderDevice::localToGlobal(Sprite *r) {
 	return true;
 }
 
+/**
+ * Called at the end of each frame
+ */
+void RenderDevice::resetDrawCounts() {
+	last_sprite_count = sprite_count;
+	last_draw_call_count = draw_call_count;
+	sprite_count = 0;
+	draw_call_count = 0;
+}
+
+/**
+ * Adds lines describing the last frame to the dev HUD. Only StatsRenderDevice records anything
+ */
+void RenderDevice::getStatsText(std::vector<std::string>&) {
+}
+
+/**
+ * Drawing images with renderToImage() onto a new, cleared image leaves colors in it that are premultiplied by alpha.
+ * Drawing that image as usual would apply alpha twice, and darken any soft edges. This changes the image, or how it is
+ * drawn, so that it looks the same as the images it was made from. Returns false if the backend can't do that, in which
+ * case the image should not be drawn in place of its parts
+ */
+bool RenderDevice::finishComposedImage(Image*) {
+	return false;
+}
+
+/**
+ * Layers need premultiplied alpha blending, which not every backend has
+ */
+bool RenderDevice::supportsLayers() {
+	return false;
+}
+
+/**
+ * Clears the layer and draws everything after this into it. The screen position origin is drawn at the top-left of the layer
+ * Returns false if layers aren't supported, in which case nothing changes
+ */
+bool RenderDevice::beginLayer(Image*, const Point&) {
+	return false;
+}
+
+void RenderDevice::endLayer() {
+}
+
 bool RenderDevice::reloadGraphics() {
 	if (reload_graphics) {
 		reload_graphics = false;
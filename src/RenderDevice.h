@@ -127,6 +127,7 @@ private:
 	virtual ~Image();
 	friend class SDLSoftwareImage;
 	friend class SDLHardwareImage;
+	friend class NullImage;
 
 private:
 	RenderDevice *device;
@@ -144,7 +145,9 @@ public:
 		TYPE_NORMAL = 0,
 		TYPE_HERO = 1,
 		TYPE_ENEMY = 2,
-		TYPE_ALLY = 3
+		TYPE_ALLY = 3,
+		TYPE_LOOT = 4,
+		TYPE_HAZARD = 5
 	};
 
 	Image *image; // image to be used
@@ -222,6 +225,17 @@ public:
 		ERROR_EXIT = 2
 	};
 
+	// what a draw call is for, so that StatsRenderDevice can break down its counters
+	enum {
+		DRAW_MAP = 0,
+		DRAW_ENTITY = 1,
+		DRAW_HAZARD = 2,
+		DRAW_LOOT = 3,
+		DRAW_MENU = 4,
+		DRAW_TEXT = 5,
+		DRAW_CATEGORY_COUNT = 6
+	};
+
 	static const unsigned char BITS_PER_PIXEL;
 
 	RenderDevice();
@@ -243,6 +257,7 @@ public:
 	virtual int render(Sprite* r) = 0;
 	virtual int render(Renderable& r, Rect& dest) = 0;
 	virtual int renderToImage(Image* src_image, Rect& src, Image* dest_image, Rect& dest) = 0;
+	virtual bool finishComposedImage(Image* image);
 	virtual Image* renderTextToImage(FontStyle* font_style, const std::string& text, const Color& color, bool blended) = 0;
 	virtual void blankScreen() = 0;
 	virtual void commitFrame() = 0;
@@ -256,11 +271,29 @@ public:
 	virtual void setFullscreen(bool enable_fullscreen);
 	virtual unsigned short getRefreshRate();
 
-	bool reloadGraphics();
+	virtual bool reloadGraphics();
+
+	// number of sprites drawn and of draw calls made to the backend in the last frame
+	unsigned getSpriteCount() { return last_sprite_count; }
+	unsigned getDrawCallCount() { return last_draw_call_count; }
+
+	// number of images created and destroyed since this device was created
+	unsigned getImageCreateCount() { return image_create_count; }
+	unsigned getImageDestroyCount() { return image_destroy_count; }
 
-	void pushQueuedImage(const std::string& filename, int error_type);
+	// untagged drawing counts as DRAW_MENU
+	void setDrawCategory(int category) { draw_category = category; }
+	int getDrawCategory() { return draw_category; }
+	virtual void getStatsText(std::vector<std::string>& lines);
+
+	// drawing between beginLayer() and endLayer() goes into the layer image instead of the screen
+	virtual bool supportsLayers();
+	virtual bool beginLayer(Image* layer, const Point& origin);
+	virtual void endLayer();
+
+	virtual void pushQueuedImage(const std::string& filename, int error_type);
 	virtual void loadQueuedImages() = 0;
-	void cleanupQueuedImages();
+	virtual void cleanupQueuedImages();
 
 protected:
 	/* Compute clipping and global position from local frame. */
@@ -271,7 +304,9 @@ protected:
 	void cacheStore(const std::string &filename, Image *);
 	void cacheRemove(Image *image);
 	void cacheRemoveAll();
+	void releaseContextImages();
 	void windowResizeInternal();
+	void resetDrawCounts();
 
 	/** Context operations */
 	virtual int createContextInternal() = 0;
@@ -293,6 +328,14 @@ protected:
 	Rect m_clip;
 	Rect m_dest;
 
+	unsigned sprite_count;
+	unsigned draw_call_count;
+	unsigned last_sprite_count;
+	unsigned last_draw_call_count;
+	unsigned image_create_count;
+	unsigned image_destroy_count;
+	int draw_category;
+
 	std::vector<QueuedImage> image_queue;
 	std::vector<Image*> image_queue_cleanup;
 
@@ -302,6 +345,8 @@ private:
 
 	IMAGE_CACHE_CONTAINER cache;
 
+	friend class Image;
+
 	virtual void getWindowSize(short unsigned *screen_w, short unsigned *screen_h) = 0;
 };
 
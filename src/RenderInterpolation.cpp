@@ -0,0 +1,113 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "Avatar.h"
+#include "EntityManager.h"
+#include "Hazard.h"
+#include "HazardManager.h"
+#include "MapRenderer.h"
+#include "NPC.h"
+#include "NPCManager.h"
+#include "RenderInterpolation.h"
+#include "SharedGameResources.h"
+
+const float RenderInterpolation::SNAP_DISTANCE = 2.f;
+
+RenderInterpolation::RenderInterpolation() {
+}
+
+RenderInterpolation::~RenderInterpolation() {
+}
+
+/**
+ * Adds the position of every object that is drawn with interpolation
+ */
+void RenderInterpolation::getPositions(std::vector<Position>& _positions) {
+	_positions.push_back(Position(&mapr->cam.pos, 0));
+	_positions.push_back(Position(&mapr->cam.shake, 0));
+	_positions.push_back(Position(&pc->stats.pos, pc->serial));
+
+	for (size_t i = 0; i < entitym->entities.size(); ++i) {
+		_positions.push_back(Position(&entitym->entities[i]->stats.pos, entitym->entities[i]->serial));
+	}
+	for (size_t i = 0; i < npcs->npcs.size(); ++i) {
+		_positions.push_back(Position(&npcs->npcs[i]->stats.pos, npcs->npcs[i]->serial));
+	}
+	for (size_t i = 0; i < hazards->h.size(); ++i) {
+		_positions.push_back(Position(&hazards->h[i]->pos, hazards->h[i]->serial));
+	}
+}
+
+/**
+ * Remembers the current positions. Called before each logic frame
+ */
+void RenderInterpolation::saveState() {
+	positions.clear();
+	getPositions(positions);
+
+	prev_positions.clear();
+	for (size_t i = 0; i < positions.size(); ++i) {
+		prev_positions[positions[i]] = *positions[i].first;
+	}
+}
+
+/**
+ * Moves objects to where they were at alpha (0 to 1) of the way through the last logic frame
+ */
+void RenderInterpolation::begin(float alpha) {
+	end();
+
+	if (alpha >= 1)
+		return;
+
+	positions.clear();
+	getPositions(positions);
+
+	for (size_t i = 0; i < positions.size(); ++i) {
+		FPoint* pos = positions[i].first;
+
+		std::map<Position, FPoint>::iterator it = prev_positions.find(positions[i]);
+		if (it == prev_positions.end())
+			continue;
+
+		const FPoint& prev_pos = it->second;
+		if ((prev_pos.x == pos->x && prev_pos.y == pos->y) || Utils::calcDist(prev_pos, *pos) > SNAP_DISTANCE)
+			continue;
+
+		saved_positions.push_back(std::pair<FPoint*, FPoint>(pos, *pos));
+		pos->x = prev_pos.x + (pos->x - prev_pos.x) * alpha;
+		pos->y = prev_pos.y + (pos->y - prev_pos.y) * alpha;
+	}
+}
+
+/**
+ * Puts back the positions from the last logic frame
+ */
+void RenderInterpolation::end() {
+	for (size_t i = 0; i < saved_positions.size(); ++i) {
+		*saved_positions[i].first = saved_positions[i].second;
+	}
+	saved_positions.clear();
+}
+
+/**
+ * Forgets the saved positions, so that nothing is interpolated until the next logic frame
+ */
+void RenderInterpolation::clear() {
+	end();
+	prev_positions.clear();
+}
@@ -0,0 +1,67 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class RenderInterpolation
+ *
+ * Draws moving objects between their positions in the last two logic frames.
+ *
+ * saveState() is called before each logic frame and remembers the position of the camera, the player, enemies,
+ * NPCs and hazards. begin() moves each of them part of the way from that saved position to its current one, and
+ * end() puts the current positions back. Everything drawn in between sees the in-between positions, while logic
+ * never does.
+ *
+ * Objects that were created during the last logic frame, or that moved too far to be walking (e.g. teleports),
+ * are drawn where they are.
+ */
+
+#ifndef RENDER_INTERPOLATION_H
+#define RENDER_INTERPOLATION_H
+
+#include "CommonIncludes.h"
+#include "Utils.h"
+
+class RenderInterpolation {
+public:
+	RenderInterpolation();
+	~RenderInterpolation();
+
+	void saveState();
+	void begin(float alpha);
+	void end();
+	void clear();
+
+private:
+	// in tiles
+	static const float SNAP_DISTANCE;
+
+	// the address of an object's position, and the object's serial number
+	// memory may be reused for a new object during a logic frame, so the address alone doesn't identify an object
+	typedef std::pair<FPoint*, unsigned> Position;
+
+	void getPositions(std::vector<Position>& positions);
+
+	// positions before the last logic frame
+	std::map<Position, FPoint> prev_positions;
+
+	// current positions that were replaced by begin()
+	std::vector<std::pair<FPoint*, FPoint> > saved_positions;
+
+	std::vector<Position> positions;
+};
+
+#endif
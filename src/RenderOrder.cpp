@@ -0,0 +1,143 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "RenderDevice.h"
+#include "RenderOrder.h"
+
+#include <limits>
+
+RenderOrder::RenderOrder()
+	: coherent(false)
+{
+}
+
+RenderOrder::~RenderOrder() {
+}
+
+/**
+ * Forgets last frame's order, so the next sort starts from scratch
+ */
+void RenderOrder::clear() {
+	list.clear();
+	order.clear();
+	coherent = false;
+}
+
+bool RenderOrder::isLess(const Key& k1, const Key& k2) {
+	if (k1.prio != k2.prio)
+		return k1.prio < k2.prio;
+	return k1.index < k2.index;
+}
+
+/**
+ * Returns false if the keys could not be sorted within max_moves. The keys are left in an undefined order in that case
+ */
+bool RenderOrder::insertionSort(size_t max_moves) {
+	size_t moves = 0;
+
+	for (size_t i = 1; i < keys.size(); ++i) {
+		if (!isLess(keys[i], keys[i-1]))
+			continue;
+
+		const Key key = keys[i];
+		size_t j = i;
+		do {
+			keys[j] = keys[j-1];
+			--j;
+
+			if (++moves > max_moves)
+				return false;
+		} while (j > 0 && isLess(key, keys[j-1]));
+
+		keys[j] = key;
+	}
+
+	return true;
+}
+
+/**
+ * Least significant digit radix sort on the prio, one byte per pass. Bytes that are the same in every key are skipped.
+ * Each pass is stable, so keys that start out in index order stay in index order when their prios are equal
+ */
+void RenderOrder::radixSort() {
+	uint64_t diff = 0;
+	for (size_t i = 1; i < keys.size(); ++i) {
+		diff |= keys[i].prio ^ keys[0].prio;
+	}
+
+	keys_tmp.resize(keys.size());
+
+	for (unsigned shift = 0; shift < 64; shift += 8) {
+		if (((diff >> shift) & 0xff) == 0)
+			continue;
+
+		size_t offsets[256] = {0};
+		for (size_t i = 0; i < keys.size(); ++i) {
+			offsets[(keys[i].prio >> shift) & 0xff]++;
+		}
+
+		size_t total = 0;
+		for (size_t i = 0; i < 256; ++i) {
+			const size_t bucket_size = offsets[i];
+			offsets[i] = total;
+			total += bucket_size;
+		}
+
+		for (size_t i = 0; i < keys.size(); ++i) {
+			keys_tmp[offsets[(keys[i].prio >> shift) & 0xff]++] = keys[i];
+		}
+
+		keys.swap(keys_tmp);
+	}
+}
+
+/**
+ * Fills the list with pointers to the Renderables in r, sorted by prio. r itself is not changed
+ */
+void RenderOrder::sort(std::vector<Renderable>& r) {
+	const size_t count = r.size();
+	keys.resize(count);
+
+	// start from last frame's order; usually only a few Renderables have changed places
+	coherent = false;
+	if (count > 0 && order.size() == count) {
+		for (size_t i = 0; i < count; ++i) {
+			keys[i].index = order[i];
+			keys[i].prio = r[order[i]].prio;
+		}
+		coherent = insertionSort(count * MAX_MOVES_PER_KEY);
+	}
+
+	if (!coherent) {
+		for (size_t i = 0; i < count; ++i) {
+			keys[i].index = static_cast<unsigned>(i);
+			keys[i].prio = r[i].prio;
+		}
+
+		if (count < RADIX_MIN_SIZE)
+			insertionSort(std::numeric_limits<size_t>::max());
+		else
+			radixSort();
+	}
+
+	order.resize(count);
+	list.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		order[i] = keys[i].index;
+		list[i] = &r[keys[i].index];
+	}
+}
@@ -0,0 +1,77 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class RenderOrder
+ *
+ * Sorts a list of Renderables by prio without moving them.
+ *
+ * The sort works on a compact array of (prio, index) keys, and the result is a list of pointers into the Renderable
+ * list in drawing order. Renderables with the same prio keep the order they were added in.
+ *
+ * The list of Renderables is rebuilt every frame, but in mostly the same order and with mostly the same prios. So if
+ * the list has the same size as last frame, the keys start out in last frame's order and are fixed up with an
+ * insertion sort. If that takes too many moves, or the list size changed, a radix sort on the prio is used instead.
+ */
+
+#ifndef RENDER_ORDER_H
+#define RENDER_ORDER_H
+
+#include "CommonIncludes.h"
+
+class Renderable;
+
+class RenderOrder {
+public:
+	RenderOrder();
+	~RenderOrder();
+
+	void sort(std::vector<Renderable>& r);
+	void clear();
+
+	bool wasCoherent() const { return coherent; }
+
+	// pointers into the sorted Renderable list, in drawing order
+	std::vector<Renderable*> list;
+
+private:
+	class Key {
+	public:
+		uint64_t prio;
+		unsigned index;
+	};
+
+	// the insertion sort gives up after this many moves per key
+	static const size_t MAX_MOVES_PER_KEY = 8;
+
+	// shorter lists are always sorted with an insertion sort
+	static const size_t RADIX_MIN_SIZE = 64;
+
+	static bool isLess(const Key& k1, const Key& k2);
+	bool insertionSort(size_t max_moves);
+	void radixSort();
+
+	std::vector<Key> keys;
+	std::vector<Key> keys_tmp;
+
+	// the order of the indices after last frame's sort
+	std::vector<unsigned> order;
+
+	bool coherent;
+};
+
+#endif
@@ -33,16 +33,88 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "UtilsFileSystem.h"
 #include "UtilsParsing.h"
 
+namespace {
+	/**
+	 * Splits UTF-8 text into code points
+	 * Returns false for malformed text and for code points above 0xFFFF, which SDL_ttf has no glyph metrics for
+	 */
+	bool decodeUTF8(const std::string& text, std::vector<Uint16>& codepoints) {
+		codepoints.clear();
+
+		size_t i = 0;
+		while (i < text.length()) {
+			const unsigned char c = static_cast<unsigned char>(text[i]);
+			Uint32 codepoint;
+			size_t extra;
+
+			if (c < 0x80) {
+				codepoint = c;
+				extra = 0;
+			}
+			else if ((c & 0xe0) == 0xc0) {
+				codepoint = c & 0x1f;
+				extra = 1;
+			}
+			else if ((c & 0xf0) == 0xe0) {
+				codepoint = c & 0x0f;
+				extra = 2;
+			}
+			else {
+				return false;
+			}
+
+			if (i + extra >= text.length())
+				return false;
+
+			for (size_t j = 1; j <= extra; ++j) {
+				const unsigned char next = static_cast<unsigned char>(text[i + j]);
+				if ((next & 0xc0) != 0x80)
+					return false;
+				codepoint = (codepoint << 6) | (next & 0x3f);
+			}
+
+			codepoints.push_back(static_cast<Uint16>(codepoint));
+			i += extra + 1;
+		}
+
+		return true;
+	}
+
+	std::string encodeUTF8(Uint16 codepoint) {
+		std::string str;
+		if (codepoint < 0x80) {
+			str += static_cast<char>(codepoint);
+		}
+		else if (codepoint < 0x800) {
+			str += static_cast<char>(0xc0 | (codepoint >> 6));
+			str += static_cast<char>(0x80 | (codepoint & 0x3f));
+		}
+		else {
+			str += static_cast<char>(0xe0 | (codepoint >> 12));
+			str += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f));
+			str += static_cast<char>(0x80 | (codepoint & 0x3f));
+		}
+		return str;
+	}
+}
+
+SDLFontStyle::Glyph::Glyph()
+	: advance(0)
+{
+}
+
 SDLFontStyle::SDLFontStyle()
 	: FontStyle()
 	, ttfont(NULL)
 	, use_default_style(true)
+	, atlas_sprite(NULL)
 {
 }
 
 SDLFontEngine::SDLFontEngine()
 	: FontEngine()
 	, active_font(NULL)
+	, glyph_atlas_failed(false)
 {
 	// Initiate SDL_ttf
 	if(!TTF_WasInit() && TTF_Init()==-1) {
@@ -144,14 +216,14 @@ SDLFontEngine::SDLFontEngine()
 		std::string font_path = mods->locate(style->path);
 
 		// check inside the "fonts/" directory if we can't find our font
-		if (!Filesystem::fileExists(mods->locate(style->path))) {
+		if (font_path.empty()) {
 			font_path = mods->locate("fonts/" + style->path);
 			if (font_path.empty())
 				Utils::logError("FontEngine: Could not find font file: '%s'", style->path.c_str());
 		}
 
 		if (!font_path.empty()) {
-			style->ttfont = TTF_OpenFont(font_path.c_str(), style->ptsize);
+			style->ttfont = TTF_OpenFontRW(mods->openRW(font_path), 1, style->ptsize);
 			if(style->ttfont == NULL) {
 				Utils::logError("FontEngine: TTF_OpenFont: %s", TTF_GetError());
 			}
@@ -169,6 +241,8 @@ SDLFontEngine::SDLFontEngine()
 		}
 	}
 
+	text_cache.setBudget(static_cast<size_t>(std::max(settings->text_cache_size, 0)) * 1024 * 1024);
+
 	// Attempt to set the default active font
 	setFont("font_regular");
 	if (!isActiveFontValid()) {
@@ -202,10 +276,16 @@ Point SDLFontEngine::calcSize(const std::string& text) {
 	if (!isActiveFontValid())
 		return Point(1, 1);
 
+	Point size;
+	if (text_cache.getSize(active_font, text, size))
+		return size;
+
 	int w, h;
 	TTF_SizeUTF8(active_font->ttfont, text.c_str(), &w, &h);
 
-	return Point(w, h);
+	size = Point(w, h);
+	text_cache.storeSize(active_font, text, size);
+	return size;
 }
 
 /**
@@ -306,9 +386,26 @@ void SDLFontEngine::renderInternal(const std::string& text, int x, int y, int ju
 	else
 		dest_rect = position(text, x, y, justify);
 
+	int draw_category = render_device->getDrawCategory();
+	render_device->setDrawCategory(RenderDevice::DRAW_TEXT);
+
+	// Screen text can be drawn one glyph at a time from the font's glyph atlas, which batches into few draw calls
+	if (!target && settings->text_glyph_atlas && renderGlyphs(text, dest_rect, color)) {
+		render_device->setDrawCategory(draw_category);
+		return;
+	}
+
 	// Render text into target
 	// We render the same thing twice because blending with itself produces visually clearer text, especially on noisy backgrounds
-	graphics = render_device->renderTextToImage(active_font, text, color, active_font->blend);
+	// Strings that were drawn before come from the text cache, which keeps its own reference to the image
+	graphics = text_cache.get(active_font, text, color, active_font->blend);
+	bool cached = (graphics != NULL);
+	if (!graphics) {
+		graphics = render_device->renderTextToImage(active_font, text, color, active_font->blend);
+		if (graphics && text_cache.isEnabled())
+			cached = text_cache.store(active_font, text, color, active_font->blend, graphics);
+	}
+
 	if (graphics) {
 		if (target) {
 			Rect clip;
@@ -328,12 +425,221 @@ void SDLFontEngine::renderInternal(const std::string& text, int x, int y, int ju
 			}
 		}
 
-		// text is cached, we can free temp resource
-		graphics->unref();
+		if (!cached)
+			graphics->unref();
+	}
+
+	render_device->setDrawCategory(draw_category);
+}
+
+/**
+ * Draws text to the screen from the glyph atlas of the active font, adding any glyphs that are missing from it
+ * Returns false if the text needs to be rendered as a whole string instead
+ */
+bool SDLFontEngine::renderGlyphs(const std::string& text, const Rect& dest_rect, const Color& color) {
+	// the atlas is premultiplied, so alpha_mod wouldn't fade the glyph colors
+	// underlines would also be broken up between glyphs
+	if (glyph_atlas_failed || color.a != 255 || active_font->underline)
+		return false;
+
+	std::vector<Uint16> codepoints;
+	if (!decodeUTF8(text, codepoints))
+		return false;
+
+	std::vector<Uint16> new_glyphs;
+	for (size_t i = 0; i < codepoints.size(); ++i) {
+		if (active_font->atlas_rejected.find(codepoints[i]) != active_font->atlas_rejected.end())
+			return false;
+		if (active_font->glyphs.find(codepoints[i]) == active_font->glyphs.end())
+			new_glyphs.push_back(codepoints[i]);
+	}
+
+	if (!active_font->atlas_sprite || !new_glyphs.empty()) {
+		if (!buildGlyphAtlas(active_font, new_glyphs))
+			return false;
+
+		// glyphs that didn't fit in the atlas are drawn with the rest of the string instead
+		for (size_t i = 0; i < new_glyphs.size(); ++i) {
+			if (active_font->glyphs.find(new_glyphs[i]) == active_font->glyphs.end())
+				return false;
+		}
+	}
+
+	// glyphs are placed the way SDL_ttf places them in a string: by advance plus kerning
+	std::vector<int> pen_x(codepoints.size(), dest_rect.x);
+	bool kerning = TTF_GetFontKerning(active_font->ttfont) != 0;
+	for (size_t i = 1; i < codepoints.size(); ++i) {
+		pen_x[i] = pen_x[i-1] + active_font->glyphs[codepoints[i-1]].advance;
+		if (kerning)
+			pen_x[i] += TTF_GetFontKerningSizeGlyphs(active_font->ttfont, codepoints[i-1], codepoints[i]);
+	}
+
+	Sprite* sprite = active_font->atlas_sprite;
+	sprite->color_mod = color;
+	sprite->alpha_mod = color.a;
+
+	// like string images, the glyphs are drawn twice for clearer text
+	for (int pass = 0; pass < 2; ++pass) {
+		for (size_t i = 0; i < codepoints.size(); ++i) {
+			const SDLFontStyle::Glyph& glyph = active_font->glyphs[codepoints[i]];
+			if (glyph.clip.w <= 0 || glyph.clip.h <= 0)
+				continue;
+
+			sprite->setClipFromRect(glyph.clip);
+			sprite->setDest(pen_x[i], dest_rect.y);
+			render_device->render(sprite);
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Rebuilds the glyph atlas of a font style with its current glyphs plus new_glyphs
+ * Each glyph is rendered alone by SDL_ttf and copied into the atlas in white, so that color_mod can tint it
+ */
+bool SDLFontEngine::buildGlyphAtlas(SDLFontStyle* style, const std::vector<Uint16>& new_glyphs) {
+	std::set<Uint16> codepoints;
+
+	// start with printable ASCII, so that most text doesn't need the atlas rebuilt
+	if (!style->atlas_sprite) {
+		for (Uint16 c = 32; c < 127; ++c)
+			codepoints.insert(c);
+	}
+
+	std::map<Uint16, SDLFontStyle::Glyph>::iterator it;
+	for (it = style->glyphs.begin(); it != style->glyphs.end(); ++it)
+		codepoints.insert(it->first);
+
+	codepoints.insert(new_glyphs.begin(), new_glyphs.end());
+
+	const SDL_Color white = Color(255, 255, 255);
+	std::map<Uint16, SDLFontStyle::Glyph> glyphs;
+	std::vector<std::pair<Rect, SDL_Surface*> > surfaces;
+	Point pen;
+	int row_height = 0;
+
+	std::set<Uint16>::iterator cp_it;
+	for (cp_it = codepoints.begin(); cp_it != codepoints.end(); ++cp_it) {
+		SDLFontStyle::Glyph glyph;
+		int minx, maxx, miny, maxy;
+		if (TTF_GlyphMetrics(style->ttfont, *cp_it, &minx, &maxx, &miny, &maxy, &glyph.advance) != 0) {
+			style->atlas_rejected.insert(*cp_it);
+			continue;
+		}
+
+		// empty glyphs such as spaces only have an advance
+		std::string str = encodeUTF8(*cp_it);
+		SDL_Surface *surface;
+		if (style->blend)
+			surface = TTF_RenderUTF8_Blended(style->ttfont, str.c_str(), white);
+		else
+			surface = TTF_RenderUTF8_Solid(style->ttfont, str.c_str(), white);
+
+		if (surface && surface->format->BytesPerPixel != 1 && surface->format->BytesPerPixel != 4) {
+			SDL_FreeSurface(surface);
+			style->atlas_rejected.insert(*cp_it);
+			continue;
+		}
+
+		if (surface) {
+			if (pen.x + surface->w > GLYPH_ATLAS_WIDTH) {
+				pen.x = 0;
+				pen.y += row_height + 1;
+				row_height = 0;
+			}
+
+			if (surface->w > GLYPH_ATLAS_WIDTH || pen.y + surface->h > GLYPH_ATLAS_MAX_HEIGHT) {
+				SDL_FreeSurface(surface);
+				style->atlas_rejected.insert(*cp_it);
+				continue;
+			}
+
+			// glyphs are kept a pixel apart, so that scaled rendering doesn't sample their neighbours
+			glyph.clip = Rect(pen.x, pen.y, surface->w, surface->h);
+			surfaces.push_back(std::pair<Rect, SDL_Surface*>(glyph.clip, surface));
+			pen.x += surface->w + 1;
+			row_height = std::max(row_height, surface->h);
+		}
+
+		glyphs[*cp_it] = glyph;
+	}
+
+	Image *atlas = render_device->createImage(GLYPH_ATLAS_WIDTH, std::max(pen.y + row_height, 1));
+	if (atlas) {
+		atlas->beginPixelBatch();
+	}
+
+	for (size_t i = 0; i < surfaces.size(); ++i) {
+		SDL_Surface *surface = surfaces[i].second;
+
+		if (atlas && (!SDL_MUSTLOCK(surface) || SDL_LockSurface(surface) == 0)) {
+			const Rect& clip = surfaces[i].first;
+			for (int y = 0; y < surface->h; ++y) {
+				const Uint8* row = static_cast<const Uint8*>(surface->pixels) + y * surface->pitch;
+				for (int x = 0; x < surface->w; ++x) {
+					// solid text is palettized, with the text in any index but 0
+					Uint8 alpha;
+					if (surface->format->BytesPerPixel == 1)
+						alpha = (row[x] != 0 ? 255 : 0);
+					else
+						alpha = static_cast<Uint8>(reinterpret_cast<const Uint32*>(row)[x] >> 24);
+
+					if (alpha > 0)
+						atlas->drawPixel(clip.x + x, clip.y + y, Color(255, 255, 255, alpha));
+				}
+			}
+
+			if (SDL_MUSTLOCK(surface))
+				SDL_UnlockSurface(surface);
+		}
+
+		SDL_FreeSurface(surface);
+	}
+
+	if (!atlas)
+		return false;
+
+	atlas->endPixelBatch();
+
+	// the pixels are composed like a layer, which is also how the atlas needs to be blended
+	if (!render_device->finishComposedImage(atlas)) {
+		Utils::logInfo("FontEngine: Glyph atlas is not supported by this renderer. Using string rendering.");
+		glyph_atlas_failed = true;
+		atlas->unref();
+		return false;
+	}
+
+	clearGlyphAtlas(style);
+	style->glyphs.swap(glyphs);
+	style->atlas_sprite = atlas->createSprite();
+	atlas->unref();
+
+	return style->atlas_sprite != NULL;
+}
+
+void SDLFontEngine::clearGlyphAtlas(SDLFontStyle* style) {
+	delete style->atlas_sprite;
+	style->atlas_sprite = NULL;
+	style->glyphs.clear();
+}
+
+/**
+ * Also drops the glyph atlases, since they belong to the render context as well
+ */
+void SDLFontEngine::clearImages() {
+	FontEngine::clearImages();
+
+	for (size_t i = 0; i < font_styles.size(); ++i) {
+		clearGlyphAtlas(&font_styles[i]);
+		font_styles[i].atlas_rejected.clear();
 	}
+	glyph_atlas_failed = false;
 }
 
 SDLFontEngine::~SDLFontEngine() {
+	for (size_t i = 0; i < font_styles.size(); ++i)
+		clearGlyphAtlas(&font_styles[i]);
 	for (unsigned int i=0; i<font_styles.size(); ++i) TTF_CloseFont(font_styles[i].ttfont);
 	TTF_Quit();
 }
@@ -23,13 +23,28 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "FontEngine.h"
 #include <SDL_ttf.h>
 
+class Sprite;
+
 class SDLFontStyle : public FontStyle {
 public:
+	class Glyph {
+	public:
+		Glyph();
+
+		Rect clip;
+		int advance;
+	};
+
 	SDLFontStyle();
 	~SDLFontStyle() {};
 
 	TTF_Font *ttfont;
 	bool use_default_style;
+
+	// glyph atlas, only used with the text_glyph_atlas setting
+	std::map<Uint16, Glyph> glyphs;
+	std::set<Uint16> atlas_rejected;
+	Sprite *atlas_sprite;
 };
 
 /**
@@ -41,10 +56,17 @@ public:
 
 class SDLFontEngine : public FontEngine {
 private:
+	static const int GLYPH_ATLAS_WIDTH = 512;
+	static const int GLYPH_ATLAS_MAX_HEIGHT = 2048;
+
 	bool isActiveFontValid();
+	bool renderGlyphs(const std::string& text, const Rect& dest_rect, const Color& color);
+	bool buildGlyphAtlas(SDLFontStyle* style, const std::vector<Uint16>& new_glyphs);
+	void clearGlyphAtlas(SDLFontStyle* style);
 
 	std::vector<SDLFontStyle> font_styles;
 	SDLFontStyle *active_font;
+	bool glyph_atlas_failed;
 
 protected:
 	void renderInternal(const std::string& text, int x, int y, int justify, Image *target, const Color& color, bool shadow);
@@ -53,6 +75,8 @@ public:
 	SDLFontEngine();
 	~SDLFontEngine();
 
+	void clearImages();
+
 	int getLineHeight();
 	int getFontHeight();
 
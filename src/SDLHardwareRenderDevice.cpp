@@ -47,12 +47,18 @@ SDLHardwareImage::SDLHardwareImage(RenderDevice *_device, SDL_Renderer *_rendere
 }
 
 SDLHardwareImage::~SDLHardwareImage() {
-	if (surface)
+	if (surface) {
+		static_cast<SDLHardwareRenderDevice *>(device)->releaseTexture(surface);
 		SDL_DestroyTexture(surface);
+	}
 	if (pixel_batch_surface)
 		SDL_FreeSurface(pixel_batch_surface);
 }
 
+void SDLHardwareImage::setRenderTarget(SDL_Texture* target) {
+	static_cast<SDLHardwareRenderDevice *>(device)->setRenderTarget(target);
+}
+
 int SDLHardwareImage::getWidth() const {
 	int w, h;
 	SDL_QueryTexture(surface, NULL, NULL, &w, &h);
@@ -68,11 +74,11 @@ int SDLHardwareImage::getHeight() const {
 void SDLHardwareImage::fillWithColor(const Color& color) {
 	if (!surface) return;
 
-	SDL_SetRenderTarget(renderer, surface);
+	setRenderTarget(surface);
 	SDL_SetTextureBlendMode(surface, SDL_BLENDMODE_BLEND);
 	SDL_SetRenderDrawColor(renderer, color.r, color.g , color.b, color.a);
 	SDL_RenderClear(renderer);
-	SDL_SetRenderTarget(renderer, NULL);
+	setRenderTarget(NULL);
 }
 
 /*
@@ -104,11 +110,11 @@ void SDLHardwareImage::drawPixel(int x, int y, const Color& color) {
 }
 
 void SDLHardwareImage::drawPixelSingle(int x, int y, const Color& color) {
-	SDL_SetRenderTarget(renderer, surface);
+	setRenderTarget(surface);
 	SDL_SetTextureBlendMode(surface, SDL_BLENDMODE_BLEND);
 	SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
 	SDL_RenderDrawPoint(renderer, x, y);
-	SDL_SetRenderTarget(renderer, NULL);
+	setRenderTarget(NULL);
 }
 
 void SDLHardwareImage::drawPixelBatch(int x, int y, const Color& color) {
@@ -153,11 +159,11 @@ void SDLHardwareImage::drawPixelBatch(int x, int y, const Color& color) {
 }
 
 void SDLHardwareImage::drawLine(int x0, int y0, int x1, int y1, const Color& color) {
-	SDL_SetRenderTarget(renderer, surface);
+	setRenderTarget(surface);
 	SDL_SetTextureBlendMode(surface, SDL_BLENDMODE_BLEND);
 	SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
 	SDL_RenderDrawLine(renderer, x0, y0, x1, y1);
-	SDL_SetRenderTarget(renderer, NULL);
+	setRenderTarget(NULL);
 }
 
 void SDLHardwareImage::drawFilledRect(int x, int y, int w, int h, const Color& color) {
@@ -167,11 +173,11 @@ void SDLHardwareImage::drawFilledRect(int x, int y, int w, int h, const Color& c
 	rect.w = w;
 	rect.h = h;
 
-	SDL_SetRenderTarget(renderer, surface);
+	setRenderTarget(surface);
 	SDL_SetTextureBlendMode(surface, SDL_BLENDMODE_BLEND);
 	SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
 	SDL_RenderFillRect(renderer, &rect);
-	SDL_SetRenderTarget(renderer, NULL);
+	setRenderTarget(NULL);
 }
 
 
@@ -219,7 +225,7 @@ void SDLHardwareImage::endPixelBatch() {
 	SDL_Texture *pixel_batch_texture = SDL_CreateTextureFromSurface(renderer, pixel_batch_surface);
 
 	if (pixel_batch_texture) {
-		SDL_SetRenderTarget(renderer, surface);
+		setRenderTarget(surface);
 		SDL_SetTextureBlendMode(surface, SDL_BLENDMODE_BLEND);
 
 		if (pixel_batch_type == PIXEL_BATCH_ALL) {
@@ -229,7 +235,7 @@ void SDLHardwareImage::endPixelBatch() {
 			SDL_Rect dst(pixel_batch_area);
 			SDL_RenderCopy(renderer, pixel_batch_texture, NULL, &dst);
 		}
-		SDL_SetRenderTarget(renderer, NULL);
+		setRenderTarget(NULL);
 
 		SDL_DestroyTexture(pixel_batch_texture);
 	}
@@ -249,9 +255,9 @@ Image* SDLHardwareImage::resize(int width, int height) {
 
 	if (scaled->surface != NULL) {
 		// copy the source texture to the new texture, stretching it in the process
-		SDL_SetRenderTarget(renderer, scaled->surface);
+		setRenderTarget(scaled->surface);
 		SDL_RenderCopyEx(renderer, surface, NULL, NULL, 0, NULL, SDL_FLIP_NONE);
-		SDL_SetRenderTarget(renderer, NULL);
+		setRenderTarget(NULL);
 
 		// Remove the old surface
 		this->unref();
@@ -271,6 +277,14 @@ SDLHardwareRenderDevice::SDLHardwareRenderDevice()
 	, titlebar_icon(NULL)
 	, title(NULL)
 	, background_color(0,0,0,255)
+	, current_target(NULL)
+	, layer_target(NULL)
+	, layer_support(false)
+	, layer_blend_mode(SDL_BLENDMODE_BLEND)
+	, batch_texture(NULL)
+	, batch_blend_mode(SDL_BLENDMODE_BLEND)
+	, batch_texture_w(0)
+	, batch_texture_h(0)
 {
 	Utils::logInfo("Using Render Device: SDLHardwareRenderDevice (hardware, SDL 2, %s)", SDL_GetCurrentVideoDriver());
 
@@ -411,6 +425,18 @@ int SDLHardwareRenderDevice::createContextInternal() {
 		is_initialized = (texture != NULL);
 	}
 
+	if (is_initialized) {
+		// layers are drawn to the screen as premultiplied alpha, which needs a custom blend mode
+		layer_support = false;
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+		layer_blend_mode = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+		layer_support = (SDL_SetTextureBlendMode(texture, layer_blend_mode) == 0);
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+#endif
+		if (!layer_support)
+			Utils::logInfo("RenderDevice: Premultiplied alpha is not supported. HUD layers are disabled.");
+	}
+
 	if (is_initialized) {
 		// update title bar text and icon
 		updateTitleBar();
@@ -443,21 +469,15 @@ int SDLHardwareRenderDevice::render(Renderable& r, Rect& dest) {
 	dest.h = r.src.h;
     SDL_Rect src = r.src;
     SDL_Rect _dest = dest;
-	SDL_SetRenderTarget(renderer, texture);
 
 	SDL_Texture *surface = static_cast<SDLHardwareImage *>(r.image)->surface;
 
 	if (r.blend_mode == Renderable::BLEND_ADD) {
-		SDL_SetTextureBlendMode(surface, SDL_BLENDMODE_ADD);
+		return drawTexture(surface, SDL_BLENDMODE_ADD, src, _dest, r.color_mod, r.alpha_mod);
 	}
 	else { // Renderable::BLEND_NORMAL
-		SDL_SetTextureBlendMode(surface, SDL_BLENDMODE_BLEND);
+		return drawTexture(surface, SDL_BLENDMODE_BLEND, src, _dest, r.color_mod, r.alpha_mod);
 	}
-
-	SDL_SetTextureColorMod(surface, r.color_mod.r, r.color_mod.g, r.color_mod.b);
-	SDL_SetTextureAlphaMod(surface, r.alpha_mod);
-
-	return SDL_RenderCopy(renderer, surface, &src, &_dest);
 }
 
 int SDLHardwareRenderDevice::render(Sprite *r) {
@@ -486,20 +506,138 @@ int SDLHardwareRenderDevice::render(Sprite *r) {
 
     SDL_Rect src = m_clip;
     SDL_Rect dest = m_dest;
-	SDL_SetRenderTarget(renderer, texture);
 
+	// sprites are drawn with whatever blend mode the texture already has
 	SDL_Texture *surface = static_cast<SDLHardwareImage *>(r->getGraphics())->surface;
-	SDL_SetTextureColorMod(surface, r->color_mod.r, r->color_mod.g, r->color_mod.b);
-	SDL_SetTextureAlphaMod(surface, r->alpha_mod);
+	SDL_BlendMode blend_mode = SDL_BLENDMODE_BLEND;
+	SDL_GetTextureBlendMode(surface, &blend_mode);
+
+	return drawTexture(surface, blend_mode, src, dest, r->color_mod, r->alpha_mod);
+}
+
+/**
+ * Draws part of a texture to the screen. With batching, the quad is only queued here, and flushBatch() draws it
+ */
+int SDLHardwareRenderDevice::drawTexture(SDL_Texture* surface, SDL_BlendMode blend_mode, const SDL_Rect& src, const SDL_Rect& _dest, const Color& color, Uint8 alpha) {
+	sprite_count++;
+	setRenderTarget(layer_target ? layer_target : texture);
+
+	SDL_Rect dest = _dest;
+	dest.x -= layer_origin.x;
+	dest.y -= layer_origin.y;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	if (settings->render_batching) {
+		if (surface != batch_texture || blend_mode != batch_blend_mode) {
+			flushBatch();
+
+			if (SDL_QueryTexture(surface, NULL, NULL, &batch_texture_w, &batch_texture_h) != 0 || batch_texture_w <= 0 || batch_texture_h <= 0)
+				return -1;
+
+			batch_texture = surface;
+			batch_blend_mode = blend_mode;
+		}
+
+		const float tex_w = static_cast<float>(batch_texture_w);
+		const float tex_h = static_cast<float>(batch_texture_h);
+
+		SDL_Vertex vertex;
+		vertex.color.r = color.r;
+		vertex.color.g = color.g;
+		vertex.color.b = color.b;
+		vertex.color.a = alpha;
+
+		// top-left, top-right, bottom-left, bottom-right
+		for (int i = 0; i < 4; ++i) {
+			const int x = (i & 1) ? 1 : 0;
+			const int y = (i & 2) ? 1 : 0;
+			vertex.position.x = static_cast<float>(dest.x + x * dest.w);
+			vertex.position.y = static_cast<float>(dest.y + y * dest.h);
+			vertex.tex_coord.x = static_cast<float>(src.x + x * src.w) / tex_w;
+			vertex.tex_coord.y = static_cast<float>(src.y + y * src.h) / tex_h;
+			batch_vertices.push_back(vertex);
+		}
+
+		return 0;
+	}
+#endif
+
+	SDL_SetTextureBlendMode(surface, blend_mode);
+	SDL_SetTextureColorMod(surface, color.r, color.g, color.b);
+	SDL_SetTextureAlphaMod(surface, alpha);
+
+	draw_call_count++;
+	return SDL_RenderCopy(renderer, surface, &src, &dest);
+}
+
+/**
+ * Draws all queued quads with one call
+ */
+void SDLHardwareRenderDevice::flushBatch() {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	if (!batch_vertices.empty()) {
+		const size_t quad_count = batch_vertices.size() / 4;
+
+		// two triangles per quad. The index list only ever grows, since it is the same for any batch
+		for (size_t i = batch_indices.size() / 6; i < quad_count; ++i) {
+			const int v = static_cast<int>(i * 4);
+			batch_indices.push_back(v);
+			batch_indices.push_back(v + 1);
+			batch_indices.push_back(v + 2);
+			batch_indices.push_back(v + 2);
+			batch_indices.push_back(v + 1);
+			batch_indices.push_back(v + 3);
+		}
+
+		// color and alpha are in the vertices
+		SDL_SetTextureBlendMode(batch_texture, batch_blend_mode);
+		SDL_SetTextureColorMod(batch_texture, 255, 255, 255);
+		SDL_SetTextureAlphaMod(batch_texture, 255);
+
+		SDL_RenderGeometry(renderer, batch_texture, &batch_vertices[0], static_cast<int>(batch_vertices.size()), &batch_indices[0], static_cast<int>(quad_count * 6));
+		draw_call_count++;
+
+		batch_vertices.clear();
+	}
+#endif
+
+	batch_texture = NULL;
+}
+
+/**
+ * Changes the render target, unless it is already set. Queued quads are drawn to the old target first
+ */
+int SDLHardwareRenderDevice::setRenderTarget(SDL_Texture* target) {
+	if (target == current_target)
+		return 0;
+
+	flushBatch();
+	current_target = target;
+	return SDL_SetRenderTarget(renderer, target);
+}
+
+/**
+ * Called before a texture is destroyed, so that no queued quads refer to it
+ */
+void SDLHardwareRenderDevice::releaseTexture(SDL_Texture* surface) {
+	if (surface == batch_texture)
+		flushBatch();
 
-	return SDL_RenderCopy(renderer, static_cast<SDLHardwareImage *>(r->getGraphics())->surface, &src, &dest);
+	if (surface == layer_target) {
+		layer_target = NULL;
+		layer_origin = Point();
+	}
+
+	// SDL resets the render target when the target texture is destroyed
+	if (surface == current_target)
+		current_target = NULL;
 }
 
 int SDLHardwareRenderDevice::renderToImage(Image* src_image, Rect& src, Image* dest_image, Rect& dest) {
 	if (!src_image || !dest_image)
 		return -1;
 
-	if (SDL_SetRenderTarget(renderer, static_cast<SDLHardwareImage *>(dest_image)->surface) != 0)
+	if (setRenderTarget(static_cast<SDLHardwareImage *>(dest_image)->surface) != 0)
 		return -1;
 
 	dest.w = src.w;
@@ -507,12 +645,29 @@ int SDLHardwareRenderDevice::renderToImage(Image* src_image, Rect& src, Image* d
     SDL_Rect _src = src;
     SDL_Rect _dest = dest;
 
+	// render() leaves the sprite's color and alpha on the texture, but the image should be copied as it is
+	SDL_Texture *src_surface = static_cast<SDLHardwareImage *>(src_image)->surface;
+	SDL_SetTextureColorMod(src_surface, 255, 255, 255);
+	SDL_SetTextureAlphaMod(src_surface, 255);
+
 	SDL_SetTextureBlendMode(static_cast<SDLHardwareImage *>(dest_image)->surface, SDL_BLENDMODE_BLEND);
-	SDL_RenderCopy(renderer, static_cast<SDLHardwareImage *>(src_image)->surface, &_src, &_dest);
-	SDL_SetRenderTarget(renderer, NULL);
+	SDL_RenderCopy(renderer, src_surface, &_src, &_dest);
+	draw_call_count++;
+	setRenderTarget(NULL);
 	return 0;
 }
 
+/**
+ * The image is drawn with the same premultiplied blend mode as layers
+ */
+bool SDLHardwareRenderDevice::finishComposedImage(Image* image) {
+	if (!layer_support || !image)
+		return false;
+
+	SDL_Texture *surface = static_cast<SDLHardwareImage *>(image)->surface;
+	return surface && SDL_SetTextureBlendMode(surface, layer_blend_mode) == 0;
+}
+
 Image * SDLHardwareRenderDevice::renderTextToImage(FontStyle* font_style, const std::string& text, const Color& color, bool blended) {
 	SDLHardwareImage *image = new SDLHardwareImage(this, renderer);
 
@@ -536,13 +691,19 @@ Image * SDLHardwareRenderDevice::renderTextToImage(FontStyle* font_style, const
 }
 
 void SDLHardwareRenderDevice::drawPixel(int x, int y, const Color& color) {
+	flushBatch();
+	if (layer_target)
+		setRenderTarget(layer_target);
 	SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-	SDL_RenderDrawPoint(renderer, x, y);
+	SDL_RenderDrawPoint(renderer, x - layer_origin.x, y - layer_origin.y);
 }
 
 void SDLHardwareRenderDevice::drawLine(int x0, int y0, int x1, int y1, const Color& color) {
+	flushBatch();
+	if (layer_target)
+		setRenderTarget(layer_target);
 	SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-	SDL_RenderDrawLine(renderer, x0, y0, x1, y1);
+	SDL_RenderDrawLine(renderer, x0 - layer_origin.x, y0 - layer_origin.y, x1 - layer_origin.x, y1 - layer_origin.y);
 }
 
 void SDLHardwareRenderDevice::drawRectangle(const Point& p0, const Point& p1, const Color& color) {
@@ -552,21 +713,54 @@ void SDLHardwareRenderDevice::drawRectangle(const Point& p0, const Point& p1, co
 	drawLine(p0.x, p1.y, p1.x+1, p1.y, color);
 }
 
+bool SDLHardwareRenderDevice::supportsLayers() {
+	return layer_support;
+}
+
+bool SDLHardwareRenderDevice::beginLayer(Image* layer, const Point& origin) {
+	if (!layer_support || !layer || layer_target)
+		return false;
+
+	SDL_Texture *surface = static_cast<SDLHardwareImage *>(layer)->surface;
+	if (!surface || setRenderTarget(surface) != 0)
+		return false;
+
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+
+	// render(Sprite*) uses the texture's blend mode, so the finished layer is drawn as premultiplied
+	SDL_SetTextureBlendMode(surface, layer_blend_mode);
+
+	layer_target = surface;
+	layer_origin = origin;
+	return true;
+}
+
+void SDLHardwareRenderDevice::endLayer() {
+	if (!layer_target)
+		return;
+
+	layer_target = NULL;
+	layer_origin = Point();
+	setRenderTarget(texture);
+}
+
 void SDLHardwareRenderDevice::blankScreen() {
 	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-	SDL_SetRenderTarget(renderer, NULL);
+	setRenderTarget(NULL);
 	SDL_RenderClear(renderer);
 	SDL_SetRenderDrawColor(renderer, background_color.r, background_color.g, background_color.b, background_color.a);
-	SDL_SetRenderTarget(renderer, texture);
+	setRenderTarget(texture);
 	SDL_RenderClear(renderer);
 	return;
 }
 
 void SDLHardwareRenderDevice::commitFrame() {
-	SDL_SetRenderTarget(renderer, NULL);
+	setRenderTarget(NULL);
 	SDL_RenderCopy(renderer, texture, NULL, NULL);
 	SDL_RenderPresent(renderer);
 	inpt->window_resized = false;
+	resetDrawCounts();
 
 	return;
 }
@@ -574,8 +768,11 @@ void SDLHardwareRenderDevice::commitFrame() {
 void SDLHardwareRenderDevice::destroyContext() {
 	resetGamma();
 
+	// queued quads may refer to textures that are about to be freed
+	flushBatch();
+
 	// we need to free all loaded graphics as they may be tied to the current context
-	RenderDevice::cacheRemoveAll();
+	releaseContextImages();
 	reload_graphics = true;
 
 	if (icons) {
@@ -595,6 +792,7 @@ void SDLHardwareRenderDevice::destroyContext() {
 
 	SDL_DestroyRenderer(renderer);
 	renderer = NULL;
+	current_target = NULL;
 
 	SDL_DestroyWindow(window);
 	window = NULL;
@@ -622,11 +820,11 @@ Image *SDLHardwareRenderDevice::createImage(int width, int height) {
 			image = NULL;
 		}
 		else {
-				SDL_SetRenderTarget(renderer, image->surface);
+				setRenderTarget(image->surface);
 				SDL_SetTextureBlendMode(image->surface, SDL_BLENDMODE_BLEND);
 				SDL_SetRenderDrawColor(renderer, 0,0,0,0);
 				SDL_RenderClear(renderer);
-				SDL_SetRenderTarget(renderer, NULL);
+				setRenderTarget(NULL);
 		}
 	}
 
@@ -652,7 +850,7 @@ void SDLHardwareRenderDevice::updateTitleBar() {
 	if (!window) return;
 
 	title = Utils::strdup(msg->get(eset->misc.window_title));
-	titlebar_icon = IMG_Load(mods->locate("images/logo/icon.png").c_str());
+	titlebar_icon = IMG_Load_RW(mods->openRW(mods->locate("images/logo/icon.png")), 1);
 
 	if (title) SDL_SetWindowTitle(window, title);
 	if (titlebar_icon) SDL_SetWindowIcon(window, titlebar_icon);
@@ -668,7 +866,7 @@ Image *SDLHardwareRenderDevice::loadImage(const std::string& filename, int error
 	SDLHardwareImage *image = new SDLHardwareImage(this, renderer);
 	if (!image) return NULL;
 
-	image->surface = IMG_LoadTexture(renderer, mods->locate(filename).c_str());
+	image->surface = IMG_LoadTexture_RW(renderer, mods->openRW(mods->locate(filename)), 1);
 
 	if(image->surface == NULL) {
 		delete image;
@@ -701,9 +899,12 @@ void SDLHardwareRenderDevice::windowResize() {
 
 	SDL_RenderSetLogicalSize(renderer, settings->view_w, settings->view_h);
 
-	if (texture) SDL_DestroyTexture(texture);
+	if (texture) {
+		releaseTexture(texture);
+		SDL_DestroyTexture(texture);
+	}
 	texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, settings->view_w, settings->view_h);
-	if (texture) SDL_SetRenderTarget(renderer, texture);
+	if (texture) setRenderTarget(texture);
 
 	settings->updateScreenVars();
 }
@@ -753,7 +954,7 @@ unsigned short SDLHardwareRenderDevice::getRefreshRate() {
 int SDLHardwareRenderDevice::loadQueuedImage(void* data) {
 	QueuedImage* image = static_cast<QueuedImage*>(data);
 	SDL_LockMutex(image->mutex);
-	image->surface = IMG_Load(image->loc_filename.c_str());
+	image->surface = IMG_Load_RW(mods->openRW(image->loc_filename), 1);
 	image->load_attempted = true;
 	SDL_CondSignal(image->loaded);
 	SDL_UnlockMutex(image->mutex);
@@ -26,6 +26,16 @@ FLARE.  If not, see http://www.gnu.org/licenses/
  * Provide an SDL_BlitSurface implementation for renderning a Renderable to
  * the screen.  Simply dispatches rendering to SDL_BlitSurface().
  *
+ * When render_batching is enabled, sprites are not drawn right away. Sprites
+ * that follow each other and use the same texture and blend mode are collected
+ * as quads, with their color and alpha in the vertices, and drawn with a single
+ * SDL_RenderGeometry() call. The drawing order is never changed. Anything else
+ * that draws, or changes the render target, draws the collected sprites first.
+ *
+ * Layers are drawn with premultiplied alpha. Drawing normally into a cleared
+ * layer leaves premultiplied colors in it, so the layer can then be drawn to
+ * the screen with the same result as drawing its contents directly.
+ *
  * As this is for the FLARE engine, the implementation uses the engine's
  * global settings context, which is included by the interface.
  *
@@ -68,6 +78,7 @@ private:
 
 	void drawPixelSingle(int x, int y, const Color& color);
 	void drawPixelBatch(int x, int y, const Color& color);
+	void setRenderTarget(SDL_Texture* target);
 };
 
 class SDLHardwareRenderDevice : public RenderDevice {
@@ -78,6 +89,7 @@ public:
 	virtual int render(Renderable& r, Rect& dest);
 	virtual int render(Sprite* r);
 	virtual int renderToImage(Image* src_image, Rect& src, Image* dest_image, Rect& dest);
+	bool finishComposedImage(Image* image);
 
 	Image *renderTextToImage(FontStyle* font_style, const std::string& text, const Color& color, bool blended);
 	void drawPixel(int x, int y, const Color& color);
@@ -95,10 +107,18 @@ public:
 	void updateTitleBar();
 	unsigned short getRefreshRate();
 
+	bool supportsLayers();
+	bool beginLayer(Image* layer, const Point& origin);
+	void endLayer();
+
 	Image* loadImage(const std::string& filename, int error_type);
 
 	void loadQueuedImages();
 
+	int setRenderTarget(SDL_Texture* target);
+	void flushBatch();
+	void releaseTexture(SDL_Texture* surface);
+
 protected:
 	int createContextInternal();
 	void createContextError();
@@ -106,6 +126,7 @@ protected:
 private:
 	void getWindowSize(short unsigned *screen_w, short unsigned *screen_h);
 	static int loadQueuedImage(void* data);
+	int drawTexture(SDL_Texture* surface, SDL_BlendMode blend_mode, const SDL_Rect& src, const SDL_Rect& dest, const Color& color, Uint8 alpha);
 
 	SDL_Window *window;
 	SDL_Renderer *renderer;
@@ -114,6 +135,25 @@ private:
 	char* title;
 	Color background_color;
 
+	// the render target that was set last, so that it is only changed when needed
+	SDL_Texture *current_target;
+
+	// set between beginLayer() and endLayer(). Drawing positions are moved by -layer_origin
+	SDL_Texture *layer_target;
+	Point layer_origin;
+	bool layer_support;
+	SDL_BlendMode layer_blend_mode;
+
+	// consecutive draws from the same texture with the same blend mode, drawn together by flushBatch()
+	SDL_Texture *batch_texture;
+	SDL_BlendMode batch_blend_mode;
+	int batch_texture_w;
+	int batch_texture_h;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	std::vector<SDL_Vertex> batch_vertices;
+	std::vector<int> batch_indices;
+#endif
+
 	/* Stores the system gamma levels so they can be restored later */
 	uint16_t gamma_r[256];
 	uint16_t gamma_g[256];
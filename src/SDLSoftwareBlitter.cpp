@@ -0,0 +1,755 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "SDLSoftwareBlitter.h"
+#include "Utils.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLIT_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 functions are compiled for that target only, so that the rest of the engine still runs without it
+#if defined(BLIT_SSE2) && SDL_VERSION_ATLEAST(2, 0, 4) && (defined(_MSC_VER) || defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define BLIT_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define BLIT_AVX2_TARGET
+#else
+#define BLIT_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+// SDL blends ARGB8888 with per-pixel alpha using its MMX blitter wherever __MMX__ is defined, and its C blitter
+// everywhere else. The two round differently, so we follow the one that SDL was most likely built with
+#if defined(__MMX__)
+#define BLIT_MMX_ROUNDING
+#endif
+
+namespace {
+
+/**
+ * Per-pixel alpha blending as done by SDL when there is no color or alpha mod
+ */
+inline Uint32 blendPixel(Uint32 s, Uint32 d) {
+	const Uint32 alpha = s >> 24;
+	if (alpha == 0)
+		return d;
+	if (alpha == 255)
+		return s;
+
+	Uint32 result = 0;
+#ifdef BLIT_MMX_ROUNDING
+	for (int shift = 0; shift < 24; shift += 8) {
+		result |= ((((s >> shift) & 0xff) * alpha >> 8) + (((d >> shift) & 0xff) * (255 - alpha) >> 8)) << shift;
+	}
+	result |= ((255 * alpha >> 8) + ((d >> 24) * (255 - alpha) >> 8)) << 24;
+#else
+	for (int shift = 0; shift < 24; shift += 8) {
+		result |= ((((d >> shift) & 0xff) * (256 - alpha) + ((s >> shift) & 0xff) * alpha) >> 8) << shift;
+	}
+	result |= (alpha + ((d >> 24) * (255 - alpha) >> 8)) << 24;
+#endif
+	return result;
+}
+
+/**
+ * Applies the color/alpha mod to a source pixel and premultiplies its color by its alpha, as SDL does before blending
+ */
+inline void modulatePixel(Uint32 s, Uint32 mod, Uint32* channels) {
+	for (int k = 0; k < 4; ++k) {
+		channels[k] = ((s >> (k * 8)) & 0xff) * ((mod >> (k * 8)) & 0xff) / 255;
+	}
+	for (int k = 0; k < 3; ++k) {
+		channels[k] = channels[k] * channels[3] / 255;
+	}
+}
+
+void blendRowScalar(const Uint32* src, Uint32* dest, int width, Uint32) {
+	for (int i = 0; i < width; ++i) {
+		dest[i] = blendPixel(src[i], dest[i]);
+	}
+}
+
+void blendModRowScalar(const Uint32* src, Uint32* dest, int width, Uint32 mod) {
+	Uint32 s[4];
+	for (int i = 0; i < width; ++i) {
+		modulatePixel(src[i], mod, s);
+
+		Uint32 result = 0;
+		for (int k = 0; k < 4; ++k) {
+			const Uint32 d = (dest[i] >> (k * 8)) & 0xff;
+			result |= (s[k] + (255 - s[3]) * d / 255) << (k * 8);
+		}
+		dest[i] = result;
+	}
+}
+
+void addRowScalar(const Uint32* src, Uint32* dest, int width, Uint32 mod) {
+	Uint32 s[4];
+	for (int i = 0; i < width; ++i) {
+		modulatePixel(src[i], mod, s);
+
+		// the destination alpha is kept
+		Uint32 result = dest[i] & 0xff000000;
+		for (int k = 0; k < 3; ++k) {
+			const Uint32 d = (dest[i] >> (k * 8)) & 0xff;
+			result |= std::min(s[k] + d, static_cast<Uint32>(255)) << (k * 8);
+		}
+		dest[i] = result;
+	}
+}
+
+#ifdef BLIT_SSE2
+
+/**
+ * floor(x / 255) for each 16-bit lane, for 0 <= x <= 255 * 255
+ */
+inline __m128i div255SSE2(__m128i x) {
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+/**
+ * Copies the alpha lane of each pixel to all four of its lanes
+ */
+inline __m128i alphaSSE2(__m128i x) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/**
+ * Two unpacked pixels with per-pixel alpha, see blendPixel()
+ */
+inline __m128i blendLanesSSE2(__m128i s, __m128i d) {
+	const __m128i color_lanes = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+	const __m128i alpha = alphaSSE2(s);
+	const __m128i inv_alpha = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+
+#ifdef BLIT_MMX_ROUNDING
+	const __m128i src_factor = _mm_or_si128(_mm_and_si128(color_lanes, alpha), _mm_andnot_si128(color_lanes, _mm_set1_epi16(255)));
+	return _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(s, src_factor), 8), _mm_srli_epi16(_mm_mullo_epi16(d, inv_alpha), 8));
+#else
+	const __m128i color = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(d, _mm_sub_epi16(_mm_set1_epi16(256), alpha)), _mm_mullo_epi16(s, alpha)), 8);
+	const __m128i dest_alpha = _mm_add_epi16(alpha, _mm_srli_epi16(_mm_mullo_epi16(d, inv_alpha), 8));
+	return _mm_or_si128(_mm_and_si128(color_lanes, color), _mm_andnot_si128(color_lanes, dest_alpha));
+#endif
+}
+
+/**
+ * Two unpacked pixels with the color/alpha mod applied and the color premultiplied by alpha, see modulatePixel()
+ */
+inline __m128i modulateLanesSSE2(__m128i s, __m128i mod) {
+	const __m128i color_lanes = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+	s = div255SSE2(_mm_mullo_epi16(s, mod));
+
+	const __m128i premultiply = _mm_or_si128(_mm_and_si128(color_lanes, alphaSSE2(s)), _mm_andnot_si128(color_lanes, _mm_set1_epi16(255)));
+	return div255SSE2(_mm_mullo_epi16(s, premultiply));
+}
+
+inline __m128i blendModLanesSSE2(__m128i s, __m128i d, __m128i mod) {
+	s = modulateLanesSSE2(s, mod);
+	const __m128i inv_alpha = _mm_sub_epi16(_mm_set1_epi16(255), alphaSSE2(s));
+	return _mm_add_epi16(s, div255SSE2(_mm_mullo_epi16(inv_alpha, d)));
+}
+
+void blendRowSSE2(const Uint32* src, Uint32* dest, int width, Uint32 mod) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i opaque_alpha = _mm_set1_epi32(255);
+
+	int i = 0;
+	for (; i + 4 <= width; i += 4) {
+		const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		const __m128i alpha = _mm_srli_epi32(s, 24);
+		const __m128i transparent = _mm_cmpeq_epi32(alpha, zero);
+		const __m128i opaque = _mm_cmpeq_epi32(alpha, opaque_alpha);
+
+		if (_mm_movemask_epi8(transparent) == 0xffff)
+			continue;
+
+		if (_mm_movemask_epi8(opaque) == 0xffff) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), s);
+			continue;
+		}
+
+		const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest + i));
+		const __m128i lo = blendLanesSSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+		const __m128i hi = blendLanesSSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+
+		// fully opaque and fully transparent pixels are copied as they are
+		__m128i result = _mm_packus_epi16(lo, hi);
+		result = _mm_or_si128(_mm_and_si128(opaque, s), _mm_andnot_si128(opaque, result));
+		result = _mm_or_si128(_mm_and_si128(transparent, d), _mm_andnot_si128(transparent, result));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), result);
+	}
+
+	blendRowScalar(src + i, dest + i, width - i, mod);
+}
+
+void blendModRowSSE2(const Uint32* src, Uint32* dest, int width, Uint32 mod) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i mod_lanes = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(mod)), zero);
+
+	int i = 0;
+	for (; i + 4 <= width; i += 4) {
+		const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+		// nothing is drawn where the source alpha is 0
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(s, 24), zero)) == 0xffff)
+			continue;
+
+		const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest + i));
+		const __m128i lo = blendModLanesSSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), mod_lanes);
+		const __m128i hi = blendModLanesSSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), mod_lanes);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packus_epi16(lo, hi));
+	}
+
+	blendModRowScalar(src + i, dest + i, width - i, mod);
+}
+
+void addRowSSE2(const Uint32* src, Uint32* dest, int width, Uint32 mod) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i mod_lanes = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(mod)), zero);
+	const __m128i color_mask = _mm_set1_epi32(0x00ffffff);
+
+	int i = 0;
+	for (; i + 4 <= width; i += 4) {
+		const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(s, 24), zero)) == 0xffff)
+			continue;
+
+		const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest + i));
+		const __m128i lo = modulateLanesSSE2(_mm_unpacklo_epi8(s, zero), mod_lanes);
+		const __m128i hi = modulateLanesSSE2(_mm_unpackhi_epi8(s, zero), mod_lanes);
+
+		// saturating add, with the source alpha cleared so that the destination alpha is kept
+		const __m128i color = _mm_and_si128(_mm_packus_epi16(lo, hi), color_mask);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_adds_epu8(color, d));
+	}
+
+	addRowScalar(src + i, dest + i, width - i, mod);
+}
+
+#endif // BLIT_SSE2
+
+#ifdef BLIT_AVX2
+
+BLIT_AVX2_TARGET inline __m256i div255AVX2(__m256i x) {
+	return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, _mm256_set1_epi16(1)), _mm256_srli_epi16(x, 8)), 8);
+}
+
+BLIT_AVX2_TARGET inline __m256i alphaAVX2(__m256i x) {
+	return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+BLIT_AVX2_TARGET inline __m256i colorLanesAVX2() {
+	return _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+}
+
+BLIT_AVX2_TARGET inline __m256i blendLanesAVX2(__m256i s, __m256i d) {
+	const __m256i color_lanes = colorLanesAVX2();
+	const __m256i alpha = alphaAVX2(s);
+	const __m256i inv_alpha = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+
+#ifdef BLIT_MMX_ROUNDING
+	const __m256i src_factor = _mm256_or_si256(_mm256_and_si256(color_lanes, alpha), _mm256_andnot_si256(color_lanes, _mm256_set1_epi16(255)));
+	return _mm256_add_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(s, src_factor), 8), _mm256_srli_epi16(_mm256_mullo_epi16(d, inv_alpha), 8));
+#else
+	const __m256i color = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(d, _mm256_sub_epi16(_mm256_set1_epi16(256), alpha)), _mm256_mullo_epi16(s, alpha)), 8);
+	const __m256i dest_alpha = _mm256_add_epi16(alpha, _mm256_srli_epi16(_mm256_mullo_epi16(d, inv_alpha), 8));
+	return _mm256_or_si256(_mm256_and_si256(color_lanes, color), _mm256_andnot_si256(color_lanes, dest_alpha));
+#endif
+}
+
+BLIT_AVX2_TARGET inline __m256i modulateLanesAVX2(__m256i s, __m256i mod) {
+	const __m256i color_lanes = colorLanesAVX2();
+	s = div255AVX2(_mm256_mullo_epi16(s, mod));
+
+	const __m256i premultiply = _mm256_or_si256(_mm256_and_si256(color_lanes, alphaAVX2(s)), _mm256_andnot_si256(color_lanes, _mm256_set1_epi16(255)));
+	return div255AVX2(_mm256_mullo_epi16(s, premultiply));
+}
+
+BLIT_AVX2_TARGET inline __m256i blendModLanesAVX2(__m256i s, __m256i d, __m256i mod) {
+	s = modulateLanesAVX2(s, mod);
+	const __m256i inv_alpha = _mm256_sub_epi16(_mm256_set1_epi16(255), alphaAVX2(s));
+	return _mm256_add_epi16(s, div255AVX2(_mm256_mullo_epi16(inv_alpha, d)));
+}
+
+// the AVX2 rows leave the last few pixels to the SSE2 rows. Unpacking and packing work within each 128-bit half,
+// so the pixels come out in the same order as they went in
+BLIT_AVX2_TARGET void blendRowAVX2(const Uint32* src, Uint32* dest, int width, Uint32 mod) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i opaque_alpha = _mm256_set1_epi32(255);
+
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		const __m256i alpha = _mm256_srli_epi32(s, 24);
+		const __m256i transparent = _mm256_cmpeq_epi32(alpha, zero);
+		const __m256i opaque = _mm256_cmpeq_epi32(alpha, opaque_alpha);
+
+		if (_mm256_movemask_epi8(transparent) == -1)
+			continue;
+
+		if (_mm256_movemask_epi8(opaque) == -1) {
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), s);
+			continue;
+		}
+
+		const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dest + i));
+		const __m256i lo = blendLanesAVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero));
+		const __m256i hi = blendLanesAVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero));
+
+		__m256i result = _mm256_packus_epi16(lo, hi);
+		result = _mm256_or_si256(_mm256_and_si256(opaque, s), _mm256_andnot_si256(opaque, result));
+		result = _mm256_or_si256(_mm256_and_si256(transparent, d), _mm256_andnot_si256(transparent, result));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), result);
+	}
+
+	blendRowSSE2(src + i, dest + i, width - i, mod);
+}
+
+BLIT_AVX2_TARGET void blendModRowAVX2(const Uint32* src, Uint32* dest, int width, Uint32 mod) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i mod_lanes = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(mod)), zero);
+
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+
+		if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_srli_epi32(s, 24), zero)) == -1)
+			continue;
+
+		const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dest + i));
+		const __m256i lo = blendModLanesAVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), mod_lanes);
+		const __m256i hi = blendModLanesAVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), mod_lanes);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), _mm256_packus_epi16(lo, hi));
+	}
+
+	blendModRowSSE2(src + i, dest + i, width - i, mod);
+}
+
+BLIT_AVX2_TARGET void addRowAVX2(const Uint32* src, Uint32* dest, int width, Uint32 mod) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i mod_lanes = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(mod)), zero);
+	const __m256i color_mask = _mm256_set1_epi32(0x00ffffff);
+
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+
+		if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_srli_epi32(s, 24), zero)) == -1)
+			continue;
+
+		const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dest + i));
+		const __m256i lo = modulateLanesAVX2(_mm256_unpacklo_epi8(s, zero), mod_lanes);
+		const __m256i hi = modulateLanesAVX2(_mm256_unpackhi_epi8(s, zero), mod_lanes);
+
+		const __m256i color = _mm256_and_si256(_mm256_packus_epi16(lo, hi), color_mask);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), _mm256_adds_epu8(color, d));
+	}
+
+	addRowSSE2(src + i, dest + i, width - i, mod);
+}
+
+#endif // BLIT_AVX2
+
+void copyRow(const Uint32* src, Uint32* dest, int width, Uint32) {
+	memcpy(dest, src, static_cast<size_t>(width) * sizeof(Uint32));
+}
+
+/**
+ * Fills a surface with pseudo-random pixels. Every fourth pixel is fully transparent and every fourth is opaque
+ */
+void fillTestSurface(SDL_Surface* surface, Uint32 seed) {
+	for (int y = 0; y < surface->h; ++y) {
+		Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+		for (int x = 0; x < surface->w; ++x) {
+			seed = seed * 1664525u + 1013904223u;
+			row[x] = seed;
+			if (x % 4 == 0)
+				row[x] &= 0x00ffffff;
+			else if (x % 4 == 1)
+				row[x] |= 0xff000000;
+		}
+	}
+}
+
+SDL_Surface* createTestSurface(int width, int height) {
+	return SDL_CreateRGBSurface(0, width, height, 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
+}
+
+} // namespace
+
+SDLSoftwareBlitter::SDLSoftwareBlitter()
+	: kernel(KERNEL_SDL)
+{
+	for (int i = 0; i < MODE_COUNT; ++i) {
+		mode_matches[i] = false;
+	}
+
+	for (int i = KERNEL_COUNT - 1; i > KERNEL_SDL; --i) {
+		if (isKernelAvailable(i)) {
+			kernel = i;
+			break;
+		}
+	}
+
+	std::string mismatched;
+	for (int i = 0; i < MODE_COUNT; ++i) {
+		mode_matches[i] = (checkKernel(kernel, i) == 0);
+		if (!mode_matches[i])
+			mismatched += std::string(mismatched.empty() ? "" : ", ") + getModeName(i);
+	}
+
+	Utils::logInfo("SDLSoftwareBlitter: Using %s kernels.", getKernelName(kernel));
+	if (!mismatched.empty())
+		Utils::logInfo("SDLSoftwareBlitter: Results differ from this SDL version for '%s'. SDL_BlitSurface() will be used for those.", mismatched.c_str());
+}
+
+SDLSoftwareBlitter::~SDLSoftwareBlitter() {
+}
+
+bool SDLSoftwareBlitter::isKernelAvailable(int _kernel) {
+	if (_kernel == KERNEL_SDL || _kernel == KERNEL_SCALAR)
+		return true;
+#ifdef BLIT_SSE2
+	if (_kernel == KERNEL_SSE2)
+		return SDL_HasSSE2() == SDL_TRUE;
+#endif
+#ifdef BLIT_AVX2
+	if (_kernel == KERNEL_AVX2)
+		return SDL_HasAVX2() == SDL_TRUE;
+#endif
+	return false;
+}
+
+const char* SDLSoftwareBlitter::getKernelName(int _kernel) {
+	switch (_kernel) {
+		case KERNEL_SCALAR: return "scalar";
+		case KERNEL_SSE2: return "SSE2";
+		case KERNEL_AVX2: return "AVX2";
+		default: return "SDL";
+	}
+}
+
+const char* SDLSoftwareBlitter::getModeName(int mode) {
+	switch (mode) {
+		case MODE_COPY: return "copy";
+		case MODE_BLEND: return "blend";
+		case MODE_BLEND_MOD: return "blend+mod";
+		default: return "add";
+	}
+}
+
+SDLSoftwareBlitter::RowFunction SDLSoftwareBlitter::getRowFunction(int _kernel, int mode) {
+	if (mode == MODE_COPY)
+		return copyRow;
+
+#ifdef BLIT_AVX2
+	if (_kernel == KERNEL_AVX2)
+		return (mode == MODE_BLEND) ? blendRowAVX2 : (mode == MODE_BLEND_MOD) ? blendModRowAVX2 : addRowAVX2;
+#endif
+#ifdef BLIT_SSE2
+	if (_kernel == KERNEL_SSE2)
+		return (mode == MODE_BLEND) ? blendRowSSE2 : (mode == MODE_BLEND_MOD) ? blendModRowSSE2 : addRowSSE2;
+#endif
+
+	return (mode == MODE_BLEND) ? blendRowScalar : (mode == MODE_BLEND_MOD) ? blendModRowScalar : addRowScalar;
+}
+
+bool SDLSoftwareBlitter::canBlit(SDL_Surface* surface) {
+	Uint32 color_key;
+	return surface && surface->format->format == SDL_PIXELFORMAT_ARGB8888 && !(surface->flags & SDL_RLEACCEL) && SDL_GetColorKey(surface, &color_key) != 0;
+}
+
+/**
+ * Returns the kind of blit that SDL would do with the surface's current settings, or -1 if it isn't covered here
+ * mod is set to the color and alpha mod, packed like an ARGB8888 pixel
+ */
+int SDLSoftwareBlitter::getMode(SDL_Surface* surface, Uint32& mod) {
+	SDL_BlendMode blend_mode;
+	Uint8 r, g, b, a;
+	SDL_GetSurfaceBlendMode(surface, &blend_mode);
+	SDL_GetSurfaceColorMod(surface, &r, &g, &b);
+	SDL_GetSurfaceAlphaMod(surface, &a);
+
+	mod = (static_cast<Uint32>(a) << 24) | (static_cast<Uint32>(r) << 16) | (static_cast<Uint32>(g) << 8) | b;
+
+	if (blend_mode == SDL_BLENDMODE_NONE)
+		return (mod == 0xffffffff) ? MODE_COPY : -1;
+	else if (blend_mode == SDL_BLENDMODE_BLEND)
+		return (mod == 0xffffffff) ? MODE_BLEND : MODE_BLEND_MOD;
+	else if (blend_mode == SDL_BLENDMODE_ADD)
+		return MODE_ADD;
+
+	return -1;
+}
+
+/**
+ * Clips the rectangles the same way as SDL_BlitSurface(). dest_rect is changed to the area that is drawn to.
+ * Returns false if nothing is left to draw
+ */
+bool SDLSoftwareBlitter::clip(SDL_Surface* src, const SDL_Rect* src_rect, SDL_Surface* dest, SDL_Rect* dest_rect, SDL_Rect& clipped_src) {
+	int src_x = 0;
+	int src_y = 0;
+	int w = src->w;
+	int h = src->h;
+
+	if (src_rect) {
+		src_x = src_rect->x;
+		w = src_rect->w;
+		if (src_x < 0) {
+			w += src_x;
+			dest_rect->x -= src_x;
+			src_x = 0;
+		}
+		w = std::min(w, src->w - src_x);
+
+		src_y = src_rect->y;
+		h = src_rect->h;
+		if (src_y < 0) {
+			h += src_y;
+			dest_rect->y -= src_y;
+			src_y = 0;
+		}
+		h = std::min(h, src->h - src_y);
+	}
+
+	const SDL_Rect& clip_rect = dest->clip_rect;
+	int dx = clip_rect.x - dest_rect->x;
+	if (dx > 0) {
+		w -= dx;
+		dest_rect->x += dx;
+		src_x += dx;
+	}
+	dx = dest_rect->x + w - clip_rect.x - clip_rect.w;
+	if (dx > 0)
+		w -= dx;
+
+	int dy = clip_rect.y - dest_rect->y;
+	if (dy > 0) {
+		h -= dy;
+		dest_rect->y += dy;
+		src_y += dy;
+	}
+	dy = dest_rect->y + h - clip_rect.y - clip_rect.h;
+	if (dy > 0)
+		h -= dy;
+
+	if (w <= 0 || h <= 0) {
+		dest_rect->w = dest_rect->h = 0;
+		return false;
+	}
+
+	clipped_src.x = src_x;
+	clipped_src.y = src_y;
+	clipped_src.w = dest_rect->w = w;
+	clipped_src.h = dest_rect->h = h;
+	return true;
+}
+
+void SDLSoftwareBlitter::blitRows(int _kernel, int mode, Uint32 mod, SDL_Surface* src, const SDL_Rect& src_rect, SDL_Surface* dest, const SDL_Rect& dest_rect) {
+	const RowFunction row_function = getRowFunction(_kernel, mode);
+
+	const bool lock_src = SDL_MUSTLOCK(src);
+	const bool lock_dest = SDL_MUSTLOCK(dest);
+	if (lock_src) SDL_LockSurface(src);
+	if (lock_dest) SDL_LockSurface(dest);
+
+	const Uint8* src_row = static_cast<const Uint8*>(src->pixels) + src_rect.y * src->pitch + src_rect.x * 4;
+	Uint8* dest_row = static_cast<Uint8*>(dest->pixels) + dest_rect.y * dest->pitch + dest_rect.x * 4;
+
+	for (int y = 0; y < src_rect.h; ++y) {
+		row_function(reinterpret_cast<const Uint32*>(src_row), reinterpret_cast<Uint32*>(dest_row), src_rect.w, mod);
+		src_row += src->pitch;
+		dest_row += dest->pitch;
+	}
+
+	if (lock_dest) SDL_UnlockSurface(dest);
+	if (lock_src) SDL_UnlockSurface(src);
+}
+
+int SDLSoftwareBlitter::blit(SDL_Surface* src, const SDL_Rect* src_rect, SDL_Surface* dest, SDL_Rect* dest_rect) {
+	Blit prepared;
+	const int result = prepare(src, src_rect, dest, dest_rect, prepared);
+	if (result < 0)
+		return SDL_BlitSurface(src, src_rect, dest, dest_rect);
+
+	if (result > 0)
+		blitRows(kernel, prepared.mode, prepared.mod, src, prepared.src_rect, dest, prepared.dest_rect);
+
+	return 0;
+}
+
+/**
+ * Clips a blit and stores it, together with the source surface's current blend mode and mods, to be drawn later by
+ * blitRows(). Returns 1 if the blit was prepared, 0 if there is nothing to draw, and -1 if it has to go through blit()
+ */
+int SDLSoftwareBlitter::prepare(SDL_Surface* src, const SDL_Rect* src_rect, SDL_Surface* dest, SDL_Rect* dest_rect, Blit& prepared) {
+	if (kernel == KERNEL_SDL || !canBlit(src) || !canBlit(dest))
+		return -1;
+
+	prepared.mode = getMode(src, prepared.mod);
+	if (prepared.mode < 0 || !mode_matches[prepared.mode])
+		return -1;
+
+	SDL_Rect full_dest = { 0, 0, 0, 0 };
+	if (!dest_rect)
+		dest_rect = &full_dest;
+
+	if (!clip(src, src_rect, dest, dest_rect, prepared.src_rect))
+		return 0;
+
+	prepared.src = src;
+	prepared.dest_rect = *dest_rect;
+	return 1;
+}
+
+/**
+ * Draws the part of a prepared blit that lies within the rows [row_begin, row_end) of dest
+ */
+void SDLSoftwareBlitter::blitRows(const Blit& prepared, SDL_Surface* dest, int row_begin, int row_end) {
+	const int y0 = std::max(prepared.dest_rect.y, row_begin);
+	const int y1 = std::min(prepared.dest_rect.y + prepared.dest_rect.h, row_end);
+	if (y0 >= y1)
+		return;
+
+	SDL_Rect src_rect = prepared.src_rect;
+	src_rect.y += y0 - prepared.dest_rect.y;
+	src_rect.h = y1 - y0;
+
+	SDL_Rect dest_rect = prepared.dest_rect;
+	dest_rect.y = y0;
+	dest_rect.h = y1 - y0;
+
+	blitRows(kernel, prepared.mode, prepared.mod, prepared.src, src_rect, dest, dest_rect);
+}
+
+/**
+ * Blits test patterns with the given kernel and with SDL_BlitSurface(), and returns the number of pixels that differ
+ */
+unsigned SDLSoftwareBlitter::checkKernel(int _kernel, int mode) {
+	if (_kernel == KERNEL_SDL)
+		return 0;
+
+	// odd sizes, so that the scalar tails of the SIMD rows are used as well
+	SDL_Surface* src = createTestSurface(71, 9);
+	SDL_Surface* dest_sdl = createTestSurface(67, 11);
+	SDL_Surface* dest = createTestSurface(67, 11);
+	if (!src || !dest_sdl || !dest) {
+		SDL_FreeSurface(src);
+		SDL_FreeSurface(dest_sdl);
+		SDL_FreeSurface(dest);
+		return 1;
+	}
+
+	const Uint32 mods[] = { 0xffffffff, 0x80ffffff, 0xffc86432, 0x4d0afa80, 0x00ffffff };
+	const size_t mod_count = (mode == MODE_COPY || mode == MODE_BLEND) ? 1 : sizeof(mods) / sizeof(mods[0]);
+
+	// the source sticks out on the top left, so that clipping is checked too
+	SDL_Rect src_rect = { -3, 1, 74, 12 };
+	const SDL_Rect dest_start = { 5, -2, 0, 0 };
+
+	SDL_SetSurfaceBlendMode(src, (mode == MODE_COPY) ? SDL_BLENDMODE_NONE : (mode == MODE_ADD) ? SDL_BLENDMODE_ADD : SDL_BLENDMODE_BLEND);
+
+	unsigned mismatches = 0;
+	for (size_t m = 0; m < mod_count; ++m) {
+		Uint32 mod = mods[m];
+		if (mode == MODE_BLEND_MOD && mod == 0xffffffff)
+			continue;
+
+		SDL_SetSurfaceColorMod(src, static_cast<Uint8>(mod >> 16), static_cast<Uint8>(mod >> 8), static_cast<Uint8>(mod));
+		SDL_SetSurfaceAlphaMod(src, static_cast<Uint8>(mod >> 24));
+
+		fillTestSurface(src, static_cast<Uint32>(m) + 1);
+		fillTestSurface(dest_sdl, static_cast<Uint32>(m) + 100);
+		fillTestSurface(dest, static_cast<Uint32>(m) + 100);
+
+		SDL_Rect dest_rect = dest_start;
+		SDL_BlitSurface(src, &src_rect, dest_sdl, &dest_rect);
+
+		dest_rect = dest_start;
+		SDL_Rect clipped_src;
+		if (getMode(src, mod) == mode && clip(src, &src_rect, dest, &dest_rect, clipped_src))
+			blitRows(_kernel, mode, mod, src, clipped_src, dest, dest_rect);
+
+		for (int y = 0; y < dest->h; ++y) {
+			const Uint32* row_sdl = reinterpret_cast<const Uint32*>(static_cast<Uint8*>(dest_sdl->pixels) + y * dest_sdl->pitch);
+			const Uint32* row = reinterpret_cast<const Uint32*>(static_cast<Uint8*>(dest->pixels) + y * dest->pitch);
+			for (int x = 0; x < dest->w; ++x) {
+				if (row[x] != row_sdl[x])
+					mismatches++;
+			}
+		}
+	}
+
+	SDL_FreeSurface(src);
+	SDL_FreeSurface(dest_sdl);
+	SDL_FreeSurface(dest);
+
+	return mismatches;
+}
+
+/**
+ * Returns the throughput of a kernel in megapixels per second
+ */
+float SDLSoftwareBlitter::benchmark(int _kernel, int mode, int iterations) {
+	const int size = 256;
+	SDL_Surface* src = createTestSurface(size, size);
+	SDL_Surface* dest = createTestSurface(size, size);
+	if (!src || !dest || iterations <= 0) {
+		SDL_FreeSurface(src);
+		SDL_FreeSurface(dest);
+		return 0;
+	}
+
+	fillTestSurface(src, 1);
+	fillTestSurface(dest, 2);
+
+	SDL_SetSurfaceBlendMode(src, (mode == MODE_COPY) ? SDL_BLENDMODE_NONE : (mode == MODE_ADD) ? SDL_BLENDMODE_ADD : SDL_BLENDMODE_BLEND);
+	if (mode == MODE_BLEND_MOD) {
+		SDL_SetSurfaceColorMod(src, 200, 160, 120);
+		SDL_SetSurfaceAlphaMod(src, 160);
+	}
+
+	Uint32 mod;
+	getMode(src, mod);
+	const SDL_Rect rect = { 0, 0, size, size };
+
+	const Uint64 start = SDL_GetPerformanceCounter();
+	for (int i = 0; i < iterations; ++i) {
+		if (_kernel == KERNEL_SDL) {
+			SDL_Rect dest_rect = rect;
+			SDL_BlitSurface(src, &rect, dest, &dest_rect);
+		}
+		else {
+			blitRows(_kernel, mode, mod, src, rect, dest, rect);
+		}
+	}
+	const Uint64 ticks = SDL_GetPerformanceCounter() - start;
+
+	SDL_FreeSurface(src);
+	SDL_FreeSurface(dest);
+
+	if (ticks == 0)
+		return 0;
+
+	const double seconds = static_cast<double>(ticks) / static_cast<double>(SDL_GetPerformanceFrequency());
+	return static_cast<float>(static_cast<double>(size * size) * iterations / seconds / 1000000.0);
+}
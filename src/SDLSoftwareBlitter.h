@@ -0,0 +1,96 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class SDLSoftwareBlitter
+ *
+ * Blits between ARGB8888 surfaces without going through SDL_BlitSurface(), using SSE2 or AVX2 when the CPU has them.
+ *
+ * blit() is a drop-in replacement for SDL_BlitSurface(). The blend mode and color/alpha mods are read from the source
+ * surface, and the result is meant to match the blitter that SDL picks for the same case, down to the last bit. Each
+ * kernel is checked against SDL_BlitSurface() when the blitter is created. Kernels that don't match the linked SDL
+ * version are not used for that kind of blit. Anything not covered here (other pixel formats, color keys, RLE, other
+ * blend modes, color/alpha mods without blending) is passed on to SDL_BlitSurface().
+ *
+ * A blit can also be prepared and drawn later, one band of rows at a time. The rows of one band can be drawn while
+ * another thread draws a different band.
+ */
+
+#ifndef SDL_SOFTWARE_BLITTER_H
+#define SDL_SOFTWARE_BLITTER_H
+
+#include "CommonIncludes.h"
+
+class SDLSoftwareBlitter {
+public:
+	enum {
+		KERNEL_SDL = 0,
+		KERNEL_SCALAR = 1,
+		KERNEL_SSE2 = 2,
+		KERNEL_AVX2 = 3,
+		KERNEL_COUNT = 4
+	};
+
+	enum {
+		MODE_COPY = 0,
+		MODE_BLEND = 1,
+		MODE_BLEND_MOD = 2,
+		MODE_ADD = 3,
+		MODE_COUNT = 4
+	};
+
+	// a clipped blit, with the blend mode and mods it had when it was prepared
+	class Blit {
+	public:
+		SDL_Surface* src;
+		SDL_Rect src_rect;
+		SDL_Rect dest_rect;
+		int mode;
+		Uint32 mod;
+	};
+
+	SDLSoftwareBlitter();
+	~SDLSoftwareBlitter();
+
+	int blit(SDL_Surface* src, const SDL_Rect* src_rect, SDL_Surface* dest, SDL_Rect* dest_rect);
+
+	int prepare(SDL_Surface* src, const SDL_Rect* src_rect, SDL_Surface* dest, SDL_Rect* dest_rect, Blit& prepared);
+	void blitRows(const Blit& prepared, SDL_Surface* dest, int row_begin, int row_end);
+
+	bool isKernelAvailable(int _kernel);
+	int getKernel() { return kernel; }
+
+	unsigned checkKernel(int _kernel, int mode);
+	float benchmark(int _kernel, int mode, int iterations);
+
+	static const char* getKernelName(int _kernel);
+	static const char* getModeName(int mode);
+
+private:
+	typedef void (*RowFunction)(const Uint32* src, Uint32* dest, int width, Uint32 mod);
+
+	static RowFunction getRowFunction(int _kernel, int mode);
+	static bool canBlit(SDL_Surface* surface);
+	static int getMode(SDL_Surface* surface, Uint32& mod);
+	static bool clip(SDL_Surface* src, const SDL_Rect* src_rect, SDL_Surface* dest, SDL_Rect* dest_rect, SDL_Rect& clipped_src);
+	static void blitRows(int _kernel, int mode, Uint32 mod, SDL_Surface* src, const SDL_Rect& src_rect, SDL_Surface* dest, const SDL_Rect& dest_rect);
+
+	int kernel;
+	bool mode_matches[MODE_COUNT];
+};
+
+#endif
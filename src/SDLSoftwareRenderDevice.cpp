@@ -45,8 +45,11 @@ SDLSoftwareImage::SDLSoftwareImage(RenderDevice *_device)
 }
 
 SDLSoftwareImage::~SDLSoftwareImage() {
-	if (surface)
+	if (surface) {
+		// queued blits may still read from this surface
+		static_cast<SDLSoftwareRenderDevice *>(device)->flushBlits();
 		SDL_FreeSurface(surface);
+	}
 }
 
 int SDLSoftwareImage::getWidth() const {
@@ -60,6 +63,8 @@ int SDLSoftwareImage::getHeight() const {
 void SDLSoftwareImage::fillWithColor(const Color& color) {
 	if (!surface) return;
 
+	static_cast<SDLSoftwareRenderDevice *>(device)->flushBlits();
+
 	SDL_FillRect(surface, NULL, MapRGBA(color.r, color.g, color.b, color.a));
 }
 
@@ -76,6 +81,8 @@ void SDLSoftwareImage::drawPixel(int x, int y, const Color& color) {
 	if (x < 0 || y < 0 || x >= getWidth() || y >= getHeight())
 		return;
 
+	static_cast<SDLSoftwareRenderDevice *>(device)->flushBlits();
+
 	Uint32 pixel = MapRGBA(color.r, color.g, color.b, color.a);
 
 	int bpp = surface->format->BytesPerPixel;
@@ -145,6 +152,8 @@ void SDLSoftwareImage::drawLine(int x0, int y0, int x1, int y1, const Color& col
 }
 
 void SDLSoftwareImage::drawFilledRect(int x, int y, int w, int h, const Color& color) {
+	static_cast<SDLSoftwareRenderDevice *>(device)->flushBlits();
+
 	SDL_Rect rect;
 	rect.x = x;
 	rect.y = y;
@@ -210,6 +219,10 @@ SDLSoftwareRenderDevice::SDLSoftwareRenderDevice()
 	min_screen.x = eset->resolutions.min_screen_w;
 	min_screen.y = eset->resolutions.min_screen_h;
 
+	render_pool.init(settings->render_threads);
+	if (render_pool.getThreadCount() > 1)
+		Utils::logInfo("RenderDevice: Drawing with %d threads", render_pool.getThreadCount());
+
 	SDL_DisplayMode desktop;
 	if (SDL_GetDesktopDisplayMode(0, &desktop) == 0) {
 		// we only support display #0
@@ -381,7 +394,9 @@ int SDLSoftwareRenderDevice::render(Renderable& r, Rect& dest) {
 	SDL_SetSurfaceColorMod(surface, r.color_mod.r, r.color_mod.g, r.color_mod.b);
 	SDL_SetSurfaceAlphaMod(surface, r.alpha_mod);
 
-	return SDL_BlitSurface(surface, &src, screen, &_dest);
+	sprite_count++;
+	draw_call_count++;
+	return blitToScreen(surface, &src, &_dest);
 }
 
 int SDLSoftwareRenderDevice::render(Sprite *r) {
@@ -400,7 +415,51 @@ int SDLSoftwareRenderDevice::render(Sprite *r) {
 	SDL_SetSurfaceColorMod(surface, r->color_mod.r, r->color_mod.g, r->color_mod.b);
 	SDL_SetSurfaceAlphaMod(surface, r->alpha_mod);
 
-	return SDL_BlitSurface(surface, &src, screen, &dest);
+	sprite_count++;
+	draw_call_count++;
+	return blitToScreen(surface, &src, &dest);
+}
+
+/**
+ * Blits to the screen. With more than one render thread, the blit is queued and drawn by flushBlits()
+ */
+int SDLSoftwareRenderDevice::blitToScreen(SDL_Surface* surface, const SDL_Rect* src, SDL_Rect* dest) {
+	if (render_pool.getThreadCount() > 1) {
+		SDLSoftwareBlitter::Blit blit;
+		const int result = blitter.prepare(surface, src, screen, dest, blit);
+		if (result > 0)
+			queued_blits.push_back(blit);
+		if (result >= 0)
+			return 0;
+
+		// blits that SDL has to do read the surface's blend mode and mods when they are drawn, so they can't wait
+		flushBlits();
+	}
+
+	return blitter.blit(surface, src, screen, dest);
+}
+
+void SDLSoftwareRenderDevice::drawBlitBands(void* data, size_t begin, size_t end) {
+	SDLSoftwareRenderDevice* device = static_cast<SDLSoftwareRenderDevice*>(data);
+	const std::vector<SDLSoftwareBlitter::Blit>& blits = device->queued_blits;
+
+	for (size_t i = 0; i < blits.size(); ++i) {
+		device->blitter.blitRows(blits[i], device->screen, static_cast<int>(begin), static_cast<int>(end));
+	}
+}
+
+/**
+ * Draws all queued blits. Each render thread takes one band of screen rows and draws every blit that touches it,
+ * in the order they were queued, so the result is the same as drawing them one after the other
+ */
+void SDLSoftwareRenderDevice::flushBlits() {
+	if (queued_blits.empty())
+		return;
+
+	if (screen)
+		render_pool.run(drawBlitBands, this, static_cast<size_t>(screen->h));
+
+	queued_blits.clear();
 }
 
 int SDLSoftwareRenderDevice::renderToImage(Image* src_image, Rect& src, Image* dest_image, Rect& dest) {
@@ -409,8 +468,50 @@ int SDLSoftwareRenderDevice::renderToImage(Image* src_image, Rect& src, Image* d
 	SDL_Rect _src = src;
 	SDL_Rect _dest = dest;
 
-	return SDL_BlitSurface(static_cast<SDLSoftwareImage *>(src_image)->surface, &_src,
-						   static_cast<SDLSoftwareImage *>(dest_image)->surface, &_dest);
+	flushBlits();
+
+	// render() leaves the sprite's color and alpha on the surface, but the image should be copied as it is
+	SDL_Surface *src_surface = static_cast<SDLSoftwareImage *>(src_image)->surface;
+	SDL_SetSurfaceColorMod(src_surface, 255, 255, 255);
+	SDL_SetSurfaceAlphaMod(src_surface, 255);
+
+	return blitter.blit(src_surface, &_src, static_cast<SDLSoftwareImage *>(dest_image)->surface, &_dest);
+}
+
+/**
+ * SDL has no premultiplied blend mode for surfaces, so the colors are divided by alpha again instead
+ */
+bool SDLSoftwareRenderDevice::finishComposedImage(Image* image) {
+	if (!image)
+		return false;
+
+	SDL_Surface *surface = static_cast<SDLSoftwareImage *>(image)->surface;
+	if (!surface || surface->format->format != SDL_PIXELFORMAT_ARGB8888)
+		return false;
+
+	if (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) != 0)
+		return false;
+
+	for (int y = 0; y < surface->h; ++y) {
+		Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+		for (int x = 0; x < surface->w; ++x) {
+			const Uint32 alpha = row[x] >> 24;
+			if (alpha == 0 || alpha == 255)
+				continue;
+
+			Uint32 pixel = alpha << 24;
+			for (int shift = 0; shift < 24; shift += 8) {
+				const Uint32 color = (((row[x] >> shift) & 0xff) * 255 + alpha / 2) / alpha;
+				pixel |= std::min(color, static_cast<Uint32>(255)) << shift;
+			}
+			row[x] = pixel;
+		}
+	}
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_UnlockSurface(surface);
+
+	return true;
 }
 
 Image* SDLSoftwareRenderDevice::renderTextToImage(FontStyle* font_style, const std::string& text, const Color& color, bool blended) {
@@ -432,6 +533,8 @@ Image* SDLSoftwareRenderDevice::renderTextToImage(FontStyle* font_style, const s
 }
 
 void SDLSoftwareRenderDevice::drawPixel(int x, int y, const Color& color) {
+	flushBlits();
+
 	Uint32 pixel = MapRGBA(color.r, color.g, color.b, color.a);
 
 	int bpp = screen->format->BytesPerPixel;
@@ -513,25 +616,29 @@ void SDLSoftwareRenderDevice::drawRectangle(const Point& p0, const Point& p1, co
 }
 
 void SDLSoftwareRenderDevice::blankScreen() {
+	flushBlits();
 	SDL_FillRect(screen, NULL, background_color);
 	return;
 }
 
 void SDLSoftwareRenderDevice::commitFrame() {
+	flushBlits();
 	SDL_UpdateTexture(texture, NULL, screen->pixels, screen->pitch);
 	SDL_RenderClear(renderer);
 	SDL_RenderCopy(renderer, texture, NULL, NULL);
 	SDL_RenderPresent(renderer);
 	inpt->window_resized = false;
+	resetDrawCounts();
 
 	return;
 }
 
 void SDLSoftwareRenderDevice::destroyContext() {
+	flushBlits();
 	resetGamma();
 
 	// we need to free all loaded graphics as they may be tied to the current context
-	RenderDevice::cacheRemoveAll();
+	releaseContextImages();
 	reload_graphics = true;
 
 	if (icons) {
@@ -621,7 +728,7 @@ void SDLSoftwareRenderDevice::updateTitleBar() {
 	if (!window) return;
 
 	title = Utils::strdup(msg->get(eset->misc.window_title));
-	titlebar_icon = IMG_Load(mods->locate("images/logo/icon.png").c_str());
+	titlebar_icon = IMG_Load_RW(mods->openRW(mods->locate("images/logo/icon.png")), 1);
 
 	if (title) SDL_SetWindowTitle(window, title);
 	if (titlebar_icon) SDL_SetWindowIcon(window, titlebar_icon);
@@ -636,7 +743,7 @@ Image *SDLSoftwareRenderDevice::loadImage(const std::string& filename, int error
 	// load image
 	SDLSoftwareImage *image;
 	image = NULL;
-	SDL_Surface *cleanup = IMG_Load(mods->locate(filename).c_str());
+	SDL_Surface *cleanup = IMG_Load_RW(mods->openRW(mods->locate(filename)), 1);
 	if(!cleanup) {
 		if (error_type != ERROR_NONE)
 			Utils::logError("SDLSoftwareRenderDevice: Couldn't load image: '%s'. %s", filename.c_str(), IMG_GetError());
@@ -668,6 +775,7 @@ void SDLSoftwareRenderDevice::getWindowSize(short unsigned *screen_w, short unsi
 }
 
 void SDLSoftwareRenderDevice::windowResize() {
+	flushBlits();
 	windowResizeInternal();
 
 	SDL_RenderSetLogicalSize(renderer, settings->view_w, settings->view_h);
@@ -728,7 +836,7 @@ unsigned short SDLSoftwareRenderDevice::getRefreshRate() {
 int SDLSoftwareRenderDevice::loadQueuedImage(void* data) {
 	QueuedImage* image = static_cast<QueuedImage*>(data);
 	SDL_LockMutex(image->mutex);
-	image->surface = IMG_Load(image->loc_filename.c_str());
+	image->surface = IMG_Load_RW(mods->openRW(image->loc_filename), 1);
 	image->load_attempted = true;
 	SDL_CondSignal(image->loaded);
 	SDL_UnlockMutex(image->mutex);
@@ -22,11 +22,19 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #define SDLSOFTWARERENDERDEVICE_H
 
 #include "RenderDevice.h"
+#include "SDLSoftwareBlitter.h"
+#include "WorkerPool.h"
 
 /** Provide rendering device using SDL_BlitSurface backend.
  *
  * Provide an SDL_BlitSurface implementation for renderning a Renderable to
- * the screen.  Simply dispatches rendering to SDL_BlitSurface().
+ * the screen.  Simply dispatches rendering to SDL_BlitSurface(), through
+ * SDLSoftwareBlitter, which has faster kernels for the common cases.
+ *
+ * With more than one render thread, blits to the screen are only recorded.
+ * When the frame is committed, or before anything else touches the screen or
+ * an image, the screen is split into one horizontal band per thread, and each
+ * thread draws the recorded blits in order, clipped to its own band.
  *
  * As this is for the FLARE engine, the implementation uses the engine's
  * global settings context, which is included by the interface.
@@ -66,6 +74,7 @@ public:
 	virtual int render(Renderable& r, Rect& dest);
 	virtual int render(Sprite* r);
 	virtual int renderToImage(Image* src_image, Rect& src, Image* dest_image, Rect& dest);
+	bool finishComposedImage(Image* image);
 
 	Image* renderTextToImage(FontStyle* font_style, const std::string& text, const Color& color, bool blended);
 	void drawPixel(int x, int y, const Color& color);
@@ -87,6 +96,8 @@ public:
 
 	void loadQueuedImages();
 
+	void flushBlits();
+
 protected:
 	int createContextInternal();
 	void createContextError();
@@ -95,6 +106,8 @@ private:
 	Uint32 MapRGBA(Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 	void getWindowSize(short unsigned *screen_w, short unsigned *screen_h);
 	static int loadQueuedImage(void* data);
+	static void drawBlitBands(void* data, size_t begin, size_t end);
+	int blitToScreen(SDL_Surface* surface, const SDL_Rect* src, SDL_Rect* dest);
 
 	SDL_Surface* screen;
 	SDL_Window* window;
@@ -104,6 +117,12 @@ private:
 	char* title;
 	uint32_t background_color;
 
+	SDLSoftwareBlitter blitter;
+
+	// blits to the screen that haven't been drawn yet
+	std::vector<SDLSoftwareBlitter::Blit> queued_blits;
+	WorkerPool render_pool;
+
 	/* Stores the system gamma levels so they can be restored later */
 	uint16_t gamma_r[256];
 	uint16_t gamma_g[256];
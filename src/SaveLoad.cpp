@@ -36,6 +36,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "FogOfWar.h"
 #include "GameStatePlay.h"
 #include "MapRenderer.h"
+#include "MapSaver.h"
 #include "Menu.h"
 #include "MenuActionBar.h"
 #include "MenuCharacter.h"
@@ -76,6 +77,9 @@ void SaveLoad::saveGame() {
 
 	if (game_slot <= 0) return;
 
+	// headless runs are benchmarks, and must leave the player's saves alone
+	if (settings->headless) return;
+
 	// if needed, create the save file structure
 	Utils::createSaveDir(game_slot);
 
@@ -471,7 +475,7 @@ void SaveLoad::loadGame() {
 			}
 			else if (infile.key == "spawn") {
 				mapr->teleport_mapname = Parse::popFirstString(infile.val);
-				if (mapr->teleport_mapname != "" && Filesystem::fileExists(mods->locate(mapr->teleport_mapname))) {
+				if (mapr->teleport_mapname != "" && mods->fileExists(mapr->teleport_mapname)) {
 					mapr->teleport_destination.x = static_cast<float>(Parse::popFirstInt(infile.val)) + 0.5f;
 					mapr->teleport_destination.y = static_cast<float>(Parse::popFirstInt(infile.val)) + 0.5f;
 					mapr->teleportation = true;
@@ -750,6 +754,8 @@ void SaveLoad::loadPowerTree() {
 void SaveLoad::saveFOW() {
 	std::ofstream outfile;
 
+	if (settings->headless) return;
+
 	// Save fow dark layer
 	if (mapr->fogofwar && mapr->save_fogofwar && !mapr->getFilename().empty() && fow->dark_layer_id < mapr->layernames.size()) {
 		std::string fow_filename = mapr->getFOWFilename();
@@ -760,21 +766,9 @@ void SaveLoad::saveFOW() {
 			outfile << "# " << mapr->getFilename() << std::endl;
 			outfile << "[layer]" << std::endl;
 			outfile << "type=" << mapr->layernames[fow->dark_layer_id] << std::endl;
-			outfile << "data=" << std::endl;
-
-			std::string layer = "";
-			for (int line = 0; line < mapr->h; line++) {
-				std::stringstream map_row;
-				for (int tile = 0; tile < mapr->w; tile++) {
-					unsigned short val = mapr->layers[fow->dark_layer_id][tile][line];
-					map_row << val << ",";
-				}
-				layer += map_row.str();
-				layer += '\n';
-			}
-			layer.erase(layer.end()-2, layer.end());
-			layer += '\n';
-			outfile << layer << std::endl;
+
+			// explored areas are large runs of the same value
+			MapSaver::writeLayerData(outfile, mapr->layers[fow->dark_layer_id], Map::LAYER_FORMAT_RLE);
 
 			if (outfile.bad()) Utils::logError("SaveLoad: Unable to save map data. No write access or disk is full!");
 			outfile.close();
@@ -67,8 +67,11 @@ Settings::Settings()
 	, encounter_dist(0) // set in updateScreenVars()
 	, soft_reset(false)
 	, safe_video(false)
+	, headless(false)
+	, rebuild_cache(false)
+	, cache_mod_index(false)
 {
-	config.resize(55);
+	config.resize(63);
 	setConfigDefault(0,  "fullscreen",          &typeid(fullscreen),          "1",             &fullscreen,          "Fullscreen mode | 0 = disable, 1 = enable");
 	setConfigDefault(1,  "resolution_w",        &typeid(screen_w),            "640",           &screen_w,            "Window size");
 	setConfigDefault(2,  "resolution_h",        &typeid(screen_h),            "480",           &screen_h,            "");
@@ -124,6 +127,14 @@ Settings::Settings()
 	setConfigDefault(52, "fade_walls",          &typeid(fade_walls),          "1",             &fade_walls,          "Lowers the opacity of walls that are covering the player. 0 = disable, 1 = enable");
 	setConfigDefault(53, "setup_language",      &typeid(setup_language),      "0",             &setup_language,      "(First-time-launch setup) Language | 0 = show dialog, 1 = no dialog");
 	setConfigDefault(54, "setup_mousemove",     &typeid(setup_mousemove),     "0",             &setup_mousemove,     "(First-time-launch setup) Mouse movement | 0 = show dialog, 1 = no dialog");
+	setConfigDefault(55, "ai_threads",          &typeid(ai_threads),          "0",             &ai_threads,          "Number of threads used to update enemy and ally AI. 0 = one per CPU core, 1 = single-threaded");
+	setConfigDefault(56, "layer_cache_size",    &typeid(layer_cache_size),    "64",            &layer_cache_size,    "Memory in megabytes used to keep pre-rendered background map layers. 0 = disable");
+	setConfigDefault(57, "render_batching",     &typeid(render_batching),     "1",             &render_batching,     "Combines consecutive sprites that use the same texture into one draw call (hardware renderer only). 0 = disable, 1 = enable");
+	setConfigDefault(58, "render_threads",      &typeid(render_threads),      "0",             &render_threads,      "Number of threads used to draw each frame (software renderer only). 0 = one per CPU core, 1 = single-threaded");
+	setConfigDefault(59, "text_cache_size",     &typeid(text_cache_size),     "4",             &text_cache_size,     "Memory in megabytes used to keep rendered text. 0 = disable");
+	setConfigDefault(60, "retained_hud",        &typeid(retained_hud),        "1",             &retained_hud,        "Keeps HUD menus in cached layers that are only redrawn when they change (hardware renderer only). 0 = disable, 1 = enable");
+	setConfigDefault(61, "render_interpolation", &typeid(render_interpolation), "0",            &render_interpolation, "Draws frames as often as the display refreshes, moving objects smoothly between logic frames. Logic still runs at max_fps. 0 = disable, 1 = enable");
+	setConfigDefault(62, "text_glyph_atlas",    &typeid(text_glyph_atlas),    "0",             &text_glyph_atlas,    "Draws text on screen from a texture of individual letters instead of rendering each string. 0 = disable, 1 = enable");
 }
 
 void Settings::setConfigDefault(size_t index, const std::string& name, const std::type_info *type, const std::string& default_val, void *storage, const std::string& comment) {
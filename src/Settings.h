@@ -133,6 +133,14 @@ public:
 	bool setup_language;
 	bool setup_mousemove;
 	bool enable_threaded_image_load;
+	int ai_threads;
+	int layer_cache_size;
+	bool render_batching;
+	int render_threads;
+	int text_cache_size;
+	bool retained_hud;
+	bool render_interpolation;
+	bool text_glyph_atlas;
 
 	// Dev console: shortcut commands
 	std::string dev_cmd_1;
@@ -178,6 +186,11 @@ public:
 
 	bool safe_video;
 
+	bool headless; // no window or audio device, see --headless
+
+	bool rebuild_cache; // ignore any FileParserCache files and the saved mod index, see --rebuild-cache
+	bool cache_mod_index; // save the ModManager index between runs, see --cache-mod-index
+
 private:
 	class ConfigEntry {
 	public:
@@ -0,0 +1,317 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "Entity.h"
+#include "SpatialGrid.h"
+#include "StatBlock.h"
+
+#include <cfloat>
+
+SpatialGrid::Filter::Filter()
+	: alliance(ALLIANCE_ANY)
+	, state(STATE_ANY)
+	, in_combat(false)
+{
+}
+
+SpatialGrid::Filter::Filter(int _alliance, int _state)
+	: alliance(_alliance)
+	, state(_state)
+	, in_combat(false)
+{
+}
+
+bool SpatialGrid::Filter::accepts(const Entity* e) const {
+	if (alliance == ALLIANCE_ALLY && !e->stats.hero_ally)
+		return false;
+	else if (alliance == ALLIANCE_ENEMY && e->stats.hero_ally)
+		return false;
+
+	if (in_combat && !e->stats.in_combat)
+		return false;
+
+	if (state == STATE_ALIVE)
+		return e->stats.alive;
+	else if (state == STATE_NOT_DEAD)
+		return e->stats.cur_state != StatBlock::ENTITY_DEAD && e->stats.cur_state != StatBlock::ENTITY_CRITDEAD;
+	else if (state == STATE_CORPSE)
+		return e->stats.corpse;
+
+	return true;
+}
+
+SpatialGrid::SpatialGrid()
+	: entities(NULL)
+	, grid_map_size()
+	, cells_w(1)
+	, cells_h(1)
+{
+	cells.resize(1);
+}
+
+SpatialGrid::~SpatialGrid() {
+}
+
+/**
+ * Places every entity in its cell. Needs to be called when the entity list changes
+ */
+void SpatialGrid::rebuild(const std::vector<Entity*>* _entities, const Point& map_size) {
+	entities = _entities;
+	grid_map_size = map_size;
+
+	int w = std::max((map_size.x + CELL_SIZE - 1) / CELL_SIZE, 1);
+	int h = std::max((map_size.y + CELL_SIZE - 1) / CELL_SIZE, 1);
+	if (w != cells_w || h != cells_h) {
+		cells_w = w;
+		cells_h = h;
+		cells.resize(static_cast<size_t>(cells_w * cells_h));
+	}
+
+	for (size_t i = 0; i < cells.size(); ++i) {
+		cells[i].clear();
+	}
+
+	entity_cell.resize(entities ? entities->size() : 0);
+	for (size_t i = 0; i < entity_cell.size(); ++i) {
+		entity_cell[i] = getCell((*entities)[i]->stats.pos);
+		cells[entity_cell[i]].push_back(static_cast<unsigned>(i));
+	}
+}
+
+/**
+ * Moves an entity to a new cell if its position changed
+ */
+void SpatialGrid::update(size_t index) {
+	sync();
+	if (index >= entity_cell.size())
+		return;
+
+	int cell = getCell((*entities)[index]->stats.pos);
+	if (cell == entity_cell[index])
+		return;
+
+	std::vector<unsigned>& old_cell = cells[entity_cell[index]];
+	for (size_t i = 0; i < old_cell.size(); ++i) {
+		if (old_cell[i] == index) {
+			old_cell[i] = old_cell.back();
+			old_cell.pop_back();
+			break;
+		}
+	}
+
+	entity_cell[index] = cell;
+	cells[cell].push_back(static_cast<unsigned>(index));
+}
+
+/**
+ * Entities outside of the map are placed in the nearest cell
+ */
+int SpatialGrid::getCell(const FPoint& pos) const {
+	int x = std::max(std::min(static_cast<int>(pos.x) / CELL_SIZE, cells_w - 1), 0);
+	int y = std::max(std::min(static_cast<int>(pos.y) / CELL_SIZE, cells_h - 1), 0);
+	return y * cells_w + x;
+}
+
+/**
+ * Entities may be added to or removed from the list outside of EntityManager::logic() (e.g. NPCs joining the party)
+ */
+void SpatialGrid::sync() {
+	if (entities && entity_cell.size() != entities->size())
+		rebuild(entities, grid_map_size);
+}
+
+void SpatialGrid::collectCells(int x0, int y0, int x1, int y1) {
+	found.clear();
+
+	x0 = std::max(std::min(x0 / CELL_SIZE, cells_w - 1), 0);
+	y0 = std::max(std::min(y0 / CELL_SIZE, cells_h - 1), 0);
+	x1 = std::max(std::min(x1 / CELL_SIZE, cells_w - 1), 0);
+	y1 = std::max(std::min(y1 / CELL_SIZE, cells_h - 1), 0);
+
+	for (int y = y0; y <= y1; ++y) {
+		for (int x = x0; x <= x1; ++x) {
+			const std::vector<unsigned>& cell = cells[y * cells_w + x];
+			found.insert(found.end(), cell.begin(), cell.end());
+		}
+	}
+}
+
+void SpatialGrid::getSortedResult(std::vector<Entity*>& result) {
+	std::sort(found.begin(), found.end());
+
+	result.clear();
+	for (size_t i = 0; i < found.size(); ++i) {
+		result.push_back((*entities)[found[i]]);
+	}
+}
+
+/**
+ * Gets the entities that are within radius of center (see Utils::isWithinRadius())
+ */
+void SpatialGrid::getInRadius(const FPoint& center, float radius, const Filter& filter, std::vector<Entity*>& result) {
+	result.clear();
+	sync();
+	if (!entities)
+		return;
+
+	collectCells(static_cast<int>(center.x - radius), static_cast<int>(center.y - radius), static_cast<int>(center.x + radius), static_cast<int>(center.y + radius));
+
+	size_t count = 0;
+	for (size_t i = 0; i < found.size(); ++i) {
+		Entity* e = (*entities)[found[i]];
+		if (filter.accepts(e) && Utils::isWithinRadius(center, radius, e->stats.pos))
+			found[count++] = found[i];
+	}
+	found.resize(count);
+
+	getSortedResult(result);
+}
+
+/**
+ * Gets the entities whose position is within a rectangle of tiles
+ */
+void SpatialGrid::getInRect(const Rect& tiles, const Filter& filter, std::vector<Entity*>& result) {
+	result.clear();
+	sync();
+	if (!entities)
+		return;
+
+	collectCells(tiles.x, tiles.y, tiles.x + tiles.w - 1, tiles.y + tiles.h - 1);
+
+	size_t count = 0;
+	for (size_t i = 0; i < found.size(); ++i) {
+		Entity* e = (*entities)[found[i]];
+		if (filter.accepts(e) && Utils::isWithinRect(tiles, Point(e->stats.pos)))
+			found[count++] = found[i];
+	}
+	found.resize(count);
+
+	getSortedResult(result);
+}
+
+/**
+ * Gets up to k entities that are closest to pos and no further than max_range, sorted by distance
+ */
+void SpatialGrid::getNearest(const FPoint& pos, const Filter& filter, size_t k, float max_range, std::vector<Entity*>& result) {
+	result.clear();
+	sync();
+	findNearest(pos, filter, k, max_range, nearest);
+
+	for (size_t i = 0; i < nearest.size(); ++i) {
+		result.push_back((*entities)[nearest[i].second]);
+	}
+}
+
+/**
+ * Gets the single closest entity, storing its distance if requested
+ */
+Entity* SpatialGrid::getNearest(const FPoint& pos, const Filter& filter, float max_range, float* distance) {
+	getNearest(pos, filter, 1, max_range, nearest_result);
+
+	if (nearest_result.empty())
+		return NULL;
+
+	if (distance)
+		*distance = nearest[0].first;
+
+	return nearest_result[0];
+}
+
+/**
+ * Same as above, but the grid is left untouched and candidates is used as scratch space
+ * This can be called from several threads at once, as long as each has its own candidates list and nothing moves
+ */
+Entity* SpatialGrid::getNearest(const FPoint& pos, const Filter& filter, float max_range, float* distance, std::vector< std::pair<float, unsigned> >& candidates) const {
+	findNearest(pos, filter, 1, max_range, candidates);
+
+	if (candidates.empty())
+		return NULL;
+
+	if (distance)
+		*distance = candidates[0].first;
+
+	return (*entities)[candidates[0].second];
+}
+
+/**
+ * Cells are searched in rings around pos, until no unsearched cell can hold a closer entity
+ * The best candidates are stored as (distance, entity index) pairs, sorted by distance
+ */
+void SpatialGrid::findNearest(const FPoint& pos, const Filter& filter, size_t k, float max_range, std::vector< std::pair<float, unsigned> >& candidates) const {
+	candidates.clear();
+	if (!entities || k == 0)
+		return;
+
+	const int cx = getCell(pos) % cells_w;
+	const int cy = getCell(pos) / cells_w;
+	const size_t total = entities->size();
+	size_t examined = 0;
+
+	for (int r = 0; examined < total; ++r) {
+		if (r > 0) {
+			// the distance from pos to the nearest cell that hasn't been searched yet
+			// sides that reach the edge of the grid have nothing left to search
+			float bound = FLT_MAX;
+			if (cx - r + 1 > 0)
+				bound = std::min(bound, pos.x - static_cast<float>((cx - r + 1) * CELL_SIZE));
+			if (cx + r < cells_w)
+				bound = std::min(bound, static_cast<float>((cx + r) * CELL_SIZE) - pos.x);
+			if (cy - r + 1 > 0)
+				bound = std::min(bound, pos.y - static_cast<float>((cy - r + 1) * CELL_SIZE));
+			if (cy + r < cells_h)
+				bound = std::min(bound, static_cast<float>((cy + r) * CELL_SIZE) - pos.y);
+
+			if (bound == FLT_MAX || bound > max_range)
+				break;
+			if (candidates.size() >= k && candidates.back().first < bound)
+				break;
+		}
+
+		for (int y = std::max(cy - r, 0); y <= std::min(cy + r, cells_h - 1); ++y) {
+			// rows in the middle of the ring only have cells on the left and right sides
+			bool full_row = (y == cy - r || y == cy + r);
+			int step = full_row ? 1 : 2 * r;
+
+			for (int x = cx - r; x <= cx + r; x += step) {
+				if (x < 0 || x >= cells_w)
+					continue;
+
+				const std::vector<unsigned>& cell = cells[y * cells_w + x];
+				examined += cell.size();
+
+				for (size_t i = 0; i < cell.size(); ++i) {
+					Entity* e = (*entities)[cell[i]];
+					if (!filter.accepts(e))
+						continue;
+
+					float dist = Utils::calcDist(pos, e->stats.pos);
+					if (dist > max_range)
+						continue;
+
+					// keep the k best candidates sorted by distance, then by index
+					std::pair<float, unsigned> candidate(dist, cell[i]);
+					if (candidates.size() >= k && !(candidate < candidates.back()))
+						continue;
+
+					if (candidates.size() >= k)
+						candidates.pop_back();
+					candidates.insert(std::upper_bound(candidates.begin(), candidates.end(), candidate), candidate);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,97 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class SpatialGrid
+ *
+ * Buckets the entities of EntityManager into square cells of map tiles, so that proximity queries
+ * only need to look at the entities that are close by.
+ *
+ * The grid stores indices into EntityManager::entities. All query results are returned in the same
+ * order as that list (or by distance for nearest queries, with ties going to the lower index), so that
+ * code moved onto the grid behaves the same as the loops it replaces.
+ */
+
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "CommonIncludes.h"
+#include "Utils.h"
+
+class Entity;
+
+class SpatialGrid {
+public:
+	enum {
+		ALLIANCE_ANY = 0,
+		ALLIANCE_ALLY = 1, // hero allies
+		ALLIANCE_ENEMY = 2 // everything else
+	};
+
+	enum {
+		STATE_ANY = 0,
+		STATE_ALIVE = 1,
+		STATE_NOT_DEAD = 2, // not in the dead or critdead states
+		STATE_CORPSE = 3
+	};
+
+	class Filter {
+	public:
+		int alliance;
+		int state;
+		bool in_combat;
+		Filter();
+		Filter(int _alliance, int _state);
+		bool accepts(const Entity* e) const;
+	};
+
+	static const int CELL_SIZE = 4; // in tiles
+
+	SpatialGrid();
+	~SpatialGrid();
+
+	void rebuild(const std::vector<Entity*>* _entities, const Point& map_size);
+	void update(size_t index);
+
+	void getInRadius(const FPoint& center, float radius, const Filter& filter, std::vector<Entity*>& result);
+	void getInRect(const Rect& tiles, const Filter& filter, std::vector<Entity*>& result);
+	void getNearest(const FPoint& pos, const Filter& filter, size_t k, float max_range, std::vector<Entity*>& result);
+	Entity* getNearest(const FPoint& pos, const Filter& filter, float max_range, float* distance);
+	Entity* getNearest(const FPoint& pos, const Filter& filter, float max_range, float* distance, std::vector< std::pair<float, unsigned> >& candidates) const;
+
+private:
+	int getCell(const FPoint& pos) const;
+	void sync();
+	void collectCells(int x0, int y0, int x1, int y1);
+	void findNearest(const FPoint& pos, const Filter& filter, size_t k, float max_range, std::vector< std::pair<float, unsigned> >& candidates) const;
+	void getSortedResult(std::vector<Entity*>& result);
+
+	const std::vector<Entity*>* entities;
+	Point grid_map_size;
+	int cells_w;
+	int cells_h;
+
+	std::vector< std::vector<unsigned> > cells;
+	std::vector<int> entity_cell;
+
+	// scratch space reused between queries
+	std::vector<unsigned> found;
+	std::vector< std::pair<float, unsigned> > nearest;
+	std::vector<Entity*> nearest_result;
+};
+
+#endif
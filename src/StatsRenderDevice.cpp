@@ -0,0 +1,349 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "MessageEngine.h"
+#include "Settings.h"
+#include "SharedResources.h"
+#include "StatsRenderDevice.h"
+
+StatsRenderDevice::Counters::Counters()
+	: render_calls(0)
+	, pixels(0)
+	, texture_switches(0)
+	, state_changes(0)
+	, render_to_image_calls(0)
+	, images_created(0)
+{
+}
+
+StatsRenderDevice::StatsRenderDevice(RenderDevice* _device)
+	: device(_device)
+	, last_images_destroyed(0)
+	, last_destroy_count(0)
+	, last_image(NULL)
+	, last_blend_mode(Renderable::BLEND_NORMAL)
+	, last_color_mod(255, 255, 255)
+	, last_alpha_mod(255)
+	, frame(0)
+{
+	Utils::logInfo("RenderDevice: Recording draw statistics");
+}
+
+StatsRenderDevice::~StatsRenderDevice() {
+	if (csv_file.is_open())
+		csv_file.close();
+
+	delete device;
+}
+
+int StatsRenderDevice::createContextInternal() {
+	// the wrapped device handles its own fallbacks, and exits if they all fail
+	return device->createContext();
+}
+
+void StatsRenderDevice::createContextError() {
+	Utils::logError("StatsRenderDevice: createContext() failed");
+}
+
+/**
+ * Returns the number of pixels of dest that are inside the view
+ */
+uint64_t StatsRenderDevice::getVisiblePixels(const Rect& dest) {
+	int x0 = std::max(dest.x, 0);
+	int y0 = std::max(dest.y, 0);
+	int x1 = std::min(dest.x + dest.w, static_cast<int>(settings->view_w));
+	int y1 = std::min(dest.y + dest.h, static_cast<int>(settings->view_h));
+
+	if (x1 <= x0 || y1 <= y0)
+		return 0;
+
+	return static_cast<uint64_t>(x1 - x0) * static_cast<uint64_t>(y1 - y0);
+}
+
+/**
+ * Adds a draw call to the current category. Primitives pass a NULL image, and their color as the color mod
+ */
+void StatsRenderDevice::countDraw(const Image* image, uint64_t pixels, uint8_t blend_mode, const Color& color_mod, uint8_t alpha_mod) {
+	Counters& c = counters[draw_category];
+
+	c.render_calls++;
+	c.pixels += pixels;
+
+	if (image && image != last_image) {
+		c.texture_switches++;
+		last_image = image;
+	}
+
+	if (blend_mode != last_blend_mode || last_color_mod != color_mod || alpha_mod != last_alpha_mod) {
+		c.state_changes++;
+		last_blend_mode = blend_mode;
+		last_color_mod = color_mod;
+		last_alpha_mod = alpha_mod;
+	}
+}
+
+/**
+ * Adds the images the wrapped device created since it had created last_create_count to the current category
+ */
+void StatsRenderDevice::countImagesCreated(unsigned last_create_count) {
+	counters[draw_category].images_created += device->getImageCreateCount() - last_create_count;
+}
+
+int StatsRenderDevice::render(Renderable& r, Rect& dest) {
+	if (r.image) {
+		Rect dest_rect(dest.x, dest.y, r.src.w, r.src.h);
+		countDraw(r.image, getVisiblePixels(dest_rect), r.blend_mode, r.color_mod, r.alpha_mod);
+	}
+
+	return device->render(r, dest);
+}
+
+int StatsRenderDevice::render(Sprite *r) {
+	if (r && localToGlobal(r)) {
+		Rect dest_rect(m_dest.x, m_dest.y, m_clip.w, m_clip.h);
+		countDraw(r->getGraphics(), getVisiblePixels(dest_rect), Renderable::BLEND_NORMAL, r->color_mod, r->alpha_mod);
+	}
+
+	return device->render(r);
+}
+
+int StatsRenderDevice::renderToImage(Image* src_image, Rect& src, Image* dest_image, Rect& dest) {
+	counters[draw_category].render_to_image_calls++;
+	return device->renderToImage(src_image, src, dest_image, dest);
+}
+
+bool StatsRenderDevice::finishComposedImage(Image* image) {
+	return device->finishComposedImage(image);
+}
+
+Image* StatsRenderDevice::renderTextToImage(FontStyle* font_style, const std::string& text, const Color& color, bool blended) {
+	unsigned create_count = device->getImageCreateCount();
+	Image* image = device->renderTextToImage(font_style, text, color, blended);
+	countImagesCreated(create_count);
+	return image;
+}
+
+void StatsRenderDevice::drawPixel(int x, int y, const Color& color) {
+	countDraw(NULL, getVisiblePixels(Rect(x, y, 1, 1)), Renderable::BLEND_NORMAL, color, color.a);
+	device->drawPixel(x, y, color);
+}
+
+/**
+ * Lines are counted at their full length, without clipping
+ */
+void StatsRenderDevice::drawLine(int x0, int y0, int x1, int y1, const Color& color) {
+	const uint64_t length = static_cast<uint64_t>(std::max(abs(x1 - x0), abs(y1 - y0)) + 1);
+	countDraw(NULL, length, Renderable::BLEND_NORMAL, color, color.a);
+	device->drawLine(x0, y0, x1, y1, color);
+}
+
+void StatsRenderDevice::drawRectangle(const Point& p0, const Point& p1, const Color& color) {
+	const uint64_t perimeter = static_cast<uint64_t>(2 * (abs(p1.x - p0.x) + abs(p1.y - p0.y)));
+	countDraw(NULL, perimeter, Renderable::BLEND_NORMAL, color, color.a);
+	device->drawRectangle(p0, p1, color);
+}
+
+void StatsRenderDevice::blankScreen() {
+	device->blankScreen();
+}
+
+void StatsRenderDevice::commitFrame() {
+	device->commitFrame();
+
+	last_sprite_count = device->getSpriteCount();
+	last_draw_call_count = device->getDrawCallCount();
+
+	unsigned destroy_count = device->getImageDestroyCount();
+	last_images_destroyed = destroy_count - last_destroy_count;
+	last_destroy_count = destroy_count;
+
+	for (int i = 0; i < DRAW_CATEGORY_COUNT; ++i) {
+		last_counters[i] = counters[i];
+		counters[i] = Counters();
+	}
+
+	writeRow();
+	frame++;
+
+	// the backend state isn't known at the start of a frame
+	last_image = NULL;
+	last_blend_mode = Renderable::BLEND_NORMAL;
+	last_color_mod = Color(255, 255, 255);
+	last_alpha_mod = 255;
+}
+
+/**
+ * Writes the last frame to render_stats.csv. The file is created on the first frame
+ */
+void StatsRenderDevice::writeRow() {
+	const char* category_names[DRAW_CATEGORY_COUNT] = {"map", "entity", "hazard", "loot", "menu", "text"};
+
+	if (frame == 0) {
+		std::string csv_path = settings->path_user + "render_stats.csv";
+		csv_file.open(csv_path.c_str(), std::ios::out);
+
+		if (!csv_file.is_open()) {
+			Utils::logError("StatsRenderDevice: Unable to open '%s' for writing.", csv_path.c_str());
+			return;
+		}
+
+		Utils::logInfo("StatsRenderDevice: Writing draw statistics to '%s'", csv_path.c_str());
+
+		csv_file << "frame,sprites,draw_calls,images_destroyed";
+		for (int i = 0; i < DRAW_CATEGORY_COUNT; ++i) {
+			csv_file << "," << category_names[i] << "_render_calls";
+			csv_file << "," << category_names[i] << "_pixels";
+			csv_file << "," << category_names[i] << "_texture_switches";
+			csv_file << "," << category_names[i] << "_state_changes";
+			csv_file << "," << category_names[i] << "_render_to_image_calls";
+			csv_file << "," << category_names[i] << "_images_created";
+		}
+		csv_file << "\n";
+	}
+
+	if (!csv_file.is_open())
+		return;
+
+	csv_file << frame << "," << last_sprite_count << "," << last_draw_call_count << "," << last_images_destroyed;
+	for (int i = 0; i < DRAW_CATEGORY_COUNT; ++i) {
+		const Counters& c = last_counters[i];
+		csv_file << "," << c.render_calls << "," << c.pixels << "," << c.texture_switches << "," << c.state_changes;
+		csv_file << "," << c.render_to_image_calls << "," << c.images_created;
+	}
+	csv_file << "\n";
+
+	if (csv_file.bad()) {
+		Utils::logError("StatsRenderDevice: Unable to write draw statistics. No write access or disk is full!");
+		csv_file.close();
+	}
+}
+
+/**
+ * One line for the whole frame, then one line for each category that drew anything
+ */
+void StatsRenderDevice::getStatsText(std::vector<std::string>& lines) {
+	std::string category_names[DRAW_CATEGORY_COUNT];
+	category_names[DRAW_MAP] = msg->get("Map");
+	category_names[DRAW_ENTITY] = msg->get("Entities");
+	category_names[DRAW_HAZARD] = msg->get("Hazards");
+	category_names[DRAW_LOOT] = msg->get("Loot");
+	category_names[DRAW_MENU] = msg->get("Menus");
+	category_names[DRAW_TEXT] = msg->get("Text");
+
+	const float view_pixels = static_cast<float>(std::max(settings->view_w * settings->view_h, 1));
+
+	Counters total;
+	for (int i = 0; i < DRAW_CATEGORY_COUNT; ++i) {
+		total.render_calls += last_counters[i].render_calls;
+		total.pixels += last_counters[i].pixels;
+		total.texture_switches += last_counters[i].texture_switches;
+		total.state_changes += last_counters[i].state_changes;
+		total.render_to_image_calls += last_counters[i].render_to_image_calls;
+		total.images_created += last_counters[i].images_created;
+	}
+
+	lines.push_back(msg->getv("Render stats: %u calls, %.2fx overdraw, %u texture switches, %u state changes, %u renderToImage, %u/%u images created/destroyed", total.render_calls, static_cast<float>(total.pixels) / view_pixels, total.texture_switches, total.state_changes, total.render_to_image_calls, total.images_created, last_images_destroyed));
+
+	for (int i = 0; i < DRAW_CATEGORY_COUNT; ++i) {
+		const Counters& c = last_counters[i];
+		if (c.render_calls == 0 && c.render_to_image_calls == 0 && c.images_created == 0)
+			continue;
+
+		lines.push_back(msg->getv("%s: %u calls, %.2fx overdraw, %u texture switches, %u state changes, %u renderToImage, %u images created", category_names[i].c_str(), c.render_calls, static_cast<float>(c.pixels) / view_pixels, c.texture_switches, c.state_changes, c.render_to_image_calls, c.images_created));
+	}
+}
+
+void StatsRenderDevice::destroyContext() {
+	device->destroyContext();
+}
+
+Image *StatsRenderDevice::createImage(int width, int height) {
+	unsigned create_count = device->getImageCreateCount();
+	Image* image = device->createImage(width, height);
+	countImagesCreated(create_count);
+	return image;
+}
+
+void StatsRenderDevice::setGamma(float g) {
+	device->setGamma(g);
+}
+
+void StatsRenderDevice::resetGamma() {
+	device->resetGamma();
+}
+
+void StatsRenderDevice::updateTitleBar() {
+	device->updateTitleBar();
+}
+
+void StatsRenderDevice::setBackgroundColor(Color color) {
+	device->setBackgroundColor(color);
+}
+
+void StatsRenderDevice::setFullscreen(bool enable_fullscreen) {
+	device->setFullscreen(enable_fullscreen);
+}
+
+unsigned short StatsRenderDevice::getRefreshRate() {
+	return device->getRefreshRate();
+}
+
+bool StatsRenderDevice::reloadGraphics() {
+	return device->reloadGraphics();
+}
+
+bool StatsRenderDevice::supportsLayers() {
+	return device->supportsLayers();
+}
+
+bool StatsRenderDevice::beginLayer(Image* layer, const Point& origin) {
+	return device->beginLayer(layer, origin);
+}
+
+void StatsRenderDevice::endLayer() {
+	device->endLayer();
+}
+
+Image *StatsRenderDevice::loadImage(const std::string& filename, int error_type) {
+	unsigned create_count = device->getImageCreateCount();
+	Image* image = device->loadImage(filename, error_type);
+	countImagesCreated(create_count);
+	return image;
+}
+
+void StatsRenderDevice::getWindowSize(short unsigned *screen_w, short unsigned *screen_h) {
+	*screen_w = settings->screen_w;
+	*screen_h = settings->screen_h;
+}
+
+void StatsRenderDevice::windowResize() {
+	device->windowResize();
+}
+
+void StatsRenderDevice::pushQueuedImage(const std::string& filename, int error_type) {
+	device->pushQueuedImage(filename, error_type);
+}
+
+void StatsRenderDevice::loadQueuedImages() {
+	unsigned create_count = device->getImageCreateCount();
+	device->loadQueuedImages();
+	countImagesCreated(create_count);
+}
+
+void StatsRenderDevice::cleanupQueuedImages() {
+	device->cleanupQueuedImages();
+}
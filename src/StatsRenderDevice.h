@@ -0,0 +1,121 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#ifndef STATSRENDERDEVICE_H
+#define STATSRENDERDEVICE_H
+
+#include "RenderDevice.h"
+
+#include <fstream>
+
+/** Provide a rendering device that records what is drawn through another one.
+ *
+ * Every call is passed on to the wrapped device, which does the actual
+ * drawing and owns all images. Per frame, the number of render calls, the
+ * pixels they cover, texture switches, blend and color mod changes,
+ * renderToImage() calls and created images are counted for each draw
+ * category (see RenderDevice::setDrawCategory()). Destroyed images are only
+ * counted for the whole frame, since they are released from anywhere.
+ *
+ * The last frame is shown on the dev HUD, and every frame is written as a
+ * row to render_stats.csv in the user data folder.
+ *
+ * @class StatsRenderDevice
+ * @see RenderDevice
+ *
+ */
+
+class StatsRenderDevice : public RenderDevice {
+public:
+
+	explicit StatsRenderDevice(RenderDevice* _device);
+	~StatsRenderDevice();
+
+	virtual int render(Renderable& r, Rect& dest);
+	virtual int render(Sprite* r);
+	virtual int renderToImage(Image* src_image, Rect& src, Image* dest_image, Rect& dest);
+	bool finishComposedImage(Image* image);
+
+	Image* renderTextToImage(FontStyle* font_style, const std::string& text, const Color& color, bool blended);
+	void drawPixel(int x, int y, const Color& color);
+	void drawLine(int x0, int y0, int x1, int y1, const Color& color);
+	void drawRectangle(const Point& p0, const Point& p1, const Color& color);
+	void blankScreen();
+	void commitFrame();
+	void destroyContext();
+	void windowResize();
+	Image *createImage(int width, int height);
+	void setGamma(float g);
+	void resetGamma();
+	void updateTitleBar();
+	void setBackgroundColor(Color color);
+	void setFullscreen(bool enable_fullscreen);
+	unsigned short getRefreshRate();
+	bool reloadGraphics();
+	bool supportsLayers();
+	bool beginLayer(Image* layer, const Point& origin);
+	void endLayer();
+
+	Image* loadImage(const std::string& filename, int error_type);
+
+	void pushQueuedImage(const std::string& filename, int error_type);
+	void loadQueuedImages();
+	void cleanupQueuedImages();
+
+	void getStatsText(std::vector<std::string>& lines);
+
+protected:
+	int createContextInternal();
+	void createContextError();
+
+private:
+	class Counters {
+	public:
+		unsigned render_calls;
+		uint64_t pixels;
+		unsigned texture_switches;
+		unsigned state_changes;
+		unsigned render_to_image_calls;
+		unsigned images_created;
+		Counters();
+	};
+
+	void getWindowSize(short unsigned *screen_w, short unsigned *screen_h);
+
+	uint64_t getVisiblePixels(const Rect& dest);
+	void countDraw(const Image* image, uint64_t pixels, uint8_t blend_mode, const Color& color_mod, uint8_t alpha_mod);
+	void countImagesCreated(unsigned last_create_count);
+	void writeRow();
+
+	RenderDevice* device;
+
+	Counters counters[DRAW_CATEGORY_COUNT];
+	Counters last_counters[DRAW_CATEGORY_COUNT];
+	unsigned last_images_destroyed;
+	unsigned last_destroy_count;
+
+	// the state of the previous draw call, to find texture switches and state changes
+	const Image* last_image;
+	uint8_t last_blend_mode;
+	Color last_color_mod;
+	uint8_t last_alpha_mod;
+
+	unsigned frame;
+	std::ofstream csv_file;
+};
+
+#endif // STATSRENDERDEVICE_H
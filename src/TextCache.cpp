@@ -0,0 +1,170 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "RenderDevice.h"
+#include "TextCache.h"
+
+TextCache::Key::Key(const FontStyle* _font, const std::string& _text, const Color& _color, bool _blended)
+	: font(_font)
+	, text(_text)
+	, color((static_cast<uint32_t>(_color.r) << 24) | (static_cast<uint32_t>(_color.g) << 16) | (static_cast<uint32_t>(_color.b) << 8) | static_cast<uint32_t>(_color.a))
+	, blended(_blended)
+{
+}
+
+bool TextCache::Key::operator<(const Key& other) const {
+	if (font != other.font)
+		return font < other.font;
+	if (color != other.color)
+		return color < other.color;
+	if (blended != other.blended)
+		return blended < other.blended;
+	return text < other.text;
+}
+
+TextCache::Entry::Entry()
+	: image(NULL)
+	, bytes(0)
+	, last_used(0)
+{
+}
+
+TextCache::TextCache()
+	: use_count(0)
+	, budget(0)
+	, memory_used(0)
+	, hit_count(0)
+	, miss_count(0)
+	, evict_count(0)
+	, size_hit_count(0)
+	, size_miss_count(0)
+{
+}
+
+TextCache::~TextCache() {
+	clear();
+}
+
+/**
+ * Drops every image and size and resets the counters
+ */
+void TextCache::clear() {
+	while (!entries.empty()) {
+		erase(entries.begin());
+	}
+	sizes.clear();
+
+	memory_used = 0;
+	use_count = 0;
+	hit_count = miss_count = evict_count = 0;
+	size_hit_count = size_miss_count = 0;
+}
+
+/**
+ * Sets the most memory the text images may take up. A budget of 0 disables the image cache
+ */
+void TextCache::setBudget(size_t bytes) {
+	if (bytes == budget)
+		return;
+
+	budget = bytes;
+	clear();
+}
+
+void TextCache::erase(std::map<Key, Entry>::iterator it) {
+	memory_used -= it->second.bytes;
+	lru.erase(it->second.last_used);
+	it->second.image->unref();
+	entries.erase(it);
+}
+
+/**
+ * Returns the image for a string, or NULL if it needs to be rendered. The cache keeps its reference to the image
+ */
+Image* TextCache::get(const FontStyle* font, const std::string& text, const Color& color, bool blended) {
+	if (budget == 0)
+		return NULL;
+
+	std::map<Key, Entry>::iterator it = entries.find(Key(font, text, color, blended));
+	if (it == entries.end()) {
+		miss_count++;
+		return NULL;
+	}
+
+	lru.erase(it->second.last_used);
+	it->second.last_used = ++use_count;
+	lru[it->second.last_used] = &it->first;
+
+	hit_count++;
+	return it->second.image;
+}
+
+/**
+ * Adds a newly rendered string, dropping the least recently used images if needed.
+ * Returns true if the cache took over the caller's reference to the image, or false if the image is too large to keep
+ */
+bool TextCache::store(const FontStyle* font, const std::string& text, const Color& color, bool blended, Image* image) {
+	const size_t bytes = static_cast<size_t>(image->getWidth() * image->getHeight() * 4);
+	if (bytes > budget)
+		return false;
+
+	while (memory_used + bytes > budget && !lru.empty()) {
+		erase(entries.find(*(lru.begin()->second)));
+		evict_count++;
+	}
+
+	std::pair<std::map<Key, Entry>::iterator, bool> inserted = entries.insert(std::make_pair(Key(font, text, color, blended), Entry()));
+	if (!inserted.second)
+		return false;
+
+	Entry& entry = inserted.first->second;
+	entry.image = image;
+	entry.bytes = bytes;
+	entry.last_used = ++use_count;
+	lru[entry.last_used] = &inserted.first->first;
+	memory_used += bytes;
+
+	return true;
+}
+
+/**
+ * Looks up the measured size of a string. Sizes are only cached while the image cache is enabled
+ */
+bool TextCache::getSize(const FontStyle* font, const std::string& text, Point& size) {
+	if (budget == 0)
+		return false;
+
+	std::map<std::pair<const FontStyle*, std::string>, Point>::iterator it = sizes.find(std::make_pair(font, text));
+	if (it == sizes.end()) {
+		size_miss_count++;
+		return false;
+	}
+
+	size = it->second;
+	size_hit_count++;
+	return true;
+}
+
+void TextCache::storeSize(const FontStyle* font, const std::string& text, const Point& size) {
+	if (budget == 0)
+		return;
+
+	if (sizes.size() >= SIZE_CACHE_MAX)
+		sizes.clear();
+
+	sizes[std::make_pair(font, text)] = size;
+}
@@ -0,0 +1,106 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class TextCache
+ *
+ * Keeps rendered text images, so that strings drawn every frame are only rasterized once.
+ *
+ * Images are keyed by font, text, color and blend mode. Their total size is kept within a memory budget; when a new
+ * image doesn't fit, the images that were used least recently are dropped.
+ *
+ * The measured size of each string is cached as well, keyed by font and text. This cache is simply emptied when it
+ * gets too large, since the same strings are measured over and over while laying out text.
+ */
+
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include "CommonIncludes.h"
+#include "Utils.h"
+
+class FontStyle;
+class Image;
+
+class TextCache {
+private:
+	// the size cache is emptied when it reaches this many strings
+	static const size_t SIZE_CACHE_MAX = 4096;
+
+	class Key {
+	public:
+		const FontStyle* font;
+		std::string text;
+		uint32_t color;
+		bool blended;
+		Key(const FontStyle* _font, const std::string& _text, const Color& _color, bool _blended);
+		bool operator<(const Key& other) const;
+	};
+
+	class Entry {
+	public:
+		Image* image;
+		size_t bytes;
+		unsigned last_used;
+		Entry();
+	};
+
+	void erase(std::map<Key, Entry>::iterator it);
+
+	std::map<Key, Entry> entries;
+
+	// the key of each entry, ordered by when it was last used
+	std::map<unsigned, const Key*> lru;
+	unsigned use_count;
+
+	std::map<std::pair<const FontStyle*, std::string>, Point> sizes;
+
+	size_t budget;
+	size_t memory_used;
+
+	unsigned hit_count;
+	unsigned miss_count;
+	unsigned evict_count;
+	unsigned size_hit_count;
+	unsigned size_miss_count;
+
+public:
+	TextCache();
+	~TextCache();
+
+	void clear();
+	void setBudget(size_t bytes);
+
+	Image* get(const FontStyle* font, const std::string& text, const Color& color, bool blended);
+	bool store(const FontStyle* font, const std::string& text, const Color& color, bool blended, Image* image);
+
+	bool getSize(const FontStyle* font, const std::string& text, Point& size);
+	void storeSize(const FontStyle* font, const std::string& text, const Point& size);
+
+	bool isEnabled() { return budget > 0; }
+
+	// counters since the cache was last cleared
+	unsigned getHitCount() { return hit_count; }
+	unsigned getMissCount() { return miss_count; }
+	unsigned getEvictCount() { return evict_count; }
+	unsigned getSizeHitCount() { return size_hit_count; }
+	unsigned getSizeMissCount() { return size_miss_count; }
+	size_t getImageCount() { return entries.size(); }
+	size_t getMemoryUsed() { return memory_used; }
+};
+
+#endif
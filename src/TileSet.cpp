@@ -189,6 +189,10 @@ void TileSet::logic() {
 	}
 }
 
+bool TileSet::isAnimated(size_t index) const {
+	return index < anim.size() && anim[index].frames > 0;
+}
+
 TileSet::~TileSet() {
 	for (size_t i = 0; i < sprites.size(); ++i) {
 		if (sprites[i])
@@ -76,6 +76,7 @@ public:
 	~TileSet();
 	void load(const std::string& filename);
 	void logic();
+	bool isAnimated(size_t index) const;
 
 	std::vector<Tile_Def> tiles;
 
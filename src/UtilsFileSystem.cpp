@@ -116,6 +116,34 @@ int Filesystem::getDirList(const std::string &dir, std::vector<std::string> &dir
 	return 0;
 }
 
+/**
+ * Returns the names of the files and the directories in a given directory, in a single pass over the directory
+ */
+int Filesystem::getDirContents(const std::string &dir, std::vector<std::string> &files, std::vector<std::string> &dirs) {
+	DIR *dp;
+	struct dirent *dirp;
+	struct stat st;
+
+	if((dp = opendir(convertSlashes(dir).c_str())) == NULL)
+		return errno;
+
+	while ((dirp = readdir(dp)) != NULL) {
+		std::string name = std::string(dirp->d_name);
+		if (name == "." || name == "..")
+			continue;
+
+		if (stat(convertSlashes(dir + "/" + name).c_str(), &st) == -1)
+			continue;
+
+		if (S_ISDIR(st.st_mode))
+			dirs.push_back(name);
+		else
+			files.push_back(name);
+	}
+	closedir(dp);
+	return 0;
+}
+
 bool Filesystem::isDirectory(const std::string &path, bool show_error) {
 	std::string clean_path = convertSlashes(path);
 	struct stat st;
@@ -229,3 +257,47 @@ std::string Filesystem::getFullPath(const std::string &path) {
 	free(full_path);
 	return ret;
 }
+
+/**
+ * Reads the entire contents of a file into a buffer with a single read
+ * Returns false if the file couldn't be opened or read
+ */
+bool Filesystem::readFile(const std::string &filename, std::string &buffer) {
+	buffer.clear();
+
+	std::ifstream infile(convertSlashes(filename).c_str(), std::ios::in | std::ios::binary);
+	if (!infile.is_open())
+		return false;
+
+	infile.seekg(0, std::ios::end);
+	std::streamoff size = infile.tellg();
+	if (size < 0)
+		return false;
+
+	infile.seekg(0, std::ios::beg);
+	buffer.resize(static_cast<size_t>(size));
+	if (size > 0)
+		infile.read(&buffer[0], size);
+
+	bool ret = !infile.fail();
+	infile.close();
+
+	if (!ret)
+		buffer.clear();
+
+	return ret;
+}
+
+/**
+ * Gets the size and last modification time of a file
+ * Returns false if the file doesn't exist
+ */
+bool Filesystem::getFileInfo(const std::string &filename, uint64_t &size, int64_t &mtime) {
+	struct stat st;
+	if (stat(convertSlashes(filename).c_str(), &st) != 0)
+		return false;
+
+	size = static_cast<uint64_t>(st.st_size);
+	mtime = static_cast<int64_t>(st.st_mtime);
+	return true;
+}
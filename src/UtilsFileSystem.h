@@ -25,6 +25,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #ifndef UTILS_FILE_SYSTEM_H
 #define UTILS_FILE_SYSTEM_H
 
+#include <stdint.h>
 #include <string>
 
 namespace Filesystem {
@@ -35,6 +36,7 @@ namespace Filesystem {
 	bool fileExists(const std::string &filename);
 	int getFileList(const std::string &dir, const std::string &ext, std::vector<std::string> &files);
 	int getDirList(const std::string &dir, std::vector<std::string> &dirs);
+	int getDirContents(const std::string &dir, std::vector<std::string> &files, std::vector<std::string> &dirs);
 
 	bool isDirectory(const std::string &path, bool show_error = true);
 
@@ -49,6 +51,9 @@ namespace Filesystem {
 	std::string removeTrailingSlash(const std::string& path);
 
 	std::string getFullPath(const std::string &path);
+
+	bool readFile(const std::string &filename, std::string &buffer);
+	bool getFileInfo(const std::string &filename, uint64_t &size, int64_t &mtime);
 }
 
 
@@ -26,6 +26,8 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "UtilsParsing.h"
 #include "WidgetLabel.h"
 
+#include <cctype>
+#include <climits>
 #include <cstdlib>
 #include <math.h>
 #include <typeinfo>
@@ -65,7 +67,7 @@ std::string Parse::stripCarriageReturn(const std::string& line) {
 	return line;
 }
 
-std::string Parse::getLine(std::ifstream &infile) {
+std::string Parse::getLine(std::istream &infile) {
 	std::string line;
 	// This is the standard way to check whether a read failed.
 	if (!getline(infile, line))
@@ -373,6 +375,53 @@ int Parse::popFirstInt(std::string &s, char separator) {
 	return Parse::toInt(popFirstString(s, separator));
 }
 
+/**
+ * Reads the int at index pos of s, then moves pos past the next separator (or to the end of s).
+ * The result is the same as popFirstInt() on the rest of the string, but s is not copied, so reading a whole list is linear
+ */
+int Parse::nextInt(const std::string &s, size_t &pos, char separator) {
+	const size_t len = s.length();
+	size_t i = pos;
+
+	// same as reading from a stream: leading whitespace, an optional sign, then digits
+	while (i < len && isspace(static_cast<unsigned char>(s[i])))
+		++i;
+
+	bool negative = false;
+	if (i < len && (s[i] == '-' || s[i] == '+')) {
+		negative = (s[i] == '-');
+		++i;
+	}
+
+	int64_t value = 0;
+	bool has_digits = false;
+	bool overflow = false;
+	while (i < len && s[i] >= '0' && s[i] <= '9') {
+		if (!overflow) {
+			value = value * 10 + (s[i] - '0');
+			overflow = (value > static_cast<int64_t>(INT_MAX) + 1);
+		}
+		has_digits = true;
+		++i;
+	}
+
+	// skip anything else before the separator
+	while (i < len) {
+		const char c = s[i++];
+		if ((separator == 0 && (c == ',' || c == ';')) || (separator != 0 && c == separator))
+			break;
+	}
+	pos = i;
+
+	if (negative)
+		value = -value;
+
+	if (!has_digits || overflow || value > INT_MAX || value < INT_MIN)
+		return 0;
+
+	return static_cast<int>(value);
+}
+
 float Parse::popFirstFloat(std::string &s, char separator) {
 	return Parse::toFloat(popFirstString(s, separator));
 }
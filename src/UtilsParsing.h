@@ -34,7 +34,7 @@ namespace Parse {
 	std::string getSectionTitle(const std::string& s);
 	void getKeyPair(const std::string& s, std::string& key, std::string& val);
 	std::string stripCarriageReturn(const std::string& line);
-	std::string getLine(std::ifstream& infile);
+	std::string getLine(std::istream& infile);
 	bool tryParseValue(const std::type_info & type, const std::string & value, void * output);
 
 	std::string toString(const std::type_info & type, void * value);
@@ -57,6 +57,7 @@ namespace Parse {
 
 	std::string popFirstString(std::string& s, char separator = 0);
 	int popFirstInt(std::string& s, char separator = 0);
+	int nextInt(const std::string& s, size_t& pos, char separator = 0);
 	float popFirstFloat(std::string& s, char separator = 0);
 	LabelInfo popLabelInfo(std::string val);
 
@@ -27,6 +27,7 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include "FontEngine.h"
 #include "InputState.h"
 #include "RenderDevice.h"
+#include "Settings.h"
 #include "SharedResources.h"
 #include "WidgetLabel.h"
 
@@ -212,6 +213,14 @@ void WidgetLabel::applyOffsets() {
 	}
 }
 
+/**
+ * Labels can be drawn straight from the font's glyph atlas, so that they all share one texture
+ * Labels that are faded or clipped to a local frame still need their own image
+ */
+bool WidgetLabel::useGlyphAtlas() {
+	return settings->text_glyph_atlas && alpha == 255 && local_frame.w == 0 && local_frame.h == 0 && local_offset.x == 0 && local_offset.y == 0;
+}
+
 /**
  * We buffer the rendered text instead of calculating it each frame
  * This function refreshes the buffer.
@@ -223,6 +232,7 @@ void WidgetLabel::recacheTextSprite() {
 		delete label;
 		label = NULL;
 	}
+	label_text.clear();
 
 	if (text.empty()) {
 		bounds.w = 0;
@@ -243,6 +253,11 @@ void WidgetLabel::recacheTextSprite() {
 	bounds.w = p.x;
 	bounds.h = std::max(p.y, font->getFontHeight());
 
+	if (useGlyphAtlas()) {
+		label_text = temp_text;
+		return;
+	}
+
 	image = render_device->createImage(bounds.w, bounds.h);
 	if (!image) return;
 
@@ -287,12 +302,24 @@ void WidgetLabel::render() {
 	if (hidden)
 		return;
 
+	// e.g. the label was faded or put in a scroll box after its text was set
+	if (!label_text.empty() && !useGlyphAtlas())
+		setUpdateFlag(UPDATE_RECACHE);
+
 	update();
 
 	if (label) {
 		label->local_frame = local_frame;
 		label->setOffset(local_offset);
+
+		int draw_category = render_device->getDrawCategory();
+		render_device->setDrawCategory(RenderDevice::DRAW_TEXT);
 		render_device->render(label);
+		render_device->setDrawCategory(draw_category);
+	}
+	else if (!label_text.empty()) {
+		font->setFont(font_style);
+		font->renderShadowed(label_text, bounds.x, bounds.y, FontEngine::JUSTIFY_LEFT, NULL, 0, color);
 	}
 
 	// reset flag
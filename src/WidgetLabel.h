@@ -57,6 +57,7 @@ private:
 	};
 
 	void recacheTextSprite();
+	bool useGlyphAtlas();
 	void applyOffsets();
 	void setUpdateFlag(int _update_flag);
 	void update();
@@ -71,6 +72,7 @@ private:
 	Sprite *label;
 
 	std::string text;
+	std::string label_text; // the text drawn from the glyph atlas, when there is no label sprite
 	std::string font_style;
 	Color color;
 
@@ -326,6 +326,34 @@ void WidgetSlot::render() {
 	}
 }
 
+/**
+ * Adds every value that changes what render() draws, for menus that keep their drawing in a layer
+ */
+void WidgetSlot::getRenderState(std::vector<unsigned long>& state) {
+	state.push_back(visible);
+	if (!visible)
+		return;
+
+	state.push_back(static_cast<unsigned long>(pos.x));
+	state.push_back(static_cast<unsigned long>(pos.y));
+	state.push_back(static_cast<unsigned long>(icon_id));
+	state.push_back(static_cast<unsigned long>(overlay_id));
+	state.push_back(static_cast<unsigned long>(amount));
+	state.push_back(static_cast<unsigned long>(max_amount));
+	state.push_back(static_cast<unsigned long>(hotkey));
+	state.push_back(highlight && (slot_highlight || (show_colorblind_highlight && settings->colorblind)));
+	state.push_back(in_focus && slot_selected);
+
+	// the cooldown wipe only changes when it moves by a whole pixel
+	int disabled_h = -1;
+	if (show_disabled_overlay && (!enabled || cooldown < 1)) {
+		disabled_h = eset->resolutions.icon_size;
+		if (cooldown > 0)
+			disabled_h = static_cast<int>(static_cast<float>(eset->resolutions.icon_size) * cooldown);
+	}
+	state.push_back(static_cast<unsigned long>(disabled_h));
+}
+
 WidgetSlot::~WidgetSlot() {
 	delete slot_selected;
 	delete slot_highlight;
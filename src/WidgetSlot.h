@@ -81,6 +81,7 @@ public:
 	void setAmount(int _amount, int _max_amount);
 	void setHotkey(int key);
 	void render();
+	void getRenderState(std::vector<unsigned long>& state);
 
 	bool enabled;
 	bool continuous;	// allow holding key to keep slot activated
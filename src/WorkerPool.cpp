@@ -0,0 +1,177 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+#include "Utils.h"
+#include "WorkerPool.h"
+
+WorkerPool::Worker::Worker()
+	: pool(NULL)
+	, thread(NULL)
+	, index(0)
+{
+}
+
+WorkerPool::WorkerPool()
+	: thread_count(1)
+	, mutex(NULL)
+	, job_ready(NULL)
+	, job_done(NULL)
+	, job_id(0)
+	, jobs_pending(0)
+	, quit(false)
+	, job_function(NULL)
+	, job_data(NULL)
+	, job_count(0)
+{
+}
+
+WorkerPool::~WorkerPool() {
+	stop();
+}
+
+/**
+ * Starts the worker threads. The calling thread counts as one of them
+ * A thread count of 0 uses one thread per CPU core
+ */
+void WorkerPool::init(int _thread_count) {
+	stop();
+
+	thread_count = (_thread_count > 0) ? _thread_count : SDL_GetCPUCount();
+	if (thread_count < 1)
+		thread_count = 1;
+
+	if (thread_count == 1)
+		return;
+
+	mutex = SDL_CreateMutex();
+	job_ready = SDL_CreateCond();
+	job_done = SDL_CreateCond();
+
+	// workers are passed to their threads by pointer, so the list must not be resized once they are running
+	workers.resize(thread_count - 1);
+	for (size_t i = 0; i < workers.size(); ++i) {
+		workers[i].pool = this;
+		workers[i].index = static_cast<int>(i);
+		workers[i].thread = SDL_CreateThread(workerMain, "WorkerPool", &workers[i]);
+
+		if (!workers[i].thread) {
+			Utils::logError("WorkerPool: Unable to create thread: %s", SDL_GetError());
+			workers.resize(i);
+			break;
+		}
+	}
+
+	thread_count = static_cast<int>(workers.size()) + 1;
+}
+
+void WorkerPool::stop() {
+	if (mutex) {
+		SDL_LockMutex(mutex);
+		quit = true;
+		SDL_CondBroadcast(job_ready);
+		SDL_UnlockMutex(mutex);
+
+		for (size_t i = 0; i < workers.size(); ++i) {
+			SDL_WaitThread(workers[i].thread, NULL);
+		}
+
+		SDL_DestroyCond(job_done);
+		SDL_DestroyCond(job_ready);
+		SDL_DestroyMutex(mutex);
+		job_done = NULL;
+		job_ready = NULL;
+		mutex = NULL;
+	}
+
+	workers.clear();
+	thread_count = 1;
+	job_id = 0;
+	jobs_pending = 0;
+	quit = false;
+}
+
+void WorkerPool::getSlice(int index, size_t& begin, size_t& end) {
+	const size_t slices = static_cast<size_t>(thread_count);
+	begin = job_count * static_cast<size_t>(index) / slices;
+	end = job_count * static_cast<size_t>(index + 1) / slices;
+}
+
+int WorkerPool::workerMain(void* data) {
+	Worker* worker = static_cast<Worker*>(data);
+	WorkerPool* pool = worker->pool;
+	unsigned last_job_id = 0;
+
+	SDL_LockMutex(pool->mutex);
+	while (true) {
+		while (!pool->quit && pool->job_id == last_job_id) {
+			SDL_CondWait(pool->job_ready, pool->mutex);
+		}
+
+		if (pool->quit)
+			break;
+
+		last_job_id = pool->job_id;
+		SDL_UnlockMutex(pool->mutex);
+
+		size_t begin, end;
+		pool->getSlice(worker->index, begin, end);
+		if (begin < end)
+			pool->job_function(pool->job_data, begin, end);
+
+		SDL_LockMutex(pool->mutex);
+		pool->jobs_pending--;
+		if (pool->jobs_pending == 0)
+			SDL_CondSignal(pool->job_done);
+	}
+	SDL_UnlockMutex(pool->mutex);
+
+	return 0;
+}
+
+/**
+ * Calls function for every item in [0, count), split between the threads. Returns when all items are done
+ */
+void WorkerPool::run(JobFunction function, void* data, size_t count) {
+	if (count == 0)
+		return;
+
+	if (workers.empty()) {
+		function(data, 0, count);
+		return;
+	}
+
+	SDL_LockMutex(mutex);
+	job_function = function;
+	job_data = data;
+	job_count = count;
+	jobs_pending = static_cast<int>(workers.size());
+	job_id++;
+	SDL_CondBroadcast(job_ready);
+	SDL_UnlockMutex(mutex);
+
+	// the calling thread takes the last slice
+	size_t begin, end;
+	getSlice(thread_count - 1, begin, end);
+	if (begin < end)
+		function(data, begin, end);
+
+	SDL_LockMutex(mutex);
+	while (jobs_pending > 0) {
+		SDL_CondWait(job_done, mutex);
+	}
+	SDL_UnlockMutex(mutex);
+}
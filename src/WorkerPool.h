@@ -0,0 +1,75 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+/**
+ * class WorkerPool
+ *
+ * A fixed set of threads that split a range of items between them.
+ *
+ * run() divides the range [0, count) into one contiguous slice per thread. The calling thread takes a slice as well,
+ * and run() returns once every slice is done. The job function must only write to data belonging to the items in its
+ * slice, so the result does not depend on how the range was divided.
+ *
+ * With a thread count of 1, no threads are started and run() calls the job function directly.
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "CommonIncludes.h"
+
+class WorkerPool {
+public:
+	typedef void (*JobFunction)(void* data, size_t begin, size_t end);
+
+	WorkerPool();
+	~WorkerPool();
+
+	void init(int _thread_count);
+	void run(JobFunction function, void* data, size_t count);
+
+	int getThreadCount() { return thread_count; }
+
+private:
+	class Worker {
+	public:
+		WorkerPool* pool;
+		SDL_Thread* thread;
+		int index;
+		Worker();
+	};
+
+	static int workerMain(void* data);
+	void stop();
+	void getSlice(int index, size_t& begin, size_t& end);
+
+	int thread_count;
+	std::vector<Worker> workers;
+
+	SDL_mutex* mutex;
+	SDL_cond* job_ready;
+	SDL_cond* job_done;
+	unsigned job_id;
+	int jobs_pending;
+	bool quit;
+
+	JobFunction job_function;
+	void* job_data;
+	size_t job_count;
+};
+
+#endif
@@ -26,17 +26,22 @@ FLARE.  If not, see http://www.gnu.org/licenses/
 #include <limits.h>
 
 #include "AnimationManager.h"
+#include "Avatar.h"
 #include "CombatText.h"
 #include "DeviceList.h"
 #include "EngineSettings.h"
+#include "EntityManager.h"
+#include "GameStatePlay.h"
 #include "GameSwitcher.h"
 #include "InputState.h"
+#include "MapRenderer.h"
 #include "MessageEngine.h"
 #include "ModManager.h"
 #include "RenderDevice.h"
 #include "SaveLoad.h"
 #include "SDLFontEngine.h"
 #include "Settings.h"
+#include "SharedGameResources.h"
 #include "SharedResources.h"
 #include "SoundManager.h"
 #include "Stats.h"
@@ -52,6 +57,23 @@ class CmdLineArgs {
 public:
 	std::string render_device_name;
 	std::vector<std::string> mod_list;
+
+	// headless mode
+	std::string headless_map;
+	std::string headless_spawn;
+	int headless_spawn_count;
+	int headless_frames;
+	unsigned int headless_seed;
+
+	CmdLineArgs()
+		: render_device_name("")
+		, mod_list()
+		, headless_map("")
+		, headless_spawn("")
+		, headless_spawn_count(0)
+		, headless_frames(600)
+		, headless_seed(1)
+	{}
 };
 
 #define PLATFORM_CPP_INCLUDE
@@ -101,7 +123,12 @@ static void init(const CmdLineArgs& cmd_line_args) {
 	Utils::logInfo("main: PATH_DATA = '%s'", settings->path_data.c_str());
 
 	// SDL Inits
-	if ( SDL_Init (SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_GAMECONTROLLER) < 0 ) {
+	// headless mode has no window or audio device, so only the timer and the event queue are needed
+	Uint32 sdl_flags = SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_GAMECONTROLLER;
+	if (settings->headless)
+		sdl_flags = SDL_INIT_TIMER | SDL_INIT_EVENTS;
+
+	if ( SDL_Init (sdl_flags) < 0 ) {
 		Utils::logError("main: Could not initialize SDL: %s", SDL_GetError());
 		Utils::logErrorDialog("main: Could not initialize SDL: %s", SDL_GetError());
 		Utils::Exit(1);
@@ -178,16 +205,33 @@ static float getSecondsElapsed(uint64_t prev_ticks, uint64_t now_ticks) {
 	return (static_cast<float>(now_ticks - prev_ticks) / static_cast<float>(SDL_GetPerformanceFrequency()));
 }
 
+/**
+ * With render_interpolation, logic still runs at max_frames_per_sec, but frames are drawn as often as the display
+ * refreshes. Each frame is drawn part of the way between the last two logic frames
+ */
 static void mainLoop () {
 	bool done = false;
 
 	float seconds_per_frame = 1.f/static_cast<float>(settings->max_frames_per_sec);
 
+	// time between drawn frames
+	float seconds_per_render = seconds_per_frame;
+	if (settings->render_interpolation) {
+		unsigned short refresh_rate = render_device->getRefreshRate();
+		if (refresh_rate > 0)
+			seconds_per_render = 1.f/static_cast<float>(refresh_rate);
+	}
+
 	uint64_t prev_ticks = SDL_GetPerformanceCounter();
 	uint64_t logic_ticks = SDL_GetPerformanceCounter();
 
 	float last_fps = -1;
 
+	// logic frames per second, counted over one second
+	float last_tps = -1;
+	int tick_count = 0;
+	uint64_t tick_count_start = SDL_GetPerformanceCounter();
+
 	while ( !done ) {
 		int loops = 0;
 		uint64_t now_ticks = SDL_GetPerformanceCounter();
@@ -212,6 +256,7 @@ static void mainLoop () {
 
 			gswitch->logic();
 			inpt->resetScroll();
+			tick_count++;
 
 			// Engine done means the user escapes the main game menu.
 			// Input done means the user closes the window.
@@ -236,13 +281,28 @@ static void mainLoop () {
 			}
 		}
 
+		float seconds_counted = getSecondsElapsed(tick_count_start, SDL_GetPerformanceCounter());
+		if (seconds_counted >= 1) {
+			last_tps = static_cast<float>(tick_count) / seconds_counted;
+			tick_count = 0;
+			tick_count_start = SDL_GetPerformanceCounter();
+		}
+
+		// logic_ticks is when the next logic frame is due, so the last one was due one frame earlier
+		float render_alpha = 1;
+		if (settings->render_interpolation && !gswitch->isPaused()) {
+			uint64_t render_ticks = SDL_GetPerformanceCounter();
+			if (render_ticks < logic_ticks)
+				render_alpha = std::max(1.f - getSecondsElapsed(render_ticks, logic_ticks) / seconds_per_frame, 0.f);
+		}
+
 		if (!inpt->window_minimized) {
 			render_device->blankScreen();
-			gswitch->render();
+			gswitch->render(render_alpha);
 
 			// display the FPS counter
 			if (last_fps != -1) {
-				gswitch->showFPS(last_fps);
+				gswitch->showFPS(last_fps, last_tps, render_alpha);
 			}
 
 			render_device->commitFrame();
@@ -250,8 +310,8 @@ static void mainLoop () {
 			// calculate the FPS
 			// if the frame completed quickly, we estimate the delay here
 			float fps_delay;
-			if (getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter()) < seconds_per_frame) {
-				fps_delay = seconds_per_frame;
+			if (getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter()) < seconds_per_render) {
+				fps_delay = seconds_per_render;
 			} else {
 				fps_delay = getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter());
 			}
@@ -264,12 +324,12 @@ static void mainLoop () {
 
 		// delay quick frames
 		// thanks to David Gow: https://davidgow.net/handmadepenguin/ch18.html
-		if (getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter()) < seconds_per_frame) {
-			int32_t delay_ms = static_cast<int32_t>((seconds_per_frame - getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter())) * 1000.f);
+		if (getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter()) < seconds_per_render) {
+			int32_t delay_ms = static_cast<int32_t>((seconds_per_render - getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter())) * 1000.f);
 			if (delay_ms > 0) {
 				SDL_Delay(delay_ms);
 			}
-			while (getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter()) < seconds_per_frame) {
+			while (getSecondsElapsed(prev_ticks, SDL_GetPerformanceCounter()) < seconds_per_render) {
 				// Waiting...
 			}
 		}
@@ -277,6 +337,156 @@ static void mainLoop () {
 	}
 }
 
+/**
+ * One frame of the main loop for headless mode, without the frame limiter
+ * The time spent in logic and in rendering is added to logic_ticks and render_ticks
+ * Returns false if logic was skipped because this is a loading frame
+ */
+static bool headlessFrame(uint64_t& logic_ticks, uint64_t& render_ticks) {
+	uint64_t start_ticks = SDL_GetPerformanceCounter();
+
+	bool is_logic_frame = !gswitch->isLoadingFrame();
+	if (is_logic_frame) {
+		inpt->handle();
+		gswitch->logic();
+		inpt->resetScroll();
+	}
+
+	uint64_t logic_end_ticks = SDL_GetPerformanceCounter();
+	logic_ticks += logic_end_ticks - start_ticks;
+
+	render_device->blankScreen();
+	gswitch->render(1);
+	render_device->commitFrame();
+
+	render_ticks += SDL_GetPerformanceCounter() - logic_end_ticks;
+
+	return is_logic_frame;
+}
+
+static void headlessSetKey(int key, bool press) {
+	inpt->pressing[key] = press;
+
+	// releasing a key also releases its lock, like a key-up event would
+	if (!press)
+		inpt->lock[key] = false;
+}
+
+/**
+ * Scripted input for headless mode, which only depends on the frame number
+ * The hero walks in each of the 8 directions in turn for one second, and uses the main attack every other second,
+ * aiming in the direction of travel
+ */
+static void headlessInput(int frame) {
+	static const int DIRECTIONS[8][2] = {
+		{0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}
+	};
+
+	int second = frame / std::max(static_cast<int>(settings->max_frames_per_sec), 1);
+	const int* dir = DIRECTIONS[second % 8];
+
+	headlessSetKey(Input::UP, dir[1] < 0);
+	headlessSetKey(Input::DOWN, dir[1] > 0);
+	headlessSetKey(Input::LEFT, dir[0] < 0);
+	headlessSetKey(Input::RIGHT, dir[0] > 0);
+	headlessSetKey(Input::MAIN1, second % 2 == 1);
+
+	inpt->mouse.x = settings->view_w_half + dir[0] * eset->tileset.tile_w;
+	inpt->mouse.y = settings->view_h_half + dir[1] * eset->tileset.tile_h;
+}
+
+/**
+ * Runs game logic as fast as possible, without a window or audio, then prints the time spent in each subsystem
+ * The hero comes from the save slot given with --load-slot. The map, the spawned enemies, the random seed and the
+ * input are all set from the command line, so that two runs with the same arguments do the same work.
+ * Returns false if the game could not be started
+ */
+static bool headlessLoop(const CmdLineArgs& cmd_line_args) {
+	const int BOOT_FRAME_LIMIT = 100 * settings->max_frames_per_sec;
+	const int SPAWN_RANGE = 10; // in tiles
+
+	uint64_t logic_ticks = 0;
+	uint64_t render_ticks = 0;
+
+	// the hero is moved with the scripted keyboard input
+	settings->mouse_move = false;
+
+	// the hero only exists once a saved game has been loaded
+	for (int i = 0; !pc; ++i) {
+		if (i >= BOOT_FRAME_LIMIT || gswitch->done || inpt->done) {
+			Utils::logError("main: Headless mode could not load a game. Use --load-slot to choose a save slot.");
+			return false;
+		}
+		headlessFrame(logic_ticks, render_ticks);
+	}
+
+	if (!cmd_line_args.headless_map.empty()) {
+		if (!mods->fileExists(cmd_line_args.headless_map)) {
+			Utils::logError("main: Headless mode could not find map '%s'.", cmd_line_args.headless_map.c_str());
+			return false;
+		}
+
+		// replaces the map from the save file. The hero starts at the map's default spawn position
+		mapr->teleportation = true;
+		mapr->teleport_mapname = cmd_line_args.headless_map;
+		mapr->teleport_destination = FPoint(-1, -1);
+	}
+
+	// let the game state and the map finish loading
+	for (int i = 0; i < settings->max_frames_per_sec; ++i) {
+		headlessFrame(logic_ticks, render_ticks);
+	}
+
+	if (!cmd_line_args.headless_spawn.empty()) {
+		for (int i = 0; i < cmd_line_args.headless_spawn_count; ++i) {
+			FPoint spawn_pos = mapr->collider.getRandomNeighbor(Point(pc->stats.pos), SPAWN_RANGE, MapCollision::MOVE_NORMAL, MapCollision::COLLIDE_TYPE_ALL_ENTITIES);
+			entitym->spawn(cmd_line_args.headless_spawn, Point(spawn_pos), NULL);
+		}
+	}
+
+	GameStatePlay::resetTimings();
+	logic_ticks = 0;
+	render_ticks = 0;
+
+	int logic_frames = 0;
+	for (int frame = 0; frame < cmd_line_args.headless_frames; ++frame) {
+		if (gswitch->done || inpt->done)
+			break;
+
+		headlessInput(frame);
+		if (headlessFrame(logic_ticks, render_ticks))
+			logic_frames++;
+	}
+
+	// same order as the GameStatePlay::TIMING_* values
+	const char* timing_names[GameStatePlay::TIMING_COUNT] = {
+		"pc", "entitym", "hazards", "loot", "npcs", "mapr", "menu", "flowfields"
+	};
+
+	const float ticks_per_ms = static_cast<float>(SDL_GetPerformanceFrequency()) / 1000.f;
+	const float frame_count = static_cast<float>(std::max(logic_frames, 1));
+	const float logic_ms = static_cast<float>(logic_ticks) / ticks_per_ms;
+
+	Utils::logInfo("main: Headless run on '%s': %d logic frames, %d entities, seed %u", mapr->getFilename().c_str(), logic_frames, static_cast<int>(entitym->entities.size()), cmd_line_args.headless_seed);
+	Utils::logInfo("main: %-10s %12s %12s %8s", "subsystem", "total (ms)", "frame (ms)", "logic");
+
+	uint64_t timed_ticks = 0;
+	for (int i = 0; i < GameStatePlay::TIMING_COUNT; ++i) {
+		float ms = static_cast<float>(GameStatePlay::timings[i]) / ticks_per_ms;
+		float percent = (logic_ms > 0) ? ms * 100.f / logic_ms : 0;
+		Utils::logInfo("main: %-10s %12.3f %12.4f %7.1f%%", timing_names[i], ms, ms / frame_count, percent);
+		timed_ticks += GameStatePlay::timings[i];
+	}
+
+	float other_ms = static_cast<float>(logic_ticks - std::min(timed_ticks, logic_ticks)) / ticks_per_ms;
+	float render_ms = static_cast<float>(render_ticks) / ticks_per_ms;
+	Utils::logInfo("main: %-10s %12.3f %12.4f %7.1f%%", "other", other_ms, other_ms / frame_count, (logic_ms > 0) ? other_ms * 100.f / logic_ms : 0);
+	Utils::logInfo("main: %-10s %12.3f %12.4f", "logic", logic_ms, logic_ms / frame_count);
+	Utils::logInfo("main: %-10s %12.3f %12.4f", "render", render_ms, render_ms / frame_count);
+
+	return true;
+}
+
 static void cleanup() {
 	Utils::lockFileWrite(-1);
 
@@ -285,10 +495,11 @@ static void cleanup() {
 	delete anim;
 	delete comb;
 	delete font;
+	font = NULL; // the render device clears the text cache when its context is destroyed
 	delete inpt;
-	delete mods;
 	delete msg;
 	delete snd;
+	delete mods; // after anything that can still be reading from a mod archive
 	delete save_load;
 	delete eset;
 
@@ -346,7 +557,7 @@ void EmscriptenMainLoop() {
 	inpt->resetScroll();
 
 	render_device->blankScreen();
-	gswitch->render();
+	gswitch->render(1);
 	render_device->commitFrame();
 }
 #endif
@@ -356,6 +567,7 @@ int main(int argc, char *argv[]) {
 
 	bool debug_event = false;
 	bool done = false;
+	int exit_status = 0;
 	CmdLineArgs cmd_line_args;
 
 	for (int i = 1 ; i < argc; i++) {
@@ -401,6 +613,30 @@ int main(int argc, char *argv[]) {
 		else if (arg == "safe-video") {
 			settings->safe_video = true;
 		}
+		else if (arg == "rebuild-cache") {
+			settings->rebuild_cache = true;
+		}
+		else if (arg == "cache-mod-index") {
+			settings->cache_mod_index = true;
+		}
+		else if (arg == "headless") {
+			settings->headless = true;
+			settings->audio = false;
+		}
+		else if (arg == "headless-map") {
+			cmd_line_args.headless_map = parseArgValue(arg_full);
+		}
+		else if (arg == "headless-spawn") {
+			std::string spawn_str = parseArgValue(arg_full);
+			cmd_line_args.headless_spawn = Parse::popFirstString(spawn_str);
+			cmd_line_args.headless_spawn_count = spawn_str.empty() ? 1 : Parse::toInt(spawn_str);
+		}
+		else if (arg == "headless-frames") {
+			cmd_line_args.headless_frames = Parse::toInt(parseArgValue(arg_full));
+		}
+		else if (arg == "headless-seed") {
+			cmd_line_args.headless_seed = static_cast<unsigned int>(Parse::toInt(parseArgValue(arg_full)));
+		}
 		else if (arg == "help") {
 			Utils::logInfo("Command line options:\n\
 --help                   Prints this message.\n\
@@ -412,12 +648,23 @@ int main(int argc, char *argv[]) {
 --debug-event            Prints verbose hardware input information.\n\
 --renderer=<RENDERER>    Specifies the rendering backend to use.\n\
                          The default is 'sdl'.\n\
+                         'stats,<RENDERER>' records draw statistics while using RENDERER,\n\
+                         which may also be 'null' to draw nothing.\n\
 --no-audio               Disables sound effects and music.\n\
 --mods=<MOD>,...         Starts the game with only these mods enabled.\n\
 --load-slot=<SLOT>       Loads a save slot by numerical index.\n\
 --load-script=<SCRIPT>   Execute's a script upon loading a saved game.\n\
                          The script path is mod-relative.\n\
---safe-video             Launches with the minimum video settings.");
+--safe-video             Launches with the minimum video settings.\n\
+--rebuild-cache          Parses all cached mod data files again and rewrites the cache.\n\
+--cache-mod-index        Saves the index of mod files, and reuses it while the mod directories are unchanged.\n\
+--headless               Runs a logic benchmark without a window or audio, then exits.\n\
+                         Requires --load-slot. Save files are not written.\n\
+--headless-map=<MAP>     Headless mode: moves the hero to this map after loading.\n\
+--headless-spawn=<CATEGORY>,<COUNT>\n\
+                         Headless mode: spawns enemies of this category near the hero.\n\
+--headless-frames=<N>    Headless mode: the number of logic frames to run. The default is 600.\n\
+--headless-seed=<N>      Headless mode: the random seed. The default is 1.");
 			done = true;
 		}
 		else {
@@ -427,7 +674,10 @@ int main(int argc, char *argv[]) {
 
 soft_reset:
 	if (!done) {
-		srand(static_cast<unsigned int>(time(NULL)));
+		if (settings->headless)
+			srand(cmd_line_args.headless_seed);
+		else
+			srand(static_cast<unsigned int>(time(NULL)));
 #ifdef __EMSCRIPTEN__
 		platform.FSInit();
 		emscripten_set_main_loop(EmscriptenMainLoop, settings->max_frames_per_sec, 1);
@@ -437,10 +687,17 @@ soft_reset:
 		if (debug_event)
 			inpt->enableEventLog();
 
-		mainLoop();
+		if (settings->headless) {
+			if (!headlessLoop(cmd_line_args))
+				exit_status = 1;
+		}
+		else {
+			mainLoop();
+		}
 #endif
 
-		if (gswitch)
+		// headless mode changes some settings for the run, which shouldn't be kept
+		if (gswitch && !settings->headless)
 			gswitch->saveUserSettings();
 
 		cleanup();
@@ -456,5 +713,5 @@ soft_reset:
 
 	delete settings;
 
-	return 0;
+	return exit_status;
 }
@@ -0,0 +1,265 @@
+/*
+Copyright © 2026 FLARE contributors
+
+This file is part of FLARE.
+
+FLARE is free software: you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+FLARE is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+FLARE.  If not, see http://www.gnu.org/licenses/
+*/
+
+
+/**
+ * flarepak
+ *
+ * Packs a mod directory into a .flarepak archive, or lists the contents of one.
+ * See src/PackArchive.h for the format.
+ *
+ * This is built on its own, without SDL or the rest of the engine:
+ *   cmake --build . --target flarepak
+ */
+
+#include <algorithm>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+
+namespace {
+
+const char MAGIC[] = "FLAREPAK";
+const size_t MAGIC_LENGTH = 8;
+const size_t HEADER_SIZE = 24;
+const uint32_t VERSION = 1;
+const uint32_t METHOD_STORE = 0;
+
+class Entry {
+public:
+	Entry()
+		: offset(0)
+		, size(0)
+	{}
+
+	std::string path;
+	uint64_t offset;
+	uint64_t size;
+};
+
+void writeLE(std::string& out, uint64_t value, size_t bytes) {
+	for (size_t i = 0; i < bytes; ++i) {
+		out += static_cast<char>((value >> (i * 8)) & 0xff);
+	}
+}
+
+uint64_t readLE(const unsigned char* in, size_t bytes) {
+	uint64_t value = 0;
+	for (size_t i = 0; i < bytes; ++i) {
+		value |= static_cast<uint64_t>(in[i]) << (i * 8);
+	}
+	return value;
+}
+
+/**
+ * Recursively collects the files in a directory, as paths relative to the mod directory
+ */
+bool collectFiles(const std::string& base, const std::string& rel, std::vector<std::string>& files) {
+	std::string dir = rel.empty() ? base : base + "/" + rel;
+
+	DIR* dp = opendir(dir.c_str());
+	if (!dp) {
+		fprintf(stderr, "flarepak: Could not open directory '%s'\n", dir.c_str());
+		return false;
+	}
+
+	std::vector<std::string> names;
+	struct dirent* dirp;
+	while ((dirp = readdir(dp)) != NULL) {
+		std::string name(dirp->d_name);
+		if (name != "." && name != "..")
+			names.push_back(name);
+	}
+	closedir(dp);
+
+	// sorted, so that packing the same directory twice gives the same archive
+	std::sort(names.begin(), names.end());
+
+	for (size_t i = 0; i < names.size(); ++i) {
+		std::string child = rel.empty() ? names[i] : rel + "/" + names[i];
+		std::string full = base + "/" + child;
+
+		struct stat st;
+		if (stat(full.c_str(), &st) != 0)
+			continue;
+
+		if (S_ISDIR(st.st_mode)) {
+			if (!collectFiles(base, child, files))
+				return false;
+		}
+		else if (S_ISREG(st.st_mode)) {
+			files.push_back(child);
+		}
+	}
+
+	return true;
+}
+
+bool appendFile(FILE* out, const std::string& filename, uint64_t& size) {
+	FILE* in = fopen(filename.c_str(), "rb");
+	if (!in) {
+		fprintf(stderr, "flarepak: Could not read '%s'\n", filename.c_str());
+		return false;
+	}
+
+	char buf[65536];
+	size_t count;
+	size = 0;
+	while ((count = fread(buf, 1, sizeof(buf), in)) > 0) {
+		if (fwrite(buf, 1, count, out) != count) {
+			fclose(in);
+			fprintf(stderr, "flarepak: Write error\n");
+			return false;
+		}
+		size += count;
+	}
+
+	bool ok = !ferror(in);
+	fclose(in);
+	if (!ok)
+		fprintf(stderr, "flarepak: Could not read '%s'\n", filename.c_str());
+	return ok;
+}
+
+int pack(std::string mod_dir, std::string out_filename) {
+	while (mod_dir.size() > 1 && (mod_dir[mod_dir.size()-1] == '/' || mod_dir[mod_dir.size()-1] == '\\'))
+		mod_dir.erase(mod_dir.size()-1);
+
+	if (out_filename.empty())
+		out_filename = mod_dir + ".flarepak";
+
+	std::vector<std::string> paths;
+	if (!collectFiles(mod_dir, "", paths))
+		return 1;
+
+	FILE* out = fopen(out_filename.c_str(), "wb");
+	if (!out) {
+		fprintf(stderr, "flarepak: Could not write '%s'\n", out_filename.c_str());
+		return 1;
+	}
+
+	// the header is written again once the table offset is known
+	std::string header(HEADER_SIZE, '\0');
+	fwrite(header.data(), 1, header.size(), out);
+
+	std::vector<Entry> entries;
+	uint64_t offset = HEADER_SIZE;
+	for (size_t i = 0; i < paths.size(); ++i) {
+		Entry entry;
+		entry.path = paths[i];
+		entry.offset = offset;
+		if (entry.path.size() > 0xffff || !appendFile(out, mod_dir + "/" + paths[i], entry.size)) {
+			fclose(out);
+			remove(out_filename.c_str());
+			return 1;
+		}
+		offset += entry.size;
+		entries.push_back(entry);
+	}
+
+	std::string table;
+	for (size_t i = 0; i < entries.size(); ++i) {
+		writeLE(table, entries[i].path.size(), 2);
+		table += entries[i].path;
+		writeLE(table, entries[i].offset, 8);
+		writeLE(table, entries[i].size, 8);
+		writeLE(table, entries[i].size, 8); // stored size
+		writeLE(table, METHOD_STORE, 4);
+	}
+	fwrite(table.data(), 1, table.size(), out);
+
+	header.assign(MAGIC, MAGIC_LENGTH);
+	writeLE(header, VERSION, 4);
+	writeLE(header, entries.size(), 4);
+	writeLE(header, offset, 8);
+	fseek(out, 0, SEEK_SET);
+	fwrite(header.data(), 1, header.size(), out);
+
+	bool ok = !ferror(out);
+	if (fclose(out) != 0 || !ok) {
+		fprintf(stderr, "flarepak: Write error\n");
+		remove(out_filename.c_str());
+		return 1;
+	}
+
+	printf("%s: %u files, %llu bytes\n", out_filename.c_str(), static_cast<unsigned>(entries.size()), static_cast<unsigned long long>(offset));
+	return 0;
+}
+
+int list(const std::string& filename) {
+	FILE* in = fopen(filename.c_str(), "rb");
+	if (!in) {
+		fprintf(stderr, "flarepak: Could not read '%s'\n", filename.c_str());
+		return 1;
+	}
+
+	std::string contents;
+	char buf[65536];
+	size_t count;
+	while ((count = fread(buf, 1, sizeof(buf), in)) > 0) {
+		contents.append(buf, count);
+	}
+	fclose(in);
+
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(contents.data());
+	if (contents.size() < HEADER_SIZE || memcmp(data, MAGIC, MAGIC_LENGTH) != 0) {
+		fprintf(stderr, "flarepak: '%s' is not an archive\n", filename.c_str());
+		return 1;
+	}
+
+	uint32_t entry_count = static_cast<uint32_t>(readLE(data + 12, 4));
+	uint64_t pos = readLE(data + 16, 8);
+	printf("version %u, %u files\n", static_cast<unsigned>(readLE(data + 8, 4)), entry_count);
+
+	for (uint32_t i = 0; i < entry_count; ++i) {
+		if (pos + 2 > contents.size())
+			break;
+		size_t path_length = static_cast<size_t>(readLE(data + pos, 2));
+		pos += 2;
+		if (pos + path_length + 28 > contents.size())
+			break;
+		std::string path(contents, static_cast<size_t>(pos), path_length);
+		pos += path_length;
+		uint64_t size = readLE(data + pos + 8, 8);
+		uint32_t method = static_cast<uint32_t>(readLE(data + pos + 24, 4));
+		pos += 28;
+		printf("%12llu  %u  %s\n", static_cast<unsigned long long>(size), method, path.c_str());
+	}
+
+	return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	if (argc == 3 && strcmp(argv[1], "--list") == 0)
+		return list(argv[2]);
+	else if ((argc == 2 || argc == 3) && argv[1][0] != '-')
+		return pack(argv[1], argc == 3 ? argv[2] : "");
+
+	printf("usage: flarepak MOD_DIRECTORY [ARCHIVE]\n");
+	printf("       flarepak --list ARCHIVE\n\n");
+	printf("Packs a mod directory into a .flarepak archive. By default, the archive is written next to the directory, as MOD_DIRECTORY.flarepak.\n");
+	printf("The engine only uses an archive when the mod directory it was packed from isn't there, so move or remove the directory after packing.\n");
+	return argc == 1 ? 0 : 1;
+}